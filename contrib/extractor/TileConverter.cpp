@@ -0,0 +1,347 @@
+/*
+ * This file is part of the Continued-MaNGOS Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Converts the .map files written by mapextractor into read-only .tile files,
+// which the server maps in memory instead of reading (see GridMap::loadTileData).
+
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <stdio.h>
+#include <string.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#include "loadlib/loadlib.h"
+
+char input_path[512] = "./maps";
+char output_path[512] = "";
+
+// Must match src/game/Maps/GridMap.h
+#define MAP_TILE_ALIGNMENT    64
+
+struct map_fileheader
+{
+    uint32 mapMagic;
+    uint32 versionMagic;
+    uint32 areaMapOffset;
+    uint32 areaMapSize;
+    uint32 heightMapOffset;
+    uint32 heightMapSize;
+    uint32 liquidMapOffset;
+    uint32 liquidMapSize;
+    uint32 holesOffset;
+    uint32 holesSize;
+};
+
+#define MAP_AREA_NO_AREA      0x0001
+
+struct map_areaHeader
+{
+    uint32 fourcc;
+    uint16 flags;
+    uint16 gridArea;
+};
+
+#define MAP_HEIGHT_NO_HEIGHT  0x0001
+#define MAP_HEIGHT_AS_INT16   0x0002
+#define MAP_HEIGHT_AS_INT8    0x0004
+
+struct map_heightHeader
+{
+    uint32 fourcc;
+    uint32 flags;
+    float  gridHeight;
+    float  gridMaxHeight;
+};
+
+#define MAP_LIQUID_NO_TYPE    0x0001
+#define MAP_LIQUID_NO_HEIGHT  0x0002
+
+struct map_liquidHeader
+{
+    uint32 fourcc;
+    uint16 flags;
+    uint16 liquidType;
+    uint8  offsetX;
+    uint8  offsetY;
+    uint8  width;
+    uint8  height;
+    float  liquidLevel;
+};
+
+struct map_tileHeader
+{
+    uint32 tileMagic;
+    uint32 versionMagic;
+    uint32 fileSize;
+    map_areaHeader area;
+    map_heightHeader height;
+    map_liquidHeader liquid;
+    uint32 areaMapOffset;
+    uint32 heightV9Offset;
+    uint32 heightV8Offset;
+    uint32 liquidEntryOffset;
+    uint32 liquidFlagsOffset;
+    uint32 liquidMapOffset;
+};
+
+char const* MAP_MAGIC         = "MAPS";
+char const* MAP_VERSION_MAGIC = "z1.3";
+char const* MAP_AREA_MAGIC    = "AREA";
+char const* MAP_HEIGHT_MAGIC  = "MHGT";
+char const* MAP_LIQUID_MAGIC  = "MLIQ";
+char const* MAP_TILE_MAGIC    = "MTIL";
+char const* MAP_TILE_VERSION_MAGIC = "t1.0";
+
+void Usage(char* prg)
+{
+    printf(
+        "Usage:\n"\
+        "%s -[var] [value]\n"\
+        "-i set directory of the .map files (default ./maps)\n"\
+        "-o set output directory of the .tile files (default: same as input)\n"\
+        "Example: %s -i \"c:\\server\\data\\maps\"", prg, prg);
+    exit(1);
+}
+
+void HandleArgs(int argc, char* arg[])
+{
+    for (int c = 1; c < argc; ++c)
+    {
+        if (arg[c][0] != '-')
+            Usage(arg[0]);
+
+        switch (arg[c][1])
+        {
+            case 'i':
+                if (c + 1 < argc)
+                    strncpy(input_path, arg[(c++) + 1], sizeof(input_path) - 1);
+                else
+                    Usage(arg[0]);
+                break;
+            case 'o':
+                if (c + 1 < argc)
+                    strncpy(output_path, arg[(c++) + 1], sizeof(output_path) - 1);
+                else
+                    Usage(arg[0]);
+                break;
+            default:
+                Usage(arg[0]);
+        }
+    }
+    if (!output_path[0])
+        strcpy(output_path, input_path);
+}
+
+bool ListMapFiles(std::vector<std::string>& files)
+{
+#ifdef WIN32
+    WIN32_FIND_DATA findFileInfo;
+    std::string filter = std::string(input_path) + "/*.map";
+    HANDLE hFind = FindFirstFile(filter.c_str(), &findFileInfo);
+    if (hFind == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        if ((findFileInfo.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+            files.push_back(findFileInfo.cFileName);
+    }
+    while (FindNextFile(hFind, &findFileInfo));
+
+    FindClose(hFind);
+#else
+    DIR* dirp = opendir(input_path);
+    if (!dirp)
+        return false;
+
+    while (dirent* dp = readdir(dirp))
+    {
+        size_t len = strlen(dp->d_name);
+        if (len > 4 && !strcmp(dp->d_name + len - 4, ".map"))
+            files.push_back(dp->d_name);
+    }
+    closedir(dirp);
+#endif
+    return true;
+}
+
+// Bounds-checked view of a section of the source file
+template<class T>
+T const* MapSection(std::vector<char> const& data, uint32 offset, size_t count = 1)
+{
+    if (offset + sizeof(T) * count > data.size())
+        return NULL;
+    return reinterpret_cast<T const*>(&data[offset]);
+}
+
+// Appends a section at the next aligned offset of the tile, returns that offset
+uint32 AppendSection(std::vector<char>& tile, void const* src, size_t size)
+{
+    size_t offset = (tile.size() + MAP_TILE_ALIGNMENT - 1) & ~size_t(MAP_TILE_ALIGNMENT - 1);
+    tile.resize(offset + size, 0);
+    memcpy(&tile[offset], src, size);
+    return uint32(offset);
+}
+
+bool ConvertMap(std::string const& mapFile, std::string const& tileFile)
+{
+    FILE* in = fopen(mapFile.c_str(), "rb");
+    if (!in)
+    {
+        printf("Can't open the map file '%s'\n", mapFile.c_str());
+        return false;
+    }
+    fseek(in, 0, SEEK_END);
+    long fileSize = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    std::vector<char> data(fileSize > 0 ? fileSize : 0);
+    bool readOk = !data.empty() && fread(&data[0], data.size(), 1, in) == 1;
+    fclose(in);
+
+    map_fileheader const* header = readOk ? MapSection<map_fileheader>(data, 0) : NULL;
+    if (!header || header->mapMagic != *((uint32 const*)(MAP_MAGIC)) ||
+            header->versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)))
+    {
+        printf("Map file '%s' is non-compatible version (outdated?), extract it again\n", mapFile.c_str());
+        return false;
+    }
+
+    std::vector<char> tile(sizeof(map_tileHeader), 0);
+    map_tileHeader tileHeader;
+    memset(&tileHeader, 0, sizeof(tileHeader));
+    tileHeader.tileMagic = *((uint32 const*)(MAP_TILE_MAGIC));
+    tileHeader.versionMagic = *((uint32 const*)(MAP_TILE_VERSION_MAGIC));
+
+    if (header->areaMapOffset)
+    {
+        map_areaHeader const* area = MapSection<map_areaHeader>(data, header->areaMapOffset);
+        if (!area || area->fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+            return false;
+        tileHeader.area = *area;
+        if (!(area->flags & MAP_AREA_NO_AREA))
+        {
+            uint16 const* areaMap = MapSection<uint16>(data, header->areaMapOffset + sizeof(map_areaHeader), 16 * 16);
+            if (!areaMap)
+                return false;
+            tileHeader.areaMapOffset = AppendSection(tile, areaMap, sizeof(uint16) * 16 * 16);
+        }
+    }
+
+    if (header->heightMapOffset)
+    {
+        map_heightHeader const* height = MapSection<map_heightHeader>(data, header->heightMapOffset);
+        if (!height || height->fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+            return false;
+        tileHeader.height = *height;
+        if (!(height->flags & MAP_HEIGHT_NO_HEIGHT))
+        {
+            size_t valueSize = sizeof(float);
+            if (height->flags & MAP_HEIGHT_AS_INT16)
+                valueSize = sizeof(uint16);
+            else if (height->flags & MAP_HEIGHT_AS_INT8)
+                valueSize = sizeof(uint8);
+
+            uint32 v9Offset = header->heightMapOffset + sizeof(map_heightHeader);
+            uint32 v8Offset = v9Offset + valueSize * 129 * 129;
+            char const* v9 = MapSection<char>(data, v9Offset, valueSize * 129 * 129);
+            char const* v8 = MapSection<char>(data, v8Offset, valueSize * 128 * 128);
+            if (!v9 || !v8)
+                return false;
+            tileHeader.heightV9Offset = AppendSection(tile, v9, valueSize * 129 * 129);
+            tileHeader.heightV8Offset = AppendSection(tile, v8, valueSize * 128 * 128);
+        }
+    }
+
+    if (header->liquidMapOffset)
+    {
+        map_liquidHeader const* liquid = MapSection<map_liquidHeader>(data, header->liquidMapOffset);
+        if (!liquid || liquid->fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+            return false;
+        tileHeader.liquid = *liquid;
+
+        uint32 offset = header->liquidMapOffset + sizeof(map_liquidHeader);
+        if (!(liquid->flags & MAP_LIQUID_NO_TYPE))
+        {
+            uint16 const* entries = MapSection<uint16>(data, offset, 16 * 16);
+            uint8 const* flags = MapSection<uint8>(data, offset + sizeof(uint16) * 16 * 16, 16 * 16);
+            if (!entries || !flags)
+                return false;
+            tileHeader.liquidEntryOffset = AppendSection(tile, entries, sizeof(uint16) * 16 * 16);
+            tileHeader.liquidFlagsOffset = AppendSection(tile, flags, sizeof(uint8) * 16 * 16);
+            offset += (sizeof(uint16) + sizeof(uint8)) * 16 * 16;
+        }
+        if (!(liquid->flags & MAP_LIQUID_NO_HEIGHT))
+        {
+            size_t count = liquid->width * liquid->height;
+            float const* levels = MapSection<float>(data, offset, count);
+            if (!levels)
+                return false;
+            tileHeader.liquidMapOffset = AppendSection(tile, levels, sizeof(float) * count);
+        }
+    }
+
+    tileHeader.fileSize = uint32(tile.size());
+    memcpy(&tile[0], &tileHeader, sizeof(tileHeader));
+
+    FILE* output = fopen(tileFile.c_str(), "wb");
+    if (!output)
+    {
+        printf("Can't create the output file '%s'\n", tileFile.c_str());
+        return false;
+    }
+    bool written = fwrite(&tile[0], tile.size(), 1, output) == 1;
+    fclose(output);
+    return written;
+}
+
+int main(int argc, char* arg[])
+{
+    printf("Map to Tile Converter\n");
+    printf("=====================\n\n");
+
+    HandleArgs(argc, arg);
+
+    std::vector<std::string> files;
+    if (!ListMapFiles(files))
+    {
+        printf("Can't list the map directory '%s'\n", input_path);
+        return 1;
+    }
+
+    uint32 converted = 0;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        std::string tileName = files[i].substr(0, files[i].length() - 4) + ".tile";
+        if (ConvertMap(std::string(input_path) + "/" + files[i], std::string(output_path) + "/" + tileName))
+            ++converted;
+        else
+            printf("Failed to convert '%s'\n", files[i].c_str());
+
+        printf("Processing........................%u%%\r", uint32((100 * (i + 1)) / files.size()));
+    }
+    printf("\nConverted %u of %u map files\n", converted, uint32(files.size()));
+    return converted == files.size() ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+DROP PROCEDURE IF EXISTS add_migration;
+delimiter ??
+CREATE PROCEDURE `add_migration`()
+BEGIN
+DECLARE v INT DEFAULT 1;
+SET v = (SELECT COUNT(*) FROM `migrations` WHERE `id`='20261018120000');
+IF v=0 THEN
+INSERT INTO `migrations` VALUES ('20261018120000');
+-- Add your query below.
+
+-- Lets realmd reload only the accounts changed since its last account cache update
+-- (a second TIMESTAMP column with CURRENT_TIMESTAMP needs MySQL 5.6.5 or MariaDB)
+ALTER TABLE `account` ADD COLUMN `last_modified` timestamp NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+    ADD KEY `idx_last_modified` (`last_modified`);
+
+-- End of migration.
+END IF;
+END??
+delimiter ; 
+CALL add_migration();
+DROP PROCEDURE IF EXISTS add_migration;
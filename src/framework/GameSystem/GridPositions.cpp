@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "GameSystem/GridPositions.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#define GRID_POSITIONS_MIN_CAPACITY 8
+
+GridPositionSlot::~GridPositionSlot()
+{
+    GridPositions::Remove(*this);
+}
+
+GridPositions::~GridPositions()
+{
+    uint32 size = m_size.load(std::memory_order_relaxed);
+    if (size)
+    {
+        // Objects still linked (grid destroyed before them) must not point to freed memory
+        GridPositionSlot** slots = Slots();
+        for (uint32 i = 0; i < size; ++i)
+            slots[i]->owner = NULL;
+    }
+    free(m_data.load(std::memory_order_relaxed));
+
+    for (char* data : m_retired)
+        free(data);
+}
+
+void GridPositions::Grow()
+{
+    uint32 capacity = m_capacity ? m_capacity * 2 : GRID_POSITIONS_MIN_CAPACITY;
+    // malloc alignment is enough for the SSE loads: the header and each array are multiples of 16 bytes
+    char* data = static_cast<char*>(malloc(HEADER_SIZE + capacity * EntrySize()));
+    assert(data);
+    *reinterpret_cast<uint32*>(data) = capacity;
+
+    // Same order as the accessors: x, y, z, radius, guid, object, slot, typeId
+    static size_t const arraySizes[] = { sizeof(float), sizeof(float), sizeof(float), sizeof(float),
+        sizeof(uint64), sizeof(WorldObject*), sizeof(GridPositionSlot*), sizeof(uint8) };
+
+    // The new buffer is filled before it replaces the old one
+    char* oldData = m_data.load(std::memory_order_relaxed);
+    uint32 size = m_size.load(std::memory_order_relaxed);
+    size_t oldOffset = HEADER_SIZE;
+    size_t newOffset = HEADER_SIZE;
+    for (size_t arraySize : arraySizes)
+    {
+        if (size)
+            memcpy(data + newOffset, oldData + oldOffset, size * arraySize);
+        oldOffset += m_capacity * arraySize;
+        newOffset += capacity * arraySize;
+    }
+
+    // Not freed yet: a searcher may still be scanning it (see m_retired)
+    if (oldData)
+        m_retired.push_back(oldData);
+    m_capacity = capacity;
+    m_data.store(data, std::memory_order_release);
+}
+
+void GridPositions::Add(GridPositionSlot& slot, WorldObject* object, uint64 guid, uint8 typeId, float x, float y, float z, float radius)
+{
+    // An object is only in one container at a time
+    Remove(slot);
+
+    uint32 index = m_size.load(std::memory_order_relaxed);
+    if (index == m_capacity)
+        Grow();
+
+    X()[index] = x;
+    Y()[index] = y;
+    Z()[index] = z;
+    Radius()[index] = radius;
+    Guids()[index] = guid;
+    Objects()[index] = object;
+    Slots()[index] = &slot;
+    TypeIds()[index] = typeId;
+    m_size.store(index + 1, std::memory_order_release);
+
+    slot.owner = this;
+    slot.index = index;
+}
+
+void GridPositions::Remove(GridPositionSlot& slot)
+{
+    GridPositions* positions = slot.owner;
+    if (!positions)
+        return;
+
+    uint32 index = slot.index;
+    uint32 last = positions->m_size.load(std::memory_order_relaxed) - 1;
+    if (index != last)
+    {
+        positions->X()[index] = positions->X()[last];
+        positions->Y()[index] = positions->Y()[last];
+        positions->Z()[index] = positions->Z()[last];
+        positions->Radius()[index] = positions->Radius()[last];
+        positions->Guids()[index] = positions->Guids()[last];
+        positions->Objects()[index] = positions->Objects()[last];
+        positions->TypeIds()[index] = positions->TypeIds()[last];
+        GridPositionSlot* moved = positions->Slots()[last];
+        positions->Slots()[index] = moved;
+        moved->index = index;
+    }
+    positions->m_size.store(last, std::memory_order_release);
+    slot.owner = NULL;
+}
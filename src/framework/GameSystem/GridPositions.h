@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_GRIDPOSITIONS_H
+#define MANGOS_GRIDPOSITIONS_H
+
+#include "Platform/Define.h"
+#include <atomic>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRID_POSITIONS_SSE2
+#include <emmintrin.h>
+#endif
+
+class WorldObject;
+class GridPositions;
+
+// Place of an object in the GridPositions of the cell container holding it
+struct GridPositionSlot
+{
+    GridPositionSlot() : owner(NULL), index(0) {}
+    ~GridPositionSlot();
+
+    GridPositions* owner;
+    uint32 index;
+};
+
+/*
+ * Packed copy of the positions of the objects of a cell container, kept next
+ * to the GridRefManager list: x, y, z and bounding radius in separate float
+ * arrays, with the guid, type id and object of each entry. Searchers scan it
+ * four entries at a time and only dereference the objects in range.
+ * Order is not stable, removal moves the last entry into the freed place: the
+ * searchers that keep the first (UnitSearcher) or last (UnitLastSearcher) match
+ * may pick another object than the GridRefManager list order would.
+ * A searcher of another thread may still be scanning the buffer replaced by
+ * Grow(), so replaced buffers are only freed with the container.
+ */
+class GridPositions
+{
+    public:
+        GridPositions() : m_data(NULL), m_size(0), m_capacity(0) {}
+        ~GridPositions();
+
+        void Add(GridPositionSlot& slot, WorldObject* object, uint64 guid, uint8 typeId, float x, float y, float z, float radius);
+        static void Remove(GridPositionSlot& slot);
+        static void Update(GridPositionSlot const& slot, float x, float y, float z, float radius)
+        {
+            if (GridPositions* positions = slot.owner)
+            {
+                positions->X()[slot.index] = x;
+                positions->Y()[slot.index] = y;
+                positions->Z()[slot.index] = z;
+                positions->Radius()[slot.index] = radius;
+            }
+        }
+
+        uint32 size() const { return m_size.load(std::memory_order_relaxed); }
+        WorldObject* GetObject(uint32 index) const { return Objects()[index]; }
+        uint64 GetGuid(uint32 index) const { return Guids()[index]; }
+        uint8 GetTypeId(uint32 index) const { return TypeIds()[index]; }
+
+        // Calls visitor(WorldObject*) for every object whose bounding circle, in 2D, is closer than
+        // radius to (x, y). Stops when the visitor returns false.
+        template<class Visitor>
+        void VisitInRange(float x, float y, float radius, Visitor& visitor) const
+        {
+            // The size is published after the entries and the buffer holding them, so it never
+            // exceeds the capacity of the buffer read next
+            uint32 const size = m_size.load(std::memory_order_acquire);
+            char const* data = m_data.load(std::memory_order_acquire);
+            if (!size)
+                return;
+
+            uint32 const capacity = GetCapacity(data);
+            float const* px = X(data);
+            float const* py = px + capacity;
+            float const* pr = py + 2 * capacity;
+            WorldObject* const* objects = Objects(data, capacity);
+            uint32 i = 0;
+#ifdef GRID_POSITIONS_SSE2
+            __m128 const cx = _mm_set1_ps(x);
+            __m128 const cy = _mm_set1_ps(y);
+            __m128 const cr = _mm_set1_ps(radius);
+            for (; i + 4 <= size; i += 4)
+            {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(px + i), cx);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(py + i), cy);
+                __m128 maxDist = _mm_add_ps(_mm_loadu_ps(pr + i), cr);
+                __m128 inRange = _mm_cmplt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(maxDist, maxDist));
+                int mask = _mm_movemask_ps(inRange);
+                for (uint32 j = 0; mask; ++j, mask >>= 1)
+                    if ((mask & 1) && !visitor(objects[i + j]))
+                        return;
+            }
+#endif
+            for (; i < size; ++i)
+            {
+                float dx = px[i] - x;
+                float dy = py[i] - y;
+                float maxDist = pr[i] + radius;
+                if (dx * dx + dy * dy < maxDist * maxDist && !visitor(objects[i]))
+                    return;
+            }
+        }
+
+    private:
+        GridPositions(GridPositions const&);
+        GridPositions& operator=(GridPositions const&);
+
+        void Grow();
+
+        // Single allocation: a 16 bytes header holding the capacity (multiple of 4), then
+        // x[], y[], z[], radius[], guid[], object[], slot[], typeId[] of capacity entries each.
+        // Readers take the capacity from the buffer they read, not from m_capacity.
+        enum { HEADER_SIZE = 16 };
+        static uint32 GetCapacity(char const* data) { return *reinterpret_cast<uint32 const*>(data); }
+        static float const* X(char const* data) { return reinterpret_cast<float const*>(data + HEADER_SIZE); }
+        static WorldObject* const* Objects(char const* data, uint32 capacity)
+        {
+            return reinterpret_cast<WorldObject* const*>(reinterpret_cast<uint64 const*>(X(data) + 4 * capacity) + capacity);
+        }
+
+        // Writer side (the thread owning the container)
+        float* X() const { return reinterpret_cast<float*>(m_data.load(std::memory_order_relaxed) + HEADER_SIZE); }
+        float* Y() const { return X() + m_capacity; }
+        float* Z() const { return Y() + m_capacity; }
+        float* Radius() const { return Z() + m_capacity; }
+        uint64* Guids() const { return reinterpret_cast<uint64*>(Radius() + m_capacity); }
+        WorldObject** Objects() const { return reinterpret_cast<WorldObject**>(Guids() + m_capacity); }
+        GridPositionSlot** Slots() const { return reinterpret_cast<GridPositionSlot**>(Objects() + m_capacity); }
+        uint8* TypeIds() const { return reinterpret_cast<uint8*>(Slots() + m_capacity); }
+
+        static size_t EntrySize() { return 4 * sizeof(float) + sizeof(uint64) + sizeof(WorldObject*) + sizeof(GridPositionSlot*) + sizeof(uint8); }
+
+        std::atomic<char*> m_data;
+        std::atomic<uint32> m_size;
+        uint32 m_capacity;
+        // Buffers replaced by Grow(), together smaller than m_data since the capacity doubles
+        std::vector<char*> m_retired;
+};
+
+#endif
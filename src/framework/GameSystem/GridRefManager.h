@@ -23,6 +23,7 @@
 #define _GRIDREFMANAGER
 
 #include "Utilities/LinkedReference/RefManager.h"
+#include "GameSystem/GridPositions.h"
 
 template<class OBJECT> class GridReference;
 
@@ -47,5 +48,12 @@ class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
         iterator end() { return iterator(NULL); }
         iterator rbegin() { return iterator(getLast()); }
         iterator rend() { return iterator(NULL); }
+
+        // Positions of the objects of the list, maintained by the TypeMapContainer insert/remove
+        GridPositions& GetPositions() { return m_positions; }
+        GridPositions const& GetPositions() const { return m_positions; }
+
+    private:
+        GridPositions m_positions;
 };
 #endif
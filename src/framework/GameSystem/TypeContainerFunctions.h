@@ -72,6 +72,7 @@ namespace MaNGOS
     {
         //elements._element[hdl] = obj;
         obj->GetGridRef().link(&elements._element, obj);
+        obj->AddToGridPositions(elements._element.GetPositions());
         return obj;
     }
 
@@ -101,6 +102,7 @@ namespace MaNGOS
     SPECIFIC_TYPE* Remove(ContainerMapList<SPECIFIC_TYPE> & /*elements*/, SPECIFIC_TYPE *obj)
     {
         obj->GetGridRef().unlink();
+        obj->RemoveFromGridPositions();
         return obj;
     }
 
@@ -19,9 +19,10 @@
 #endif /* ACE_LACKS_PRAGMA_ONCE */
 
 #include "Common.h"
+#include "WorldPacket.h"
+#include <deque>
 
 class ACE_Message_Block;
-class WorldPacket;
 class WorldSession;
 
 
@@ -81,6 +82,11 @@ typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
  * distributed where its needed. 1024 matches pretty well the
  * traffic generated by client for now.
  *
+ * Packets sent to many sockets (broadcasts) can be sent with
+ * SendSharedPacket(): their body is not copied to the buffer,
+ * only their encrypted header is kept by the socket, and the
+ * buffer and the shared bodies are written with one writev().
+ *
  * The input/output do speculative reads/writes (AKA it tryes
  * to read all data available in the kernel buffer or tryes to
  * write everything available in userspace buffer),
@@ -104,8 +110,22 @@ class MangosSocket : protected WorldHandler
         typedef ACE_Thread_Mutex LockType;
         typedef ACE_Guard<LockType> GuardType;
 
+        /// Largest header written before a packet (server or client format).
+        enum { MAX_HEADER_SIZE = sizeof(ClientPktHeader) };
+
+        /// Most iovecs given to one writev().
+        enum { MAX_OUTPUT_IOV = 64 };
+
+        /// Packet for which there is no space: a private copy, or a shared body.
+        struct QueuedPacket
+        {
+            QueuedPacket() : packet(NULL) {}
+            WorldPacket* packet;
+            SharedPacket shared;
+        };
+
         /// Queue for storing packets for which there is no space.
-        typedef ACE_Unbounded_Queue<WorldPacket*> PacketQueueT;
+        typedef ACE_Unbounded_Queue<QueuedPacket> PacketQueueT;
 
         /// Check if socket is closed.
         bool IsClosed() const { return closing_; }
@@ -121,6 +141,18 @@ class MangosSocket : protected WorldHandler
         /// @return -1 of failure
         int SendPacket (const WorldPacket& pct);
 
+        /// Send a packet that is finalized on the network thread, right before
+        /// being copied to the output buffer (see PrepareQueuedPacket()).
+        /// Packets sent after it are queued behind it, so ordering is kept.
+        /// @param pct packet to send, its content is moved away
+        /// @return -1 of failure
+        int SendDeferredPacket (WorldPacket& pct);
+
+        /// Send a packet body shared with other sockets, without copying it.
+        /// @param pct packet to send, must not be modified anymore
+        /// @return -1 of failure
+        int SendSharedPacket (const SharedPacket& pct);
+
         /// Add reference to this object.
         long AddReference() { return static_cast<long>(add_reference()); }
 
@@ -142,6 +174,12 @@ class MangosSocket : protected WorldHandler
         /// @param new_pct received packet ,note that you need to delete it.
         int ProcessIncoming (WorldPacket* new_pct) { delete new_pct; return 0; }
         int OnSocketOpen() { return 0; }
+        /// Called on the network thread for each queued packet before it is written.
+        void PrepareQueuedPacket (WorldPacket& /*pct*/) {}
+        /// Write the encrypted header of a packet to dest (MAX_HEADER_SIZE bytes).
+        /// Headers must be built in the order the packets are written.
+        /// @return the size of the header
+        uint8 BuildHeader (const WorldPacket& pct, char* dest);
 
         /// Called on open ,the void* is the acceptor.
         virtual int open (void *);
@@ -176,6 +214,19 @@ class MangosSocket : protected WorldHandler
         /// Need to be called with m_OutBufferLock lock held
         int iSendPacket (const WorldPacket& pct);
 
+        /// Queue a shared packet after the data of m_OutBuffer, never fails
+        /// Need to be called with m_OutBufferLock lock held
+        int iSendSharedPacket (const SharedPacket& pct);
+
+        /// Write m_OutBuffer and the shared packets with one writev()
+        /// Need to be called with m_OutBufferLock lock held
+        /// @param send_len set to the bytes given to writev()
+        ssize_t iSendSegments (size_t& send_len);
+
+        /// Drop the first 'len' bytes sent from m_OutBuffer and the shared packets
+        /// Need to be called with m_OutBufferLock lock held
+        void iConsumeOutput (size_t len);
+
         /// Flush m_PacketQueue if there are packets in it
         /// Need to be called with m_OutBufferLock lock held
         /// @return true if it wrote to the buffer ( AKA you need
@@ -220,6 +271,21 @@ class MangosSocket : protected WorldHandler
         /// Size of the m_OutBuffer.
         size_t m_OutBufferSize;
 
+        /// Shared packet written after the first 'bufferPos' bytes of m_OutBuffer.
+        struct SharedSegment
+        {
+            SharedPacket packet;
+            size_t bufferPos;                               // from m_OutBuffer->base()
+            size_t sent;                                    // bytes of header and body
+            uint8 headerSize;
+            char header[MAX_HEADER_SIZE];
+
+            size_t size() const { return headerSize + packet->size(); }
+        };
+
+        /// Shared packets to write, in order, interleaved with m_OutBuffer.
+        std::deque<SharedSegment> m_SharedSegments;
+
         /// Here are stored packets for which there was no space on m_OutBuffer,
         /// this allows not-to kick player if its buffer is overflowed.
         PacketQueueT m_PacketQueue;
@@ -1,6 +1,8 @@
 #include <ace/Message_Block.h>
 #include <ace/OS_NS_string.h>
 #include <ace/OS_NS_unistd.h>
+#include <ace/OS_NS_sys_socket.h>
+#include <ace/OS_NS_sys_uio.h>
 #include <ace/os_include/arpa/os_inet.h>
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
@@ -22,6 +24,7 @@
 #include "WorldSession.h"
 #include "Log.h"
 #include "DBCStores.h"
+#include "TickProfiler.h"
 
 
 template <typename SessionType, typename SocketName, typename Crypt>
@@ -54,9 +57,9 @@ MangosSocket<SessionType, SocketName, Crypt>::~MangosSocket(void)
 
     peer().close();
 
-    WorldPacket* pct;
-    while (m_PacketQueue.dequeue_head(pct) == 0)
-        delete pct;
+    QueuedPacket queued;
+    while (m_PacketQueue.dequeue_head(queued) == 0)
+        delete queued.packet;
 }
 
 template <typename SessionType, typename SocketName, typename Crypt>
@@ -87,17 +90,18 @@ int MangosSocket<SessionType, SocketName, Crypt>::SendPacket(const WorldPacket&
     if (closing_)
         return -1;
 
-    if (((SocketName*)this)->iSendPacket(pct) == -1)
+    // Do not overtake packets still waiting in the queue
+    if (!m_PacketQueue.is_empty() || ((SocketName*)this)->iSendPacket(pct) == -1)
     {
-        WorldPacket* npct;
+        QueuedPacket queued;
 
-        ACE_NEW_RETURN(npct, WorldPacket(pct), -1);
+        ACE_NEW_RETURN(queued.packet, WorldPacket(pct), -1);
 
         // NOTE maybe check of the size of the queue can be good ?
         // to make it bounded instead of unbounded
-        if (m_PacketQueue.enqueue_tail(npct) == -1)
+        if (m_PacketQueue.enqueue_tail(queued) == -1)
         {
-            delete npct;
+            delete queued.packet;
             sLog.outError("MangosSocket<SessionType, SocketName, Crypt>::SendPacket: m_PacketQueue.enqueue_tail failed");
             return -1;
         }
@@ -106,6 +110,52 @@ int MangosSocket<SessionType, SocketName, Crypt>::SendPacket(const WorldPacket&
     return 0;
 }
 
+template <typename SessionType, typename SocketName, typename Crypt>
+int MangosSocket<SessionType, SocketName, Crypt>::SendSharedPacket(const SharedPacket& pct)
+{
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+        return -1;
+
+    // Do not overtake packets still waiting in the queue
+    if (m_PacketQueue.is_empty())
+        return iSendSharedPacket(pct);
+
+    QueuedPacket queued;
+    queued.shared = pct;
+
+    if (m_PacketQueue.enqueue_tail(queued) == -1)
+    {
+        sLog.outError("MangosSocket<SessionType, SocketName, Crypt>::SendSharedPacket: m_PacketQueue.enqueue_tail failed");
+        return -1;
+    }
+
+    return 0;
+}
+
+template <typename SessionType, typename SocketName, typename Crypt>
+int MangosSocket<SessionType, SocketName, Crypt>::SendDeferredPacket(WorldPacket& pct)
+{
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+        return -1;
+
+    // Always queued: the queue is only flushed by the network thread (handle_output)
+    QueuedPacket queued;
+    ACE_NEW_RETURN(queued.packet, WorldPacket(std::move(pct)), -1);
+
+    if (m_PacketQueue.enqueue_tail(queued) == -1)
+    {
+        delete queued.packet;
+        sLog.outError("MangosSocket<SessionType, SocketName, Crypt>::SendDeferredPacket: m_PacketQueue.enqueue_tail failed");
+        return -1;
+    }
+
+    return 0;
+}
+
 template <typename SessionType, typename SocketName, typename Crypt>
 int MangosSocket<SessionType, SocketName, Crypt>::open(void *a)
 {
@@ -210,16 +260,26 @@ int MangosSocket<SessionType, SocketName, Crypt>::handle_output(ACE_HANDLE)
     if (closing_)
         return -1;
 
-    const size_t send_len = m_OutBuffer->length();
+    // Deferred packets may be waiting while the buffer is empty
+    if (m_OutBuffer->length() == 0 && m_SharedSegments.empty())
+        iFlushPacketQueue();
 
-    if (send_len == 0)
+    size_t send_len = m_OutBuffer->length();
+
+    if (send_len == 0 && m_SharedSegments.empty())
         return cancel_wakeup_output(Guard);
 
+    ssize_t n;
+    if (!m_SharedSegments.empty())
+        n = iSendSegments(send_len);
+    else
+    {
 #ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
+        n = peer().send(m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
 #else
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len);
+        n = peer().send(m_OutBuffer->rd_ptr(), send_len);
 #endif // MSG_NOSIGNAL
+    }
 
     if (n == 0)
         return -1;
@@ -230,16 +290,21 @@ int MangosSocket<SessionType, SocketName, Crypt>::handle_output(ACE_HANDLE)
 
         return -1;
     }
-    else if (n < (ssize_t)send_len) //now n > 0
-    {
-        m_OutBuffer->rd_ptr(static_cast<size_t>(n));
 
-        // move the data to the base of the buffer
+    //now n > 0
+    iConsumeOutput(static_cast<size_t>(n));
+
+    if (m_OutBuffer->length() > 0 || !m_SharedSegments.empty())
+    {
+        // move the data to the base of the buffer, the shared packets follow it
+        const size_t moved = m_OutBuffer->rd_ptr() - m_OutBuffer->base();
         m_OutBuffer->crunch();
+        for (typename std::deque<SharedSegment>::iterator itr = m_SharedSegments.begin(); itr != m_SharedSegments.end(); ++itr)
+            itr->bufferPos -= moved;
 
         return schedule_wakeup_output(Guard);
     }
-    else //now n == send_len
+    else //everything sent
     {
         m_OutBuffer->reset();
 
@@ -282,7 +347,7 @@ int MangosSocket<SessionType, SocketName, Crypt>::Update(void)
     if (closing_)
         return -1;
 
-    if (m_OutActive || m_OutBuffer->length() == 0)
+    if (m_OutActive || (m_OutBuffer->length() == 0 && m_SharedSegments.empty() && m_PacketQueue.is_empty()))
         return 0;
 
     return handle_output(get_handle());
@@ -482,14 +547,8 @@ int MangosSocket<SessionType, SocketName, Crypt>::schedule_wakeup_output(GuardTy
 }
 
 template <typename SessionType, typename SocketName, typename Crypt>
-int MangosSocket<SessionType, SocketName, Crypt>::iSendPacket(const WorldPacket& pct)
+uint8 MangosSocket<SessionType, SocketName, Crypt>::BuildHeader(const WorldPacket& pct, char* dest)
 {
-    if (m_OutBuffer->space() < pct.size() + sizeof(ServerPktHeader))
-    {
-        errno = ENOBUFS;
-        return -1;
-    }
-
     ServerPktHeader header;
 
     header.cmd = pct.GetOpcode();
@@ -501,29 +560,161 @@ int MangosSocket<SessionType, SocketName, Crypt>::iSendPacket(const WorldPacket&
 
     m_Crypt.EncryptSend((uint8*) & header, sizeof(header));
 
-    if (m_OutBuffer->copy((char*) & header, sizeof(header)) == -1)
+    memcpy(dest, &header, sizeof(header));
+    return sizeof(header);
+}
+
+template <typename SessionType, typename SocketName, typename Crypt>
+int MangosSocket<SessionType, SocketName, Crypt>::iSendPacket(const WorldPacket& pct)
+{
+    if (m_OutBuffer->space() < pct.size() + MAX_HEADER_SIZE)
+    {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    char header[MAX_HEADER_SIZE];
+    const uint8 header_size = ((SocketName*)this)->BuildHeader(pct, header);
+
+    if (m_OutBuffer->copy(header, header_size) == -1)
         ACE_ASSERT(false);
 
     if (!pct.empty())
         if (m_OutBuffer->copy((char*) pct.contents(), pct.size()) == -1)
             ACE_ASSERT(false);
 
+    if (sTickProfiler.IsEnabled())
+        sTickProfiler.AddCopiedBytes(pct.size());
+
+    return 0;
+}
+
+template <typename SessionType, typename SocketName, typename Crypt>
+int MangosSocket<SessionType, SocketName, Crypt>::iSendSharedPacket(const SharedPacket& pct)
+{
+    if (pct->size() < MIN_SHARED_PACKET_SIZE && ((SocketName*)this)->iSendPacket(*pct) == 0)
+        return 0;
+
+    m_SharedSegments.push_back(SharedSegment());
+
+    SharedSegment& segment = m_SharedSegments.back();
+    segment.packet = pct;
+    segment.bufferPos = m_OutBuffer->wr_ptr() - m_OutBuffer->base();
+    segment.sent = 0;
+    segment.headerSize = ((SocketName*)this)->BuildHeader(*pct, segment.header);
+
+    if (sTickProfiler.IsEnabled())
+        sTickProfiler.AddSharedBytes(pct->size());
+
     return 0;
 }
 
+template <typename SessionType, typename SocketName, typename Crypt>
+ssize_t MangosSocket<SessionType, SocketName, Crypt>::iSendSegments(size_t& send_len)
+{
+    iovec iov[MAX_OUTPUT_IOV];
+    int count = 0;
+    send_len = 0;
+
+    char* base = m_OutBuffer->base();
+    size_t pos = m_OutBuffer->rd_ptr() - base;
+
+    typename std::deque<SharedSegment>::const_iterator itr = m_SharedSegments.begin();
+    for (; itr != m_SharedSegments.end() && count + 3 <= MAX_OUTPUT_IOV; ++itr)
+    {
+        // buffered data before the packet, the header, then the body
+        if (itr->bufferPos > pos)
+        {
+            iov[count].iov_base = base + pos;
+            iov[count].iov_len = itr->bufferPos - pos;
+            send_len += iov[count++].iov_len;
+            pos = itr->bufferPos;
+        }
+
+        if (itr->sent < itr->headerSize)
+        {
+            iov[count].iov_base = const_cast<char*>(itr->header) + itr->sent;
+            iov[count].iov_len = itr->headerSize - itr->sent;
+            send_len += iov[count++].iov_len;
+        }
+
+        const size_t body_sent = itr->sent > itr->headerSize ? itr->sent - itr->headerSize : 0;
+        if (itr->packet->size() > body_sent)
+        {
+            iov[count].iov_base = (char*) itr->packet->contents() + body_sent;
+            iov[count].iov_len = itr->packet->size() - body_sent;
+            send_len += iov[count++].iov_len;
+        }
+    }
+
+    // data buffered after the last shared packet
+    if (itr == m_SharedSegments.end() && m_OutBuffer->wr_ptr() > base + pos && count < MAX_OUTPUT_IOV)
+    {
+        iov[count].iov_base = base + pos;
+        iov[count].iov_len = m_OutBuffer->wr_ptr() - (base + pos);
+        send_len += iov[count++].iov_len;
+    }
+
+#ifdef MSG_NOSIGNAL
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    return ACE_OS::sendmsg(get_handle(), &msg, MSG_NOSIGNAL);
+#else
+    return peer().sendv(iov, count);
+#endif // MSG_NOSIGNAL
+}
+
+template <typename SessionType, typename SocketName, typename Crypt>
+void MangosSocket<SessionType, SocketName, Crypt>::iConsumeOutput(size_t len)
+{
+    char* base = m_OutBuffer->base();
+    size_t pos = m_OutBuffer->rd_ptr() - base;
+
+    while (len > 0 && !m_SharedSegments.empty())
+    {
+        SharedSegment& segment = m_SharedSegments.front();
+        if (segment.bufferPos > pos)
+        {
+            const size_t buffered = std::min(len, segment.bufferPos - pos);
+            pos += buffered;
+            len -= buffered;
+            continue;
+        }
+
+        const size_t sent = std::min(len, segment.size() - segment.sent);
+        segment.sent += sent;
+        len -= sent;
+        if (segment.sent == segment.size())
+            m_SharedSegments.pop_front();
+    }
+
+    m_OutBuffer->rd_ptr(base + pos + len);
+}
+
 template <typename SessionType, typename SocketName, typename Crypt>
 bool MangosSocket<SessionType, SocketName, Crypt>::iFlushPacketQueue()
 {
-    WorldPacket *pct;
+    QueuedPacket queued;
     bool haveone = false;
 
-    while (m_PacketQueue.dequeue_head(pct) == 0)
+    while (m_PacketQueue.dequeue_head(queued) == 0)
     {
-        if (((SocketName*)this)->iSendPacket(*pct) == -1)
+        if (queued.shared)
+        {
+            iSendSharedPacket(queued.shared);
+            haveone = true;
+            continue;
+        }
+
+        ((SocketName*)this)->PrepareQueuedPacket(*queued.packet);
+
+        if (((SocketName*)this)->iSendPacket(*queued.packet) == -1)
         {
-            if (m_PacketQueue.enqueue_head(pct) == -1)
+            if (m_PacketQueue.enqueue_head(queued) == -1)
             {
-                delete pct;
+                delete queued.packet;
                 sLog.outError("MangosSocket<SessionType, SocketName, Crypt>::iFlushPacketQueue m_PacketQueue->enqueue_head");
                 return false;
             }
@@ -533,7 +724,7 @@ bool MangosSocket<SessionType, SocketName, Crypt>::iFlushPacketQueue()
         else
         {
             haveone = true;
-            delete pct;
+            delete queued.packet;
         }
     }
 
@@ -20,6 +20,7 @@
 #include "Common.h"
 #include "Config/Config.h"
 #include "Database/DatabaseEnv.h"
+#include "TickProfiler.h"
 
 /**
 * This is a helper class to WorldSocketMgr ,that manages
@@ -150,6 +151,7 @@ protected:
 
             AddNewSockets();
 
+            TickPhaseTimer flushTimer(sTickProfiler.GetWorldProfile(), TICK_PHASE_NETWORK_FLUSH, true);
             for (i = m_Sockets.begin(); i != m_Sockets.end();)
             {
                 if ((*i)->Update() == -1)
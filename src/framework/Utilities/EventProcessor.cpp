@@ -20,6 +20,7 @@
 
 #include "EventProcessor.h"
 #include "Log.h" // Zerix: For MANGOS_ASSERT. No idea.
+#include <algorithm>
 
 void BasicEvent::ScheduleAbort()
 {
@@ -46,12 +47,12 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.front().execTime <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* event = i->second;
-        m_events.erase(i);
+        BasicEvent* event = m_events.front().event;
+        std::pop_heap(m_events.begin(), m_events.end());
+        m_events.pop_back();
 
         if (event->IsRunning())
         {
@@ -84,33 +85,39 @@ void EventProcessor::Update(uint32 p_time)
 
 void EventProcessor::KillAllEvents(bool force)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end();)
+    // Abort handlers may add events: work on the current ones only
+    std::vector<ScheduledEvent> events;
+    events.swap(m_events);
+
+    for (auto itr = events.begin(); itr != events.end(); ++itr)
     {
+        BasicEvent* event = itr->event;
+
         // Abort events which weren't aborted already
-        if (!itr->second->IsAborted())
+        if (!event->IsAborted())
         {
-            itr->second->SetAborted();
-            itr->second->Abort(m_time);
+            event->SetAborted();
+            event->Abort(m_time);
         }
 
-        // Skip non-deletable events when we are
+        // Keep non-deletable events when we are
         // not forcing the event cancellation.
-        if (!force && !itr->second->IsDeletable())
+        if (!force && !event->IsDeletable())
         {
-            ++itr;
+            m_events.push_back(*itr);
+            std::push_heap(m_events.begin(), m_events.end());
             continue;
         }
 
-        delete itr->second;
-
-        if (force)
-            ++itr; // Clear the whole container when forcing
-        else
-            itr = m_events.erase(itr);
+        delete event;
     }
 
-    if (force)
-        m_events.clear();
+    // Reuse the heap storage when no event was kept or added
+    if (m_events.empty())
+    {
+        events.clear();
+        m_events.swap(events);
+    }
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -118,7 +125,9 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     if (set_addtime)
         Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    ScheduledEvent scheduled = { e_time, m_eventSequence++, Event };
+    m_events.push_back(scheduled);
+    std::push_heap(m_events.begin(), m_events.end());
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
@@ -22,7 +22,7 @@
 #define __EVENTPROCESSOR_H
 
 #include "Platform/Define.h"
-#include <map>
+#include <vector>
 
 class EventProcessor;
 
@@ -87,12 +87,10 @@ private:
     T _callback;
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
-
 class EventProcessor
 {
     public:
-        EventProcessor() : m_time(0) { }
+        EventProcessor() : m_time(0), m_eventSequence(0) { }
         ~EventProcessor();
 
         void Update(uint32 p_time);
@@ -109,11 +107,37 @@ class EventProcessor
 
         // Zerix: Nostalrius compatibility. Figure a better way to handle this.
         bool HasScheduledEvent() const { return m_events.empty() ? false : true; }
-        EventList const& GetEvents() const { return m_events; }
+
+        // Calls visitor(BasicEvent*) for each scheduled event, in no particular order
+        template<typename F>
+        void VisitEvents(F visitor) const
+        {
+            for (size_t i = 0; i < m_events.size(); ++i)
+                visitor(m_events[i].event);
+        }
 
     protected:
         uint64 m_time;
-        EventList m_events;
+
+    private:
+        // Events are kept in a binary heap ordered by execution time, then by the order they
+        // were added. The heap storage is kept between updates: adding an event does not
+        // allocate once the processor has held as many events.
+        struct ScheduledEvent
+        {
+            uint64 execTime;
+            uint64 sequence;
+            BasicEvent* event;
+
+            // std heap functions keep the greatest element first
+            bool operator<(ScheduledEvent const& other) const
+            {
+                return execTime != other.execTime ? execTime > other.execTime : sequence > other.sequence;
+            }
+        };
+
+        std::vector<ScheduledEvent> m_events;
+        uint64 m_eventSequence;
 };
 
 #endif
\ No newline at end of file
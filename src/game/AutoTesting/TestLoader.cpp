@@ -16,6 +16,14 @@ void AddTest_controls();
 void AddTest_channeling();
 void AddTest_auras_stack();
 void AddTest_packet_broadcaster();
+void AddTest_values_update();
+void AddTest_grid_search();
+void AddTest_procs();
+void AddTest_threat();
+void AddTest_event_processor();
+void AddTest_aura_storage();
+void AddTest_log_writer();
+void AddTest_player_save();
 
 void LoadTests()
 {
@@ -30,4 +38,12 @@ void LoadTests()
     AddTest_auras_stack();
     AddTest_cinematics();
     AddTest_packet_broadcaster();
+    AddTest_values_update();
+    AddTest_grid_search();
+    AddTest_procs();
+    AddTest_threat();
+    AddTest_event_processor();
+    AddTest_aura_storage();
+    AddTest_log_writer();
+    AddTest_player_save();
 }
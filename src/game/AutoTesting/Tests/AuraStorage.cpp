@@ -0,0 +1,253 @@
+/*
+* AuraStorage.cpp
+*
+*/
+#include "TestPCH.h"
+#include "TestSpells.h"
+#include "FlatAuraList.h"
+
+// Counts the allocations of the containers using it
+template <class T>
+struct CountingAllocator
+{
+    typedef T value_type;
+
+    explicit CountingAllocator(uint32& counter) : count(&counter) {}
+    template <class U> CountingAllocator(CountingAllocator<U> const& other) : count(other.count) {}
+
+    T* allocate(size_t n) { ++*count; return std::allocator<T>().allocate(n); }
+    void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    template <class U> bool operator==(CountingAllocator<U> const& other) const { return count == other.count; }
+    template <class U> bool operator!=(CountingAllocator<U> const& other) const { return count != other.count; }
+
+    uint32* count;
+};
+
+// Buffs applied and removed again at each update of a player. Each aura must be
+// in the list of its type exactly once, the lists must be back to the same auras in
+// the same order after the removals, and must not grow anymore once the removed
+// auras have been compacted.
+// The same additions and removals are replayed on a std::list per type, the previous
+// storage, and on a vector per type: the allocations of both are reported.
+class aura_storage_flat_lists : public SingleTest
+{
+public:
+    typedef std::list<Aura*, CountingAllocator<Aura*> > CountedList;
+    typedef std::vector<Aura*, CountingAllocator<Aura*> > CountedVector;
+
+    aura_storage_flat_lists(const char* name) : SingleTest(name), m_round(0), m_applied(0), m_listAllocations(0), m_vectorAllocations(0),
+        m_oldLists(TOTAL_AURAS, CountedList(CountingAllocator<Aura*>(m_listAllocations))),
+        m_flatLists(TOTAL_AURAS, CountedVector(CountingAllocator<Aura*>(m_vectorAllocations)))
+    {
+    }
+
+    static const int NUM_ROUNDS = 5;
+
+    // Removed slots are skipped, the other auras keep their order and the iterators
+    // on them stay valid until compact()
+    void CheckFlatList()
+    {
+        // Never dereferenced by the list
+        char storage[4];
+        Aura* auras[4];
+        for (int i = 0; i < 4; ++i)
+            auras[i] = reinterpret_cast<Aura*>(&storage[i]);
+
+        FlatAuraList list;
+        for (int i = 0; i < 4; ++i)
+            list.push_back(auras[i]);
+        FlatAuraList::const_iterator third = std::find(list.begin(), list.end(), auras[2]);
+
+        TEST_ASSERT(list.remove(auras[0]));
+        TEST_ASSERT(list.remove(auras[1]));
+        TEST_ASSERT(!list.remove(auras[1]));
+        TEST_ASSERT(list.size() == 2);
+        TEST_ASSERT(list.removedCount() == 2);
+        TEST_ASSERT(*third == auras[2]);
+        TEST_ASSERT(list.front() == auras[2]);
+        TEST_ASSERT(list.back() == auras[3]);
+        TEST_ASSERT(std::distance(list.begin(), list.end()) == 2);
+        TEST_ASSERT(*list.rbegin() == auras[3]);
+
+        list.push_back(auras[0]);
+        size_t capacity = list.capacity();
+        list.compact();
+        TEST_ASSERT(list.removedCount() == 0);
+        TEST_ASSERT(list.capacity() == capacity);
+        std::vector<Aura*> compacted(list.begin(), list.end());
+        std::vector<Aura*> expected = { auras[2], auras[3], auras[0] };
+        TEST_ASSERT(compacted == expected);
+
+        list.erase(list.begin());
+        TEST_ASSERT(list.front() == auras[3]);
+        list.erase(list.begin());
+        list.erase(list.begin());
+        TEST_ASSERT(list.empty());
+        TEST_ASSERT(list.begin() == list.end());
+    }
+
+    // Checks the lists against the auras of the holders, returns the count of auras
+    uint32 CheckLists(Player* player)
+    {
+        uint32 auras = 0;
+        Unit::SpellAuraHolderMap const& holders = player->GetSpellAuraHolderMap();
+        for (Unit::SpellAuraHolderMap::const_iterator itr = holders.begin(); itr != holders.end(); ++itr)
+        {
+            for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
+            {
+                Aura* aura = itr->second->GetAuraByEffectIndex(SpellEffectIndex(i));
+                if (!aura || aura->GetModifier()->m_auraname >= TOTAL_AURAS)
+                    continue;
+                Unit::AuraList const& list = player->GetAurasByType(AuraType(aura->GetModifier()->m_auraname));
+                if (std::count(list.begin(), list.end(), aura) != 1)
+                    Fail("Aura %u of spell %u not in the list of its type", aura->GetModifier()->m_auraname, aura->GetId());
+                ++auras;
+            }
+        }
+
+        uint32 listed = 0;
+        for (uint32 type = 0; type < TOTAL_AURAS; ++type)
+            listed += player->GetAurasByType(AuraType(type)).size();
+        if (listed != auras)
+            Fail("%u auras in the lists for %u auras of the holders", listed, auras);
+        return auras;
+    }
+
+    void GetCapacities(Player* player, std::vector<size_t>& capacities)
+    {
+        capacities.resize(TOTAL_AURAS);
+        for (uint32 type = 0; type < TOTAL_AURAS; ++type)
+            capacities[type] = player->GetAurasByType(AuraType(type)).capacity();
+    }
+
+    void GetLists(Player* player, std::vector<std::vector<Aura*> >& lists)
+    {
+        lists.resize(TOTAL_AURAS);
+        for (uint32 type = 0; type < TOTAL_AURAS; ++type)
+        {
+            Unit::AuraList const& list = player->GetAurasByType(AuraType(type));
+            lists[type].assign(list.begin(), list.end());
+        }
+    }
+
+    // One round of additions and removals, per aura type
+    void CountAllocations(std::vector<std::vector<Aura*> > const& before, std::vector<std::vector<Aura*> > const& applied)
+    {
+        // Auras the player already had, not counted
+        if (!m_round)
+        {
+            for (uint32 type = 0; type < TOTAL_AURAS; ++type)
+            {
+                m_oldLists[type].assign(before[type].begin(), before[type].end());
+                m_flatLists[type].assign(before[type].begin(), before[type].end());
+            }
+            m_listAllocations = 0;
+            m_vectorAllocations = 0;
+        }
+
+        for (uint32 type = 0; type < TOTAL_AURAS; ++type)
+        {
+            CountedList& oldList = m_oldLists[type];
+            CountedVector& flatList = m_flatLists[type];
+            size_t added = applied[type].size() - before[type].size();
+            for (size_t i = before[type].size(); i < applied[type].size(); ++i)
+            {
+                oldList.push_back(applied[type][i]);
+                flatList.push_back(applied[type][i]);
+            }
+            // FlatAuraList::compact() erases, which keeps the capacity
+            for (size_t i = 0; i < added; ++i)
+                oldList.pop_back();
+            flatList.resize(flatList.size() - added);
+            m_applied += added;
+        }
+    }
+
+    void Test() override
+    {
+        switch (GetTestStep())
+        {
+            case 0:
+                CheckFlatList();
+                if (Failed())
+                    return;
+                SpawnPlayer(0, CLASS_WARRIOR, RACE_HUMAN);
+                WaitPlayerSummon();
+                break;
+            case 1:
+                if (!GetTestPlayer(0, TESTPLAYER_MAXLEVEL))
+                    return;
+                Wait(1000);
+                break;
+            case 2:
+            {
+                Player* player = GetTestPlayer(0);
+                if (!player)
+                    return;
+
+                // Compacted at the previous update
+                std::vector<size_t> capacitiesBefore;
+                GetCapacities(player, capacitiesBefore);
+                std::vector<std::vector<Aura*> > listsBefore;
+                GetLists(player, listsBefore);
+                uint32 aurasBefore = CheckLists(player);
+
+                for (uint32 i = 0; i < sizeof(s_buffSpells) / sizeof(s_buffSpells[0]); ++i)
+                    player->AddAura(s_buffSpells[i]);
+                TEST_ASSERT(CheckLists(player) > aurasBefore);
+                std::vector<std::vector<Aura*> > listsApplied;
+                GetLists(player, listsApplied);
+
+                for (uint32 i = 0; i < sizeof(s_buffSpells) / sizeof(s_buffSpells[0]); ++i)
+                    player->RemoveAurasDueToSpell(s_buffSpells[i]);
+                TEST_ASSERT(CheckLists(player) == aurasBefore);
+
+                // Removed slots skipped before being compacted
+                std::vector<std::vector<Aura*> > listsAfter;
+                GetLists(player, listsAfter);
+                TEST_ASSERT(listsAfter == listsBefore);
+                if (Failed())
+                    return;
+
+                // Grown at the first round, then the slots are reused
+                std::vector<size_t> capacitiesAfter;
+                GetCapacities(player, capacitiesAfter);
+                if (m_round > 0)
+                    for (uint32 type = 0; type < TOTAL_AURAS; ++type)
+                        if (capacitiesAfter[type] != capacitiesBefore[type])
+                            Fail("List of aura %u reallocated at round %u", type, m_round);
+                if (Failed())
+                    return;
+
+                CountAllocations(listsBefore, listsApplied);
+                if (++m_round < NUM_ROUNDS)
+                {
+                    Wait(2 * UNIT_SPELL_UPDATE_TIME_BUFFER);
+                    return;
+                }
+
+                sLog.outString("[%s] %u auras applied and removed in %u rounds: %u allocations with a std::list per type, %u with flat lists",
+                    GetName().c_str(), m_applied, uint32(NUM_ROUNDS), m_listAllocations, m_vectorAllocations);
+                TEST_ASSERT(m_vectorAllocations < m_listAllocations);
+                if (!Failed())
+                    Finish();
+                break;
+            }
+        }
+        NextStep();
+    }
+
+private:
+    uint32 m_round;
+    uint32 m_applied;
+    uint32 m_listAllocations;
+    uint32 m_vectorAllocations;
+    std::vector<CountedList> m_oldLists;
+    std::vector<CountedVector> m_flatLists;
+};
+
+void AddTest_aura_storage()
+{
+    sAutoTestingMgr->AddTest(new aura_storage_flat_lists("aura_storage_flat_lists"));
+}
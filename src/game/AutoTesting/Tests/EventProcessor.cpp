@@ -0,0 +1,102 @@
+/*
+* EventProcessor.cpp
+*
+*/
+#include "TestPCH.h"
+#include "Utilities/EventProcessor.h"
+
+// Records its id when executed or aborted. Like SpellEvent, executed again after
+// 'rescheduleDelay' instead of being deleted when it is not 0.
+class RecordedEvent : public BasicEvent
+{
+public:
+    RecordedEvent(EventProcessor& processor, std::vector<uint32>& executed, uint32 id, uint32 rescheduleDelay = 0)
+        : m_processor(processor), m_executed(executed), m_id(id), m_rescheduleDelay(rescheduleDelay) {}
+
+    bool Execute(uint64 e_time, uint32 /*p_time*/) override
+    {
+        m_executed.push_back(m_id);
+        if (!m_rescheduleDelay)
+            return true;
+        m_processor.AddEvent(this, e_time + m_rescheduleDelay);
+        m_rescheduleDelay = 0;
+        return false;
+    }
+
+    void Abort(uint64 /*e_time*/) override { m_executed.push_back(m_id + ABORTED); }
+
+    enum { ABORTED = 1000 };
+
+private:
+    EventProcessor& m_processor;
+    std::vector<uint32>& m_executed;
+    uint32 m_id;
+    uint32 m_rescheduleDelay;
+};
+
+// The heap of EventProcessor executes the events by time, then in the order they were
+// added, only once due, and keeps rescheduled and aborted events consistent.
+class event_processor_heap : public SingleTest
+{
+public:
+    event_processor_heap(const char* name) : SingleTest(name)
+    {
+    }
+
+    void Test() override
+    {
+        EventProcessor processor;
+        std::vector<uint32> executed;
+
+        // Added out of order, 3 and 4 due at the same time
+        processor.AddEvent(new RecordedEvent(processor, executed, 1), processor.CalculateTime(300));
+        processor.AddEvent(new RecordedEvent(processor, executed, 2), processor.CalculateTime(100));
+        processor.AddEvent(new RecordedEvent(processor, executed, 3), processor.CalculateTime(200));
+        processor.AddEvent(new RecordedEvent(processor, executed, 4), processor.CalculateTime(200));
+        processor.AddEvent(new RecordedEvent(processor, executed, 5, 100), processor.CalculateTime(50));
+
+        processor.Update(40);
+        TEST_ASSERT(executed.empty());
+
+        processor.Update(160);
+        std::vector<uint32> expected = { 5, 2, 3, 4 };
+        TEST_ASSERT(executed == expected);
+        TEST_ASSERT(processor.HasScheduledEvent());
+
+        // 5 was rescheduled at 300 (update time + 100), after 1 that was added before
+        executed.clear();
+        processor.Update(100);
+        expected = { 1, 5 };
+        TEST_ASSERT(executed == expected);
+        TEST_ASSERT(!processor.HasScheduledEvent());
+
+        // An aborted event is not executed
+        executed.clear();
+        RecordedEvent* aborted = new RecordedEvent(processor, executed, 6);
+        processor.AddEvent(aborted, processor.CalculateTime(100));
+        processor.AddEvent(new RecordedEvent(processor, executed, 7), processor.CalculateTime(100));
+        aborted->ScheduleAbort();
+        processor.Update(100);
+        expected = { 6 + RecordedEvent::ABORTED, 7 };
+        TEST_ASSERT(executed == expected);
+
+        // Events still scheduled are aborted and deleted with the processor
+        executed.clear();
+        processor.AddEvent(new RecordedEvent(processor, executed, 8), processor.CalculateTime(1000));
+        uint32 visited = 0;
+        processor.VisitEvents([&visited](BasicEvent*) { ++visited; });
+        TEST_ASSERT(visited == 1);
+        processor.KillAllEvents(true);
+        TEST_ASSERT(!processor.HasScheduledEvent());
+        expected = { 8 + RecordedEvent::ABORTED };
+        TEST_ASSERT(executed == expected);
+
+        if (!Failed())
+            Finish();
+    }
+};
+
+void AddTest_event_processor()
+{
+    sAutoTestingMgr->AddTest(new event_processor_heap("event_processor_heap"));
+}
@@ -0,0 +1,217 @@
+/*
+* GridSearch.cpp
+*
+*/
+#include "TestPCH.h"
+#include "GridNotifiers.h"
+#include "GridNotifiersImpl.h"
+#include "CellImpl.h"
+#include <chrono>
+
+// Same check without GetSearchRange(): the searchers walk the object lists of the cells
+class UnpackedUnitInObjectRangeCheck
+{
+public:
+    UnpackedUnitInObjectRangeCheck(MaNGOS::AnyUnitInObjectRangeCheck& check) : i_check(check) {}
+    WorldObject const& GetFocusObject() const { return i_check.GetFocusObject(); }
+    bool operator()(Unit* u) { return i_check(u); }
+private:
+    MaNGOS::AnyUnitInObjectRangeCheck& i_check;
+};
+
+// 10 yard searches around a player, with the packed cell positions: same units as walking
+// the lists, and the packed entries follow moves, bounding radius changes and removals.
+class grid_search_packed : public SingleTest
+{
+public:
+    grid_search_packed(const char* name) : SingleTest(name, MAP_TESTING_ID, false)
+    {
+    }
+
+    enum
+    {
+        NUM_CREATURES       = 8,                            // one every 3 yards east of the player
+        FIRST_CREATURE      = 1,
+        REMOVED_CREATURE    = 1,                            // index in creatures[], despawned at the first search step
+    };
+
+    static float OffsetX(uint32 i) { return 3.0f * (i + 1); }
+
+    // Units found by the packed search, checked against the search walking the lists
+    bool Search(Player* focus, std::list<Unit*>& targets)
+    {
+        MaNGOS::AnyUnitInObjectRangeCheck check(focus, 10.0f);
+        MaNGOS::UnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(targets, check);
+        Cell::VisitAllObjects(focus, searcher, 10.0f);
+
+        UnpackedUnitInObjectRangeCheck unpackedCheck(check);
+        std::list<Unit*> unpacked;
+        MaNGOS::UnitListSearcher<UnpackedUnitInObjectRangeCheck> unpackedSearcher(unpacked, unpackedCheck);
+        Cell::VisitAllObjects(focus, unpackedSearcher, 10.0f);
+
+        std::list<Unit*> packed = targets;
+        packed.sort();
+        unpacked.sort();
+        return packed == unpacked;
+    }
+
+    static bool Contains(std::list<Unit*> const& targets, Unit* unit)
+    {
+        return std::find(targets.begin(), targets.end(), unit) != targets.end();
+    }
+
+    void Test() override
+    {
+        if (GetTestStep() == 0)
+        {
+            SpawnPlayer(0, CLASS_WARRIOR, RACE_HUMAN);
+            for (uint32 i = 0; i < NUM_CREATURES; ++i)
+                SpawnCreature(FIRST_CREATURE + i, 1, OffsetX(i), 0);
+            Wait(5000);
+            NextStep();
+            return;
+        }
+
+        Player* player = GetTestPlayer(0);
+        TEST_ASSERT(player);
+        Creature* creatures[NUM_CREATURES];
+        for (uint32 i = 0; i < NUM_CREATURES; ++i)
+            creatures[i] = i == REMOVED_CREATURE && GetTestStep() > 1 ? NULL : GetTestCreature(FIRST_CREATURE + i);
+        if (Failed())
+            return;
+
+        std::list<Unit*> targets;
+        if (GetTestStep() == 1)
+        {
+            TEST_ASSERT(Search(player, targets));
+            TEST_ASSERT(Contains(targets, player));
+            TEST_ASSERT(Contains(targets, creatures[0]));       // 3 yards
+            TEST_ASSERT(Contains(targets, creatures[2]));       // 9 yards
+            TEST_ASSERT(!Contains(targets, creatures[4]));      // 15 yards
+            TEST_ASSERT(!Contains(targets, creatures[7]));      // 24 yards
+
+            // Written directly, not through Relocate or UpdateModelData
+            creatures[4]->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, 10.0f);
+            targets.clear();
+            TEST_ASSERT(Search(player, targets));
+            TEST_ASSERT(Contains(targets, creatures[4]));
+
+            // Moved next to the player
+            creatures[7]->NearTeleportTo(player->GetPositionX() + 1.0f, player->GetPositionY(), player->GetPositionZ(), 0.0f);
+            targets.clear();
+            TEST_ASSERT(Search(player, targets));
+            TEST_ASSERT(Contains(targets, creatures[7]));
+
+            // Removed from the middle of the packed entries, the last one takes its place
+            _removedGuid = creatures[REMOVED_CREATURE]->GetObjectGuid();
+            creatures[REMOVED_CREATURE]->DespawnOrUnsummon();
+            Wait(1000);
+            NextStep();
+            return;
+        }
+
+        TEST_ASSERT(!GetMap()->GetCreature(_removedGuid));
+        TEST_ASSERT(Search(player, targets));
+        TEST_ASSERT(Contains(targets, creatures[0]));
+        TEST_ASSERT(Contains(targets, creatures[2]));
+        TEST_ASSERT(Contains(targets, creatures[4]));
+        TEST_ASSERT(Contains(targets, creatures[7]));
+        TEST_ASSERT(!Contains(targets, creatures[5]));
+
+        if (!Failed())
+            Finish();
+    }
+
+protected:
+    ObjectGuid _removedGuid;
+};
+
+// Range searches around each unit of a dense crowd (city), with and without the packed
+// cell positions: reports the time spent by each. Timings are not asserted.
+class grid_search_dense_benchmark : public SingleTest
+{
+public:
+    grid_search_dense_benchmark(const char* name) : SingleTest(name, MAP_TESTING_ID, false)
+    {
+    }
+
+    static const int NUM_PLAYERS_PER_TICK = 50;
+    static const int NUM_SPAWN_TICKS = 4;
+    static const int NUM_UNITS = NUM_PLAYERS_PER_TICK * NUM_SPAWN_TICKS;
+    static const int NUM_ROUNDS = 20;
+
+    // 20 x 10 units spread over 50 x 50 yards
+    static float OffsetX(int i) { return (i % 20) * 2.5f - 25.0f; }
+    static float OffsetY(int i) { return (i / 20) * 5.0f - 25.0f; }
+
+    template<class Check>
+    uint64 Search(Unit* focus, Check& check, std::list<Unit*>& targets)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        MaNGOS::UnitListSearcher<Check> searcher(targets, check);
+        Cell::VisitAllObjects(focus, searcher, 10.0f);
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Test() override
+    {
+        // Spawn players, and as many creatures between them
+        if (GetTestStep() < NUM_SPAWN_TICKS)
+        {
+            for (int i = 0; i < NUM_PLAYERS_PER_TICK; ++i)
+            {
+                int index = GetTestStep() * NUM_PLAYERS_PER_TICK + i;
+                SpawnPlayer(index, CLASS_WARRIOR, RACE_HUMAN, OffsetX(index), OffsetY(index));
+                SpawnCreature(NUM_UNITS + index, 1, OffsetX(index) + 1.25f, OffsetY(index) + 2.5f);
+            }
+            NextStep();
+            return;
+        }
+
+        if (GetTestStep() == NUM_SPAWN_TICKS)
+        {
+            Wait(5000);
+            NextStep();
+            return;
+        }
+
+        unsigned long long packedTime = 0;
+        unsigned long long unpackedTime = 0;
+        unsigned long long found = 0;
+        for (int round = 0; round < NUM_ROUNDS; ++round)
+        {
+            for (int i = 0; i < 2 * NUM_UNITS; ++i)
+            {
+                Unit* focus = GetTestUnit(i);
+                if (!focus)
+                    return;
+
+                MaNGOS::AnyUnitInObjectRangeCheck check(focus, 10.0f);
+                UnpackedUnitInObjectRangeCheck unpackedCheck(check);
+                std::list<Unit*> packed;
+                std::list<Unit*> unpacked;
+                packedTime += Search(focus, check, packed);
+                unpackedTime += Search(focus, unpackedCheck, unpacked);
+
+                packed.sort();
+                unpacked.sort();
+                if (packed != unpacked)
+                {
+                    Fail("Packed search around unit %i found %u units instead of %u", i, uint32(packed.size()), uint32(unpacked.size()));
+                    return;
+                }
+                found += packed.size();
+            }
+        }
+
+        sLog.outString("[%s] %u searches (%llu units found): %llu us with packed positions, %llu us walking the lists",
+            GetName().c_str(), uint32(NUM_ROUNDS * 2 * NUM_UNITS), found, packedTime, unpackedTime);
+        Finish();
+    }
+};
+
+void AddTest_grid_search()
+{
+    sAutoTestingMgr->AddTest(new grid_search_packed("grid_search_packed"));
+    sAutoTestingMgr->AddTest(new grid_search_dense_benchmark("grid_search_dense_benchmark"));
+}
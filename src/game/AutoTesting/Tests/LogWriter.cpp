@@ -0,0 +1,256 @@
+/*
+* LogWriter.cpp
+*
+*/
+#include "TestPCH.h"
+#include "LogWriter.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "ace/OS_NS_time.h"
+
+// Map threads logging at the same time to a LogWriter with small rings, so that they
+// wait for the writer: every line is written, the lines of each thread in the order
+// they were logged, and no line is lost when the file is rotated between two batches.
+class log_writer_contention : public SingleTest
+{
+public:
+    log_writer_contention(const char* name) : SingleTest(name)
+    {
+    }
+
+    static const int NUM_THREADS = 8;
+    static const int NUM_LINES = 2000;
+    static const int QUEUE_SIZE = 16;
+    static const int ROTATE_SIZE = 16 * 1024;
+
+    static void QueueLine(LogWriter& writer, FILE* file, char const* format, ...)
+    {
+        va_list ap;
+        va_start(ap, format);
+        writer.Queue(LOG_ENTRY_NO_TIMESTAMP, 0, file, "Test: ", format, ap);
+        va_end(ap);
+    }
+
+    static void Run(LogWriter& writer, FILE* file)
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; ++t)
+            threads.emplace_back([t, &writer, file]()
+            {
+                for (int i = 0; i < NUM_LINES; ++i)
+                    QueueLine(writer, file, "Thread %u line %u", t, i);
+            });
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    static void ReadLines(FILE* file, std::vector<std::string>& lines)
+    {
+        rewind(file);
+        char buffer[128];
+        while (fgets(buffer, sizeof(buffer), file))
+            lines.push_back(buffer);
+    }
+
+    // Every line of each thread once, in order
+    bool CheckLines(std::vector<std::string> const& lines)
+    {
+        std::vector<int> next(NUM_THREADS, 0);
+        for (std::string const& line : lines)
+        {
+            int thread, index;
+            if (sscanf(line.c_str(), "Test: Thread %d line %d\n", &thread, &index) != 2 || thread < 0 || thread >= NUM_THREADS)
+            {
+                Fail("Unexpected line '%s'", line.c_str());
+                return false;
+            }
+            if (index != next[thread])
+            {
+                Fail("Line %d of thread %d written after line %d", index, thread, next[thread] - 1);
+                return false;
+            }
+            ++next[thread];
+        }
+        for (int t = 0; t < NUM_THREADS; ++t)
+            if (next[t] != NUM_LINES)
+            {
+                Fail("%d lines of thread %d written", next[t], t);
+                return false;
+            }
+        return true;
+    }
+
+    // Log_YYYY-MM-DD_HH-MM-SS.log, then _2, _3... when rotated again in the same second
+    static void ReadRotatedFiles(std::string const& path, time_t start, time_t end, std::vector<std::string>& lines, uint32& rotations)
+    {
+        for (time_t second = start; second <= end; ++second)
+        {
+            tm aTm;
+            ACE_OS::localtime_r(&second, &aTm);
+            char suffix[24];
+            snprintf(suffix, sizeof(suffix), "_%04d-%02d-%02d_%02d-%02d-%02d", aTm.tm_year + 1900, aTm.tm_mon + 1, aTm.tm_mday, aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+            for (uint32 count = 1; ; ++count)
+            {
+                std::string rotatedPath = path;
+                rotatedPath.insert(path.find_last_of('.'), count > 1 ? suffix + std::string("_") + std::to_string(count) : std::string(suffix));
+                FILE* rotated = fopen(rotatedPath.c_str(), "r");
+                if (!rotated)
+                    break;
+                ReadLines(rotated, lines);
+                fclose(rotated);
+                remove(rotatedPath.c_str());
+                ++rotations;
+            }
+        }
+    }
+
+    void Test() override
+    {
+        FILE* file = tmpfile();
+        TEST_ASSERT(file);
+        if (Failed())
+            return;
+
+        {
+            LogWriter writer(QUEUE_SIZE);
+            writer.Start();
+            Run(writer, file);
+            writer.Flush();
+            TEST_ASSERT(writer.GetWrittenLines() == uint64(NUM_THREADS * NUM_LINES));
+            writer.Stop();
+        }
+        std::vector<std::string> lines;
+        ReadLines(file, lines);
+        fclose(file);
+        TEST_ASSERT(CheckLines(lines));
+        if (Failed())
+            return;
+
+        std::string const path = "log_writer_contention.log";
+        file = fopen(path.c_str(), "w+");
+        TEST_ASSERT(file);
+        if (Failed())
+            return;
+
+        time_t start = time(nullptr);
+        {
+            LogWriter writer(QUEUE_SIZE, ROTATE_SIZE);
+            writer.AddRotatedFile(file, path);
+            writer.Start();
+            Run(writer, file);
+            writer.Stop();
+        }
+        time_t end = time(nullptr);
+
+        // Reopened for appending at each rotation
+        fclose(file);
+        lines.clear();
+        uint32 rotations = 0;
+        ReadRotatedFiles(path, start, end, lines, rotations);
+        file = fopen(path.c_str(), "r");
+        TEST_ASSERT(file);
+        if (file)
+        {
+            ReadLines(file, lines);
+            fclose(file);
+        }
+        remove(path.c_str());
+        TEST_ASSERT(rotations > 0);
+        TEST_ASSERT(CheckLines(lines));
+
+        if (!Failed())
+            Finish();
+    }
+};
+
+// Map threads logging at the same time: reports the lines per second of the logging
+// threads when each line is written with fprintf and fflush under a lock, like Log
+// without LogAsync, and when it is queued to a LogWriter. Timings are not asserted.
+class log_writer_throughput_benchmark : public SingleTest
+{
+public:
+    log_writer_throughput_benchmark(const char* name) : SingleTest(name)
+    {
+    }
+
+    static const int NUM_THREADS = 8;
+    static const int NUM_LINES = 20000;
+
+    static void QueueLine(LogWriter& writer, FILE* file, char const* format, ...)
+    {
+        va_list ap;
+        va_start(ap, format);
+        writer.Queue(0, 0, file, nullptr, format, ap);
+        va_end(ap);
+    }
+
+    // Microseconds spent by the threads to log all their lines
+    template<class LogLine>
+    static uint64 Run(LogLine logLine)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; ++t)
+            threads.emplace_back([t, &logLine]()
+            {
+                for (int i = 0; i < NUM_LINES; ++i)
+                    logLine(t, i);
+            });
+        for (std::thread& thread : threads)
+            thread.join();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static uint64 LinesPerSecond(uint64 time) { return time ? uint64(NUM_THREADS) * NUM_LINES * 1000000 / time : 0; }
+
+    void Test() override
+    {
+        FILE* syncFile = tmpfile();
+        FILE* asyncFile = tmpfile();
+        TEST_ASSERT(syncFile && asyncFile);
+        if (Failed())
+        {
+            if (syncFile)
+                fclose(syncFile);
+            if (asyncFile)
+                fclose(asyncFile);
+            return;
+        }
+
+        std::mutex lock;
+        uint64 syncTime = Run([syncFile, &lock](int thread, int line)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            Log::outTimestamp(syncFile);
+            fprintf(syncFile, "Unit %u of thread %u moved to cell %u", thread * NUM_LINES + line, thread, line % 64);
+            fprintf(syncFile, "\n");
+            fflush(syncFile);
+        });
+
+        LogWriter writer(4096);
+        writer.Start();
+        uint64 asyncTime = Run([&writer, asyncFile](int thread, int line)
+        {
+            QueueLine(writer, asyncFile, "Unit %u of thread %u moved to cell %u", thread * NUM_LINES + line, thread, line % 64);
+        });
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        writer.Flush();
+        uint64 flushTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        writer.Stop();
+
+        sLog.outString("[%s] %u threads, %u lines each: " UI64FMTD " lines/s with fprintf and fflush, " UI64FMTD " lines/s queued with LogAsync (then " UI64FMTD " us until written, " UI64FMTD " waits on a full queue)",
+            GetName().c_str(), uint32(NUM_THREADS), uint32(NUM_LINES), LinesPerSecond(syncTime), LinesPerSecond(asyncTime), flushTime, writer.GetFullQueueWaits());
+
+        fclose(syncFile);
+        fclose(asyncFile);
+        Finish();
+    }
+};
+
+void AddTest_log_writer()
+{
+    sAutoTestingMgr->AddTest(new log_writer_contention("log_writer_contention"));
+    sAutoTestingMgr->AddTest(new log_writer_throughput_benchmark("log_writer_throughput_benchmark"));
+}
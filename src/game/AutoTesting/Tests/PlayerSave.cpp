@@ -0,0 +1,164 @@
+/*
+* PlayerSave.cpp
+*
+*/
+#include "TestPCH.h"
+
+// Incremental saves: a section is skipped only while its hash is the one last saved,
+// and direct writes of its columns force the next save to write it again.
+// SaveToDB of a clean player writes none of the sections, a dirty one writes its
+// changed sections only.
+class player_save_sections : public SingleTest
+{
+public:
+    player_save_sections(const char* name) : SingleTest(name, MAP_TESTING_ID, false)
+    {
+    }
+
+    enum
+    {
+        SAVE_FIRST,                                         // every section
+        SAVE_CLEAN,                                         // nothing changed
+        SAVE_MONEY,                                         // column of the characters row
+        SAVE_AURA,                                          // aura saved in character_aura
+        SAVE_GOLD_TO_DB,                                    // money written outside of SaveToDB
+        MAX_SAVES
+    };
+
+    // Sections written by one SaveToDB
+    void Save(Player* player, uint32 save)
+    {
+        uint32* written = _written[save];
+        for (uint32 i = 0; i < Player::MAX_SAVE_SECTIONS; ++i)
+            written[i] = player->GetSaveSectionWrites(Player::SaveSection(i));
+
+        // Bots are never saved
+        PlayerBotEntry* bot = player->GetSession()->GetBot();
+        player->GetSession()->SetBot(nullptr);
+        player->SaveToDB();
+        player->GetSession()->SetBot(bot);
+
+        for (uint32 i = 0; i < Player::MAX_SAVE_SECTIONS; ++i)
+            written[i] = player->GetSaveSectionWrites(Player::SaveSection(i)) - written[i];
+    }
+
+    // Nothing is asserted before the rows written by the saves are deleted
+    void SaveToDB(Player* player)
+    {
+        bool incrementalSave = sWorld.getConfig(CONFIG_BOOL_INCREMENTAL_PLAYER_SAVE);
+        uint32 fullSaveInterval = sWorld.getConfig(CONFIG_UINT32_PLAYER_SAVE_FULL_INTERVAL);
+        bool statsOnLogout = sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT);
+        sWorld.setConfig(CONFIG_BOOL_INCREMENTAL_PLAYER_SAVE, true);
+        sWorld.setConfig(CONFIG_UINT32_PLAYER_SAVE_FULL_INTERVAL, MAX_SAVES + 1);
+        sWorld.setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, false);
+
+        player->ResetSaveSections();
+        Save(player, SAVE_FIRST);
+        Save(player, SAVE_CLEAN);
+        player->ModifyMoney(100);
+        Save(player, SAVE_MONEY);
+        player->AddAura(1243);
+        Save(player, SAVE_AURA);
+        player->SaveGoldToDB();
+        Save(player, SAVE_GOLD_TO_DB);
+        player->RemoveAurasDueToSpell(1243);
+
+        sWorld.setConfig(CONFIG_BOOL_INCREMENTAL_PLAYER_SAVE, incrementalSave);
+        sWorld.setConfig(CONFIG_UINT32_PLAYER_SAVE_FULL_INTERVAL, fullSaveInterval);
+        sWorld.setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, statsOnLogout);
+    }
+
+    void Test() override
+    {
+        if (GetTestStep() == 0)
+        {
+            SpawnPlayer(0, CLASS_WARRIOR, RACE_HUMAN);
+            Wait(1000);
+            NextStep();
+            return;
+        }
+
+        Player* player = GetTestPlayer(0, 0);
+        TEST_ASSERT(player);
+        if (!player)
+            return;
+
+        if (GetTestStep() == 1)
+        {
+            player->ResetSaveSections();
+            TEST_ASSERT(player->IsSaveSectionChanged(Player::SAVE_SECTION_CHARACTER, 1234));
+            TEST_ASSERT(!player->IsSaveSectionChanged(Player::SAVE_SECTION_CHARACTER, 1234));
+            TEST_ASSERT(player->IsSaveSectionChanged(Player::SAVE_SECTION_CHARACTER, 5678));
+            TEST_ASSERT(player->IsSaveSectionChanged(Player::SAVE_SECTION_AURAS, 5678));
+
+            // Money written outside of SaveToDB
+            player->SaveGoldToDB();
+            TEST_ASSERT(player->IsSaveSectionChanged(Player::SAVE_SECTION_CHARACTER, 5678));
+            TEST_ASSERT(!player->IsSaveSectionChanged(Player::SAVE_SECTION_AURAS, 5678));
+
+            player->ResetSaveSections();
+            TEST_ASSERT(player->IsSaveSectionChanged(Player::SAVE_SECTION_AURAS, 5678));
+
+            // Same sum of (skill << 16) + value, different skills
+            std::unordered_map<uint16, uint16> skills1;
+            skills1[43] = 300;
+            skills1[44] = 5;
+            std::unordered_map<uint16, uint16> skills2;
+            skills2[43] = 5;
+            skills2[44] = 300;
+            TEST_ASSERT(Player::GetForgottenSkillsHash(skills1) != Player::GetForgottenSkillsHash(skills2));
+
+            std::unordered_map<uint16, uint16> skills3;
+            skills3[44] = 5;
+            skills3[43] = 300;
+            TEST_ASSERT(Player::GetForgottenSkillsHash(skills1) == Player::GetForgottenSkillsHash(skills3));
+
+            skills3[43] = 301;
+            TEST_ASSERT(Player::GetForgottenSkillsHash(skills1) != Player::GetForgottenSkillsHash(skills3));
+
+            SaveToDB(player);
+            // Async writes
+            Wait(5000);
+            NextStep();
+            return;
+        }
+
+        // The test character only exists in the database because of the saves above
+        Player::DeleteFromDB(player->GetObjectGuid(), 0, false, true);
+        sObjectMgr.InsertPlayerInCache(player);
+
+        TEST_ASSERT(_written[SAVE_FIRST][Player::SAVE_SECTION_CHARACTER] == 1);
+        TEST_ASSERT(_written[SAVE_FIRST][Player::SAVE_SECTION_AURAS] == 1);
+        TEST_ASSERT(_written[SAVE_FIRST][Player::SAVE_SECTION_COOLDOWNS] == 1);
+        TEST_ASSERT(_written[SAVE_FIRST][Player::SAVE_SECTION_STATS] == 1);
+#if SUPPORTED_CLIENT_BUILD > CLIENT_BUILD_1_10_2
+        TEST_ASSERT(_written[SAVE_FIRST][Player::SAVE_SECTION_FORGOTTEN_SKILLS] == 1);
+#endif
+
+        // No DELETE/INSERT of any section
+        for (uint32 i = 0; i < Player::MAX_SAVE_SECTIONS; ++i)
+            TEST_ASSERT(_written[SAVE_CLEAN][i] == 0);
+
+        TEST_ASSERT(_written[SAVE_MONEY][Player::SAVE_SECTION_CHARACTER] == 1);
+        TEST_ASSERT(_written[SAVE_MONEY][Player::SAVE_SECTION_AURAS] == 0);
+        TEST_ASSERT(_written[SAVE_MONEY][Player::SAVE_SECTION_COOLDOWNS] == 0);
+
+        TEST_ASSERT(_written[SAVE_AURA][Player::SAVE_SECTION_CHARACTER] == 0);
+        TEST_ASSERT(_written[SAVE_AURA][Player::SAVE_SECTION_AURAS] == 1);
+        TEST_ASSERT(_written[SAVE_AURA][Player::SAVE_SECTION_COOLDOWNS] == 0);
+
+        TEST_ASSERT(_written[SAVE_GOLD_TO_DB][Player::SAVE_SECTION_CHARACTER] == 1);
+        TEST_ASSERT(_written[SAVE_GOLD_TO_DB][Player::SAVE_SECTION_AURAS] == 0);
+
+        if (!Failed())
+            Finish();
+    }
+
+protected:
+    uint32 _written[MAX_SAVES][Player::MAX_SAVE_SECTIONS];
+};
+
+void AddTest_player_save()
+{
+    sAutoTestingMgr->AddTest(new player_save_sections("player_save_sections"));
+}
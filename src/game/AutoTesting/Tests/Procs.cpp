@@ -0,0 +1,164 @@
+/*
+* Procs.cpp
+*
+*/
+#include "TestPCH.h"
+#include "TestSpells.h"
+
+// Auras with proc flags, or handled in Unit::IsTriggeredAtSpellProcEvent
+static uint32 const s_procSpells[] =
+{
+    12834, 16487, 12317, 20230, 324, 20154, 15286, 12319, 12292, 20128, 16176, 2565, 20925
+};
+
+static uint32 const s_procExtras[] =
+{
+    PROC_EX_NORMAL_HIT, PROC_EX_CRITICAL_HIT, PROC_EX_MISS, PROC_EX_DODGE, PROC_EX_PARRY, PROC_EX_BLOCK, PROC_EX_RESIST
+};
+
+// Unit::ProcDamageAndSpellFor only visits the holders indexed by proc flags: it must select
+// exactly the holders (and in the same order) as a pass over all of the auras.
+class proc_candidates_index : public SingleTest
+{
+public:
+    proc_candidates_index(const char* name) : SingleTest(name)
+    {
+    }
+
+    // Selection of every holder of the unit, as done before the index
+    void SelectAll(Unit* unit, bool isVictim, Unit* target, uint32 procFlag, uint32 procExtra, SpellEntry const* procSpell, std::vector<SpellAuraHolder*>& holders)
+    {
+        Unit::SpellAuraHolderMap const& auras = unit->GetSpellAuraHolderMap();
+        for (Unit::SpellAuraHolderMap::const_iterator itr = auras.begin(); itr != auras.end(); ++itr)
+        {
+            if (procSpell && procSpell->Id == itr->first)
+                continue;
+            if (itr->second->IsDeleted())
+                continue;
+
+            bool hasmodifier = false;
+            for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
+                if (Aura* aura = itr->second->GetAuraByEffectIndex(SpellEffectIndex(i)))
+                    if (SpellModifier* auraMod = aura->GetSpellModifier())
+                        if (auraMod->charges > 0)
+                            hasmodifier = true;
+            if (hasmodifier)
+                continue;
+
+            SpellProcEventEntry const* spellProcEvent = nullptr;
+            if (unit->IsTriggeredAtSpellProcEvent(target, itr->second, procSpell, procFlag, procExtra, BASE_ATTACK, isVictim, spellProcEvent))
+                holders.push_back(itr->second);
+        }
+    }
+
+    uint32 CompareProcs(Unit* unit, Unit* target, SpellEntry const* procSpell)
+    {
+        uint32 triggered = 0;
+        for (uint32 bit = 0; bit < 30; ++bit)
+        {
+            for (uint32 e = 0; e < sizeof(s_procExtras) / sizeof(s_procExtras[0]); ++e)
+            {
+                for (int isVictim = 0; isVictim < 2; ++isVictim)
+                {
+                    uint32 procFlag = 1 << bit;
+                    std::vector<SpellAuraHolder*> expected;
+                    SelectAll(unit, isVictim, target, procFlag, s_procExtras[e], procSpell, expected);
+
+                    ProcTriggeredList triggeredList;
+                    unit->ProcDamageAndSpellFor(isVictim, target, procFlag, s_procExtras[e], BASE_ATTACK, procSpell, 100, triggeredList);
+
+                    std::vector<SpellAuraHolder*> selected;
+                    for (ProcTriggeredList::const_iterator itr = triggeredList.begin(); itr != triggeredList.end(); ++itr)
+                    {
+                        itr->triggeredByHolder->SetInUse(false);
+                        selected.push_back(itr->triggeredByHolder);
+                    }
+
+                    if (selected != expected)
+                    {
+                        Fail("Proc flag 0x%x, extra 0x%x, spell %u%s: %u holders selected instead of %u", procFlag, s_procExtras[e],
+                            procSpell ? procSpell->Id : 0, isVictim ? " [victim]" : "", uint32(selected.size()), uint32(expected.size()));
+                        return triggered;
+                    }
+                    triggered += selected.size();
+                }
+            }
+        }
+        return triggered;
+    }
+
+    void Test() override
+    {
+        switch (GetTestStep())
+        {
+            case 0:
+                SpawnPlayer(0, CLASS_WARRIOR, RACE_HUMAN);
+                SpawnCreature(1, 1, 3.0f);
+                WaitPlayerSummon();
+                break;
+            case 1:
+            {
+                Player* player = GetTestPlayer(0, TESTPLAYER_MAXLEVEL);
+                player->EnableOption(PLAYER_CHEAT_ALWAYS_PROC);
+                for (uint32 i = 0; i < sizeof(s_buffSpells) / sizeof(s_buffSpells[0]); ++i)
+                    player->AddAura(s_buffSpells[i]);
+                for (uint32 i = 0; i < sizeof(s_procSpells) / sizeof(s_procSpells[0]); ++i)
+                    player->AddAura(s_procSpells[i]);
+                Wait(1000);
+                break;
+            }
+            case 2:
+            {
+                Player* player = GetTestPlayer(0);
+                Creature* target = GetTestCreature(1);
+                if (!player || !target)
+                    return;
+
+                uint32 holders = player->GetSpellAuraHolderMap().size();
+                uint32 candidates = player->GetProcSpellAuraHolderCount();
+                TEST_ASSERT(candidates < holders);
+
+                uint32 triggered = CompareProcs(player, target, nullptr);
+                // Heroic Strike, Fireball
+                triggered += CompareProcs(player, target, sSpellMgr.GetSpellEntry(78));
+                triggered += CompareProcs(player, target, sSpellMgr.GetSpellEntry(133));
+                TEST_ASSERT(triggered > 0);
+
+                // A removed holder leaves the index, the others are still selected in order
+                for (uint32 i = 0; i < sizeof(s_procSpells) / sizeof(s_procSpells[0]); ++i)
+                {
+                    SpellEntry const* spellProto = sSpellMgr.GetSpellEntry(s_procSpells[i]);
+                    if (!spellProto || !player->HasAura(s_procSpells[i]) || !Unit::GetSpellAuraHolderProcFlags(spellProto))
+                        continue;
+
+                    player->RemoveAurasDueToSpell(s_procSpells[i]);
+                    TEST_ASSERT(player->GetProcSpellAuraHolderCount() == --candidates);
+                    CompareProcs(player, target, nullptr);
+                    break;
+                }
+
+                // Holders without proc flags are not indexed
+                for (uint32 i = 0; i < sizeof(s_buffSpells) / sizeof(s_buffSpells[0]); ++i)
+                {
+                    SpellEntry const* spellProto = sSpellMgr.GetSpellEntry(s_buffSpells[i]);
+                    if (!spellProto || !player->HasAura(s_buffSpells[i]) || Unit::GetSpellAuraHolderProcFlags(spellProto))
+                        continue;
+
+                    player->RemoveAurasDueToSpell(s_buffSpells[i]);
+                    TEST_ASSERT(player->GetProcSpellAuraHolderCount() == candidates);
+                    break;
+                }
+
+                if (!Failed())
+                    Finish();
+                break;
+            }
+        }
+        NextStep();
+    }
+};
+
+void AddTest_procs()
+{
+    sAutoTestingMgr->AddTest(new proc_candidates_index("proc_candidates_index"));
+}
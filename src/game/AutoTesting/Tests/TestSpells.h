@@ -0,0 +1,19 @@
+/*
+ * TestSpells.h
+ *
+ * Spell lists shared by the tests.
+ */
+
+#ifndef GAME_AUTOTESTING_TESTS_TESTSPELLS_H_
+#define GAME_AUTOTESTING_TESTS_TESTSPELLS_H_
+
+#include "Platform/Define.h"
+
+// Raid buffs, consumables and world buffs
+static uint32 const s_buffSpells[] =
+{
+    1243, 1244, 1459, 1126, 19740, 20217, 6673, 1038, 19742, 14752, 976, 17538, 11405, 16609, 22888,
+    15366, 24425, 22817, 22818, 22820, 17628, 17626
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*
+* Threat.cpp
+*
+*/
+#include "TestPCH.h"
+#include "ThreatManager.h"
+
+// A few players hitting a boss: after each victim selection the threat list is ranked
+// highest first, each player maps to its own reference, and removed references leave
+// both the list and the index.
+class threat_raid_boss : public SingleTest
+{
+public:
+    threat_raid_boss(const char* name) : SingleTest(name, MAP_TESTING_ID, false)
+    {
+    }
+
+    static const int NUM_PLAYERS = 5;
+
+    static bool IsRanked(ThreatList const& list)
+    {
+        float previous = 0.0f;
+        for (ThreatList::const_iterator itr = list.begin(); itr != list.end(); ++itr)
+        {
+            if (itr != list.begin() && (*itr)->getThreat() > previous)
+                return false;
+            previous = (*itr)->getThreat();
+        }
+        return true;
+    }
+
+    static Unit* GetRankedTarget(ThreatList const& list, uint32 rank)
+    {
+        ThreatList::const_iterator itr = list.begin();
+        for (; itr != list.end() && rank; ++itr, --rank) {}
+        return itr != list.end() ? (*itr)->getTarget() : nullptr;
+    }
+
+    void Test() override
+    {
+        switch (GetTestStep())
+        {
+            case 0:
+                for (int i = 0; i < NUM_PLAYERS; ++i)
+                    SpawnPlayer(i, CLASS_WARRIOR, RACE_HUMAN, i * 2.0f - 4.0f, 2.0f);
+                SpawnCreature(NUM_PLAYERS, 1);
+                Wait(5000);
+                break;
+            case 1:
+            {
+                Creature* boss = GetTestCreature(NUM_PLAYERS);
+                Player* players[NUM_PLAYERS];
+                for (int i = 0; i < NUM_PLAYERS; ++i)
+                    players[i] = GetTestPlayer(i);
+                if (Failed())
+                    return;
+                ThreatManager& threatManager = boss->getThreatManager();
+
+                // Threat 100, 200, ... 500: ranked from the last player to the first
+                for (int i = 0; i < NUM_PLAYERS; ++i)
+                    threatManager.addThreatDirectly(players[i], 100.0f * (i + 1));
+                threatManager.getHostileTarget();
+                ThreatList const& list = threatManager.getThreatList();
+                TEST_ASSERT(int(list.size()) == NUM_PLAYERS);
+                TEST_ASSERT(IsRanked(list));
+                for (int i = 0; i < NUM_PLAYERS; ++i)
+                {
+                    TEST_ASSERT(GetRankedTarget(list, i) == players[NUM_PLAYERS - 1 - i]);
+                    TEST_ASSERT(threatManager.getThreat(players[i]) == 100.0f * (i + 1));
+                }
+
+                // Several changes between two selections: the first player takes the lead,
+                // the third one drops to the bottom
+                threatManager.addThreatDirectly(players[0], 1000.0f);
+                threatManager.addThreatDirectly(players[3], 50.0f);
+                threatManager.modifyThreatPercent(players[2], -90);
+                threatManager.getHostileTarget();
+                TEST_ASSERT(IsRanked(list));
+                TEST_ASSERT(GetRankedTarget(list, 0) == players[0]);
+                TEST_ASSERT(GetRankedTarget(list, 1) == players[4]);
+                TEST_ASSERT(GetRankedTarget(list, 2) == players[3]);
+                TEST_ASSERT(GetRankedTarget(list, 3) == players[1]);
+                TEST_ASSERT(GetRankedTarget(list, 4) == players[2]);
+                TEST_ASSERT(threatManager.getThreat(players[0]) == 1100.0f);
+
+                // Removed from the middle of the ranking
+                threatManager.modifyThreatPercent(players[3], -101);
+                threatManager.getHostileTarget();
+                TEST_ASSERT(int(list.size()) == NUM_PLAYERS - 1);
+                TEST_ASSERT(IsRanked(list));
+                TEST_ASSERT(threatManager.getThreat(players[3]) == 0.0f);
+                TEST_ASSERT(GetRankedTarget(list, 2) == players[1]);
+
+                // Back at the bottom of the ranking
+                threatManager.addThreatDirectly(players[3], 1.0f);
+                threatManager.getHostileTarget();
+                TEST_ASSERT(int(list.size()) == NUM_PLAYERS);
+                TEST_ASSERT(GetRankedTarget(list, NUM_PLAYERS - 1) == players[3]);
+
+                boss->DeleteThreatList();
+                if (!Failed())
+                    Finish();
+                break;
+            }
+        }
+        NextStep();
+    }
+};
+
+void AddTest_threat()
+{
+    sAutoTestingMgr->AddTest(new threat_raid_boss("threat_raid_boss"));
+}
@@ -0,0 +1,166 @@
+/*
+* ValuesUpdate.cpp
+*
+*/
+#include "TestPCH.h"
+
+// Health change of a creature seen by a few players: the viewers of the same class get
+// the bytes the block would have had if built for them, and fields rewritten per viewer
+// keep the block unique.
+class values_update_sharing : public SingleTest
+{
+public:
+    values_update_sharing(const char* name) : SingleTest(name, MAP_TESTING_ID, false)
+    {
+    }
+
+    static bool SameBytes(ByteBuffer const& lhs, ByteBuffer const& rhs)
+    {
+        return lhs.wpos() == rhs.wpos() && !memcmp(lhs.contents(), rhs.contents(), lhs.wpos());
+    }
+
+    void Test() override
+    {
+        const uint32 NUM_PLAYERS = 3;
+
+        if (GetTestStep() == 0)
+        {
+            for (uint32 i = 0; i < NUM_PLAYERS; ++i)
+                SpawnPlayer(i, CLASS_WARRIOR, RACE_HUMAN, float(i), 0);
+            SpawnCreature(NUM_PLAYERS, 1, 5.0f, 0);
+            Wait(5000);
+            NextStep();
+            return;
+        }
+
+        Creature* creature = GetTestCreature(NUM_PLAYERS);
+        TEST_ASSERT(creature);
+        Player* players[NUM_PLAYERS];
+        for (uint32 i = 0; i < NUM_PLAYERS; ++i)
+        {
+            players[i] = GetTestPlayer(i);
+            TEST_ASSERT(players[i]);
+        }
+        if (Failed())
+            return;
+
+        TEST_ASSERT(players[0]->GetValuesUpdateViewerClass(players[0]) == VALUES_VIEWER_SELF);
+
+        // Not yet sent: the block is built from the changed fields
+        creature->SetHealth(creature->GetMaxHealth() - 1);
+        for (uint32 i = 0; i < NUM_PLAYERS; ++i)
+            TEST_ASSERT(creature->GetValuesUpdateViewerClass(players[i]) == VALUES_VIEWER_OTHER);
+
+        UpdateDataMapType updates;
+        ValuesUpdateBlockCache cache(true);
+        for (uint32 i = 0; i < NUM_PLAYERS; ++i)
+            creature->BuildUpdateDataForPlayer(players[i], updates, &cache);
+
+        TEST_ASSERT(updates.size() == NUM_PLAYERS);
+        TEST_ASSERT(cache.built[VALUES_VIEWER_OTHER]);
+        TEST_ASSERT(cache.bytesBuilt == cache.blocks[VALUES_VIEWER_OTHER].wpos());
+        TEST_ASSERT(cache.bytesShared == (NUM_PLAYERS - 1) * cache.blocks[VALUES_VIEWER_OTHER].wpos());
+        for (uint32 i = 0; i < NUM_PLAYERS; ++i)
+        {
+            ByteBuffer block;
+            creature->BuildValuesUpdateBlock(block, players[i]);
+            TEST_ASSERT(SameBytes(block, cache.blocks[VALUES_VIEWER_OTHER]));
+        }
+
+        // Without sharing, every viewer gets its own block
+        ValuesUpdateBlockCache unshared(false);
+        for (uint32 i = 0; i < NUM_PLAYERS; ++i)
+            creature->BuildUpdateDataForPlayer(players[i], updates, &unshared);
+        TEST_ASSERT(!unshared.built[VALUES_VIEWER_OTHER]);
+        TEST_ASSERT(unshared.bytesShared == 0);
+        TEST_ASSERT(unshared.bytesBuilt == NUM_PLAYERS * cache.blocks[VALUES_VIEWER_OTHER].wpos());
+
+        // Dynamic flags are rewritten for each viewer (lootable, tapped)
+        creature->SetUInt32Value(UNIT_DYNAMIC_FLAGS, creature->GetUInt32Value(UNIT_DYNAMIC_FLAGS) ^ UNIT_DYNFLAG_TRACK_UNIT);
+        TEST_ASSERT(creature->GetValuesUpdateViewerClass(players[0]) == VALUES_VIEWER_UNIQUE);
+
+        if (!Failed())
+            Finish();
+    }
+};
+
+// Health changes of a creature seen by 300 players: reports the bytes serialized by
+// BuildValuesUpdate with and without per-viewer-class sharing of the blocks.
+class values_update_sharing_benchmark : public SingleTest
+{
+public:
+    values_update_sharing_benchmark(const char* name) : SingleTest(name, MAP_TESTING_ID, false),
+        _builtWithout(0), _builtWith(0), _sharedWith(0), _startBuilt(0), _startShared(0), _configValue(true)
+    {
+    }
+
+    void StartMeasure(bool share)
+    {
+        sWorld.setConfig(CONFIG_BOOL_SHARE_VALUES_UPDATE_BLOCKS, share);
+        _startBuilt = Object::GetValuesUpdateBytesBuilt();
+        _startShared = Object::GetValuesUpdateBytesShared();
+    }
+
+    void Test() override
+    {
+        const int NUM_PLAYERS_PER_TICK = 50;
+        const int NUM_SPAWN_TICKS = 6;
+        const int NUM_HEALTH_CHANGES = 10;
+
+        // Spawn players
+        if (GetTestStep() < NUM_SPAWN_TICKS)
+        {
+            for (int i = 0; i < NUM_PLAYERS_PER_TICK; ++i)
+                SpawnPlayer(GetTestStep()*NUM_PLAYERS_PER_TICK + i + 1, CLASS_WARRIOR, RACE_HUMAN, 0, 0);
+            NextStep();
+            return;
+        }
+
+        uint32 step = GetTestStep() - NUM_SPAWN_TICKS;
+        if (step == 0)
+        {
+            SpawnCreature(0, 1, 5.0f, 0);
+            _configValue = sWorld.getConfig(CONFIG_BOOL_SHARE_VALUES_UPDATE_BLOCKS);
+            Wait(5000);
+        }
+        else if (step == 1)
+            StartMeasure(false);
+        else if (step < 2 + 2 * NUM_HEALTH_CHANGES)
+        {
+            if (step == 2 + NUM_HEALTH_CHANGES)
+            {
+                _builtWithout = Object::GetValuesUpdateBytesBuilt() - _startBuilt;
+                StartMeasure(true);
+            }
+            Creature* creature = GetTestCreature(0);
+            if (!creature)
+                return;
+            creature->SetHealth(creature->GetMaxHealth() - step);
+            Wait(200);
+        }
+        else
+        {
+            _builtWith = Object::GetValuesUpdateBytesBuilt() - _startBuilt;
+            _sharedWith = Object::GetValuesUpdateBytesShared() - _startShared;
+            sWorld.setConfig(CONFIG_BOOL_SHARE_VALUES_UPDATE_BLOCKS, _configValue);
+            sLog.outString("[%s] Values update bytes built: %llu without sharing, %llu with sharing (%llu bytes reused)",
+                GetName().c_str(), _builtWithout, _builtWith, _sharedWith);
+            Finish();
+        }
+        NextStep();
+    }
+
+protected:
+    unsigned long long _builtWithout;
+    unsigned long long _builtWith;
+    unsigned long long _sharedWith;
+    uint64 _startBuilt;
+    uint64 _startShared;
+    bool _configValue;
+};
+
+void AddTest_values_update()
+{
+    sAutoTestingMgr->AddTest(new values_update_sharing("values_update_sharing"));
+    sAutoTestingMgr->AddTest(new values_update_sharing_benchmark("values_update_sharing_benchmark"));
+}
@@ -37,6 +37,7 @@
 #include "Formulas.h"
 #include "GridNotifiersImpl.h"
 #include "Chat.h"
+#include "LogsDatabaseWriter.h"
 
 namespace MaNGOS
 {
@@ -663,26 +664,21 @@ void BattleGround::EndBattleGround(Team winner)
             BattleGroundScoreMap::const_iterator score = m_PlayerScores.find(itr->first);
             if (score != m_PlayerScores.end())
             {
-                static SqlStatementID insLogBg;
-                SqlStatement logStmt = LogsDatabase.CreateStatement(insLogBg,
-                        "INSERT INTO logs_battleground SET "
-                        "bgid=?, bgtype=?, bgduration=?, bgteamcount=?, "
-                        "playerGuid=?, team=?, deaths=?, honorBonus=?, "
-                        "honorableKills=?");
-
-                logStmt.addUInt32(GetInstanceID());
-                logStmt.addUInt32(GetTypeID());
-                logStmt.addUInt32(GetStartTime() / 1000);
-                logStmt.addUInt32(GetPlayersCountByTeam(team));
-
-                logStmt.addUInt32(itr->first);
-                logStmt.addUInt32(team);
-                logStmt.addUInt32(score->second->Deaths);
-                logStmt.addUInt32(score->second->BonusHonor);
-
-                logStmt.addUInt32(score->second->HonorableKills);
-
-                logStmt.Execute();
+                LogsDatabaseEvent event(LOGS_TABLE_BATTLEGROUND);
+
+                event.addUInt32(GetInstanceID());
+                event.addUInt32(GetTypeID());
+                event.addUInt32(GetPlayersCountByTeam(team));
+                event.addUInt32(GetStartTime() / 1000);
+
+                event.addUInt32(itr->first);
+                event.addUInt32(team);
+                event.addUInt32(score->second->Deaths);
+                event.addUInt32(score->second->BonusHonor);
+
+                event.addUInt32(score->second->HonorableKills);
+
+                event.Write();
             }
         }
     }
@@ -75,6 +75,9 @@ class MANGOS_DLL_SPEC Camera
     public:
         GridReference<Camera>& GetGridRef() { return m_gridRef; }
         bool isActiveObject() const { return false; }
+        // cameras follow their view point and are never searched by position
+        void AddToGridPositions(GridPositions& /*positions*/) {}
+        void RemoveFromGridPositions() {}
     private:
         GridReference<Camera> m_gridRef;
 };
@@ -776,11 +776,12 @@ void Channel::SetOwner(ObjectGuid guid, bool exclaim)
 
 void Channel::SendToAll(WorldPacket *data, ObjectGuid guid)
 {
+    BroadcastPacket packet(data);
     for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
     {
         if (PlayerPointer pPlayer = GetPlayer(i->first))
             if (!pPlayer->GetSocial()->HasIgnore(guid))
-                pPlayer->GetSession()->SendPacket(data);
+                packet.SendTo(pPlayer->GetSession());
     }
 }
 
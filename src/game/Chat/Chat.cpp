@@ -207,6 +207,7 @@ ChatCommand * ChatHandler::getCommandTable()
     {
         { NODE, "check",          SEC_DEVELOPPER,     false, &ChatHandler::HandleDebugLoSCommand,                 "", nullptr },
         { NODE, "allow",          SEC_DEVELOPPER,     false, &ChatHandler::HandleDebugLoSAllowCommand,            "", nullptr },
+        { NODE, "cache",          SEC_DEVELOPPER,     false, &ChatHandler::HandleDebugLoSCacheCommand,            "", nullptr },
         { MSTR, nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
@@ -773,6 +774,7 @@ ChatCommand * ChatHandler::getCommandTable()
     static ChatCommand serverCommandTable[] =
     {
         { NODE, "corpses",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerCorpsesCommand,       "", nullptr },
+        { NODE, "dbqueues",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerDbQueuesCommand,      "", nullptr },
         { NODE, "exit",           SEC_CONSOLE,        true,  &ChatHandler::HandleServerExitCommand,          "", nullptr },
         { NODE, "idlerestart",    SEC_ADMINISTRATOR,  true, nullptr,                                         "", serverIdleRestartCommandTable },
         { NODE, "idleshutdown",   SEC_ADMINISTRATOR,  true, nullptr,                                         "", serverShutdownCommandTable },
@@ -783,6 +785,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { NODE, "restart",        SEC_ADMINISTRATOR,  true, nullptr,                                         "", serverRestartCommandTable },
         { NODE, "shutdown",       SEC_ADMINISTRATOR,  true, nullptr,                                         "", serverShutdownCommandTable },
         { NODE, "set",            SEC_ADMINISTRATOR,  true, nullptr,                                         "", serverSetCommandTable },
+        { NODE, "tickstats",      SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerTickStatsCommand,     "", nullptr },
         { MSTR, nullptr,          0,                  false, nullptr,                                        "", nullptr }
     };
 
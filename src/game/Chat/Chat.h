@@ -303,6 +303,7 @@ class MANGOS_DLL_SPEC ChatHandler
         // Debug
         bool HandleDebugLoSCommand(char* args);
         bool HandleDebugLoSAllowCommand(char* args);
+        bool HandleDebugLoSCacheCommand(char* args);
         bool HandleDebugAssertFalseCommand(char* args);
         bool HandleDebugPvPCreditCommand(char* args);
         bool HandleDebugMonsterChatCommand(char *args);
@@ -762,6 +763,8 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleServerIdleRestartCommand(char* args);
         bool HandleServerIdleShutDownCommand(char* args);
         bool HandleServerInfoCommand(char* args);
+        bool HandleServerDbQueuesCommand(char* args);
+        bool HandleServerTickStatsCommand(char* args);
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
         bool HandleServerMotdCommand(char* args);
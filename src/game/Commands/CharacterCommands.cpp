@@ -1389,6 +1389,7 @@ bool ChatHandler::HandleCharacterRenameCommand(char* args)
         PSendSysMessage(LANG_RENAME_PLAYER, GetNameLink(target).c_str());
         target->SetAtLoginFlag(AT_LOGIN_RENAME);
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '1' WHERE guid = '%u'", target->GetGUIDLow());
+        target->InvalidateSaveSection(Player::SAVE_SECTION_CHARACTER);
     }
     else
     {
@@ -1504,6 +1504,18 @@ bool ChatHandler::HandleDebugLoSAllowCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleDebugLoSCacheCommand(char* /*args*/)
+{
+    Map* map = m_session->GetPlayer()->GetMap();
+    LineOfSightCacheStats stats = map->GetLineOfSightCacheStats();
+    uint64 lookups = stats.hits + stats.misses;
+
+    PSendSysMessage("LOS cache of map %u (%u ms):", map->GetId(), sWorld.getConfig(CONFIG_UINT32_LOS_CACHE_TIME));
+    PSendSysMessage(" Hits: " UI64FMTD " / " UI64FMTD " (%.1f%%)", stats.hits, lookups, lookups ? 100.0f * stats.hits / lookups : 0.0f);
+    PSendSysMessage(" Gameobject invalidations: " UI64FMTD, stats.invalidations);
+    return true;
+}
+
 bool ChatHandler::HandleSendSpellVisualCommand(char *args)
 {
     Unit *pTarget = GetSelectedUnit();
@@ -2492,6 +2504,12 @@ bool ChatHandler::HandleMmapStatsCommand(char* /*args*/)
 
     MMAP::MMapManager *manager = MMAP::MMapFactory::createOrGetMMapManager();
     PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
+    MMAP::NavMeshQueryStats queryStats = manager->getNavMeshQueryStats();
+    PSendSysMessage(" navmesh queries: " UI64FMTD " leases, " UI64FMTD " misses, %u leased (peak %u)",
+                    queryStats.leases, queryStats.misses, queryStats.active, queryStats.peak);
+    MMAP::PathCorridorStats corridorStats = manager->getPathCorridorStats();
+    PSendSysMessage(" path corridors: " UI64FMTD " hits, " UI64FMTD " misses, " UI64FMTD " invalidations",
+                    corridorStats.hits, corridorStats.misses, corridorStats.invalidations);
 
     const dtNavMesh* navmesh = manager->GetNavMesh(m_session->GetPlayer()->GetMapId());
     if (Transport* transport = m_session->GetPlayer()->GetTransport())
@@ -38,6 +38,8 @@
 #include "AuraRemovalMgr.h"
 #include "AutoBroadCastMgr.h"
 #include "SpellModMgr.h"
+#include "TickProfiler.h"
+#include "LogsDatabaseWriter.h"
 
 bool ChatHandler::HandleAnnounceCommand(char* args)
 {
@@ -327,6 +329,101 @@ bool ChatHandler::HandleServerInfoCommand(char* /*args*/)
     return true;
 }
 
+// Async SQL queues depth and delay threads batching
+bool ChatHandler::HandleServerDbQueuesCommand(char* /*args*/)
+{
+    struct
+    {
+        char const* name;
+        Database* db;
+    } const databases[] =
+    {
+        { "Login",     &LoginDatabase     },
+        { "World",     &WorldDatabase     },
+        { "Character", &CharacterDatabase },
+        { "Logs",      &LogsDatabase      },
+    };
+
+    for (auto const& database : databases)
+    {
+        SqlAsyncStats stats;
+        database.db->GetAsyncStats(stats);
+        PSendSysMessage("%s: %u queued. " UI64FMTD " batches (" UI64FMTD " statements, max %u per batch, " UI64FMTD " replayed), " UI64FMTD " unbatched operations",
+            database.name, stats.queued, stats.batches, stats.batchedStatements, stats.maxBatchStatements, stats.replayedBatches, stats.unbatchedOperations);
+    }
+
+    PSendSysMessage("Logs events: %u buffered, " UI64FMTD " inserts, " UI64FMTD " writes delayed by the Logs queue",
+        sLogsDatabaseWriter.GetBufferedEvents(), sLogsDatabaseWriter.GetStatements(), sLogsDatabaseWriter.GetDeferredUpdates());
+    for (uint32 i = 0; i < MAX_LOGS_TABLES; ++i)
+    {
+        LogsDatabaseTable table = LogsDatabaseTable(i);
+        if (sLogsDatabaseWriter.GetWrittenEvents(table) || sLogsDatabaseWriter.GetDroppedEvents(table))
+            PSendSysMessage("  %s: " UI64FMTD " written, " UI64FMTD " dropped", LogsDatabaseWriter::GetTableName(table),
+                sLogsDatabaseWriter.GetWrittenEvents(table), sLogsDatabaseWriter.GetDroppedEvents(table));
+    }
+    return true;
+}
+
+static void SendTickPhaseStats(ChatHandler* handler, TickProfile const* profile, TickPhase phase)
+{
+    TickPhaseStats stats = profile->GetStats(phase);
+    handler->PSendSysMessage("  %-12s p50 %6uus  p95 %6uus  p99 %6uus  max %6uus  [%u ticks]",
+        TickProfiler::GetPhaseName(phase), stats.p50, stats.p95, stats.p99, stats.max, stats.samples);
+}
+
+// .server tickstats [mapId [instanceId]]
+bool ChatHandler::HandleServerTickStatsCommand(char* args)
+{
+    if (!sTickProfiler.IsEnabled())
+        SendSysMessage("Tick profiler is disabled (PerformanceLog.TickProfiler), showing old values.");
+
+    uint32 mapId = 0;
+    if (!ExtractUInt32(&args, mapId))
+    {
+        SendSysMessage("World:");
+        for (uint32 i = TICK_PHASE_WORLD; i <= TICK_PHASE_NETWORK_FLUSH; ++i)
+            SendTickPhaseStats(this, sTickProfiler.GetWorldProfile(), TickPhase(i));
+        PSendSysMessage("  Packet bytes last tick: " UI64FMTD " copied, " UI64FMTD " shared",
+            sTickProfiler.GetLastTickCopiedBytes(), sTickProfiler.GetLastTickSharedBytes());
+
+        std::vector<TickProfilePtr> maps;
+        sTickProfiler.GetSlowestMaps(maps, 5);
+        SendSysMessage("Slowest maps:");
+        for (auto const& map : maps)
+        {
+            TickPhaseStats stats = map->GetStats(TICK_PHASE_MAP);
+            PSendSysMessage("  Map %3u inst %5u  p50 %6uus  p95 %6uus  p99 %6uus  max %6uus",
+                map->GetMapId(), map->GetInstanceId(), stats.p50, stats.p95, stats.p99, stats.max);
+        }
+        return true;
+    }
+
+    uint32 instanceId = 0;
+    bool anyInstance = !ExtractUInt32(&args, instanceId);
+
+    std::vector<TickProfilePtr> maps;
+    sTickProfiler.GetMapProfiles(maps);
+    bool found = false;
+    for (auto const& map : maps)
+    {
+        if (map->GetMapId() != mapId || (!anyInstance && map->GetInstanceId() != instanceId))
+            continue;
+
+        found = true;
+        PSendSysMessage("Map %u inst %u:", map->GetMapId(), map->GetInstanceId());
+        for (uint32 i = TICK_PHASE_MAP; i < MAX_TICK_PHASES; ++i)
+            SendTickPhaseStats(this, map.get(), TickPhase(i));
+    }
+
+    if (!found)
+    {
+        PSendSysMessage("No loaded map %u.", mapId);
+        SetSentErrorMessage(true);
+        return false;
+    }
+    return true;
+}
+
 // Display the 'Message of the day' for the realm
 bool ChatHandler::HandleServerMotdCommand(char* /*args*/)
 {
@@ -595,6 +595,7 @@ void Guild::BroadcastToGuild(WorldSession *session, const std::string& msg, uint
 
     WorldPacket data;
     ChatHandler::BuildChatPacket(data, CHAT_MSG_GUILD, msg.c_str(), Language(language), pPlayer->GetChatTag(), pPlayer->GetObjectGuid(), pPlayer->GetName());
+    ::BroadcastPacket packet(std::move(data));
 
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
@@ -604,7 +605,7 @@ void Guild::BroadcastToGuild(WorldSession *session, const std::string& msg, uint
         MasterPlayer *pl = ObjectAccessor::FindMasterPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
 
         if (pl && pl->GetSession() && !pl->GetSocial()->HasIgnore(session->GetMasterPlayer()->GetObjectGuid()))
-            pl->GetSession()->SendPacket(&data);
+            packet.SendTo(pl->GetSession());
     }
 }
 
@@ -619,6 +620,7 @@ void Guild::BroadcastToOfficers(WorldSession *session, const std::string& msg, u
 
     WorldPacket data;
     ChatHandler::BuildChatPacket(data, CHAT_MSG_OFFICER, msg.c_str(), Language(language), pPlayer->GetChatTag(), pPlayer->GetObjectGuid(), pPlayer->GetName());
+    ::BroadcastPacket packet(std::move(data));
 
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
@@ -628,17 +630,18 @@ void Guild::BroadcastToOfficers(WorldSession *session, const std::string& msg, u
         MasterPlayer *pl = ObjectAccessor::FindMasterPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
 
         if (pl && pl->GetSession() && !pl->GetSocial()->HasIgnore(session->GetMasterPlayer()->GetObjectGuid()))
-            pl->GetSession()->SendPacket(&data);
+            packet.SendTo(pl->GetSession());
     }
 }
 
 void Guild::BroadcastPacket(WorldPacket *packet)
 {
+    ::BroadcastPacket shared(packet);
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         Player *player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
         if (player)
-            player->GetSession()->SendPacket(packet);
+            shared.SendTo(player->GetSession());
     }
 }
 
@@ -667,6 +667,7 @@ void HonorMgr::SaveStoredData()
             "`honorLastWeekHK` = %u, `honorLastWeekCP` = %.1f, `honorStoredHK` = %u, `honorStoredDK` = %u WHERE `guid` = %u",
             finiteAlways(m_rankPoints), m_standing, m_highestRank.rank, m_lastWeekHK,
             finiteAlways(m_lastWeekCP), m_storedHK, m_storedDK, m_owner->GetGUIDLow());
+    m_owner->InvalidateSaveSection(Player::SAVE_SECTION_CHARACTER);
 }
 
 void HonorMgr::Load(QueryResult* result)
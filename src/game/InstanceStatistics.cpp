@@ -24,6 +24,7 @@
 #include "Creature.h"
 #include "SpellEntry.h"
 #include "ProgressBar.h"
+#include "LogsDatabaseWriter.h"
 
 INSTANTIATE_SINGLETON_1(InstanceStatisticsMgr);
 
@@ -155,9 +156,9 @@ void InstanceStatisticsMgr::IncrementWipeCounter(uint32 mapId, uint32 creatureEn
         it->second.count++;
         count = it->second.count;
     }
-    m_wipesMutex.release();
-
+    // Saved under the lock, so the events of a counter are written in the order of the counts
     Save(mapId, creatureEntry, count);
+    m_wipesMutex.release();
 }
 
 void InstanceStatisticsMgr::IncrementKillCounter(Creature* pKiller, Player* pVictim, SpellEntry const* spellProto)
@@ -196,9 +197,8 @@ void InstanceStatisticsMgr::IncrementKillCounter(Creature* pKiller, Player* pVic
             count = ++it2->second;
         }
     }
-    m_creatureKillsMutex.release();
-
     Save(mapId,creatureEntry,spellId,count);
+    m_creatureKillsMutex.release();
 }
 
 void InstanceStatisticsMgr::IncrementCustomCounter(eInstanceCustomCounter index, bool save)
@@ -216,31 +216,32 @@ void InstanceStatisticsMgr::IncrementCustomCounter(eInstanceCustomCounter index,
         it->second++;
         count = it->second;
     }
-    m_customCountersMutex.release();
 
     if (save)
     {
-        LogsDatabase.BeginTransaction();
-        LogsDatabase.PExecute("DELETE FROM `instance_custom_counters` WHERE `index` = %u", index);
-        LogsDatabase.PExecute("INSERT INTO `instance_custom_counters` (`index`, `count`) VALUES (%u, %u)", index, count);
-        LogsDatabase.CommitTransaction();
+        LogsDatabaseEvent event(LOGS_TABLE_INSTANCE_CUSTOM_COUNTERS);
+        event.addUInt32(index);
+        event.addUInt32(count);
+        event.Write();
     }
+    m_customCountersMutex.release();
 }
 
 void InstanceStatisticsMgr::Save(uint32 mapId, uint32 creatureEntry, uint32 spellId, uint32 count)
 {
-    LogsDatabase.BeginTransaction();
-    LogsDatabase.PExecute("DELETE FROM `instance_creature_kills` WHERE `mapId` = %u and `creatureEntry` = %u and `spellEntry` = %u",
-        mapId, creatureEntry, spellId);
-    LogsDatabase.PExecute("INSERT INTO `instance_creature_kills` (`mapId`, `creatureEntry`, `spellEntry`, `count`) VALUES (%u, %u, %u, %u)",
-        mapId, creatureEntry, spellId, count);
-    LogsDatabase.CommitTransaction();
+    LogsDatabaseEvent event(LOGS_TABLE_INSTANCE_CREATURE_KILLS);
+    event.addUInt32(mapId);
+    event.addUInt32(creatureEntry);
+    event.addUInt32(spellId);
+    event.addUInt32(count);
+    event.Write();
 }
 
 void InstanceStatisticsMgr::Save(uint32 mapId, uint32 creatureEntry, uint32 count)
 {
-    LogsDatabase.BeginTransaction();
-    LogsDatabase.PExecute("DELETE FROM `instance_wipes` WHERE `mapId` = %u and `creatureEntry` = %u",  mapId, creatureEntry);
-    LogsDatabase.PExecute("INSERT INTO `instance_wipes` (`mapId`, `creatureEntry`, `count`) VALUES (%u, %u, %u)", mapId, creatureEntry, count);
-    LogsDatabase.CommitTransaction();
+    LogsDatabaseEvent event(LOGS_TABLE_INSTANCE_WIPES);
+    event.addUInt32(mapId);
+    event.addUInt32(creatureEntry);
+    event.addUInt32(count);
+    event.Write();
 }
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LogsDatabaseWriter.h"
+#include "Policies/Singleton.h"
+#include "Policies/SingletonImp.h"
+#include "Database/DatabaseEnv.h"
+#include "Config/Config.h"
+#include "Timer.h"
+#include "Log.h"
+
+#include "ace/OS_NS_time.h"
+
+INSTANTIATE_SINGLETON_1(LogsDatabaseWriter);
+
+struct LogsDatabaseTableInfo
+{
+    char const* name;
+    char const* columns;                                    // without `time`
+    uint32 columnCount;
+    bool timed;                                             // has a `time` column, set to the time of the event
+    bool replace;                                           // counters: the last row of a key replaces the `count` of the previous ones
+};
+
+static LogsDatabaseTableInfo const logsTables[MAX_LOGS_TABLES] =
+{
+    { "logs_chat",                "`type`, `guid`, `target`, `channelId`, `channelName`, `message`",                                         6, true,  false },
+    { "logs_trade",               "`type`, `sender`, `senderType`, `senderEntry`, `receiver`, `amount`, `data`",                             7, true,  false },
+    { "logs_characters",          "`type`, `guid`, `account`, `name`, `ip`, `clientHash`",                                                   6, true,  false },
+    { "logs_transactions",        "`type`, `guid1`, `money1`, `spell1`, `items1`, `guid2`, `money2`, `spell2`, `items2`",                    9, true,  false },
+    { "logs_battleground",        "`bgid`, `bgtype`, `bgteamcount`, `bgduration`, `playerGuid`, `team`, `deaths`, `honorBonus`, `honorableKills`", 9, true,  false },
+    { "smartlog_creature",        "`type`, `entry`, `guid`, `specifier`, `combatTime`, `content`",                                           6, true,  false },
+    { "instance_wipes",           "`mapId`, `creatureEntry`, `count`",                                                                       3, false, true  },
+    { "instance_creature_kills",  "`mapId`, `creatureEntry`, `spellEntry`, `count`",                                                         4, false, true  },
+    { "instance_custom_counters", "`index`, `count`",                                                                                        2, false, true  },
+};
+
+LogsDatabaseEvent::LogsDatabaseEvent(LogsDatabaseTable table) : m_table(table), m_time(time(nullptr))
+{
+    m_values.reserve(logsTables[table].columnCount);
+}
+
+void LogsDatabaseEvent::addUInt32(uint32 value)
+{
+    m_values.emplace_back();
+    m_values.back().number = value;
+}
+
+void LogsDatabaseEvent::addInt32(int32 value)
+{
+    m_values.emplace_back();
+    m_values.back().number = value;
+}
+
+void LogsDatabaseEvent::addString(std::string const& value)
+{
+    m_values.emplace_back();
+    m_values.back().isString = true;
+    m_values.back().text = value;
+}
+
+void LogsDatabaseEvent::Write()
+{
+    sLogsDatabaseWriter.Add(*this);
+}
+
+LogsDatabaseWriter::LogsDatabaseWriter() : m_bufferedEvents(0), m_statements(0), m_deferredUpdates(0), m_reportedDrops(0),
+    m_lastWriteTime(0), m_maxRows(500), m_delay(1000), m_maxEvents(50000), m_maxQueuedQueries(100)
+{
+    for (uint32 i = 0; i < MAX_LOGS_TABLES; ++i)
+    {
+        m_droppedEvents[i] = 0;
+        m_writtenEvents[i] = 0;
+        m_files[i] = nullptr;
+    }
+}
+
+LogsDatabaseWriter::~LogsDatabaseWriter()
+{
+    for (uint32 i = 0; i < MAX_LOGS_TABLES; ++i)
+        if (m_files[i])
+            fclose(m_files[i]);
+}
+
+void LogsDatabaseWriter::Initialize()
+{
+    m_maxRows = std::max(1, sConfig.GetIntDefault("LogsDB.Batch.MaxRows", 500));
+    m_delay = std::max(0, sConfig.GetIntDefault("LogsDB.Batch.Delay", 1000));
+    m_maxEvents = std::max(1, sConfig.GetIntDefault("LogsDB.Batch.MaxEvents", 50000));
+    m_maxQueuedQueries = std::max(0, sConfig.GetIntDefault("LogsDB.Batch.MaxQueuedQueries", 100));
+    m_directory = sConfig.GetStringDefault("LogsDB.Batch.Directory", "");
+    if (!m_directory.empty())
+    {
+        char last = m_directory[m_directory.size() - 1];
+        if (last != '/' && last != '\\')
+            m_directory.append("/");
+    }
+    m_lastWriteTime = WorldTimer::getMSTime();
+
+    if (m_directory.empty())
+        sLog.outString("Logs database events written by %u rows every %u ms", m_maxRows, m_delay);
+    else
+        sLog.outString("Logs database events appended to %s<table>.txt every %u ms", m_directory.c_str(), m_delay);
+}
+
+char const* LogsDatabaseWriter::GetTableName(LogsDatabaseTable table)
+{
+    return logsTables[table].name;
+}
+
+void LogsDatabaseWriter::Add(LogsDatabaseEvent& event)
+{
+    ASSERT(event.m_values.size() == logsTables[event.m_table].columnCount);
+
+    std::lock_guard<std::mutex> guard(m_eventsLock);
+    if (m_bufferedEvents >= m_maxEvents)
+    {
+        ++m_droppedEvents[event.m_table];
+        return;
+    }
+
+    m_events[event.m_table].push_back(std::move(event));
+    ++m_bufferedEvents;
+}
+
+void LogsDatabaseWriter::Update(bool writeAll)
+{
+    if (!m_bufferedEvents)
+        return;
+
+    if (!writeAll)
+    {
+        if (m_bufferedEvents < m_maxRows && WorldTimer::getMSTimeDiffToNow(m_lastWriteTime) < m_delay)
+            return;
+
+        // The events wait for the queries already queued, instead of adding to the lag of the logs database
+        if (m_directory.empty())
+        {
+            SqlAsyncStats stats;
+            LogsDatabase.GetAsyncStats(stats);
+            if (stats.queued > m_maxQueuedQueries)
+            {
+                ++m_deferredUpdates;
+                return;
+            }
+        }
+    }
+
+    m_lastWriteTime = WorldTimer::getMSTime();
+
+    {
+        std::lock_guard<std::mutex> guard(m_eventsLock);
+        for (uint32 i = 0; i < MAX_LOGS_TABLES; ++i)
+            m_writtenBatch[i].swap(m_events[i]);
+        m_bufferedEvents = 0;
+    }
+
+    uint64 dropped = 0;
+    for (uint32 i = 0; i < MAX_LOGS_TABLES; ++i)
+    {
+        dropped += m_droppedEvents[i];
+
+        std::vector<LogsDatabaseEvent>& events = m_writtenBatch[i];
+        if (events.empty())
+            continue;
+
+        if (m_directory.empty())
+            WriteToDatabase(LogsDatabaseTable(i), events);
+        else
+            WriteToFile(LogsDatabaseTable(i), events);
+
+        m_writtenEvents[i] += events.size();
+        events.clear();
+    }
+
+    if (dropped > m_reportedDrops)
+    {
+        sLog.outError("LogsDatabaseWriter: " UI64FMTD " events dropped, more than %u events were waiting to be written (LogsDB.Batch.MaxEvents)",
+            dropped - m_reportedDrops, m_maxEvents);
+        m_reportedDrops = dropped;
+    }
+}
+
+void LogsDatabaseWriter::WriteToDatabase(LogsDatabaseTable table, std::vector<LogsDatabaseEvent> const& events)
+{
+    LogsDatabaseTableInfo const& info = logsTables[table];
+
+    std::string query;
+    std::string escaped;
+    for (size_t first = 0; first < events.size(); first += m_maxRows)
+    {
+        // One bad row (value out of range or too long in strict mode, duplicate key) would reject
+        // the whole statement: IGNORE turns these errors into warnings and only skips or clamps that row
+        query = "INSERT IGNORE INTO `";
+        query.append(info.name).append("` (");
+        if (info.timed)
+            query.append("`time`, ");
+        query.append(info.columns).append(") VALUES ");
+
+        size_t last = std::min(events.size(), first + m_maxRows);
+        for (size_t e = first; e < last; ++e)
+        {
+            LogsDatabaseEvent const& event = events[e];
+            query.append(e == first ? "(" : ", (");
+            if (info.timed)
+                query.append("FROM_UNIXTIME(").append(std::to_string(uint64(event.m_time))).append("), ");
+
+            for (size_t v = 0; v < event.m_values.size(); ++v)
+            {
+                LogsDatabaseEvent::Value const& value = event.m_values[v];
+                if (v)
+                    query.append(", ");
+                if (value.isString)
+                {
+                    escaped = value.text;
+                    LogsDatabase.escape_string(escaped);
+                    query.append("'").append(escaped).append("'");
+                }
+                else
+                    query.append(std::to_string(value.number));
+            }
+            query.append(")");
+        }
+        if (info.replace)
+            query.append(" ON DUPLICATE KEY UPDATE `count` = VALUES(`count`)");
+
+        LogsDatabase.Execute(query.c_str());
+        ++m_statements;
+    }
+}
+
+void LogsDatabaseWriter::WriteToFile(LogsDatabaseTable table, std::vector<LogsDatabaseEvent> const& events)
+{
+    FILE*& file = m_files[table];
+    if (!file)
+    {
+        std::string path = m_directory + logsTables[table].name + ".txt";
+        file = fopen(path.c_str(), "a");
+        if (!file)
+        {
+            sLog.outError("LogsDatabaseWriter: can not open %s, " SIZEFMTD " `%s` events lost", path.c_str(), events.size(), logsTables[table].name);
+            return;
+        }
+    }
+
+    // Default format of LOAD DATA INFILE: tab separated fields, escaped by '\'
+    std::string line;
+    for (LogsDatabaseEvent const& event : events)
+    {
+        line.clear();
+        if (logsTables[table].timed)
+        {
+            char timeString[24];
+            tm localTime;
+            ACE_OS::localtime_r(&event.m_time, &localTime);
+            strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S\t", &localTime);
+            line.append(timeString);
+        }
+
+        for (size_t v = 0; v < event.m_values.size(); ++v)
+        {
+            LogsDatabaseEvent::Value const& value = event.m_values[v];
+            if (v)
+                line.push_back('\t');
+            if (!value.isString)
+            {
+                line.append(std::to_string(value.number));
+                continue;
+            }
+
+            for (char c : value.text)
+            {
+                switch (c)
+                {
+                    case '\\': line.append("\\\\"); break;
+                    case '\t': line.append("\\t"); break;
+                    case '\n': line.append("\\n"); break;
+                    case '\r': line.append("\\r"); break;
+                    case '\0': line.append("\\0"); break;
+                    default: line.push_back(c); break;
+                }
+            }
+        }
+        line.push_back('\n');
+        fwrite(line.data(), 1, line.size(), file);
+    }
+    fflush(file);
+}
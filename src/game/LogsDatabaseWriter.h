@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOGSDATABASEWRITER_H
+#define MANGOS_LOGSDATABASEWRITER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Tables of the logs database written through LogsDatabaseWriter
+enum LogsDatabaseTable
+{
+    LOGS_TABLE_CHAT,
+    LOGS_TABLE_TRADE,
+    LOGS_TABLE_CHARACTERS,
+    LOGS_TABLE_TRANSACTIONS,
+    LOGS_TABLE_BATTLEGROUND,
+    LOGS_TABLE_SMARTLOG_CREATURE,
+    LOGS_TABLE_INSTANCE_WIPES,                              // counters, rows replaced by key
+    LOGS_TABLE_INSTANCE_CREATURE_KILLS,
+    LOGS_TABLE_INSTANCE_CUSTOM_COUNTERS,
+    MAX_LOGS_TABLES
+};
+
+/**
+ * A row of a logs table. The values are added in the order of the table
+ * columns, without the time column: the time of the event is taken when
+ * it is created, so the row keeps it even when it is written later.
+ */
+class LogsDatabaseEvent
+{
+    friend class LogsDatabaseWriter;
+
+    public:
+        explicit LogsDatabaseEvent(LogsDatabaseTable table);
+
+        void addUInt32(uint32 value);
+        void addInt32(int32 value);
+        void addString(std::string const& value);
+
+        // Hands the event to sLogsDatabaseWriter. Any thread.
+        void Write();
+
+    private:
+        struct Value
+        {
+            Value() : isString(false), number(0) {}
+            bool isString;
+            int64 number;
+            std::string text;
+        };
+
+        LogsDatabaseTable m_table;
+        time_t m_time;
+        std::vector<Value> m_values;
+};
+
+/**
+ * Buffers the events of the logs tables in memory, and writes them from the
+ * world thread as one multi-row INSERT IGNORE per table and per LogsDB.Batch.MaxRows
+ * events, instead of one async statement per event: an invalid event only loses its row.
+ * The events stay buffered while the async queue of LogsDatabase is longer than
+ * LogsDB.Batch.MaxQueuedQueries. Past LogsDB.Batch.MaxEvents buffered events,
+ * new events are dropped and counted.
+ * With LogsDB.Batch.Directory, the rows are appended to a file per table instead,
+ * in the default format of LOAD DATA INFILE.
+ */
+class LogsDatabaseWriter
+{
+    public:
+        LogsDatabaseWriter();
+        ~LogsDatabaseWriter();
+
+        void Initialize();
+
+        void Add(LogsDatabaseEvent& event);
+        // World thread. With 'writeAll', writes every buffered event whatever the async queue (shutdown).
+        void Update(bool writeAll = false);
+
+        static char const* GetTableName(LogsDatabaseTable table);
+        uint32 GetBufferedEvents() const { return m_bufferedEvents; }
+        uint64 GetWrittenEvents(LogsDatabaseTable table) const { return m_writtenEvents[table]; }
+        uint64 GetDroppedEvents(LogsDatabaseTable table) const { return m_droppedEvents[table]; }
+        uint64 GetStatements() const { return m_statements; }
+        uint64 GetDeferredUpdates() const { return m_deferredUpdates; }
+
+    private:
+        void WriteToDatabase(LogsDatabaseTable table, std::vector<LogsDatabaseEvent> const& events);
+        void WriteToFile(LogsDatabaseTable table, std::vector<LogsDatabaseEvent> const& events);
+
+        std::mutex m_eventsLock;
+        std::vector<LogsDatabaseEvent> m_events[MAX_LOGS_TABLES];
+        std::atomic<uint32> m_bufferedEvents;
+        std::atomic<uint64> m_droppedEvents[MAX_LOGS_TABLES];
+
+        // World thread only
+        std::vector<LogsDatabaseEvent> m_writtenBatch[MAX_LOGS_TABLES];
+        std::atomic<uint64> m_writtenEvents[MAX_LOGS_TABLES];
+        std::atomic<uint64> m_statements;
+        std::atomic<uint64> m_deferredUpdates;
+        uint64 m_reportedDrops;
+        uint32 m_lastWriteTime;
+        FILE* m_files[MAX_LOGS_TABLES];
+
+        uint32 m_maxRows;
+        uint32 m_delay;
+        uint32 m_maxEvents;
+        uint32 m_maxQueuedQueries;
+        std::string m_directory;
+};
+
+#define sLogsDatabaseWriter MaNGOS::Singleton<LogsDatabaseWriter>::Instance()
+
+#endif
@@ -64,14 +64,8 @@ int MapSocket::ProcessIncoming(WorldPacket* new_pct)
     return 0;
 }
 
-int MapSocket::iSendPacket(const WorldPacket& pct)
+uint8 MapSocket::BuildHeader(const WorldPacket& pct, char* dest)
 {
-    if (m_OutBuffer->space() < pct.size() + sizeof(ClientPktHeader))
-    {
-        errno = ENOBUFS;
-        return -1;
-    }
-
     ClientPktHeader header;
 
     header.cmd = pct.GetOpcode();
@@ -82,14 +76,8 @@ int MapSocket::iSendPacket(const WorldPacket& pct)
 
     m_Crypt.EncryptSend((uint8*) & header, sizeof(header));
 
-    if (m_OutBuffer->copy((char*) & header, sizeof(header)) == -1)
-        ACE_ASSERT(false);
-
-    if (!pct.empty())
-        if (m_OutBuffer->copy((char*) pct.contents(), pct.size()) == -1)
-            ACE_ASSERT(false);
-
-    return 0;
+    memcpy(dest, &header, sizeof(header));
+    return sizeof(header);
 }
 
 int MapSocket::OnSocketOpen()
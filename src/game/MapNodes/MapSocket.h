@@ -20,7 +20,7 @@ class MapSocket: public MangosSocket<NodeSession, MapSocket, NoCrypt>
     protected:
         int OnSocketOpen();
         int ProcessIncoming (WorldPacket* new_pct);
-        int iSendPacket (const WorldPacket& pct);
+        uint8 BuildHeader (const WorldPacket& pct, char* dest);
 };
 
 #endif // MAPSOCKET_H
@@ -30,12 +30,15 @@
 #include "Policies/SingletonImp.h"
 #include "Util.h"
 #include "SQLStorages.h"
+#include "ace/Mem_Map.h"
 
 char const* MAP_MAGIC         = "MAPS";
 char const* MAP_VERSION_MAGIC = "z1.3";
 char const* MAP_AREA_MAGIC    = "AREA";
 char const* MAP_HEIGHT_MAGIC  = "MHGT";
 char const* MAP_LIQUID_MAGIC  = "MLIQ";
+char const* MAP_TILE_MAGIC    = "MTIL";
+char const* MAP_TILE_VERSION_MAGIC = "t1.0";
 
 GridMap::GridMap()
 {
@@ -117,14 +120,110 @@ bool GridMap::loadData(char* filename)
     return false;
 }
 
+bool GridMap::loadTileData(char const* filename)
+{
+    // Unload old data if exist
+    unloadData();
+
+    // Missing tile is not an error, the caller falls back to the .map file
+    std::unique_ptr<ACE_Mem_Map> mapping(new ACE_Mem_Map());
+    if (mapping->map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) != 0)
+        return false;
+    // The mapping stays valid without the file descriptor: a preloaded continent maps thousands of tiles
+    mapping->close_handle();
+
+    uint8 const* base = static_cast<uint8 const*>(mapping->addr());
+    size_t fileSize = mapping->size();
+    GridMapTileHeader const* header = reinterpret_cast<GridMapTileHeader const*>(base);
+    if (!base || fileSize < sizeof(GridMapTileHeader) ||
+            header->tileMagic    != *((uint32 const*)(MAP_TILE_MAGIC)) ||
+            header->versionMagic != *((uint32 const*)(MAP_TILE_VERSION_MAGIC)) ||
+            header->fileSize     != fileSize)
+    {
+        sLog.outError("Tile file '%s' is non-compatible version or truncated. Please, convert it again using tileconverter.", filename);
+        return false;
+    }
+
+    // Sections are used in place: reject anything out of bounds or misaligned
+    auto section = [&](uint32 offset, size_t size) -> void*
+    {
+        if (!offset || offset % MAP_TILE_ALIGNMENT || offset + size > fileSize)
+            return nullptr;
+        return const_cast<uint8*>(base + offset);
+    };
+
+    if (header->area.fourcc == *((uint32 const*)(MAP_AREA_MAGIC)))
+    {
+        m_gridArea = header->area.gridArea;
+        if (!(header->area.flags & MAP_AREA_NO_AREA))
+            m_area_map = static_cast<uint16*>(section(header->areaMapOffset, sizeof(uint16) * 16 * 16));
+    }
+
+    if (header->height.fourcc == *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+    {
+        m_gridHeight = header->height.gridHeight;
+        uint32 flags = header->height.flags;
+        if (!(flags & MAP_HEIGHT_NO_HEIGHT))
+        {
+            size_t valueSize = sizeof(float);
+            if (flags & MAP_HEIGHT_AS_INT16)
+            {
+                valueSize = sizeof(uint16);
+                m_gridIntHeightMultiplier = (header->height.gridMaxHeight - header->height.gridHeight) / 65535;
+                m_gridGetHeight = &GridMap::getHeightFromUint16;
+            }
+            else if (flags & MAP_HEIGHT_AS_INT8)
+            {
+                valueSize = sizeof(uint8);
+                m_gridIntHeightMultiplier = (header->height.gridMaxHeight - header->height.gridHeight) / 255;
+                m_gridGetHeight = &GridMap::getHeightFromUint8;
+            }
+            else
+                m_gridGetHeight = &GridMap::getHeightFromFloat;
+
+            m_V9 = static_cast<float*>(section(header->heightV9Offset, valueSize * 129 * 129));
+            m_V8 = static_cast<float*>(section(header->heightV8Offset, valueSize * 128 * 128));
+            if (!m_V9 || !m_V8)
+                m_gridGetHeight = &GridMap::getHeightFromFlat;
+        }
+    }
+
+    if (header->liquid.fourcc == *((uint32 const*)(MAP_LIQUID_MAGIC)))
+    {
+        m_liquidType    = header->liquid.liquidType;
+        m_liquid_offX   = header->liquid.offsetX;
+        m_liquid_offY   = header->liquid.offsetY;
+        m_liquid_width  = header->liquid.width;
+        m_liquid_height = header->liquid.height;
+        m_liquidLevel   = header->liquid.liquidLevel;
+
+        if (!(header->liquid.flags & MAP_LIQUID_NO_TYPE))
+        {
+            m_liquidEntry = static_cast<uint16*>(section(header->liquidEntryOffset, sizeof(uint16) * 16 * 16));
+            m_liquidFlags = static_cast<uint8*>(section(header->liquidFlagsOffset, sizeof(uint8) * 16 * 16));
+        }
+        if (!(header->liquid.flags & MAP_LIQUID_NO_HEIGHT))
+            m_liquid_map = static_cast<float*>(section(header->liquidMapOffset, sizeof(float) * m_liquid_width * m_liquid_height));
+    }
+
+    m_tileMapping = std::move(mapping);
+    return true;
+}
+
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    // Mapped sections belong to the page cache, only heap arrays are freed
+    if (m_tileMapping)
+        m_tileMapping.reset();
+    else
+    {
+        delete[] m_area_map;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] m_liquidEntry;
+        delete[] m_liquidFlags;
+        delete[] m_liquid_map;
+    }
 
     m_area_map = NULL;
     m_V9 = NULL;
@@ -604,6 +703,24 @@ GridMapLiquidStatus GridMap::getLiquidStatus(float x, float y, float z, uint8 Re
 
 bool GridMap::ExistMap(uint32 mapid, int gx, int gy)
 {
+    if (sWorld.getConfig(CONFIG_BOOL_TERRAIN_MAPPED_TILES))
+    {
+        std::string tilePath = sWorld.GetDataPath() + "maps/%03u%02u%02u.tile";
+        char tileName[512];
+        snprintf(tileName, sizeof(tileName), tilePath.c_str(), mapid, gy, gx);
+
+        if (FILE* tf = fopen(tileName, "rb"))
+        {
+            GridMapTileHeader header;
+            bool valid = fread(&header, sizeof(header), 1, tf) == 1 &&
+                         header.tileMagic    == *((uint32 const*)(MAP_TILE_MAGIC)) &&
+                         header.versionMagic == *((uint32 const*)(MAP_TILE_VERSION_MAGIC));
+            fclose(tf);
+            if (valid)
+                return true;
+        }
+    }
+
     int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
     char* tmp = new char[len];
     snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapid, gy, gx);
@@ -662,6 +779,7 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
         {
             m_GridMaps[i][k] = NULL;
             m_GridRef[i][k] = 0;
+            m_GridGeometryLoaded[i][k] = false;
         }
     }
 
@@ -701,7 +819,7 @@ GridMap* TerrainInfo::Load(const uint32 x, const uint32 y)
 
     // quick check if GridMap already loaded
     GridMap* pMap = m_GridMaps[x][y];
-    if (!pMap)
+    if (!pMap || !m_GridGeometryLoaded[x][y])
         pMap = LoadMapAndVMap(x, y);
 
     return pMap;
@@ -738,18 +856,31 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
             GridMap* pMap = m_GridMaps[x][y];
 
             // delete those GridMap objects which have refcount = 0
-            if (pMap && iRef == 0)
+            // (preloaded grids may have no geometry, they are referenced until the map loads them)
+            if (pMap && iRef == 0 && (m_GridGeometryLoaded[x][y] || !pMap->IsMapped()))
             {
-                m_GridMaps[x][y] = NULL;
-                // delete grid data if reference count == 0
-                pMap->unloadData();
-                delete pMap;
+                // against Preload() from the grid preload workers
+                LOCK_GUARD lock(m_mutex);
 
-                // unload VMAPS...
-                VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
+                // mapped tiles cost no private memory, keep them for the next visit
+                if (!pMap->IsMapped())
+                {
+                    m_GridMaps[x][y] = NULL;
+                    // delete grid data if reference count == 0
+                    pMap->unloadData();
+                    delete pMap;
+                }
+
+                if (m_GridGeometryLoaded[x][y])
+                {
+                    m_GridGeometryLoaded[x][y] = false;
+
+                    // unload VMAPS...
+                    VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
 
-                // unload mmap...
-                MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
+                    // unload mmap...
+                    MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
+                }
             }
         }
     }
@@ -1108,7 +1239,7 @@ GridMap* TerrainInfo::GetGrid(const float x, const float y)
 
     // quick check if GridMap already loaded
     GridMap* pMap = m_GridMaps[gx][gy];
-    if (!pMap)
+    if (!pMap || !m_GridGeometryLoaded[gx][gy])
         pMap = LoadMapAndVMap(gx, gy);
 
     return pMap;
@@ -1117,28 +1248,15 @@ GridMap* TerrainInfo::GetGrid(const float x, const float y)
 GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 {
     // double checked lock pattern
-    if (!m_GridMaps[x][y])
+    if (!m_GridMaps[x][y] || !m_GridGeometryLoaded[x][y])
     {
         LOCK_GUARD lock(m_mutex);
 
         if (!m_GridMaps[x][y])
-        {
-            GridMap* map = new GridMap();
-
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, y, x);
-
-            if (!map->loadData(tmp))
-            {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
-            }
-
-            delete[] tmp;
-            m_GridMaps[x][y] = map;
+            m_GridMaps[x][y] = LoadGridMap(x, y);
 
+        if (!m_GridGeometryLoaded[x][y])
+        {
             // load VMAPs for current map/grid...
             const MapEntry* i_mapEntry = sMapStorage.LookupEntry<MapEntry>(m_mapId);
             const char* mapName = i_mapEntry ? i_mapEntry->name : "UNNAMEDMAP\x0";
@@ -1158,12 +1276,99 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
             // load navmesh
             MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+
+            m_GridGeometryLoaded[x][y] = true;
         }
     }
 
     return  m_GridMaps[x][y];
 }
 
+GridMap* TerrainInfo::LoadGridMap(const uint32 x, const uint32 y) const
+{
+    GridMap* map = new GridMap();
+
+    // shared read-only tile first, private copy of the .map file otherwise
+    if (sWorld.getConfig(CONFIG_BOOL_TERRAIN_MAPPED_TILES))
+    {
+        std::string tilePath = sWorld.GetDataPath() + "maps/%03u%02u%02u.tile";
+        char tileName[512];
+        snprintf(tileName, sizeof(tileName), tilePath.c_str(), m_mapId, y, x);
+        if (map->loadTileData(tileName))
+            return map;
+    }
+
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, y, x);
+
+    if (!map->loadData(tmp))
+    {
+        sLog.outError("Error load map file: \n %s\n", tmp);
+        // ASSERT(false);
+    }
+
+    delete[] tmp;
+    return map;
+}
+
+void TerrainInfo::Preload(const uint32 x, const uint32 y, std::vector<std::string>& models)
+{
+    // written by LoadMapAndVMap from the map threads, only read them under the lock
+    bool mapLoaded;
+    bool geometryLoaded;
+    {
+        LOCK_GUARD lock(m_mutex);
+        mapLoaded = m_GridMaps[x][y] != NULL;
+        geometryLoaded = m_GridGeometryLoaded[x][y];
+    }
+
+    if (!mapLoaded)
+    {
+        // read without the lock, map threads may need other grids meanwhile
+        GridMap* map = LoadGridMap(x, y);
+        {
+            LOCK_GUARD lock(m_mutex);
+            if (!m_GridMaps[x][y])
+            {
+                m_GridMaps[x][y] = map;
+                map = NULL;
+            }
+            geometryLoaded = m_GridGeometryLoaded[x][y];
+        }
+        if (map)
+        {
+            map->unloadData();
+            delete map;
+        }
+    }
+
+    if (geometryLoaded)
+        return;
+
+    // vmap and mmap tiles are inserted at Load(), in trees used by the map threads.
+    // Load the vmap models now, and read the mmap tile to have it in the page cache.
+    VMAP::VMapFactory::createOrGetVMapManager()->preloadMapModels((sWorld.GetDataPath() + "vmaps").c_str(), m_mapId, x, y, models);
+
+    if (sWorld.getConfig(CONFIG_BOOL_MMAP_ENABLED))
+    {
+        char fileName[512];
+        snprintf(fileName, sizeof(fileName), (sWorld.GetDataPath() + "mmaps/%03i%02i%02i.mmtile").c_str(), m_mapId, y, x);
+        if (FILE* file = fopen(fileName, "rb"))
+        {
+            char buffer[16 * 1024];
+            while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer)) {}
+            fclose(file);
+        }
+    }
+}
+
+void TerrainInfo::ReleasePreload(std::vector<std::string> const& models)
+{
+    VMAP::VMapFactory::createOrGetVMapManager()->releaseMapModels(models);
+}
+
 float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= NULL*/) const
 {
     if (const_cast<TerrainInfo*>(this)->GetGrid(x, y))
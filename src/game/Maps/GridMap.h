@@ -28,6 +28,8 @@
 #include <memory>
 #include <bitset>
 #include <list>
+#include <string>
+#include <vector>
 
 class Creature;
 class Unit;
@@ -36,6 +38,7 @@ class InstanceData;
 class Group;
 class BattleGround;
 class Map;
+class ACE_Mem_Map;
 struct LiquidTypeEntry;
 
 struct GridMapFileHeader
@@ -88,6 +91,27 @@ struct GridMapLiquidHeader
     float liquidLevel;
 };
 
+#define MAP_TILE_ALIGNMENT    64
+
+// Read-only terrain tile (.tile), converted from a .map file by contrib/extractor/tileconverter.
+// Sections start at aligned offsets so that they are used in place from a shared file mapping.
+// A section header with a null fourcc, or a null offset, means that the data is absent.
+struct GridMapTileHeader
+{
+    uint32 tileMagic;
+    uint32 versionMagic;
+    uint32 fileSize;
+    GridMapAreaHeader area;
+    GridMapHeightHeader height;
+    GridMapLiquidHeader liquid;
+    uint32 areaMapOffset;
+    uint32 heightV9Offset;
+    uint32 heightV8Offset;
+    uint32 liquidEntryOffset;
+    uint32 liquidFlagsOffset;
+    uint32 liquidMapOffset;
+};
+
 enum GridMapLiquidStatus
 {
     LIQUID_MAP_NO_WATER     = 0x00000000,
@@ -154,6 +178,9 @@ class GridMap
         uint8* m_liquidFlags;
         float* m_liquid_map;
 
+        // Set when the arrays above point into a mapped .tile file instead of the heap
+        std::unique_ptr<ACE_Mem_Map> m_tileMapping;
+
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
@@ -172,7 +199,9 @@ class GridMap
         ~GridMap();
 
         bool loadData(char* filaname);
+        bool loadTileData(char const* filename);
         void unloadData();
+        bool IsMapped() const { return m_tileMapping != nullptr; }
 
         static bool ExistMap(uint32 mapid, int gx, int gy);
         static bool ExistVMap(uint32 mapid, int gx, int gy);
@@ -245,6 +274,7 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<AtomicLong>
         // to cleanup unreferenced GridMap objects - they are too heavy
         // to destroy them dynamically, especially on highly populated servers
         // THIS METHOD IS NOT THREAD-SAFE!!!! AND IT SHOULDN'T BE THREAD-SAFE!!!!
+        // (only against Preload(), which may run at any time)
         void CleanUpGrids(const uint32 diff);
 
     protected:
@@ -252,6 +282,10 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<AtomicLong>
         // load/unload terrain data
         GridMap* Load(const uint32 x, const uint32 y);
         void Unload(const uint32 x, const uint32 y);
+        // ahead of Load(), from a grid preload worker: the GridMap, the vmap models
+        // (kept until ReleasePreload) and the mmap tile file. The grid must be referenced.
+        void Preload(const uint32 x, const uint32 y, std::vector<std::string>& models);
+        void ReleasePreload(std::vector<std::string> const& models);
 
     private:
         TerrainInfo(const TerrainInfo&);
@@ -259,6 +293,7 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<AtomicLong>
 
         GridMap* GetGrid(const float x, const float y);
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y);
+        GridMap* LoadGridMap(const uint32 x, const uint32 y) const;
 
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
@@ -267,6 +302,8 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<AtomicLong>
 
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        // vmaps and mmaps of the grid are loaded. Mapped GridMaps outlive their geometry.
+        bool m_GridGeometryLoaded[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         // global garbage collection timer
         ShortIntervalTimer i_timer;
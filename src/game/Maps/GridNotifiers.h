@@ -66,7 +66,7 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL MessageDeliverer
     {
         Player const& i_player;
-        WorldPacket *i_message;
+        BroadcastPacket i_message;
         bool i_toSelf;
         MessageDeliverer(Player const& pl, WorldPacket *msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
         void Visit(CameraMapType &m);
@@ -75,7 +75,7 @@ namespace MaNGOS
 
     struct MessageDelivererExcept
     {
-        WorldPacket*  i_message;
+        BroadcastPacket i_message;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldPacket *msg, Player const* skipped)
@@ -87,7 +87,7 @@ namespace MaNGOS
 
     struct MANGOS_DLL_DECL ObjectMessageDeliverer
     {
-        WorldPacket *i_message;
+        BroadcastPacket i_message;
         explicit ObjectMessageDeliverer(WorldPacket *msg) : i_message(msg) {}
         void Visit(CameraMapType &m);
         template<class SKIP> void Visit(GridRefManager<SKIP> &) {}
@@ -96,7 +96,7 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL MessageDistDeliverer
     {
         Player const& i_player;
-        WorldPacket *i_message;
+        BroadcastPacket i_message;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
@@ -110,7 +110,7 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL ObjectMessageDistDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket *i_message;
+        BroadcastPacket i_message;
         float i_dist;
         ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket *msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
         void Visit(CameraMapType &m);
@@ -201,6 +201,32 @@ namespace MaNGOS
     };
     */
 
+    // Checks that only accept objects within GetSearchRange() of their focus object let the
+    // searchers scan the packed positions of the cell (GridPositions) instead of the object list
+    template<class T, class Check, class Action>
+    inline auto VisitSearchCandidates(GridRefManager<T>& m, Check const& check, Action& action, int) -> decltype(check.GetSearchRange(), void())
+    {
+        WorldObject const& focus = check.GetFocusObject();
+        float range = check.GetSearchRange() + focus.GetObjectBoundingRadius();
+        auto visitor = [&action](WorldObject* obj) { return action(static_cast<T*>(obj)); };
+        m.GetPositions().VisitInRange(focus.GetPositionX(), focus.GetPositionY(), range, visitor);
+    }
+
+    template<class T, class Check, class Action>
+    inline void VisitSearchCandidates(GridRefManager<T>& m, Check const& /*check*/, Action& action, long)
+    {
+        for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+            if (!action(itr->getSource()))
+                return;
+    }
+
+    // Calls action(T*) for the objects of the container the check may accept, until it returns false
+    template<class T, class Check, class Action>
+    inline void VisitSearchCandidates(GridRefManager<T>& m, Check const& check, Action action)
+    {
+        VisitSearchCandidates(m, check, action, 0);
+    }
+
     // WorldObject searchers & workers
 
     template<class Check>
@@ -813,6 +839,7 @@ namespace MaNGOS
         public:
             AnyUnfriendlyUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range) : i_obj(obj), i_funit(funit), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Unit* u)
             {
                 if(!i_funit->CanSeeInWorld(u))
@@ -833,6 +860,7 @@ namespace MaNGOS
             AnyUnfriendlyVisibleUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range)
                 : i_obj(obj), i_funit(funit), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Unit* u)
             {
                 return u->isAlive()
@@ -851,6 +879,7 @@ namespace MaNGOS
         public:
             AnyFriendlyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Unit* u)
             {
                 if(u->isAlive() && i_obj->IsWithinDistInMap(u, i_range) && i_obj->IsFriendlyTo(u) && u->CanSeeInWorld(i_obj))
@@ -867,6 +896,7 @@ namespace MaNGOS
         public:
             AnyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Unit* u)
             {
                 if(u->isAlive() && i_obj->IsWithinDistInMap(u, i_range) && u->CanSeeInWorld(i_obj))
@@ -885,6 +915,7 @@ namespace MaNGOS
         public:
             NearestAttackableUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, Unit const* owner, float range) : i_obj(obj), i_funit(funit), i_owner(owner), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Unit* u)
             {
                 if (i_owner && i_owner->IsPlayer() && u->IsPlayer() && !i_owner->IsPvP() && !i_owner->ToPlayer()->IsInDuelWith(u->ToPlayer()))
@@ -918,6 +949,7 @@ namespace MaNGOS
                 i_targetForUnit = i_originalCaster->isType(TYPEMASK_UNIT);
             }
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Unit* u)
             {
                 // Check contains checks for: live, non-selectable, non-attackable flags, flight check and GM check, ignore totems
@@ -959,6 +991,7 @@ namespace MaNGOS
                 i_targetForUnit = i_originalCaster->isType(TYPEMASK_UNIT);
             }
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Unit* u)
             {
                 // Check contains checks for: live, non-selectable, non-attackable flags, flight check and GM check, ignore totems
@@ -1230,6 +1263,7 @@ namespace MaNGOS
         public:
             AnyPlayerInObjectRangeCheck(WorldObject const* obj, float range, bool distance_3d=true) : i_obj(obj), i_range(range), b_3dDist(distance_3d) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Player* u)
             {
                 if(u->isAlive() && i_obj->IsWithinDistInMap(u, i_range, b_3dDist))
@@ -1249,6 +1283,7 @@ namespace MaNGOS
             AnyPlayerInObjectRangeWithAuraCheck(WorldObject const* obj, float range, uint32 spellId)
                 : i_obj(obj), i_range(range), i_spellId(spellId) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            float GetSearchRange() const { return i_range; }
             bool operator()(Player* u)
             {
                 return u->isAlive()
@@ -438,14 +438,13 @@ void MaNGOS::UnitSearcher<Check>::Visit(CreatureMapType &m)
     if (i_object)
         return;
 
-    for(CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitSearchCandidates(m, i_check, [this](Creature* obj)
     {
-        if (i_check(itr->getSource()))
-        {
-            i_object = itr->getSource();
-            return;
-        }
-    }
+        if (!i_check(obj))
+            return true;
+        i_object = obj;
+        return false;
+    });
 }
 
 template<class Check>
@@ -455,50 +454,57 @@ void MaNGOS::UnitSearcher<Check>::Visit(PlayerMapType &m)
     if (i_object)
         return;
 
-    for(PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitSearchCandidates(m, i_check, [this](Player* obj)
     {
-        if (i_check(itr->getSource()))
-        {
-            i_object = itr->getSource();
-            return;
-        }
-    }
+        if (!i_check(obj))
+            return true;
+        i_object = obj;
+        return false;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(CreatureMapType &m)
 {
-    for(CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitSearchCandidates(m, i_check, [this](Creature* obj)
     {
-        if (i_check(itr->getSource()))
-            i_object = itr->getSource();
-    }
+        if (i_check(obj))
+            i_object = obj;
+        return true;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType &m)
 {
-    for(PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitSearchCandidates(m, i_check, [this](Player* obj)
     {
-        if (i_check(itr->getSource()))
-            i_object = itr->getSource();
-    }
+        if (i_check(obj))
+            i_object = obj;
+        return true;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType &m)
 {
-    for(PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    VisitSearchCandidates(m, i_check, [this](Player* obj)
+    {
+        if (i_check(obj))
+            i_objects.push_back(obj);
+        return true;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType &m)
 {
-    for(CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    VisitSearchCandidates(m, i_check, [this](Creature* obj)
+    {
+        if (i_check(obj))
+            i_objects.push_back(obj);
+        return true;
+    });
 }
 
 // Creature searchers
@@ -545,32 +551,35 @@ void MaNGOS::PlayerSearcher<Check>::Visit(PlayerMapType &m)
     if (i_object)
         return;
 
-    for(PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitSearchCandidates(m, i_check, [this](Player* obj)
     {
-        if (i_check(itr->getSource()))
-        {
-            i_object = itr->getSource();
-            return;
-        }
-    }
+        if (!i_check(obj))
+            return true;
+        i_object = obj;
+        return false;
+    });
 }
 
 template<class Check>
 void MaNGOS::PlayerLastSearcher<Check>::Visit(PlayerMapType &m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitSearchCandidates(m, i_check, [this](Player* obj)
     {
-        if (i_check(itr->getSource()))
-            i_object = itr->getSource();
-    }
+        if (i_check(obj))
+            i_object = obj;
+        return true;
+    });
 }
 
 template<class Check>
 void MaNGOS::PlayerListSearcher<Check>::Visit(PlayerMapType &m)
 {
-    for(PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    VisitSearchCandidates(m, i_check, [this](Player* obj)
+    {
+        if (i_check(obj))
+            i_objects.push_back(obj);
+        return true;
+    });
 }
 
 template<class Builder>
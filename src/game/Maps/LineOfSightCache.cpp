@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "LineOfSightCache.h"
+#include <cstring>
+
+// A set bit 63 on the "to" point marks results that include the dynamic tree
+#define LOS_CACHE_DYNAMIC_FLAG  (uint64(1) << 63)
+
+LineOfSightCache::LineOfSightCache() : m_dynamicGeneration(0), m_hits(0), m_misses(0), m_invalidations(0)
+{
+    // null keys never match: no map coordinate rounds to the lowest packed value
+    memset(m_entries, 0, sizeof(m_entries));
+    for (uint32 i = 0; i < LOS_CACHE_AREAS; ++i)
+        m_areaGenerations[i] = 0;
+}
+
+uint64 LineOfSightCache::PackPoint(float x, float y, float z)
+{
+    // 21 bits per axis, +/- 1M steps of LOS_CACHE_GRID_SIZE
+    uint64 qx = uint64(int64(std::floor(x / LOS_CACHE_GRID_SIZE + 0.5f)) + (1 << 20)) & 0x1FFFFF;
+    uint64 qy = uint64(int64(std::floor(y / LOS_CACHE_GRID_SIZE + 0.5f)) + (1 << 20)) & 0x1FFFFF;
+    uint64 qz = uint64(int64(std::floor(z / LOS_CACHE_GRID_SIZE + 0.5f)) + (1 << 20)) & 0x1FFFFF;
+    return qx | (qy << 21) | (qz << 42);
+}
+
+uint32 LineOfSightCache::GetSlot(uint64 from, uint64 to)
+{
+    uint64 hash = from * UI64LIT(0x9E3779B97F4A7C15) ^ (to + (to << 17) + (to >> 23));
+    hash ^= hash >> 31;
+    return uint32(hash) & (LOS_CACHE_SIZE - 1);
+}
+
+bool LineOfSightCache::Find(float x1, float y1, float z1, float x2, float y2, float z2, bool checkDynLos, uint32 now, bool& result)
+{
+    uint64 from = PackPoint(x1, y1, z1);
+    uint64 to = PackPoint(x2, y2, z2) | (checkDynLos ? LOS_CACHE_DYNAMIC_FLAG : 0);
+    uint32 slot = GetSlot(from, to);
+    uint32 generation = checkDynLos ? GetDynamicGeneration(x1, y1, x2, y2) : 0;
+
+    std::lock_guard<std::mutex> guard(m_locks[slot % LOS_CACHE_LOCKS]);
+    Entry const& entry = m_entries[slot];
+    if (entry.from != from || entry.to != to || int32(entry.expireTime - now) <= 0 ||
+            (checkDynLos && entry.generation != generation))
+    {
+        ++m_misses;
+        return false;
+    }
+
+    result = entry.result;
+    ++m_hits;
+    return true;
+}
+
+void LineOfSightCache::Store(float x1, float y1, float z1, float x2, float y2, float z2, bool checkDynLos,
+                             uint32 generation, uint32 expireTime, bool result)
+{
+    uint64 from = PackPoint(x1, y1, z1);
+    uint64 to = PackPoint(x2, y2, z2) | (checkDynLos ? LOS_CACHE_DYNAMIC_FLAG : 0);
+    uint32 slot = GetSlot(from, to);
+
+    std::lock_guard<std::mutex> guard(m_locks[slot % LOS_CACHE_LOCKS]);
+    Entry& entry = m_entries[slot];
+    entry.from = from;
+    entry.to = to;
+    entry.expireTime = expireTime;
+    entry.generation = generation;
+    entry.result = result;
+}
+
+uint32 LineOfSightCache::GetDynamicGeneration(float x1, float y1, float x2, float y2) const
+{
+    int32 minX = GetArea(std::min(x1, x2));
+    int32 maxX = GetArea(std::max(x1, x2));
+    int32 minY = GetArea(std::min(y1, y2));
+    int32 maxY = GetArea(std::max(y1, y2));
+    if ((maxX - minX + 1) * (maxY - minY + 1) > LOS_CACHE_SEGMENT_AREAS)
+        return m_dynamicGeneration.load(std::memory_order_acquire);
+
+    // The generations only grow, so their sum changes as soon as one of them does
+    uint32 generation = 0;
+    for (int32 x = minX; x <= maxX; ++x)
+        for (int32 y = minY; y <= maxY; ++y)
+            generation += m_areaGenerations[GetAreaSlot(x, y)].load(std::memory_order_acquire);
+    return generation;
+}
+
+void LineOfSightCache::InvalidateDynamic(float minX, float minY, float maxX, float maxY)
+{
+    int32 areaMinX = GetArea(minX);
+    int32 areaMaxX = GetArea(maxX);
+    int32 areaMinY = GetArea(minY);
+    int32 areaMaxY = GetArea(maxY);
+    if ((areaMaxX - areaMinX + 1) * (areaMaxY - areaMinY + 1) >= LOS_CACHE_AREAS)
+    {
+        for (uint32 i = 0; i < LOS_CACHE_AREAS; ++i)
+            m_areaGenerations[i].fetch_add(1, std::memory_order_release);
+    }
+    else
+    {
+        for (int32 x = areaMinX; x <= areaMaxX; ++x)
+            for (int32 y = areaMinY; y <= areaMaxY; ++y)
+                m_areaGenerations[GetAreaSlot(x, y)].fetch_add(1, std::memory_order_release);
+    }
+    m_dynamicGeneration.fetch_add(1, std::memory_order_release);
+    ++m_invalidations;
+}
+
+LineOfSightCacheStats LineOfSightCache::GetStats() const
+{
+    LineOfSightCacheStats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.invalidations = m_invalidations;
+    return stats;
+}
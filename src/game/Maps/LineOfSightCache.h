@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_LINEOFSIGHTCACHE_H
+#define MANGOS_LINEOFSIGHTCACHE_H
+
+#include "Common.h"
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+#define LOS_CACHE_SIZE          2048                        // entries per map, power of 2
+#define LOS_CACHE_LOCKS         16
+#define LOS_CACHE_GRID_SIZE     0.5f                        // endpoints closer than this share a result
+#define LOS_CACHE_AREA_SIZE     64.0f                       // dynamic results are invalidated per area of this size
+#define LOS_CACHE_AREAS         256                         // area generations, hashed, power of 2
+#define LOS_CACHE_SEGMENT_AREAS 16                          // longer segments use the generation of the whole map
+
+struct LineOfSightCacheStats
+{
+    uint64 hits;
+    uint64 misses;
+    uint64 invalidations;
+};
+
+// Short-lived results of Map::isInLineOfSight, keyed on both endpoints rounded to LOS_CACHE_GRID_SIZE.
+// Direct mapped: a new pair simply replaces the one stored in its slot.
+// Results that include the dynamic tree are also dropped as soon as a gameobject model is
+// added, removed, moved or toggled in one of the areas their segment crosses (see InvalidateDynamic),
+// so a transport moving every tick only drops the results around it.
+class LineOfSightCache
+{
+    public:
+        LineOfSightCache();
+
+        bool Find(float x1, float y1, float z1, float x2, float y2, float z2, bool checkDynLos, uint32 now, bool& result);
+        // generation: GetDynamicGeneration() of the segment read before the query, so a change during the query discards the result
+        void Store(float x1, float y1, float z1, float x2, float y2, float z2, bool checkDynLos,
+                   uint32 generation, uint32 expireTime, bool result);
+
+        uint32 GetDynamicGeneration(float x1, float y1, float x2, float y2) const;
+        // A model with these bounds changed in the dynamic tree
+        void InvalidateDynamic(float minX, float minY, float maxX, float maxY);
+        LineOfSightCacheStats GetStats() const;
+
+    private:
+        struct Entry
+        {
+            uint64 from;
+            uint64 to;
+            uint32 expireTime;
+            uint32 generation;
+            bool result;
+        };
+
+        static uint64 PackPoint(float x, float y, float z);
+        static uint32 GetSlot(uint64 from, uint64 to);
+        static int32 GetArea(float coord) { return int32(std::floor(coord / LOS_CACHE_AREA_SIZE)); }
+        static uint32 GetAreaSlot(int32 x, int32 y) { return (uint32(x) * 73856093u ^ uint32(y) * 19349663u) & (LOS_CACHE_AREAS - 1); }
+
+        Entry m_entries[LOS_CACHE_SIZE];
+        std::mutex m_locks[LOS_CACHE_LOCKS];
+        std::atomic<uint32> m_dynamicGeneration;                // any change on the map
+        std::atomic<uint32> m_areaGenerations[LOS_CACHE_AREAS];
+
+        std::atomic<uint64> m_hits;
+        std::atomic<uint64> m_misses;
+        std::atomic<uint64> m_invalidations;
+};
+
+#endif
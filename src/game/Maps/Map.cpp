@@ -39,6 +39,7 @@
 #include "VMapFactory.h"
 #include "BattleGroundMgr.h"
 #include "DynamicTree.h"
+#include "GameObjectModel.h"
 #include "RegularGrid.h"
 #include "PathFinder.h"
 #include "Detour/Include/DetourNavMesh.h"
@@ -54,11 +55,18 @@
 #include "GameEventMgr.h"
 #include "world/world_event_wareffort.h"
 #include "LFGMgr.h"
+#include "MovementGenerator.h"
 
 Map::~Map()
 {
     UnloadAll(true);
 
+    if (m_gridPreloads)
+    {
+        m_gridPreloads->Wait();
+        UpdatePreloadedGrids(true);
+    }
+
     if (!m_scriptSchedule.empty())
         sScriptMgr.DecreaseScheduledScriptCount(m_scriptSchedule.size());
 
@@ -80,6 +88,8 @@ Map::~Map()
 
     delete m_weatherSystem;
     m_weatherSystem = NULL;
+
+    sTickProfiler.ReleaseMapProfile(m_tickProfile);
 }
 
 void Map::LoadMapAndVMap(int gx, int gy)
@@ -125,10 +135,14 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
     //add reference for TerrainData object
     m_TerrainData->AddRef();
 
+    if (ThreadPool* preloadPool = sMapMgr.GetGridPreloadPool())
+        m_gridPreloads.reset(new ThreadPool::TaskGroup(preloadPool));
+
     m_persistentState = sMapPersistentStateMgr.AddPersistentState(i_mapEntry, GetInstanceId(), 0, IsDungeon());
     m_persistentState->SetUsedByMapState(this);
 
     m_weatherSystem = new WeatherSystem(this);
+    m_tickProfile = sTickProfiler.CreateMapProfile(id, InstanceId);
 }
 
 // Nostalrius
@@ -284,6 +298,76 @@ Map::EnsureGridCreated(const GridPair &p)
     }
 }
 
+void Map::PreloadGridAhead(float oldX, float oldY, float x, float y)
+{
+    if (!m_gridPreloads)
+        return;
+
+    float dx = x - oldX;
+    float dy = y - oldY;
+    float dist = sqrt(dx * dx + dy * dy);
+    // Not moving, or teleported: the destination is loaded at enter anyway
+    if (dist < 0.1f || dist > SIZE_OF_GRIDS)
+        return;
+
+    float ahead = GetGridActivationDistance() + sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_DISTANCE);
+    GridPair p = MaNGOS::ComputeGridPair(x + dx / dist * ahead, y + dy / dist * ahead);
+    if (p.x_coord >= MAX_NUMBER_OF_GRIDS || p.y_coord >= MAX_NUMBER_OF_GRIDS)
+        return;
+
+    // terrain coordinates, see EnsureGridCreated
+    uint32 gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    uint32 gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+    if (m_bLoadedGrids[gx][gy])
+        return;
+
+    PreloadedGrid* preload;
+    {
+        ACE_Guard<MapMutexType> guard(m_preloadedGridsLock);
+        std::unique_ptr<PreloadedGrid>& entry = m_preloadedGrids[gx * MAX_NUMBER_OF_GRIDS + gy];
+        if (entry)
+            return;
+        // the grid must not be cleaned up before the map loads it
+        m_TerrainData->RefGrid(gx, gy);
+        entry.reset(new PreloadedGrid(WorldTimer::getMSTime()));
+        preload = entry.get();
+    }
+
+    TerrainInfo* terrain = m_TerrainData;
+    m_gridPreloads->Run([terrain, preload, gx, gy]()
+    {
+        terrain->Preload(gx, gy, preload->models);
+        preload->done = true;
+    });
+}
+
+void Map::UpdatePreloadedGrids(bool all)
+{
+    ACE_Guard<MapMutexType> guard(m_preloadedGridsLock);
+    if (m_preloadedGrids.empty())
+        return;
+
+    // not reached in a grid cleanup delay: the player turned back
+    uint32 expireDelay = sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN);
+    for (PreloadedGridsMap::iterator itr = m_preloadedGrids.begin(); itr != m_preloadedGrids.end();)
+    {
+        PreloadedGrid* preload = itr->second.get();
+        uint32 gx = itr->first / MAX_NUMBER_OF_GRIDS;
+        uint32 gy = itr->first % MAX_NUMBER_OF_GRIDS;
+        // the models are written by the worker until done
+        if (!preload->done || (!all && !m_bLoadedGrids[gx][gy] && WorldTimer::getMSTimeDiffToNow(preload->requestTime) < expireDelay))
+        {
+            ++itr;
+            continue;
+        }
+
+        // the map holds its own references on what it loaded
+        m_TerrainData->ReleasePreload(preload->models);
+        m_TerrainData->UnrefGrid(gx, gy);
+        itr = m_preloadedGrids.erase(itr);
+    }
+}
+
 void
 Map::EnsureGridLoadedAtEnter(const Cell &cell, Player *player)
 {
@@ -661,24 +745,6 @@ inline void Map::UpdateActiveCellsCallback(uint32 diff, uint32 now, uint32 threa
     }
 }
 
-class MapAsynchCellsWorker : public ACE_Based::Runnable
-{
-public:
-    MapAsynchCellsWorker(int i, int nthreads, uint32 _diff, uint32 _now, uint32 _step, Map* m) : threadIdx(i), nThreads(nthreads), now(_now), diff(_diff), map(m), step(_step)
-    {
-    }
-
-    virtual void run()
-    {
-        map->UpdateActiveCellsCallback(diff, now, threadIdx, nThreads, step);
-    }
-    int threadIdx;
-    int nThreads;
-    uint32 diff, now, step;
-    Map* map;
-};
-
-
 inline void Map::UpdateActiveCellsAsynch(uint32 now, uint32 diff)
 {
     resetMarkedCells();
@@ -691,25 +757,14 @@ inline void Map::UpdateActiveCellsAsynch(uint32 now, uint32 diff)
         MarkCellsAroundObject(*m_activeNonPlayersIter);
 
     const int nthreads = sWorld.getConfig(CONFIG_UINT32_MTCELLS_THREADS);
-    // Step 1
-    std::vector<ACE_Based::Thread*> threads;
-    for (int i = 0; i < (nthreads - 1); ++i)
-        threads.push_back(new ACE_Based::Thread(new MapAsynchCellsWorker(i, nthreads, diff, now, 0, this)));
-    UpdateActiveCellsCallback(diff, now, nthreads-1, nthreads, 0);
-    for (int i = 0; i < threads.size(); ++i)
-    {
-        threads[i]->wait();
-        delete threads[i];
-    }
-    // Step 2
-    threads.clear();
-    for (int i = 0; i < (nthreads - 1); ++i)
-        threads.push_back(new ACE_Based::Thread(new MapAsynchCellsWorker(i, nthreads, diff, now, 1, this)));
-    UpdateActiveCellsCallback(diff, now, nthreads-1, nthreads, 1);
-    for (int i = 0; i < threads.size(); ++i)
+    ThreadPool::TaskGroup cellsUpdate(sMapMgr.GetUpdatePool());
+    // Step 1, then step 2 once every stripe of step 1 is done
+    for (uint32 step = 0; step < 2; ++step)
     {
-        threads[i]->wait();
-        delete threads[i];
+        for (int i = 0; i < (nthreads - 1); ++i)
+            cellsUpdate.Run([this, diff, now, i, nthreads, step]() { UpdateActiveCellsCallback(diff, now, i, nthreads, step); });
+        UpdateActiveCellsCallback(diff, now, nthreads-1, nthreads, step);
+        cellsUpdate.Wait();
     }
 }
 
@@ -737,27 +792,35 @@ inline void Map::UpdateActiveCellsSynch(uint32 now, uint32 diff)
     }
 }
 
-class UnitsMovementUpdater : public ACE_Based::Runnable
+class UnitsMovementUpdater
 {
 public:
-    UnitsMovementUpdater(int i, int nthreads, std::set<Unit*>& _updates, uint32 _diff) : threadIdx(i), nThreads(nthreads), updates(_updates), diff(_diff)
+    UnitsMovementUpdater(size_t _begin, size_t _end, std::vector<Unit*> const& _updates) : begin(_begin), end(_end), updates(_updates)
     {
     }
 
-    virtual void run()
+    // Each unit with the time elapsed since its own previous update
+    void run()
     {
-        int i = 0;
-        for (std::set<Unit*>::iterator iter = updates.begin(); iter != updates.end(); ++iter)
-            if (((++i) % nThreads) == threadIdx)
-                if ((*iter)->IsInWorld())
-                    (*iter)->GetMotionMaster()->UpdateMotionAsync(diff);
+        for (size_t i = begin; i < end; ++i)
+        {
+            MotionMaster* motion = updates[i]->GetMotionMaster();
+            uint32 diff = motion->TakeQueuedAsyncDiff();
+            if (updates[i]->IsInWorld())
+                motion->UpdateMotionAsync(diff);
+        }
     }
-    int threadIdx;
-    int nThreads;
-    std::set<Unit*>& updates;
-    uint32 diff;
+    size_t begin;
+    size_t end;
+    std::vector<Unit*> const& updates;
 };
 
+static Unit* GetMovementTarget(Unit* unit)
+{
+    MotionMaster* motion = unit->GetMotionMaster();
+    return motion->empty() ? nullptr : motion->top()->GetCurrentTarget();
+}
+
 inline void Map::UpdateCells(uint32 map_diff)
 {
     uint32 now = WorldTimer::getMSTime();
@@ -767,24 +830,57 @@ inline void Map::UpdateCells(uint32 map_diff)
     _lastCellsUpdate = now;
 
     /// update active cells around players and active objects
+    TickPhaseTimer cellsTimer(m_tickProfile.get(), TICK_PHASE_MAP_CELLS);
     if (IsContinent() && sWorld.getConfig(CONFIG_UINT32_MTCELLS_THREADS))
         UpdateActiveCellsAsynch(now, diff);
     else
         UpdateActiveCellsSynch(now, diff);
+}
 
-    int nthreads = sWorld.getConfig(CONFIG_UINT32_CONTINENTS_MOTIONUPDATE_THREADS);
-    if (IsContinent() && nthreads)
+// Path requests of the units updated since the previous batch. Run at every map update,
+// so that each unit moves on the tick it was updated.
+void Map::UpdateMovementBatch()
+{
+    TickPhaseTimer movementTimer(m_tickProfile.get(), TICK_PHASE_MAP_MOVEMENT);
+    _unitsMvtUpdateNow.clear();
+    unitsMvtUpdate.Drain(_unitsMvtUpdateNow);
+    if (!_unitsMvtUpdateNow.empty())
     {
-        std::vector<ACE_Based::Thread*> threads;
-        for (int i = 0; i < nthreads; ++i)
-            threads.push_back(new ACE_Based::Thread(new UnitsMovementUpdater(i, nthreads, unitsMvtUpdate, diff)));
-        for (int i = 0; i < threads.size(); ++i)
+        size_t count = _unitsMvtUpdateNow.size();
+        size_t nthreads = IsContinent() ? sWorld.getConfig(CONFIG_UINT32_CONTINENTS_MOTIONUPDATE_THREADS) : 0;
+        nthreads = std::max<size_t>(1, std::min(nthreads, count));
+
+        // Units chasing the same target are solved one after another on the same worker:
+        // their corridors hit the path cache and they share the worker's navmesh query.
+        if (sWorld.getConfig(CONFIG_BOOL_MOTIONUPDATE_BATCH))
         {
-            threads[i]->wait();
-            delete threads[i];
+            _unitsMvtTargets.resize(count);
+            for (size_t i = 0; i < count; ++i)
+                _unitsMvtTargets[i] = std::make_pair(GetMovementTarget(_unitsMvtUpdateNow[i]), _unitsMvtUpdateNow[i]);
+            std::sort(_unitsMvtTargets.begin(), _unitsMvtTargets.end());
+            for (size_t i = 0; i < count; ++i)
+                _unitsMvtUpdateNow[i] = _unitsMvtTargets[i].second;
         }
+
+        ThreadPool::TaskGroup motionUpdate(sMapMgr.GetUpdatePool());
+        size_t begin = 0;
+        for (size_t i = 0; i < nthreads && begin < count; ++i)
+        {
+            size_t end = std::max(begin + 1, count * (i + 1) / nthreads);
+            // never split a target group between two workers
+            while (end < count && !_unitsMvtTargets.empty() && _unitsMvtTargets[end].first && _unitsMvtTargets[end].first == _unitsMvtTargets[end - 1].first)
+                ++end;
+            UnitsMovementUpdater updater(begin, end, _unitsMvtUpdateNow);
+            if (end == count)
+                updater.run();
+            else
+                motionUpdate.Run([updater]() mutable { updater.run(); });
+            begin = end;
+        }
+        motionUpdate.Wait();
+        _unitsMvtTargets.clear();
     }
-    unitsMvtUpdate.clear();
+    _unitsMvtUpdateNow.clear();
 }
 
 
@@ -868,8 +964,11 @@ void Map::Update(uint32 t_diff)
 {
     uint32 updateMapTime = WorldTimer::getMSTime();
     uint32 timeDiff = 0;
+    TickProfile* profile = m_tickProfile.get();
+    TickPhaseTimer mapTimer(profile, TICK_PHASE_MAP);
     _dynamicTree.update(t_diff);
 
+    TickPhaseTimer sessionsTimer(profile, TICK_PHASE_MAP_SESSIONS);
     ProcessSessionPackets(PACKET_PROCESS_DB_QUERY); // TODO: Move somewhere else ?
     UpdateSessionsMovementAndSpellsIfNeeded();
     /// update worldsessions for existing players
@@ -884,25 +983,40 @@ void Map::Update(uint32 t_diff)
             pSession->Update(updater);
         }
     }
+    sessionsTimer.Stop();
     uint32 sessionsUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime);
 
     /// update players at tick
     UpdateSessionsMovementAndSpellsIfNeeded();
-    UpdatePlayers();
+    {
+        TickPhaseTimer playersTimer(profile, TICK_PHASE_MAP_PLAYERS);
+        UpdatePlayers();
+    }
     uint32 playersUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime) - sessionsUpdateTime;
 
     UpdateCells(t_diff);
+    UpdateMovementBatch();
     uint32 activeCellsUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime) - playersUpdateTime - sessionsUpdateTime;
 
     // Send world objects and item update field changes
-    SendObjectUpdates();
+    {
+        TickPhaseTimer objectUpdatesTimer(profile, TICK_PHASE_MAP_OBJECT_UPDATES);
+        SendObjectUpdates();
+    }
     uint32 objectsUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime) - activeCellsUpdateTime - playersUpdateTime - sessionsUpdateTime;
 
-    UpdateVisibilityForRelocations();
+    {
+        TickPhaseTimer visibilityTimer(profile, TICK_PHASE_MAP_VISIBILITY);
+        UpdateVisibilityForRelocations();
+    }
     uint32 visibilityUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime) - objectsUpdateTime - activeCellsUpdateTime - playersUpdateTime - sessionsUpdateTime;
 
     UpdateSessionsMovementAndSpellsIfNeeded();
-    UpdatePlayers();
+    {
+        TickPhaseTimer playersTimer(profile, TICK_PHASE_MAP_PLAYERS);
+        UpdatePlayers();
+    }
+    UpdateMovementBatch();
     uint32 playersUpdateTime2 = WorldTimer::getMSTimeDiffToNow(updateMapTime) - objectsUpdateTime - activeCellsUpdateTime - playersUpdateTime - sessionsUpdateTime - visibilityUpdateTime;
 
     RemoveCorpses();
@@ -914,6 +1028,8 @@ void Map::Update(uint32 t_diff)
     uint32 additionnalUpdateCounts = 0;
     if (_updateIdx >= 0)
     {
+        // Waiting for the other continents is not part of this map update
+        mapTimer.Stop();
         additionnalWaitTime = WorldTimer::getMSTime();
         sMapMgr.MarkContinentUpdateFinished(_updateIdx);
         while (!sMapMgr.IsContinentUpdateFinished())
@@ -924,9 +1040,11 @@ void Map::Update(uint32 t_diff)
 
             UpdateSessionsMovementAndSpellsIfNeeded();
             UpdatePlayers();
+            UpdateMovementBatch();
             ++additionnalUpdateCounts;
         }
         additionnalWaitTime = WorldTimer::getMSTimeDiffToNow(additionnalWaitTime);
+        mapTimer.Start();
     }
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
@@ -942,7 +1060,11 @@ void Map::Update(uint32 t_diff)
         }
     }
 
+    if (m_gridPreloads)
+        UpdatePreloadedGrids(false);
+
     ///- Process necessary scripts
+    TickPhaseTimer scriptsTimer(profile, TICK_PHASE_MAP_SCRIPTS);
     if (m_uiScriptedEventsTimer <= t_diff)
     {
         UpdateScriptedEvents();
@@ -955,9 +1077,13 @@ void Map::Update(uint32 t_diff)
 
     if (i_data)
         i_data->Update(t_diff);
+    scriptsTimer.Stop();
 
     m_weatherSystem->UpdateWeathers(t_diff);
 
+    mapTimer.Stop();
+    profile->EndTick();
+
     bool packetBroadcastSlow = sWorld.GetBroadcaster()->IsMapSlow(GetInstanceId());
     if (sWorld.getConfig(CONFIG_UINT32_PERFLOG_SLOW_MAP_UPDATE) && updateMapTime > sWorld.getConfig(CONFIG_UINT32_PERFLOG_SLOW_MAP_UPDATE))
         sLog.out(LOG_PERFORMANCE, "Update single map %3u inst %2u: %3ums "
@@ -1280,6 +1406,8 @@ Map::PlayerRelocation(Player *player, float x, float y, float z, float orientati
     Cell old_cell(old_val);
     Cell new_cell(new_val);
     bool same_cell = (new_cell == old_cell);
+    float oldX = player->GetPositionX();
+    float oldY = player->GetPositionY();
 
     player->Relocate(x, y, z, orientation);
 
@@ -1316,6 +1444,9 @@ Map::PlayerRelocation(Player *player, float x, float y, float z, float orientati
         ResetGridExpiry(*newGrid, 0.1f);
         newGrid->SetGridState(GRID_STATE_ACTIVE);
     }
+
+    if (!same_cell)
+        PreloadGridAhead(oldX, oldY, x, y);
 }
 
 
@@ -1351,6 +1482,9 @@ void Map::DoPlayerGridRelocation(Player *player, float x, float y, float z, floa
         ResetGridExpiry(*newGrid, 0.1f);
         newGrid->SetGridState(GRID_STATE_ACTIVE);
     }
+
+    if (!same_cell)
+        PreloadGridAhead(player->GetPositionX(), player->GetPositionY(), x, y);
 }
 
 void Map::CreatureRelocation(Creature *creature, float x, float y, float z, float ang)
@@ -1715,18 +1849,20 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    BroadcastPacket packet(data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
-        itr->getSource()->GetSession()->SendPacket(data);
+        packet.SendTo(itr->getSource()->GetSession());
 }
 
 bool Map::SendToPlayersInZone(WorldPacket const* data, uint32 zoneId) const
 {
     bool foundPlayer = false;
+    BroadcastPacket packet(data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
     {
         if (itr->getSource()->GetZoneId() == zoneId)
         {
-            itr->getSource()->GetSession()->SendPacket(data);
+            packet.SendTo(itr->getSource()->GetSession());
             foundPlayer = true;
         }
     }
@@ -2698,7 +2834,7 @@ Transport* Map::GetTransport(ObjectGuid guid)
  */
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
-    return m_objectsStore.find<DynamicObject>(guid, (DynamicObject*)NULL);
+    return m_objectsStore.find<DynamicObject>(guid);
 }
 
 /**
@@ -2774,19 +2910,61 @@ WorldObject* Map::GetWorldObjectOrPlayer(ObjectGuid guid)
     return nullptr;
 }
 
-class ObjectUpdatePacketBuilder : public ACE_Based::Runnable
+MapWorkQueueSlot& Map::ClientUpdateSlot::Get(Object* obj) { return obj->GetClientUpdateQueueSlot(); }
+MapWorkQueueSlot& Map::RelocationSlot::Get(Unit* unit) { return unit->GetRelocationQueueSlot(); }
+MapWorkQueueSlot& Map::MovementUpdateSlot::Get(Unit* unit) { return unit->GetMovementQueueSlot(); }
+
+void Map::AddUpdateObject(Object* obj)
+{
+    if (_processingSendObjUpdates)
+        return;
+    i_objectsToClientUpdate.Add(obj);
+}
+
+void Map::RemoveUpdateObject(Object* obj)
+{
+    ASSERT(!_processingSendObjUpdates);
+    i_objectsToClientUpdate.Remove(obj);
+}
+
+void Map::AddRelocatedUnit(Unit* obj)
+{
+    if (_processingUnitsRelocation)
+        return;
+    i_unitsRelocated.Add(obj);
+}
+
+void Map::RemoveRelocatedUnit(Unit* obj)
+{
+    ASSERT(!_processingUnitsRelocation);
+    i_unitsRelocated.Remove(obj);
+}
+
+void Map::AddUnitToMovementUpdate(Unit* unit)
+{
+    unitsMvtUpdate.Add(unit);
+}
+
+bool Map::BatchesMovementUpdates() const
+{
+    if (sWorld.getConfig(CONFIG_BOOL_MOTIONUPDATE_BATCH))
+        return true;
+    return IsContinent() && sWorld.getConfig(CONFIG_UINT32_CONTINENTS_MOTIONUPDATE_THREADS);
+}
+
+void Map::RemoveUnitFromMovementUpdate(Unit* unit)
+{
+    unitsMvtUpdate.Remove(unit);
+    unit->GetMotionMaster()->TakeQueuedAsyncDiff();
+}
+
+class ObjectUpdatePacketBuilder
 {
 public:
-    ObjectUpdatePacketBuilder(std::set<Object*>::iterator& a, std::set<Object*>::iterator& b, uint32 now) : begin(a), end(b), beginTime(now), current(a)
+    ObjectUpdatePacketBuilder(std::vector<Object*> const& objects, uint32 a, uint32 b, uint32 now) : objects(objects), begin(a), current(a), end(b), beginTime(now)
     {
     }
 
-    virtual void run()
-    {
-        WorldDatabase.ThreadStart(); // Not needed if we don't do SQL queries from this thread ...
-        DoUpdateObjects();
-        WorldDatabase.ThreadEnd();
-    }
     void DoUpdateObjects()
     {
         uint32 timeout = sWorld.getConfig(CONFIG_UINT32_MAP_OBJECTSUPDATE_TIMEOUT);
@@ -2796,29 +2974,30 @@ public:
         {
             if (WorldTimer::getMSTimeDiffToNow(beginTime) > timeout)
                 break;
-            (*current)->BuildUpdateData(update_players);
+            objects[current]->BuildUpdateData(update_players);
         }
 
         for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
             iter->second.Send(iter->first->GetSession());
     }
-    std::set<Object*>::iterator begin;
-    std::set<Object*>::iterator current;
-    std::set<Object*>::iterator end;
+    std::vector<Object*> const& objects;
+    uint32 begin;
+    uint32 current;
+    uint32 end;
     uint32 beginTime;
 };
 
-//#define MAP_SENDOBJECTUPDATES_PROFILE
-
 void Map::SendObjectUpdates()
 {
     // VERY HEAVY LOAD in case of a lot of players at the same place
     // ~2ms / object if 500 players in the visible area around
     uint32 now = WorldTimer::getMSTime();
-    uint32 objectsCount = i_objectsToClientUpdate.size();
-    if (!objectsCount)
+    if (i_objectsToClientUpdate.empty())
         return;
     _processingSendObjUpdates = true;
+    _objectsToClientUpdateNow.clear();
+    i_objectsToClientUpdate.Drain(_objectsToClientUpdateNow);
+    uint32 objectsCount = _objectsToClientUpdateNow.size();
 
     // Compute maximum number of threads
     uint32 threads = 1;
@@ -2836,74 +3015,49 @@ void Map::SendObjectUpdates()
         threads = objectsCount;
 
     uint32 step = objectsCount / threads;
-    uint32 i = 0;
-    ACE_Based::Thread** updaters = threads > 1 ? new ACE_Based::Thread*[threads - 1] : NULL;
-    ObjectUpdatePacketBuilder** objUpdaters = new ObjectUpdatePacketBuilder*[threads];
-    std::set<Object*>::iterator itBegin = i_objectsToClientUpdate.begin();
-    std::set<Object*>::iterator itEnd = i_objectsToClientUpdate.begin();
+    std::vector<ObjectUpdatePacketBuilder> objUpdaters;
+    objUpdaters.reserve(threads);
     ASSERT(step > 0);
     ASSERT(threads >= 1);
     for (uint32 i = 0; i < threads; ++i)
     {
-        itBegin = itEnd;
-        if (i == (threads - 1))
-            itEnd = i_objectsToClientUpdate.end();
-        else
+        uint32 itEnd = i == (threads - 1) ? objectsCount : (i + 1) * step;
+        objUpdaters.emplace_back(_objectsToClientUpdateNow, i * step, itEnd, now);
+    }
+    {
+        ThreadPool::TaskGroup objectsUpdate(sMapMgr.GetUpdatePool());
+        for (uint32 i = 0; i < (threads - 1); ++i)
         {
-            for (uint32 j = 0; j < step; ++j)
-                ++itEnd;
+            ObjectUpdatePacketBuilder* builder = &objUpdaters[i];
+            objectsUpdate.Run([builder]() { builder->DoUpdateObjects(); });
         }
-        objUpdaters[i] = new ObjectUpdatePacketBuilder(itBegin, itEnd, now);
-        objUpdaters[i]->incReference();
-
-        if (i == (threads - 1)) // Do not create a useless supplementary thread
-            objUpdaters[i]->DoUpdateObjects();
-        else
-            updaters[i] = new ACE_Based::Thread(objUpdaters[i]);
+        // Last chunk is done by the map thread itself
+        objUpdaters[threads - 1].DoUpdateObjects();
+        objectsUpdate.Wait();
     }
-    for (uint32 i = 0; i < (threads - 1); ++i)
-        updaters[i]->wait();
+    // Objects skipped on timeout are queued again for the next tick
+    uint32 remaining = 0;
     for (uint32 i = 0; i < threads; ++i)
-    {
-        /* std::set::erase
-         * Iterators, pointers and references referring to elements removed by the function are invalidated.
-         * All other iterators, pointers and references keep their validity.
-         */
-        i_objectsToClientUpdate.erase(objUpdaters[i]->begin, objUpdaters[i]->current);
-        objUpdaters[i]->decReference();
-        if (i != (threads - 1))
-            delete updaters[i];
-    }
+        for (uint32 j = objUpdaters[i].current; j < objUpdaters[i].end; ++j, ++remaining)
+            i_objectsToClientUpdate.Add(_objectsToClientUpdateNow[j]);
+    _objectsToClientUpdateNow.clear();
 
     // If we timeout, use more threads !
-    if (i_objectsToClientUpdate.size())
+    if (remaining)
         ++_objUpdatesThreads;
     else
         --_objUpdatesThreads;
 
     _processingSendObjUpdates = false;
-    delete[] updaters;
-    delete[] objUpdaters;
-#ifdef MAP_SENDOBJECTUPDATES_PROFILE
-    uint32 diff = WorldTimer::getMSTimeDiffToNow(now);
-    if (diff > 50)
-        sLog.outString("SendObjectUpdates in %04u ms [%u threads. %3u/%3u]", diff, threads, objectsCount - i_objectsToClientUpdate.size(), objectsCount);
-#endif
 }
 
-class VisibilityUpdater : public ACE_Based::Runnable
+class VisibilityUpdater
 {
 public:
-    VisibilityUpdater(std::set<Unit*>::iterator& a, std::set<Unit*>::iterator& b, uint32 now) : begin(a), end(b), beginTime(now), current(a)
+    VisibilityUpdater(std::vector<Unit*> const& units, uint32 a, uint32 b, uint32 now) : units(units), begin(a), current(a), end(b), beginTime(now)
     {
     }
 
-    virtual void run()
-    {
-        WorldDatabase.ThreadStart();
-        DoUpdateVisibility();
-        WorldDatabase.ThreadEnd();
-    }
     void DoUpdateVisibility()
     {
         uint32 timeout = sWorld.getConfig(CONFIG_UINT32_MAP_VISIBILITYUPDATE_TIMEOUT);
@@ -2911,25 +3065,26 @@ public:
         {
             if (WorldTimer::getMSTimeDiffToNow(beginTime) > timeout)
                 break;
-            (*current)->ProcessRelocationVisibilityUpdates();
+            units[current]->ProcessRelocationVisibilityUpdates();
         }
     }
-    std::set<Unit*>::iterator begin;
-    std::set<Unit*>::iterator current;
-    std::set<Unit*>::iterator end;
+    std::vector<Unit*> const& units;
+    uint32 begin;
+    uint32 current;
+    uint32 end;
     uint32 beginTime;
 };
 
-//#define MAP_UPDATEVISIBILITY_PROFILE
-
 void Map::UpdateVisibilityForRelocations()
 {
     // VERY HEAVY LOAD in case of a lot of players at the same place
     uint32 now = WorldTimer::getMSTime();
-    uint32 objectsCount = i_unitsRelocated.size();
-    if (!objectsCount)
+    if (i_unitsRelocated.empty())
         return;
     _processingUnitsRelocation = true;
+    _unitsRelocatedNow.clear();
+    i_unitsRelocated.Drain(_unitsRelocatedNow);
+    uint32 objectsCount = _unitsRelocatedNow.size();
 
     // Compute number of threads to spawn
     uint32 threads = 1;
@@ -2947,53 +3102,37 @@ void Map::UpdateVisibilityForRelocations()
         threads = objectsCount;
 
     uint32 step = objectsCount / threads;
-    uint32 i = 0;
-    ACE_Based::Thread** updaters = threads > 1 ? new ACE_Based::Thread*[threads - 1] : NULL;
-    VisibilityUpdater** visUpdaters = new VisibilityUpdater*[threads];
-    std::set<Unit*>::iterator itBegin = i_unitsRelocated.begin();
-    std::set<Unit*>::iterator itEnd = i_unitsRelocated.begin();
+    std::vector<VisibilityUpdater> visUpdaters;
+    visUpdaters.reserve(threads);
     ASSERT(step > 0);
     for (uint32 i = 0; i < threads; ++i)
     {
-        itBegin = itEnd;
-        if (i == (threads - 1))
-            itEnd = i_unitsRelocated.end();
-        else
+        uint32 itEnd = i == (threads - 1) ? objectsCount : (i + 1) * step;
+        visUpdaters.emplace_back(_unitsRelocatedNow, i * step, itEnd, now);
+    }
+    {
+        ThreadPool::TaskGroup visibilityUpdate(sMapMgr.GetUpdatePool());
+        for (uint32 i = 0; i < (threads - 1); ++i)
         {
-            for (uint32 j = 0; j < step; ++j)
-                ++itEnd;
+            VisibilityUpdater* updater = &visUpdaters[i];
+            visibilityUpdate.Run([updater]() { updater->DoUpdateVisibility(); });
         }
-        visUpdaters[i] = new VisibilityUpdater(itBegin, itEnd, now);
-        visUpdaters[i]->incReference();
-        if (i == (threads - 1))
-            visUpdaters[i]->DoUpdateVisibility();
-        else
-            updaters[i] = new ACE_Based::Thread(visUpdaters[i]);
+        visUpdaters[threads - 1].DoUpdateVisibility();
+        visibilityUpdate.Wait();
     }
-    for (uint32 i = 0; i < threads - 1; ++i)
-        updaters[i]->wait();
+    // Units skipped on timeout are queued again for the next tick
+    uint32 remaining = 0;
     for (uint32 i = 0; i < threads; ++i)
-    {
-        i_unitsRelocated.erase(visUpdaters[i]->begin, visUpdaters[i]->current);
-        visUpdaters[i]->decReference();
-        if (i != (threads - 1))
-            delete updaters[i];
-    }
+        for (uint32 j = visUpdaters[i].current; j < visUpdaters[i].end; ++j, ++remaining)
+            i_unitsRelocated.Add(_unitsRelocatedNow[j]);
+    _unitsRelocatedNow.clear();
 
-    if (i_unitsRelocated.size())
+    if (remaining)
         ++_unitRelocationThreads;
     else
         --_unitRelocationThreads;
 
     _processingUnitsRelocation = false;
-    delete[] updaters;
-    delete[] visUpdaters;
-
-#ifdef MAP_UPDATEVISIBILITY_PROFILE
-    uint32 diff = WorldTimer::getMSTimeDiffToNow(now);
-    if (diff > 50)
-        sLog.outString("VisibilityUpdate in %04u ms [%u threads/done %u/%u]", diff, threads, objectsCount - i_unitsRelocated.size(), objectsCount);
-#endif
 }
 
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
@@ -3141,8 +3280,30 @@ bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, floa
     ASSERT(MaNGOS::IsValidMapCoord(x1, y1, z1));
     ASSERT(MaNGOS::IsValidMapCoord(x2, y2, z2));
 
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
+    uint32 cacheTime = sWorld.getConfig(CONFIG_UINT32_LOS_CACHE_TIME);
+    uint32 now = 0;
+    uint32 generation = 0;
+    if (cacheTime)
+    {
+        bool result;
+        now = WorldTimer::getMSTime();
+        if (m_losCache.Find(x1, y1, z1, x2, y2, z2, checkDynLos, now, result))
+            return result;
+        generation = checkDynLos ? m_losCache.GetDynamicGeneration(x1, y1, x2, y2) : 0;
+    }
+
+    bool result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
     && (!checkDynLos || CheckDynamicTreeLoS(x1, y1, z1, x2, y2, z2));
+
+    if (cacheTime)
+        m_losCache.Store(x1, y1, z1, x2, y2, z2, checkDynLos, generation, now + cacheTime, result);
+    return result;
+}
+
+void Map::InvalidateDynamicLineOfSight(const GameObjectModel& model)
+{
+    G3D::AABox const& bounds = model.getBounds();
+    m_losCache.InvalidateDynamic(bounds.low().x, bounds.low().y, bounds.high().x, bounds.high().y);
 }
 
 bool Map::GetLosHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, float modifyDist) const
@@ -37,6 +37,9 @@
 #include "GridMap.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
+#include "MapObjectStore.h"
+#include "TickProfiler.h"
+#include "LineOfSightCache.h"
 #include "Utilities/TypeList.h"
 #include "ScriptMgr.h"
 #include "vmap/DynamicTree.h"
@@ -44,7 +47,9 @@
 #include "WorldSession.h"
 #include "SQLStorages.h"
 #include "CreatureLinkingMgr.h"
+#include "ThreadPool.h"
 
+#include <atomic>
 #include <bitset>
 #include <list>
 #include <set>
@@ -354,6 +359,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         inline void UpdateActiveCellsAsynch(uint32 now, uint32 diff);
         inline void UpdateActiveCellsCallback(uint32 diff, uint32 now, uint32 threadId, uint32 totalThreads, uint32 step);
         inline void UpdateCells(uint32 diff);
+        void UpdateMovementBatch();
         void UpdateSync(const uint32);
         void UpdatePlayers();
         void DoUpdate(uint32 maxDiff);
@@ -499,70 +505,22 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         WorldObject* GetWorldObject(ObjectGuid guid);         // only use if sure that need objects at current map, specially for player case
         WorldObject* GetWorldObjectOrPlayer(ObjectGuid guid); // Returns a world object from current map, or player anywhere.
 
-        template <typename T> void InsertObject(ObjectGuid const& guid, T* ptr)
-        {
-            m_objectsStore_lock.acquire_write();
-            m_objectsStore.insert<T>(guid, ptr);
-            m_objectsStore_lock.release();
-        }
-        template <typename T> void EraseObject(ObjectGuid const& guid)
-        {
-            m_objectsStore_lock.acquire_write();
-            m_objectsStore.erase<T>(guid, (T*)nullptr);
-            m_objectsStore_lock.release();
-        }
-        template <typename T> T* GetObject(ObjectGuid const& guid)
-        {
-            m_objectsStore_lock.acquire_read();
-            T* ptr = m_objectsStore.find<T>(guid, (T*)nullptr);
-            m_objectsStore_lock.release();
-            return ptr;
-        }
-        void AddUpdateObject(Object *obj)
-        {
-            if (_processingSendObjUpdates)
-                return;
-            i_objectsToClientUpdate_lock.acquire();
-            i_objectsToClientUpdate.insert(obj);
-            i_objectsToClientUpdate_lock.release();
-        }
-
-        void RemoveUpdateObject(Object *obj)
-        {
-            ASSERT(!_processingSendObjUpdates);
-            i_objectsToClientUpdate_lock.acquire();
-            i_objectsToClientUpdate.erase( obj );
-            i_objectsToClientUpdate_lock.release();
-        }
+        template <typename T> void InsertObject(ObjectGuid const& guid, T* ptr) { m_objectsStore.insert<T>(guid, ptr); }
+        template <typename T> void EraseObject(ObjectGuid const& guid) { m_objectsStore.erase<T>(guid); }
+        // Wait-free, safe to call from the cell update threads
+        template <typename T> T* GetObject(ObjectGuid const& guid) { return m_objectsStore.find<T>(guid); }
+        // Frees the object tables replaced while growing. Only once no map is updating:
+        // the threads of other maps may still be reading the old tables.
+        void ReleaseRetiredObjectTables() { m_objectsStore.ReleaseRetiredTables(); }
+        void AddUpdateObject(Object *obj);
+        void RemoveUpdateObject(Object *obj);
         // May be called from a different map ...
-        void AddRelocatedUnit(Unit* obj)
-        {
-            if (_processingUnitsRelocation)
-                return;
-            i_unitsRelocated_lock.acquire();
-            i_unitsRelocated.insert(obj);
-            i_unitsRelocated_lock.release();
-        }
-        void RemoveRelocatedUnit(Unit* obj)
-        {
-            ASSERT(!_processingUnitsRelocation);
-            i_unitsRelocated_lock.acquire();
-            i_unitsRelocated.erase(obj);
-            i_unitsRelocated_lock.release();
-        }
+        void AddRelocatedUnit(Unit* obj);
+        void RemoveRelocatedUnit(Unit* obj);
 
-        void AddUnitToMovementUpdate(Unit* unit)
-        {
-            unitsMvtUpdate_lock.acquire();
-            unitsMvtUpdate.insert(unit);
-            unitsMvtUpdate_lock.release();
-        }
-        void RemoveUnitFromMovementUpdate(Unit* unit)
-        {
-            unitsMvtUpdate_lock.acquire();
-            unitsMvtUpdate.erase(unit);
-            unitsMvtUpdate_lock.release();
-        }
+        void AddUnitToMovementUpdate(Unit* unit);
+        bool BatchesMovementUpdates() const;
+        void RemoveUnitFromMovementUpdate(Unit* unit);
         // DynObjects currently
         uint32 GenerateLocalLowGuid(HighGuid guidhigh);
 
@@ -596,6 +554,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
             _dynamicTree.remove(model);
             _dynamicTree.balance();
             _dynamicTree_lock.release();
+            InvalidateDynamicLineOfSight(model);
         }
         void InsertGameObjectModel(const GameObjectModel& model)
         {
@@ -603,7 +562,11 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
             _dynamicTree.insert(model);
             _dynamicTree.balance();
             _dynamicTree_lock.release();
+            InvalidateDynamicLineOfSight(model);
         }
+        // A model of the dynamic tree was added, removed, moved, enabled or disabled
+        void InvalidateDynamicLineOfSight(const GameObjectModel& model);
+        LineOfSightCacheStats GetLineOfSightCacheStats() const { return m_losCache.GetStats(); }
         bool ContainsGameObjectModel(const GameObjectModel& model) const
         {
             _dynamicTree_lock.acquire_read();
@@ -645,6 +608,8 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
 
         // WeatherSystem
         WeatherSystem* GetWeatherSystem() const { return m_weatherSystem; }
+
+        TickProfile* GetTickProfile() const { return m_tickProfile.get(); }
         /** Set the weather in a zone on this map
          * @param zoneId set the weather for which zone
          * @param type What weather to set
@@ -681,6 +646,11 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedAtEnter(Cell const&, Player* player = nullptr);
 
+        // Queue the terrain of the grid ahead of a player moving from (oldX, oldY) to (x, y)
+        void PreloadGridAhead(float oldX, float oldY, float x, float y);
+        // Release the preloaded grids loaded since by the map, or never reached (all of them when 'all')
+        void UpdatePreloadedGrids(bool all);
+
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
         template<class T> void AddType(T *obj);
@@ -704,18 +674,27 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         void SendObjectUpdates();
         void UpdateVisibilityForRelocations();
 
+        // Filled by per-thread buffers, drained once per tick by the map thread
+        struct ClientUpdateSlot { static MapWorkQueueSlot& Get(Object* obj); };
+        struct RelocationSlot { static MapWorkQueueSlot& Get(Unit* unit); };
+        struct MovementUpdateSlot { static MapWorkQueueSlot& Get(Unit* unit); };
+        typedef MapWorkQueue<Object, ClientUpdateSlot> ClientUpdateQueue;
+        typedef MapWorkQueue<Unit, RelocationSlot> RelocatedUnitsQueue;
+        typedef MapWorkQueue<Unit, MovementUpdateSlot> MovementUpdateQueue;
+
         bool                    _processingSendObjUpdates;
         uint32                  _objUpdatesThreads;
-        mutable MapMutexType    i_objectsToClientUpdate_lock;
-        std::set<Object *>      i_objectsToClientUpdate;
+        ClientUpdateQueue       i_objectsToClientUpdate;
+        std::vector<Object*>    _objectsToClientUpdateNow;
 
         bool                    _processingUnitsRelocation;
         uint32                  _unitRelocationThreads;
-        mutable MapMutexType    i_unitsRelocated_lock;
-        std::set<Unit* >        i_unitsRelocated;
+        RelocatedUnitsQueue     i_unitsRelocated;
+        std::vector<Unit*>      _unitsRelocatedNow;
 
-        mutable MapMutexType    unitsMvtUpdate_lock;
-        std::set<Unit*>         unitsMvtUpdate;
+        MovementUpdateQueue     unitsMvtUpdate;
+        std::vector<Unit*>      _unitsMvtUpdateNow;
+        std::vector<std::pair<Unit*, Unit*>> _unitsMvtTargets;  // (movement target, unit) of the batch
 
         mutable MapMutexType    _corpseRemovalLock;
         typedef std::list<std::pair<Corpse*, ObjectGuid>> CorpseRemoveList;
@@ -738,6 +717,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
 
         mutable ACE_RW_Mutex   _dynamicTree_lock;
         DynamicMapTree _dynamicTree;
+        mutable LineOfSightCache m_losCache;
 
         MapPersistentState* m_persistentState;
 
@@ -748,8 +728,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         ActiveNonPlayers m_activeNonPlayers;
         ActiveNonPlayers::iterator m_activeNonPlayersIter;
 
-        typedef TypeUnorderedMapContainer<AllMapStoredObjectTypes, ObjectGuid> MapStoredObjectTypesContainer;
-        ACE_RW_Mutex                    m_objectsStore_lock;
+        typedef ConcurrentGuidMapContainer<Creature, Pet, GameObject, DynamicObject> MapStoredObjectTypesContainer;
         MapStoredObjectTypesContainer   m_objectsStore;
 
         // Objects that must update even in inactive grids without activating them
@@ -770,6 +749,19 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         TerrainInfo * const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        // Terrain read by the grid preload workers, referenced in m_TerrainData until released
+        struct PreloadedGrid
+        {
+            PreloadedGrid(uint32 time) : requestTime(time), done(false) {}
+            uint32 requestTime;
+            std::atomic<bool> done;                         // set by the worker
+            std::vector<std::string> models;                // vmap models held until released
+        };
+        typedef std::unordered_map<uint32, std::unique_ptr<PreloadedGrid>> PreloadedGridsMap;
+        std::unique_ptr<ThreadPool::TaskGroup> m_gridPreloads;
+        MapMutexType m_preloadedGridsLock;
+        PreloadedGridsMap m_preloadedGrids;
+
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
         mutable MapMutexType    i_objectsToRemove_lock;
@@ -810,6 +802,9 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
 
+        // Timings of the last updates, see TickProfiler
+        TickProfilePtr m_tickProfile;
+
         // Scripted Map Events
         std::map<uint32, ScriptedEvent> m_mScriptedEvents;
         void UpdateScriptedEvents();
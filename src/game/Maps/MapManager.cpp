@@ -49,9 +49,16 @@ MapManager::MapManager()
 
 MapManager::~MapManager()
 {
+    if (m_updatePool)
+        m_updatePool->Stop();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
+    // after the maps, which wait for their preloads
+    if (m_gridPreloadPool)
+        m_gridPreloadPool->Stop();
+
     DeleteStateMachine();
 }
 
@@ -60,6 +67,18 @@ MapManager::Initialize()
 {
     InitStateMachine();
     InitMaxInstanceId();
+
+    uint32 poolThreads = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_POOL_THREADS);
+    if (!poolThreads)
+        poolThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    m_updatePool.reset(new ThreadPool(poolThreads, sWorld.getConfig(CONFIG_BOOL_MAPUPDATE_POOL_PIN_THREADS),
+        []() { WorldDatabase.ThreadStart(); }, []() { WorldDatabase.ThreadEnd(); }));
+    sLog.outString("MapManager: %u map update workers started", m_updatePool->GetNumThreads());
+    if (uint32 preloadThreads = sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_THREADS))
+    {
+        m_gridPreloadPool.reset(new ThreadPool(preloadThreads, false));
+        sLog.outString("MapManager: %u grid preload workers started", m_gridPreloadPool->GetNumThreads());
+    }
     for (auto itr = sMapStorage.begin<MapEntry>(); itr < sMapStorage.end<MapEntry>(); ++itr)
     {
         bool load = false;
@@ -231,7 +250,7 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
     }
 }
 
-class MapAsyncUpdater : public ACE_Based::Runnable
+class MapAsyncUpdater
 {
 public:
     MapAsyncUpdater(bool* updFinished, uint32 updateDiff) :
@@ -239,9 +258,8 @@ public:
     {
     }
 
-    virtual void run()
+    void run()
     {
-        WorldDatabase.ThreadStart();
         do
         {
             for (std::vector<Map*>::iterator it = maps.begin(); it != maps.end(); ++it)
@@ -255,7 +273,6 @@ public:
             ++loops;
         }
         while (!(*updateFinished));
-        WorldDatabase.ThreadEnd();
     }
     std::vector<Map*> maps;
     volatile bool* updateFinished;
@@ -263,23 +280,6 @@ public:
     uint32 loops;
 };
 
-class ContinentAsyncUpdater : public ACE_Based::Runnable
-{
-public:
-    ContinentAsyncUpdater(uint32 updateDiff, Map* m) : diff(updateDiff), map(m)
-    {
-    }
-
-    virtual void run()
-    {
-        WorldDatabase.ThreadStart();
-        map->DoUpdate(diff);
-        WorldDatabase.ThreadEnd();
-    }
-    Map* map;
-    uint32 diff;
-};
-
 void MapManager::Update(uint32 diff)
 {
     i_timer.Update(diff);
@@ -293,10 +293,8 @@ void MapManager::Update(uint32 diff)
     uint32 mapsDiff = (uint32)i_timer.GetCurrent();
     bool updateFinished = false;
     asyncMapUpdating = true;
-    std::vector<MapAsyncUpdater*> instanceUpdaters(sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_INSTANCED_UPDATE_THREADS));
-    std::vector<ContinentAsyncUpdater*> continentsUpdaters;
-    for (int i = 0; i < instanceUpdaters.size(); ++i)
-        instanceUpdaters[i] = new MapAsyncUpdater(&updateFinished, mapsDiff); // Will be deleted at thread end
+    std::vector<MapAsyncUpdater> instanceUpdaters(sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_INSTANCED_UPDATE_THREADS), MapAsyncUpdater(&updateFinished, mapsDiff));
+    std::vector<Map*> continentsToUpdate;
 
     int mapIdx = 0;
     int continentsIdx = 0;
@@ -315,7 +313,7 @@ void MapManager::Update(uint32 diff)
         {
             if (instanceUpdaters.size())
             {
-                instanceUpdaters[mapIdx % instanceUpdaters.size()]->maps.push_back(iter->second);
+                instanceUpdaters[mapIdx % instanceUpdaters.size()].maps.push_back(iter->second);
                 ++mapIdx;
             }
             else
@@ -324,8 +322,7 @@ void MapManager::Update(uint32 diff)
         else // One threat per continent part
         {
             iter->second->SetMapUpdateIndex(continentsIdx++);
-            ContinentAsyncUpdater* task = new ContinentAsyncUpdater(mapsDiff, iter->second);
-            continentsUpdaters.push_back(task);
+            continentsToUpdate.push_back(iter->second);
         }
     }
     i_maxContinentThread = continentsIdx;
@@ -333,29 +330,25 @@ void MapManager::Update(uint32 diff)
     for (int i = 0; i < i_maxContinentThread; ++i)
         i_continentUpdateFinished[i] = false;
 
-    std::vector<ACE_Based::Thread*> asyncUpdateThreads(instanceUpdaters.size() + continentsUpdaters.size());
+    // Continents wait for each other and instance updaters loop until continents are done:
+    // each of them needs its own worker, plus one left for the nested map tasks.
+    m_updatePool->Reserve(continentsToUpdate.size() + instanceUpdaters.size() + 1);
 
-    for (int tid = 0; tid < instanceUpdaters.size(); ++tid)
-        asyncUpdateThreads[tid]                             = new ACE_Based::Thread(instanceUpdaters[tid]);
-    for (int tid = 0; tid < continentsUpdaters.size(); ++tid)
-        asyncUpdateThreads[tid + instanceUpdaters.size()]   = new ACE_Based::Thread(continentsUpdaters[tid]);
+    ThreadPool::TaskGroup instancesGroup(m_updatePool.get());
+    ThreadPool::TaskGroup continentsGroup(m_updatePool.get());
+    for (auto& updater : instanceUpdaters)
+        instancesGroup.Run([&updater]() { updater.run(); });
+    for (auto map : continentsToUpdate)
+        continentsGroup.Run([map, mapsDiff]() { map->DoUpdate(mapsDiff); });
 
     // Finish continents updating
-    for (int tid = instanceUpdaters.size(); tid < asyncUpdateThreads.size(); ++tid)
-    {
-        asyncUpdateThreads[tid]->wait();
-        delete asyncUpdateThreads[tid];
-    }
+    continentsGroup.Wait();
 
     updateFinished = true;
     SwitchPlayersInstances();
 
     // And then instances updating
-    for (int tid = 0; tid < instanceUpdaters.size(); ++tid)
-    {
-        asyncUpdateThreads[tid]->wait();
-        delete asyncUpdateThreads[tid];
-    }
+    instancesGroup.Wait();
     delete[] i_continentUpdateFinished;
     i_continentUpdateFinished = NULL;
     asyncMapUpdating = false;
@@ -363,6 +356,10 @@ void MapManager::Update(uint32 diff)
     // Execute far teleports after all map updates have finished
     ExecuteDelayedPlayerTeleports();
 
+    // No map thread can be looking objects up anymore
+    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+        iter->second->ReleaseRetiredObjectTables();
+
     MapMapType::iterator crashedMapsIter = i_maps.begin();
     while (crashedMapsIter != i_maps.end())
     {
@@ -29,6 +29,7 @@
 #include "ace/Thread_Mutex.h"
 #include "Map.h"
 #include "GridStates.h"
+#include "ThreadPool.h"
 
 class BattleGround;
 
@@ -163,6 +164,11 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
 
         void RemoveAllObjectsInRemoveList();
 
+        // Persistent workers used by every threaded step of the map update (never NULL after Initialize)
+        ThreadPool* GetUpdatePool() const { return m_updatePool.get(); }
+        // Workers reading the terrain of grids ahead of moving players (NULL when disabled)
+        ThreadPool* GetGridPreloadPool() const { return m_gridPreloadPool.get(); }
+
         bool CanPlayerEnter(uint32 mapid, Player* player);
         uint32 GenerateInstanceId() { return ++i_MaxInstanceId; }
         void InitMaxInstanceId();
@@ -234,6 +240,10 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
         volatile bool*  i_continentUpdateFinished;
         bool asyncMapUpdating;
 
+        std::unique_ptr<ThreadPool> m_updatePool;
+        // Separate from the update pool: file reads must not delay the update barriers
+        std::unique_ptr<ThreadPool> m_gridPreloadPool;
+
         // Instanced continent zones
         const static int LAST_CONTINENT_ID = 2;
         ACE_Thread_Mutex    m_scheduledInstanceSwitches_lock[LAST_CONTINENT_ID];
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPOBJECTSTORE_H
+#define MANGOS_MAPOBJECTSTORE_H
+
+#include "Common.h"
+#include "ObjectGuid.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * GUID -> object index of one object type, with wait-free lookups.
+ *
+ * Open addressing (linear probing) over atomic slots. Writers are serialized by
+ * a mutex, readers never lock: the cell update threads look objects up while
+ * the map thread (or another cell thread) adds and removes them.
+ *
+ * Erasing clears the value and keeps the key as a tombstone, so a probe chain
+ * is never cut under a reader. When the table runs out of room it is copied to
+ * a bigger one that is then published (RCU style). A reader may still be
+ * probing the previous table, so retired tables are kept until the owner calls
+ * ReleaseRetiredTables() at a point where no lookup can be in flight.
+ */
+template <class T>
+class ConcurrentGuidMap
+{
+    public:
+        ConcurrentGuidMap() : m_table(nullptr), m_used(0), m_size(0)
+        {
+            m_table.store(AllocateTable(MIN_CAPACITY), std::memory_order_release);
+        }
+
+        void insert(ObjectGuid const& guid, T* obj)
+        {
+            uint64 key = guid.GetRawValue();
+            MANGOS_ASSERT(key && obj);
+
+            std::lock_guard<std::mutex> guard(m_writeLock);
+            Table* table = m_table.load(std::memory_order_relaxed);
+            if (Slot* slot = FindSlot(table, key))
+            {
+                if (!slot->value.load(std::memory_order_relaxed))
+                    ++m_size;
+                slot->value.store(obj, std::memory_order_release);
+                return;
+            }
+
+            if ((m_used + 1) * 2 > table->capacity)
+                table = Grow();
+
+            InsertNew(table, key, obj);
+            ++m_used;
+            ++m_size;
+        }
+
+        void erase(ObjectGuid const& guid)
+        {
+            std::lock_guard<std::mutex> guard(m_writeLock);
+            if (Slot* slot = FindSlot(m_table.load(std::memory_order_relaxed), guid.GetRawValue()))
+                if (slot->value.exchange(nullptr, std::memory_order_release))
+                    --m_size;
+        }
+
+        T* find(ObjectGuid const& guid) const
+        {
+            uint64 key = guid.GetRawValue();
+            if (!key)
+                return nullptr;
+            Slot const* slot = FindSlot(m_table.load(std::memory_order_acquire), key);
+            return slot ? slot->value.load(std::memory_order_acquire) : nullptr;
+        }
+
+        uint32 size() const { return m_size; }
+
+        // Frees the tables replaced by Grow(). Only call while no other thread
+        // can be looking objects up (MapManager::Update, once all maps are updated).
+        void ReleaseRetiredTables()
+        {
+            std::lock_guard<std::mutex> guard(m_writeLock);
+            if (m_tables.size() > 1)
+                m_tables.erase(m_tables.begin(), m_tables.end() - 1);
+        }
+
+    private:
+        enum { MIN_CAPACITY = 64 };
+
+        struct Slot
+        {
+            std::atomic<uint64> key;                        // 0: never used. Once set, never changes.
+            std::atomic<T*> value;                          // nullptr: erased (tombstone)
+        };
+
+        struct Table
+        {
+            explicit Table(uint32 cap) : capacity(cap), slots(new Slot[cap])
+            {
+                for (uint32 i = 0; i < cap; ++i)
+                {
+                    slots[i].key.store(0, std::memory_order_relaxed);
+                    slots[i].value.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+            uint32 capacity;                                // power of two
+            std::unique_ptr<Slot[]> slots;
+        };
+
+        ConcurrentGuidMap(ConcurrentGuidMap const&);
+        ConcurrentGuidMap& operator=(ConcurrentGuidMap const&);
+
+        static uint32 Hash(uint64 key)
+        {
+            // Guids of one type share their high part and have sequential counters
+            key ^= key >> 33;
+            key *= UI64LIT(0xff51afd7ed558ccd);
+            key ^= key >> 33;
+            return uint32(key);
+        }
+
+        static Slot* FindSlot(Table* table, uint64 key)
+        {
+            uint32 mask = table->capacity - 1;
+            for (uint32 i = Hash(key) & mask;; i = (i + 1) & mask)
+            {
+                uint64 slotKey = table->slots[i].key.load(std::memory_order_acquire);
+                if (slotKey == key)
+                    return &table->slots[i];
+                if (!slotKey)
+                    return nullptr;
+            }
+        }
+
+        static void InsertNew(Table* table, uint64 key, T* obj)
+        {
+            uint32 mask = table->capacity - 1;
+            uint32 i = Hash(key) & mask;
+            while (table->slots[i].key.load(std::memory_order_relaxed))
+                i = (i + 1) & mask;
+            // Value first: a reader that sees the key sees the object
+            table->slots[i].value.store(obj, std::memory_order_relaxed);
+            table->slots[i].key.store(key, std::memory_order_release);
+        }
+
+        Table* AllocateTable(uint32 capacity)
+        {
+            m_tables.emplace_back(new Table(capacity));
+            return m_tables.back().get();
+        }
+
+        // Copies the live entries (tombstones are dropped) to a table sized for
+        // at most 25% load, then publishes it.
+        Table* Grow()
+        {
+            Table* oldTable = m_table.load(std::memory_order_relaxed);
+            uint32 capacity = MIN_CAPACITY;
+            while (capacity < (m_size + 1) * 4)
+                capacity *= 2;
+            // Never shrink: readers and later inserts only pay for one table that way
+            if (capacity < oldTable->capacity)
+                capacity = oldTable->capacity;
+
+            Table* newTable = AllocateTable(capacity);
+            m_used = 0;
+            for (uint32 i = 0; i < oldTable->capacity; ++i)
+            {
+                Slot& slot = oldTable->slots[i];
+                if (T* obj = slot.value.load(std::memory_order_relaxed))
+                {
+                    InsertNew(newTable, slot.key.load(std::memory_order_relaxed), obj);
+                    ++m_used;
+                }
+            }
+            m_table.store(newTable, std::memory_order_release);
+            return newTable;
+        }
+
+        std::atomic<Table*> m_table;
+        std::vector<std::unique_ptr<Table>> m_tables;       // published table is the last one
+        std::mutex m_writeLock;
+        uint32 m_used;                                      // live entries + tombstones in m_table
+        std::atomic<uint32> m_size;                         // live entries
+};
+
+/**
+ * One ConcurrentGuidMap per stored type, same insert/erase/find interface as
+ * TypeUnorderedMapContainer.
+ */
+template <class... OBJECTS>
+class ConcurrentGuidMapContainer
+{
+    public:
+        template <class T> void insert(ObjectGuid const& guid, T* obj) { get<T>().insert(guid, obj); }
+        template <class T> void erase(ObjectGuid const& guid) { get<T>().erase(guid); }
+        template <class T> T* find(ObjectGuid const& guid) const { return get<T>().find(guid); }
+
+        void ReleaseRetiredTables() { ReleaseRetiredTables(std::index_sequence_for<OBJECTS...>()); }
+
+    private:
+        template <std::size_t... I> void ReleaseRetiredTables(std::index_sequence<I...>)
+        {
+            int expand[] = { 0, (std::get<I>(m_stores).ReleaseRetiredTables(), 0)... };
+            (void)expand;
+        }
+
+        template <class T> ConcurrentGuidMap<T>& get() { return std::get<ConcurrentGuidMap<T>>(m_stores); }
+        template <class T> ConcurrentGuidMap<T> const& get() const { return std::get<ConcurrentGuidMap<T>>(m_stores); }
+
+        std::tuple<ConcurrentGuidMap<OBJECTS>...> m_stores;
+};
+
+#endif
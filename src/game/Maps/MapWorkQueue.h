@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPWORKQUEUE_H
+#define MANGOS_MAPWORKQUEUE_H
+
+#include "Common.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Position of an object in a MapWorkQueue. Stored on the object itself: it is
+ * the "already queued" flag, and lets the queue remove the object in O(1).
+ */
+class MapWorkQueueSlot
+{
+    template <class T, class SlotAccessor> friend class MapWorkQueue;
+
+    public:
+        MapWorkQueueSlot() : m_buffer(NOT_QUEUED), m_queue(nullptr), m_index(0) {}
+        // A copy is a different object, not queued anywhere
+        MapWorkQueueSlot(MapWorkQueueSlot const&) : MapWorkQueueSlot() {}
+        MapWorkQueueSlot& operator=(MapWorkQueueSlot const&) { return *this; }
+
+        bool IsQueued() const { return m_buffer.load(std::memory_order_relaxed) != NOT_QUEUED; }
+
+    private:
+        static uint32 const NOT_QUEUED = uint32(-1);
+
+        std::atomic<uint32> m_buffer;                       // buffer holding the object, NOT_QUEUED if none
+        std::atomic<void const*> m_queue;                   // written with m_index, under the buffer lock
+        uint32 m_index;
+};
+
+/**
+ * Unordered set of objects filled concurrently by the map update threads.
+ *
+ * Every thread appends to its own buffer, so queuing an object neither
+ * allocates a tree node nor contends on a map-wide lock. A buffer mutex is
+ * only ever taken by its owner thread, by the rare Remove() calls and by
+ * Drain() at the tick barrier.
+ *
+ * SlotAccessor::Get(T*) returns the MapWorkQueueSlot of an object. Only the
+ * translation units adding or removing objects need T to be complete.
+ */
+template <class T, class SlotAccessor>
+class MapWorkQueue
+{
+    public:
+        MapWorkQueue() : m_size(0)
+        {
+            for (auto& buffer : m_buffers)
+                buffer.store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~MapWorkQueue()
+        {
+            for (auto& buffer : m_buffers)
+                delete buffer.load(std::memory_order_relaxed);
+        }
+
+        // Returns false if the object is already queued, here or in another queue.
+        bool Add(T* obj)
+        {
+            MapWorkQueueSlot& slot = SlotAccessor::Get(obj);
+            if (slot.IsQueued())
+                return false;
+
+            uint32 index = GetThreadBufferIndex();
+            Buffer* buffer = GetBuffer(index);
+            std::lock_guard<std::mutex> guard(buffer->lock);
+            uint32 expected = MapWorkQueueSlot::NOT_QUEUED;
+            if (!slot.m_buffer.compare_exchange_strong(expected, index, std::memory_order_acq_rel))
+                return false;
+            slot.m_index = uint32(buffer->items.size());
+            slot.m_queue.store(this, std::memory_order_relaxed);
+            buffer->items.push_back(obj);
+            ++m_size;
+            return true;
+        }
+
+        void Remove(T* obj)
+        {
+            MapWorkQueueSlot& slot = SlotAccessor::Get(obj);
+            uint32 index = slot.m_buffer.load(std::memory_order_acquire);
+            if (index == MapWorkQueueSlot::NOT_QUEUED)
+                return;
+
+            Buffer* buffer = m_buffers[index].load(std::memory_order_acquire);
+            if (!buffer)
+                return;                                     // queued in another queue
+            std::lock_guard<std::mutex> guard(buffer->lock);
+            if (slot.m_queue.load(std::memory_order_relaxed) != this || slot.m_buffer.load(std::memory_order_relaxed) != index)
+                return;
+            buffer->items[slot.m_index] = nullptr;
+            slot.m_queue.store(nullptr, std::memory_order_relaxed);
+            slot.m_buffer.store(MapWorkQueueSlot::NOT_QUEUED, std::memory_order_release);
+            --m_size;
+        }
+
+        // Moves every queued object to 'out', in no particular order, and clears
+        // their slots. Objects queued meanwhile are kept for the next call.
+        void Drain(std::vector<T*>& out)
+        {
+            out.reserve(out.size() + m_size);
+            for (auto& bufferPtr : m_buffers)
+            {
+                Buffer* buffer = bufferPtr.load(std::memory_order_acquire);
+                if (!buffer)
+                    continue;
+                std::lock_guard<std::mutex> guard(buffer->lock);
+                for (T* obj : buffer->items)
+                {
+                    if (!obj)
+                        continue;
+                    MapWorkQueueSlot& slot = SlotAccessor::Get(obj);
+                    slot.m_queue.store(nullptr, std::memory_order_relaxed);
+                    slot.m_buffer.store(MapWorkQueueSlot::NOT_QUEUED, std::memory_order_release);
+                    out.push_back(obj);
+                    --m_size;
+                }
+                buffer->items.clear();                      // keeps the capacity for the next tick
+            }
+        }
+
+        uint32 size() const { return m_size; }
+        bool empty() const { return !m_size; }
+
+    private:
+        enum { MAX_BUFFERS = 64 };                          // threads beyond that share the last buffer
+
+        struct Buffer
+        {
+            std::mutex lock;
+            std::vector<T*> items;                          // removed objects are nulled in place
+        };
+
+        MapWorkQueue(MapWorkQueue const&);
+        MapWorkQueue& operator=(MapWorkQueue const&);
+
+        // Small id of the calling thread, shared by every queue of this type
+        static uint32 GetThreadBufferIndex()
+        {
+            static std::atomic<uint32> s_nextIndex(0);
+            thread_local uint32 t_index = s_nextIndex++;
+            return t_index < MAX_BUFFERS ? t_index : uint32(MAX_BUFFERS - 1);
+        }
+
+        Buffer* GetBuffer(uint32 index)
+        {
+            Buffer* buffer = m_buffers[index].load(std::memory_order_acquire);
+            if (buffer)
+                return buffer;
+            std::unique_ptr<Buffer> created(new Buffer());
+            if (m_buffers[index].compare_exchange_strong(buffer, created.get(), std::memory_order_acq_rel))
+                return created.release();
+            return buffer;                                  // another thread sharing this index won
+        }
+
+        std::atomic<Buffer*> m_buffers[MAX_BUFFERS];
+        std::atomic<uint32> m_size;
+};
+
+#endif
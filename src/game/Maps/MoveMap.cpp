@@ -47,6 +47,179 @@ void MMapFactory::clear()
     }
 }
 
+// ######################## NavMeshQueryPool ########################
+std::atomic<uint64> NavMeshQueryPool::s_leases(0);
+std::atomic<uint64> NavMeshQueryPool::s_misses(0);
+std::atomic<uint32> NavMeshQueryPool::s_active(0);
+std::atomic<uint32> NavMeshQueryPool::s_peak(0);
+
+NavMeshQueryPool::NavMeshQueryPool(dtNavMesh const* mesh) : m_navMesh(mesh), m_closed(false)
+{
+    for (uint32 i = 0; i < NAVMESH_QUERY_POOL_SIZE; ++i)
+        m_slots[i] = nullptr;
+}
+
+NavMeshQueryPool::~NavMeshQueryPool()
+{
+    for (uint32 i = 0; i < NAVMESH_QUERY_POOL_SIZE; ++i)
+        if (dtNavMeshQuery* query = m_slots[i].exchange(nullptr))
+            dtFreeNavMeshQuery(query);
+}
+
+dtNavMeshQuery* NavMeshQueryPool::Acquire()
+{
+    ++s_leases;
+    uint32 active = ++s_active;
+    uint32 peak = s_peak;
+    while (active > peak && !s_peak.compare_exchange_weak(peak, active))
+        ;
+
+    for (uint32 i = 0; i < NAVMESH_QUERY_POOL_SIZE; ++i)
+        if (m_slots[i].load(std::memory_order_relaxed))
+            if (dtNavMeshQuery* query = m_slots[i].exchange(nullptr, std::memory_order_acquire))
+                return query;
+
+    ++s_misses;
+    dtNavMeshQuery* query = dtAllocNavMeshQuery();
+    MANGOS_ASSERT(query);
+    if (dtStatusFailed(query->init(m_navMesh, NAVMESH_QUERY_MAX_NODES)))
+    {
+        dtFreeNavMeshQuery(query);
+        --s_active;
+        sLog.outError("MMAP:NavMeshQueryPool: Failed to initialize dtNavMeshQuery");
+        return NULL;
+    }
+    return query;
+}
+
+void NavMeshQueryPool::Release(dtNavMeshQuery* query)
+{
+    --s_active;
+    if (!m_closed)
+    {
+        for (uint32 i = 0; i < NAVMESH_QUERY_POOL_SIZE; ++i)
+        {
+            dtNavMeshQuery* expected = nullptr;
+            if (m_slots[i].compare_exchange_strong(expected, query, std::memory_order_release))
+                return;
+        }
+    }
+    // pool is full (more threads than slots) or its navmesh is gone
+    dtFreeNavMeshQuery(query);
+}
+
+NavMeshQueryStats NavMeshQueryPool::GetStats()
+{
+    NavMeshQueryStats stats;
+    stats.leases = s_leases;
+    stats.misses = s_misses;
+    stats.active = s_active;
+    stats.peak = s_peak;
+    return stats;
+}
+
+// ######################## PathCorridorCache ########################
+std::atomic<uint64> PathCorridorCache::s_hits(0);
+std::atomic<uint64> PathCorridorCache::s_misses(0);
+std::atomic<uint64> PathCorridorCache::s_invalidations(0);
+
+bool PathCorridorCache::Find(dtPolyRef startRef, dtPolyRef endRef, uint16 includeFlags, uint16 excludeFlags,
+                             dtPolyRef* path, uint32& length, uint32 maxLength)
+{
+    Key key = { startRef, endRef, (uint32(includeFlags) << 16) | excludeFlags };
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto it = m_corridors.find(key);
+    if (it == m_corridors.end() || it->second.size() > maxLength)
+    {
+        ++s_misses;
+        return false;
+    }
+
+    length = uint32(it->second.size());
+    memcpy(path, it->second.data(), length * sizeof(dtPolyRef));
+    ++s_hits;
+    return true;
+}
+
+void PathCorridorCache::Store(dtPolyRef startRef, dtPolyRef endRef, uint16 includeFlags, uint16 excludeFlags,
+                              dtPolyRef const* path, uint32 length, uint32 generation)
+{
+    Key key = { startRef, endRef, (uint32(includeFlags) << 16) | excludeFlags };
+    std::lock_guard<std::mutex> guard(m_lock);
+    // tiles were loaded or unloaded since the query started: its polygon refs may be stale
+    if (m_generation.load(std::memory_order_relaxed) != generation)
+        return;
+    // no eviction order to maintain: start over when full, hot corridors come back within a tick
+    if (m_corridors.size() >= PATH_CORRIDOR_CACHE_SIZE)
+        m_corridors.clear();
+    m_corridors[key].assign(path, path + length);
+}
+
+void PathCorridorCache::Invalidate()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_generation.fetch_add(1, std::memory_order_release);
+    if (m_corridors.empty())
+        return;
+    m_corridors.clear();
+    ++s_invalidations;
+}
+
+PathCorridorStats PathCorridorCache::GetStats()
+{
+    PathCorridorStats stats;
+    stats.hits = s_hits;
+    stats.misses = s_misses;
+    stats.invalidations = s_invalidations;
+    return stats;
+}
+
+namespace
+{
+    // Queries leased by the current thread, one per navmesh it used. Given back to their pool on thread exit.
+    class ThreadNavMeshQueries
+    {
+        public:
+            ~ThreadNavMeshQueries()
+            {
+                for (auto& lease : m_leases)
+                    lease.pool->Release(lease.query);
+            }
+
+            dtNavMeshQuery* Get(NavMeshQueryPoolPtr const& pool)
+            {
+                for (auto it = m_leases.begin(); it != m_leases.end();)
+                {
+                    if (it->pool == pool)
+                        return it->query;
+                    // navmesh was unloaded since, drop the lease
+                    if (it->pool->IsClosed())
+                    {
+                        it->pool->Release(it->query);
+                        it = m_leases.erase(it);
+                    }
+                    else
+                        ++it;
+                }
+
+                dtNavMeshQuery* query = pool->Acquire();
+                if (query)
+                    m_leases.push_back({ pool, query });
+                return query;
+            }
+
+        private:
+            struct Lease
+            {
+                NavMeshQueryPoolPtr pool;
+                dtNavMeshQuery* query;
+            };
+            std::vector<Lease> m_leases;
+    };
+
+    thread_local ThreadNavMeshQueries t_navMeshQueries;
+}
+
 // ######################## MMapManager ########################
 MMapManager::~MMapManager()
 {
@@ -199,6 +372,8 @@ bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
     {
         mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
         ++loadedTiles;
+        // new links may give shorter corridors
+        mmap->corridorCache.Invalidate();
         return true;
     }
     else
@@ -245,6 +420,7 @@ bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     }
     else
     {
+        mmap->corridorCache.Invalidate();
         mmap->mmapLoadedTiles.erase(packedGridPos);
         --loadedTiles;
         return true;
@@ -281,32 +457,6 @@ bool MMapManager::unloadMap(uint32 mapId)
     return true;
 }
 
-bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
-{
-    // check if we have this map loaded
-    if (loadedMMaps.find(mapId) == loadedMMaps.end())
-    {
-        // file may not exist, therefore not loaded
-        DEBUG_LOG("MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
-        return false;
-    }
-
-    MMapData* mmap = loadedMMaps[mapId];
-    if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-    {
-        DEBUG_LOG("MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-        return false;
-    }
-
-    dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-    dtFreeNavMeshQuery(query);
-    mmap->navMeshQueries.erase(instanceId);
-    DETAIL_LOG("MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
-
-    return true;
-}
-
 dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
 {
     if (loadedMMaps.find(mapId) == loadedMMaps.end())
@@ -320,36 +470,7 @@ dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
     if (loadedMMaps.find(mapId) == loadedMMaps.end())
         return NULL;
 
-    uint32 tid = (uintptr_t) ACE_Based::Thread::currentId();
-    MMapData* mmap = loadedMMaps[mapId];
-    mmap->navMeshQueries_lock.acquire_read();
-
-    NavMeshQuerySet::iterator it = mmap->navMeshQueries.find(tid);
-    dtNavMeshQuery* navMeshQuery = NULL;
-    if (it == mmap->navMeshQueries.end())
-    {
-        mmap->navMeshQueries_lock.release();
-        mmap->navMeshQueries_lock.acquire_write();
-
-        // allocate mesh query
-        navMeshQuery = dtAllocNavMeshQuery();
-        MANGOS_ASSERT(navMeshQuery);
-        if (DT_SUCCESS != navMeshQuery->init(mmap->navMesh, 2048))
-        {
-            mmap->navMeshQueries_lock.release();
-            dtFreeNavMeshQuery(navMeshQuery);
-            sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u thread %u", mapId, tid);
-            return NULL;
-        }
-
-        DETAIL_LOG("MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u thread %u", mapId, tid);
-        mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(tid, navMeshQuery));
-    }
-    else
-        navMeshQuery = it->second;
-    mmap->navMeshQueries_lock.release();
-
-    return navMeshQuery;
+    return GetThreadQuery(loadedMMaps[mapId]);
 }
 
 bool MMapManager::loadGameObject(uint32 displayId)
@@ -424,28 +545,27 @@ dtNavMeshQuery const* MMapManager::GetModelNavMeshQuery(uint32 displayId)
     if (loadedModels.find(displayId) == loadedModels.end())
         return NULL;
 
-    uint32 tid = (uintptr_t) ACE_Based::Thread::currentId();
-    MMapData* mmap = loadedModels[displayId];
-    if (mmap->navMeshQueries.find(tid) == mmap->navMeshQueries.end())
-    {
-        ACE_Guard<ACE_Thread_Mutex> g(lockForModels);
-        if (mmap->navMeshQueries.find(tid) == mmap->navMeshQueries.end())
-        {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            if (dtStatusFailed(query->init(mmap->navMesh, 2048)))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for displayid %03u tid %u", displayId, tid);
-                return NULL;
-            }
+    return GetThreadQuery(loadedModels[displayId]);
+}
 
-            DETAIL_LOG("MMAP:GetNavMeshQuery: created dtNavMeshQuery for displayid %03u tid %u", displayId, tid);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(tid, query));
-        }
-    }
+PathCorridorCache* MMapManager::GetCorridorCache(uint32 mapId)
+{
+    if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        return NULL;
+
+    return &loadedMMaps[mapId]->corridorCache;
+}
+
+PathCorridorCache* MMapManager::GetModelCorridorCache(uint32 displayId)
+{
+    if (loadedModels.find(displayId) == loadedModels.end())
+        return NULL;
 
-    return mmap->navMeshQueries[tid];
+    return &loadedModels[displayId]->corridorCache;
+}
+
+dtNavMeshQuery const* MMapManager::GetThreadQuery(MMapData* mmap)
+{
+    return t_navMeshQueries.Get(mmap->queryPool);
 }
 }
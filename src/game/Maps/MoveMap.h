@@ -26,6 +26,10 @@
 #include "Platform/CompilerDefs.h"
 #include "Platform/Define.h"
 #include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "Detour/Include/DetourAlloc.h"
 #include "Detour/Include/DetourNavMesh.h"
@@ -46,16 +50,113 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+
+    #define NAVMESH_QUERY_POOL_SIZE     32
+    #define NAVMESH_QUERY_MAX_NODES     2048
+
+    struct NavMeshQueryStats
+    {
+        uint64 leases;                      // queries handed to a thread
+        uint64 misses;                      // leases that had to allocate a new query
+        uint32 active;                      // queries currently leased
+        uint32 peak;                        // highest number of queries leased at once
+    };
+
+    // Free dtNavMeshQuery objects of one navmesh, kept in lock-free slots.
+    // A thread leases a query on first use and gives it back when it exits (see GetNavMeshQuery),
+    // so the number of queries follows the number of concurrent threads, not their ids.
+    class NavMeshQueryPool
+    {
+        public:
+            explicit NavMeshQueryPool(dtNavMesh const* mesh);
+            ~NavMeshQueryPool();
+
+            dtNavMeshQuery* Acquire();
+            void Release(dtNavMeshQuery* query);
+
+            // Navmesh is being unloaded: queries still leased are freed when given back
+            void Close() { m_closed = true; }
+            bool IsClosed() const { return m_closed; }
+
+            static NavMeshQueryStats GetStats();
+
+        private:
+            dtNavMesh const* m_navMesh;
+            std::atomic<dtNavMeshQuery*> m_slots[NAVMESH_QUERY_POOL_SIZE];
+            std::atomic<bool> m_closed;
+
+            static std::atomic<uint64> s_leases;
+            static std::atomic<uint64> s_misses;
+            static std::atomic<uint32> s_active;
+            static std::atomic<uint32> s_peak;
+    };
+
+    typedef std::shared_ptr<NavMeshQueryPool> NavMeshQueryPoolPtr;
+
+    #define PATH_CORRIDOR_CACHE_SIZE    4096
+
+    struct PathCorridorStats
+    {
+        uint64 hits;
+        uint64 misses;
+        uint64 invalidations;
+    };
+
+    // Polygon corridors found by PathInfo, keyed on their start and end polygons and the filter used.
+    // Poly refs change when tiles come and go, so the whole cache is dropped on tile load/unload.
+    class PathCorridorCache
+    {
+        public:
+            PathCorridorCache() : m_generation(0) {}
+
+            // Copies the corridor into path (up to maxLength polygons) when known
+            bool Find(dtPolyRef startRef, dtPolyRef endRef, uint16 includeFlags, uint16 excludeFlags,
+                      dtPolyRef* path, uint32& length, uint32 maxLength);
+            // generation: GetGeneration() read before the query, so a tile change during the query discards the corridor
+            void Store(dtPolyRef startRef, dtPolyRef endRef, uint16 includeFlags, uint16 excludeFlags,
+                       dtPolyRef const* path, uint32 length, uint32 generation);
+            void Invalidate();
+            uint32 GetGeneration() const { return m_generation.load(std::memory_order_acquire); }
+
+            static PathCorridorStats GetStats();
+
+        private:
+            struct Key
+            {
+                dtPolyRef startRef;
+                dtPolyRef endRef;
+                uint32 flags;
+
+                bool operator==(Key const& other) const
+                {
+                    return startRef == other.startRef && endRef == other.endRef && flags == other.flags;
+                }
+            };
+            struct KeyHash
+            {
+                size_t operator()(Key const& key) const
+                {
+                    uint64 hash = (uint64(key.startRef) * 0x9E3779B97F4A7C15ULL) ^ (uint64(key.endRef) + (uint64(key.flags) << 32));
+                    return size_t(hash ^ (hash >> 29));
+                }
+            };
+
+            std::mutex m_lock;
+            std::unordered_map<Key, std::vector<dtPolyRef>, KeyHash> m_corridors;
+            std::atomic<uint32> m_generation;                   // changed under m_lock by each Invalidate()
+
+            static std::atomic<uint64> s_hits;
+            static std::atomic<uint64> s_misses;
+            static std::atomic<uint64> s_invalidations;
+    };
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), queryPool(new NavMeshQueryPool(mesh)) {}
         ~MMapData()
         {
-            for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
-                dtFreeNavMeshQuery(i->second);
+            queryPool->Close();
 
             if (navMesh)
                 dtFreeNavMesh(navMesh);
@@ -63,9 +164,9 @@ namespace MMAP
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // threadId to query
-        ACE_RW_Mutex navMeshQueries_lock;
+        // we have to use single dtNavMeshQuery for every thread, since those are not thread safe
+        NavMeshQueryPoolPtr queryPool;
+        PathCorridorCache corridorCache;
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
         ACE_Thread_Mutex tilesLoading_lock;
     };
@@ -84,18 +185,22 @@ namespace MMAP
             bool loadGameObject(uint32 displayId);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
             // The returned [dtNavMeshQuery const*] is NOT threadsafe
             // Returns a NavMeshQuery valid for current thread only.
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
+            PathCorridorCache* GetCorridorCache(uint32 mapId);
+            PathCorridorCache* GetModelCorridorCache(uint32 displayId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+            NavMeshQueryStats getNavMeshQueryStats() const { return NavMeshQueryPool::GetStats(); }
+            PathCorridorStats getPathCorridorStats() const { return PathCorridorCache::GetStats(); }
         private:
             bool loadMapData(uint32 mapId);
+            dtNavMeshQuery const* GetThreadQuery(MMapData* mmap);
             uint32 packTileID(int32 x, int32 y);
 
             MMapDataSet loadedMMaps;
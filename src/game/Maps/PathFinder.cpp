@@ -35,7 +35,7 @@
 PathInfo::PathInfo(const Unit* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL), m_transport(NULL), m_targetAllowedFlags(0)
+    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL), m_corridorCache(NULL), m_transport(NULL), m_targetAllowedFlags(0)
 {
     //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
     createFilter();
@@ -62,9 +62,13 @@ bool PathInfo::calculate(float destX, float destY, float destZ, bool forceDest,
         if (!offsets)
             m_transport->CalculatePassengerOffset(destX, destY, destZ);
         m_navMeshQuery = mmap->GetModelNavMeshQuery(m_transport->GetDisplayId());
+        m_corridorCache = mmap->GetModelCorridorCache(m_transport->GetDisplayId());
     }
     else
+    {
         m_navMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId());
+        m_corridorCache = mmap->GetCorridorCache(m_sourceUnit->GetMapId());
+    }
 
     if (m_navMeshQuery)
         m_navMesh = m_navMeshQuery->getAttachedNavMesh();
@@ -311,14 +315,13 @@ void PathInfo::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
 
         // generate suffix
         uint32 suffixPolyLength = 0;
-        dtStatus dtResult = m_navMeshQuery->findPath(
+        dtStatus dtResult = findPolyPath(
                                 suffixStartPoly,    // start polygon
                                 endPoly,            // end polygon
                                 suffixEndPoint,     // start position
                                 endPoint,           // end position
-                                &m_filter,            // polygon search filter
                                 m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
-                                (int*)&suffixPolyLength,
+                                &suffixPolyLength,
                                 MAX_PATH_LENGTH - prefixPolyLength); // max number of polygons in output path
 
         if (!suffixPolyLength || dtStatusFailed(dtResult))
@@ -345,19 +348,13 @@ void PathInfo::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
         // free and invalidate old path data
         clear();
 
-        unsigned int const threadId = (uintptr_t) ACE_Based::Thread::currentId();
-
-        //if (threadId != m_navMeshQuery->m_owningThread)
-            //sLog.outError("CRASH: We are using a dtNavMeshQuery from thread %u which belongs to thread %u!", threadId, m_navMeshQuery->m_owningThread);
-
-        dtStatus dtResult = m_navMeshQuery->findPath(
+        dtStatus dtResult = findPolyPath(
                                 startPoly,          // start polygon
                                 endPoly,            // end polygon
                                 startPoint,         // start position
                                 endPoint,           // end position
-                                &m_filter,           // polygon search filter
                                 m_pathPolyRefs,     // [out] path
-                                (int*)&m_polyLength,
+                                &m_polyLength,
                                 MAX_PATH_LENGTH);   // max number of polygons in output path
 
         if (!m_polyLength || dtStatusFailed(dtResult))
@@ -379,6 +376,26 @@ void PathInfo::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
     BuildPointPath(startPoint, endPoint, distToStartPoly, distToEndPoly);
 }
 
+dtStatus PathInfo::findPolyPath(dtPolyRef startRef, dtPolyRef endRef, const float* startPos, const float* endPos,
+                                dtPolyRef* path, uint32* pathCount, uint32 maxPath)
+{
+    // many units chase the same target through the same polygons: reuse their corridor
+    uint16 includeFlags = m_filter.getIncludeFlags();
+    uint16 excludeFlags = m_filter.getExcludeFlags();
+    if (m_corridorCache && m_corridorCache->Find(startRef, endRef, includeFlags, excludeFlags, path, *pathCount, maxPath))
+        return DT_SUCCESS;
+    uint32 generation = m_corridorCache ? m_corridorCache->GetGeneration() : 0;
+
+    dtStatus dtResult = m_navMeshQuery->findPath(startRef, endRef, startPos, endPos, &m_filter, path, (int*)pathCount, maxPath);
+
+    // partial corridors depend on the search limits, only keep complete ones
+    if (m_corridorCache && dtStatusSucceed(dtResult) && !dtStatusDetail(dtResult, DT_PARTIAL_RESULT) &&
+            *pathCount && path[*pathCount - 1] == endRef)
+        m_corridorCache->Store(startRef, endRef, includeFlags, excludeFlags, path, *pathCount, generation);
+
+    return dtResult;
+}
+
 void PathInfo::BuildPointPath(const float *startPoint, const float *endPoint, float distToStartPoly, float distToEndPoly)
 {
     // generate the point-path out of our up-to-date poly-path
@@ -33,6 +33,11 @@ class Unit;
 class Transport;
 struct GridMapLiquidData;
 
+namespace MMAP
+{
+    class PathCorridorCache;
+}
+
 // 64*6.0f=384y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
 // I think we can safely cut those down even more
@@ -108,6 +113,7 @@ class PathInfo
         const Unit* const       m_sourceUnit;       // the unit that is moving
         const dtNavMesh*        m_navMesh;          // the nav mesh
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
+        MMAP::PathCorridorCache* m_corridorCache;   // corridors already found on this nav mesh
         uint32          m_targetAllowedFlags;
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
@@ -129,6 +135,8 @@ class PathInfo
         bool HaveTiles(const Vector3& p) const;
 
         void BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos);
+        dtStatus findPolyPath(dtPolyRef startRef, dtPolyRef endRef, const float* startPos, const float* endPos,
+                              dtPolyRef* path, uint32* pathCount, uint32 maxPath);
         void BuildPointPath(const float *startPoint, const float *endPoint, float distToStartPoly, float distToEndPoly);
         void BuildShortcut();
         void BuildUnderwaterPath();
@@ -89,7 +89,7 @@ class MANGOS_DLL_SPEC MotionMaster : std::stack<MovementGenerator *>
 
     public:
 
-        explicit MotionMaster(Unit *unit) : m_needsAsyncUpdate(false), m_owner(unit), m_expList(nullptr), m_cleanFlag(MMCF_NONE) {}
+        explicit MotionMaster(Unit *unit) : m_needsAsyncUpdate(false), m_queuedAsyncDiff(0), m_owner(unit), m_expList(nullptr), m_cleanFlag(MMCF_NONE) {}
         ~MotionMaster();
 
         void Initialize();
@@ -160,6 +160,9 @@ class MANGOS_DLL_SPEC MotionMaster : std::stack<MovementGenerator *>
 
         bool NeedsAsyncUpdate() const { return m_needsAsyncUpdate; }
         void SetNeedAsyncUpdate() { m_needsAsyncUpdate = true; }
+        // Async update batched by the map: sum of the update diffs of the owner until the batch runs
+        void QueueAsyncUpdate(uint32 diff) { m_queuedAsyncDiff += diff; }
+        uint32 TakeQueuedAsyncDiff() { uint32 diff = m_queuedAsyncDiff; m_queuedAsyncDiff = 0; return diff; }
     private:
         void Mutate(MovementGenerator *m);                  // use Move* functions instead
 
@@ -170,6 +173,7 @@ class MANGOS_DLL_SPEC MotionMaster : std::stack<MovementGenerator *>
         void DelayedExpire(bool reset);
 
         bool        m_needsAsyncUpdate;
+        uint32      m_queuedAsyncDiff;
         Unit       *m_owner;
         ExpireList *m_expList;
         uint8       m_cleanFlag;
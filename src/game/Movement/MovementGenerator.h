@@ -60,6 +60,9 @@ class MANGOS_DLL_SPEC MovementGenerator
         // given destination unreachable? due to pathfinding or other
         virtual bool IsReachable() const { return true; }
 
+        // unit followed or chased, batched path requests are grouped by it
+        virtual Unit* GetCurrentTarget() const { return nullptr; }
+
         // used by Evade code for select point to evade with expected restart default movement
         virtual bool GetResetPosition(Unit &, float& /*x*/, float& /*y*/, float& /*z*/) { return false; }
 
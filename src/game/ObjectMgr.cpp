@@ -1793,8 +1793,8 @@ void ObjectMgr::LoadCreatureSpells()
 void ObjectMgr::LoadCreatures(bool reload)
 {
     uint32 count = 0;
-    //                                                                          0                  1     2      3
-    std::unique_ptr<QueryResult> result(WorldDatabase.Query("SELECT `creature`.`guid`, `creature`.`id`, `map`, `modelid`,"
+    //                                  0                  1     2      3
+    char const* query = "SELECT `creature`.`guid`, `creature`.`id`, `map`, `modelid`,"
     //                      4               5             6             7             8              9                   10                  11           12
                           "`equipment_id`, `position_x`, `position_y`, `position_z`, `orientation`, `spawntimesecsmin`, `spawntimesecsmax`, `spawndist`, `currentwaypoint`,"
     //                      13           14         15            16              17
@@ -1804,7 +1804,14 @@ void ObjectMgr::LoadCreatures(bool reload)
                           "FROM `creature` "
                           "LEFT OUTER JOIN `game_event_creature` ON `creature`.`guid` = `game_event_creature`.`guid` "
                           "LEFT OUTER JOIN `pool_creature` ON `creature`.`guid` = `pool_creature`.`guid` "
-                          "LEFT OUTER JOIN `pool_creature_template` ON `creature`.`id` = `pool_creature_template`.`id`"));
+                          "LEFT OUTER JOIN `pool_creature_template` ON `creature`.`id` = `pool_creature_template`.`id`";
+
+    if (sWorld.getConfig(CONFIG_BOOL_WORLD_DB_BINARY_RESULTS_COMPARE))
+        WorldDatabase.CompareQueryProtocols(query);
+
+    uint32 startTime = WorldTimer::getMSTime();
+    bool binary = sWorld.getConfig(CONFIG_BOOL_WORLD_DB_BINARY_RESULTS);
+    std::unique_ptr<QueryResult> result(binary ? WorldDatabase.QueryBinary(query) : WorldDatabase.Query(query));
 
     if (!result)
     {
@@ -1990,7 +1997,8 @@ void ObjectMgr::LoadCreatures(bool reload)
     while (result->NextRow());
 
     sLog.outString();
-    sLog.outString(">> Loaded %lu creatures", (unsigned long)m_CreatureDataMap.size());
+    sLog.outString(">> Loaded %lu creatures in %u ms (%s protocol)", (unsigned long)m_CreatureDataMap.size(),
+        WorldTimer::getMSTimeDiffToNow(startTime), binary ? "binary" : "text");
 }
 
 void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
@@ -59,6 +59,7 @@
 #include "TemporarySummon.h"
 #include "ScriptedEscortAI.h"
 #include "GuardMgr.h"
+#include "LogsDatabaseWriter.h"
 
 // apply implementation of the singletons
 #include "Policies/SingletonImp.h"
@@ -2553,18 +2554,17 @@ void Creature::LogDeath(Unit* pKiller) const
             return;
     }
 
-    static SqlStatementID insLogDeath;
-    SqlStatement logStmt = LogsDatabase.CreateStatement(insLogDeath, "INSERT INTO smartlog_creature SET type=?, entry=?, guid=?, specifier=?, combatTime=?, content=?");
+    LogsDatabaseEvent event(LOGS_TABLE_SMARTLOG_CREATURE);
 
-    logStmt.addString("Death");
-    logStmt.addInt32(GetEntry());
-    logStmt.addInt32(GetGUIDLow());
+    event.addString("Death");
+    event.addInt32(GetEntry());
+    event.addInt32(GetGUIDLow());
 
     const MapEntry* mapEntry = sMapStorage.LookupEntry<MapEntry>(GetMapId());
     std::string result0 = mapEntry->name;
 
-    logStmt.addString(result0 + "." + GetName());
-    logStmt.addInt32(GetCombatTime(true));
+    event.addString(result0 + "." + GetName());
+    event.addInt32(GetCombatTime(true));
 
     if (pKiller)
     {
@@ -2593,7 +2593,7 @@ void Creature::LogDeath(Unit* pKiller) const
 
             result1 += ">.";
 
-            logStmt.addString(result1);
+            event.addString(result1);
         }
         else if (pUnit)
         {
@@ -2604,20 +2604,20 @@ void Creature::LogDeath(Unit* pKiller) const
                 result1 += "> with entry <";
                 result1 += pCreature->GetEntry();
                 result1 += ">.";
-                logStmt.addString(result1);
+                event.addString(result1);
             }
             else
-                logStmt.addString("Dead not by creature or player, unit exists though.");
+                event.addString("Dead not by creature or player, unit exists though.");
         }
         else
-            logStmt.addString("Dead not by creature or player, unit not exists.");
+            event.addString("Dead not by creature or player, unit not exists.");
     }
     else
     {
-        logStmt.addString("Unknown death reason (no argument passed).");
+        event.addString("Unknown death reason (no argument passed).");
     }
 
-    logStmt.Execute();
+    event.Write();
 }
 
 void Creature::LogLongCombat() const
@@ -2625,21 +2625,20 @@ void Creature::LogLongCombat() const
     if (!LogsDatabase || !sWorld.getConfig(CONFIG_BOOL_SMARTLOG_LONGCOMBAT))
         return;
 
-    static SqlStatementID insLogDeath;
-    SqlStatement logStmt = LogsDatabase.CreateStatement(insLogDeath, "INSERT INTO smartlog_creature SET type=?, entry=?, guid=?, specifier=?, combatTime=?, content=?");
+    LogsDatabaseEvent event(LOGS_TABLE_SMARTLOG_CREATURE);
 
-    logStmt.addString("LongCombat");
-    logStmt.addInt32(GetEntry());
-    logStmt.addInt32(GetGUIDLow());
+    event.addString("LongCombat");
+    event.addInt32(GetEntry());
+    event.addInt32(GetGUIDLow());
 
     const MapEntry* mapEntry = sMapStorage.LookupEntry<MapEntry>(GetMapId());
     std::string result0 = mapEntry->name;
 
-    logStmt.addString(result0 + "." + GetName());
-    logStmt.addInt32(GetCombatTime(true));
-    logStmt.addString("");
+    event.addString(result0 + "." + GetName());
+    event.addInt32(GetCombatTime(true));
+    event.addString("");
 
-    logStmt.Execute();
+    event.Write();
 }
 
 void Creature::LogScriptInfo(std::ostringstream &data) const
@@ -2647,21 +2646,20 @@ void Creature::LogScriptInfo(std::ostringstream &data) const
     if (!LogsDatabase || !sWorld.getConfig(CONFIG_BOOL_SMARTLOG_SCRIPTINFO))
         return;
 
-    static SqlStatementID insLogDeath;
-    SqlStatement logStmt = LogsDatabase.CreateStatement(insLogDeath, "INSERT INTO smartlog_creature SET type=?, entry=?, guid=?, specifier=?, combatTime=?, content=?");
+    LogsDatabaseEvent event(LOGS_TABLE_SMARTLOG_CREATURE);
 
-    logStmt.addString("ScriptInfo");
-    logStmt.addInt32(GetEntry());
-    logStmt.addInt32(GetGUIDLow());
+    event.addString("ScriptInfo");
+    event.addInt32(GetEntry());
+    event.addInt32(GetGUIDLow());
 
     const MapEntry* mapEntry = sMapStorage.LookupEntry<MapEntry>(GetMapId());
     std::string result0 = mapEntry->name;
 
-    logStmt.addString(result0 + "." + GetName());
-    logStmt.addInt32(GetCombatTime(true));
-    logStmt.addString(data);
+    event.addString(result0 + "." + GetName());
+    event.addInt32(GetCombatTime(true));
+    event.addString(data.str());
 
-    logStmt.Execute();
+    event.Write();
 }
 
 Unit* Creature::SelectAttackingTarget(AttackingTarget target, uint32 position, uint32 spellId, uint32 selectFlags) const
@@ -2249,7 +2249,11 @@ void GameObject::UpdateCollisionState()
         return;
 
     bool enabled = GetGoType() == GAMEOBJECT_TYPE_CHEST ? getLootState() == GO_READY : GetGoState() == GO_STATE_READY;
+    if (m_model->isEnabled() == enabled)
+        return;
+
     m_model->enable(enabled);
+    GetMap()->InvalidateDynamicLineOfSight(*m_model);
 }
 
 void GameObject::UpdateModel()
@@ -389,7 +389,12 @@ void WorldObject::DirectSendPublicValueUpdate(uint32 index)
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player *target) const
 {
     ByteBuffer buf(500);
+    BuildValuesUpdateBlock(buf, target);
+    data->AddUpdateBlock(buf);
+}
 
+void Object::BuildValuesUpdateBlock(ByteBuffer& buf, Player* target) const
+{
     buf << uint8(UPDATETYPE_VALUES);
 #if SUPPORTED_CLIENT_BUILD > CLIENT_BUILD_1_8_4
     buf << GetPackGUID();
@@ -402,8 +407,48 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player *target) c
 
     _SetUpdateBits(&updateMask, target);
     BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+}
 
-    data->AddUpdateBlock(buf);
+/**
+ * Returns the class of viewers that receive exactly the same UPDATETYPE_VALUES block as 'target'
+ * for the fields changed since the last update. Must stay in sync with the per-target cases of
+ * BuildValuesUpdate: any field rewritten according to the target itself makes the block unique.
+ */
+ValuesUpdateViewerClass Object::GetValuesUpdateViewerClass(Player const* target) const
+{
+    if (target == this)
+        return VALUES_VIEWER_SELF;
+
+    // Game objects store the quest activation state per viewer while building the block
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return VALUES_VIEWER_UNIQUE;
+
+    if (!isType(TYPEMASK_UNIT))
+    {
+        if (GetTypeId() == TYPEID_CORPSE && IsValueChanged(CORPSE_FIELD_DYNAMIC_FLAGS))
+            return VALUES_VIEWER_UNIQUE;
+        return VALUES_VIEWER_OTHER;
+    }
+
+    if (target->IsGameMaster() || target->HasOption(PLAYER_VIDEO_MODE))
+        return VALUES_VIEWER_UNIQUE;
+    if (IsValueChanged(UNIT_DYNAMIC_FLAGS))
+        return VALUES_VIEWER_UNIQUE;
+    if (GetTypeId() == TYPEID_UNIT && IsValueChanged(UNIT_NPC_FLAGS))
+        return VALUES_VIEWER_UNIQUE;
+
+    Player* owner = ((Unit*)this)->GetCharmerOrOwnerPlayerOrPlayerItself();
+    if (!owner)
+        return VALUES_VIEWER_OTHER;
+    if (owner == target)
+        return VALUES_VIEWER_OWNER;
+    if (!owner->IsInSameRaidWith(target))
+        return VALUES_VIEWER_OTHER;
+
+    // Inter-faction raids: faction is rewritten with the viewer's one
+    if (IsValueChanged(UNIT_FIELD_FACTIONTEMPLATE))
+        return VALUES_VIEWER_UNIQUE;
+    return VALUES_VIEWER_GROUP;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData * data) const
@@ -1011,6 +1056,10 @@ void Object::SetFloatValue(uint16 index, float value)
     {
         m_floatValues[ index ] = value;
         MarkForClientUpdate();
+
+        // the grid searchers filter on the radius packed with the position, whoever sets it
+        if (index == UNIT_FIELD_BOUNDINGRADIUS && isType(TYPEMASK_UNIT))
+            static_cast<WorldObject*>(this)->UpdateGridPosition();
     }
 }
 
@@ -1189,7 +1238,7 @@ bool Object::PrintIndexError(uint32 index, bool set) const
     return false;
 }
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players)
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateBlockCache* cache)
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -1200,7 +1249,41 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (!cache)
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        return;
+    }
+
+    ValuesUpdateViewerClass viewerClass = cache->shareBlocks ? GetValuesUpdateViewerClass(pl) : VALUES_VIEWER_UNIQUE;
+    if (viewerClass == VALUES_VIEWER_UNIQUE)
+    {
+        ByteBuffer buf(500);
+        BuildValuesUpdateBlock(buf, pl);
+        cache->bytesBuilt += buf.wpos();
+        iter->second.AddUpdateBlock(buf);
+        return;
+    }
+
+    ByteBuffer& block = cache->blocks[viewerClass];
+    if (!cache->built[viewerClass])
+    {
+        BuildValuesUpdateBlock(block, pl);
+        cache->built[viewerClass] = true;
+        cache->bytesBuilt += block.wpos();
+    }
+    else
+        cache->bytesShared += block.wpos();
+    iter->second.AddUpdateBlock(block);
+}
+
+std::atomic<uint64> Object::ms_valuesUpdateBytesBuilt(0);
+std::atomic<uint64> Object::ms_valuesUpdateBytesShared(0);
+
+void Object::AddValuesUpdateStats(ValuesUpdateBlockCache const& cache)
+{
+    ms_valuesUpdateBytesBuilt += cache.bytesBuilt;
+    ms_valuesUpdateBytesShared += cache.bytesShared;
 }
 
 void Object::AddToClientUpdateList()
@@ -1324,6 +1407,7 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
     m_position.y = y;
     m_position.z = z;
     m_position.o = orientation;
+    UpdateGridPosition();
 
     m_movementInfo.ChangePosition(x, y, z, orientation);
     m_movementInfo.UpdateTime(WorldTimer::getMSTime());
@@ -1341,6 +1425,11 @@ void WorldObject::Relocate(float x, float y, float z)
     Relocate(x, y, z, GetOrientation());
 }
 
+void WorldObject::AddToGridPositions(GridPositions& positions)
+{
+    positions.Add(m_gridPosition, this, GetGUID(), GetTypeId(), m_position.x, m_position.y, m_position.z, GetObjectBoundingRadius());
+}
+
 void WorldObject::SetOrientation(float orientation)
 {
     m_position.o = orientation;
@@ -1868,7 +1957,7 @@ void WorldObject::SendMessageToSet(WorldPacket *data, bool /*bToSelf*/) const
 
 struct MANGOS_DLL_DECL ObjectViewersDeliverer
 {
-    WorldPacket* i_message;
+    BroadcastPacket i_message;
     WorldObject const* i_sender;
     WorldObject const* i_except;
     explicit ObjectViewersDeliverer(WorldObject const* sender, WorldPacket *msg, WorldObject const* except) : i_message(msg), i_sender(sender), i_except(except) {}
@@ -1878,7 +1967,7 @@ struct MANGOS_DLL_DECL ObjectViewersDeliverer
             if (Player* player = iter->getSource()->GetOwner())
                 if (player != i_except && player != i_sender)
                     if (player->IsInVisibleList_Unsafe(i_sender))
-                        player->GetSession()->SendPacket(i_message);
+                        i_message.SendTo(player->GetSession());
     }
     template<class SKIP> void Visit(GridRefManager<SKIP> &) {}
 };
@@ -2447,12 +2536,13 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType &i_updateDatas;
     WorldObject &i_object;
-    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj)
+    ValuesUpdateBlockCache* i_blockCache;
+    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d, ValuesUpdateBlockCache* cache) : i_updateDatas(d), i_object(obj), i_blockCache(cache)
     {
         // send self fields changes in another way, otherwise
         // with new camera system when player's camera too far from player, camera wouldn't receive packets and changes from player
         if (i_object.isType(TYPEMASK_PLAYER))
-            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas);
+            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas, i_blockCache);
     }
 
     void Visit(CameraMapType &m)
@@ -2461,7 +2551,7 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter->getSource()->GetOwner();
             if (owner != &i_object && owner->IsInVisibleList_Unsafe(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, i_blockCache);
         }
     }
 
@@ -2470,10 +2560,13 @@ struct WorldObjectChangeAccumulator
 
 void WorldObject::BuildUpdateData(UpdateDataMapType & update_players)
 {
-    WorldObjectChangeAccumulator notifier(*this, update_players);
+    // Viewers of the same class share one serialized values block
+    ValuesUpdateBlockCache blockCache(sWorld.getConfig(CONFIG_BOOL_SHARE_VALUES_UPDATE_BLOCKS));
+    WorldObjectChangeAccumulator notifier(*this, update_players, &blockCache);
     // Update with modifier for long range players
     Cell::VisitWorldObjects(this, notifier, GetMap()->GetVisibilityDistance() + GetVisibilityModifier());
 
+    AddValuesUpdateStats(blockCache);
     ClearUpdateMask(false);
 }
 
@@ -29,7 +29,10 @@
 #include "ObjectGuid.h"
 #include "Camera.h"
 #include "SpellEntry.h"
+#include "MapWorkQueue.h"
+#include "GameSystem/GridPositions.h"
 
+#include <atomic>
 #include <set>
 #include <string>
 
@@ -89,6 +92,33 @@ class Transport;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
 
+// Viewers of an object which are guaranteed to receive byte-identical values update blocks
+enum ValuesUpdateViewerClass
+{
+    VALUES_VIEWER_SELF      = 0,
+    VALUES_VIEWER_OWNER     = 1,                            // charmer or owner player of the object
+    VALUES_VIEWER_GROUP     = 2,                            // in the same raid as the owner
+    VALUES_VIEWER_OTHER     = 3,
+    MAX_VALUES_VIEWER_CLASS = 4,
+    VALUES_VIEWER_UNIQUE    = MAX_VALUES_VIEWER_CLASS       // block depends on the viewer itself, can't be shared
+};
+
+// Values update blocks already serialized for an object during one BuildUpdateData call
+struct ValuesUpdateBlockCache
+{
+    explicit ValuesUpdateBlockCache(bool share) : shareBlocks(share), bytesBuilt(0), bytesShared(0)
+    {
+        for (int i = 0; i < MAX_VALUES_VIEWER_CLASS; ++i)
+            built[i] = false;
+    }
+
+    bool shareBlocks;                                       // false: one block per viewer, only keep stats
+    ByteBuffer blocks[MAX_VALUES_VIEWER_CLASS];
+    bool built[MAX_VALUES_VIEWER_CLASS];
+    uint32 bytesBuilt;                                      // serialized by BuildValuesUpdate
+    uint32 bytesShared;                                     // copied from a block built for another viewer
+};
+
 struct Position
 {
     Position() = default;
@@ -360,12 +390,18 @@ class MANGOS_DLL_SPEC Object
         void ExecuteDelayedActions();
 
         void BuildValuesUpdateBlockForPlayer( UpdateData *data, Player *target ) const;
+        void BuildValuesUpdateBlock(ByteBuffer& buf, Player* target) const;
+        ValuesUpdateViewerClass GetValuesUpdateViewerClass(Player const* target) const;
         void BuildOutOfRangeUpdateBlock( UpdateData *data ) const;
         void BuildMovementUpdateBlock( UpdateData * data, uint8 flags = 0 ) const;
 
         void BuildMovementUpdate(ByteBuffer * data, uint8 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer *data, UpdateMask *updateMask, Player *target ) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players);
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateBlockCache* cache = nullptr);
+
+        // Bytes of values update blocks serialized / shared between viewers since startup
+        static uint64 GetValuesUpdateBytesBuilt() { return ms_valuesUpdateBytesBuilt; }
+        static uint64 GetValuesUpdateBytesShared() { return ms_valuesUpdateBytesShared; }
 
         void SendOutOfRangeUpdateToPlayer(Player* player);
 
@@ -589,6 +625,9 @@ class MANGOS_DLL_SPEC Object
 
         virtual bool HasQuest(uint32 /* quest_id */) const { return false; }
         virtual bool HasInvolvedQuest(uint32 /* quest_id */) const { return false; }
+
+        // Position in Map::i_objectsToClientUpdate
+        MapWorkQueueSlot& GetClientUpdateQueueSlot() { return m_clientUpdateQueueSlot; }
     protected:
 
         Object ( );
@@ -601,6 +640,12 @@ class MANGOS_DLL_SPEC Object
 
         virtual void _SetCreateBits(UpdateMask *updateMask, Player *target) const;
 
+        bool IsValueChanged(uint16 index) const { return index < m_valuesCount && m_uint32Values_mirror[index] != m_uint32Values[index]; }
+        static void AddValuesUpdateStats(ValuesUpdateBlockCache const& cache);
+
+        static std::atomic<uint64> ms_valuesUpdateBytesBuilt;
+        static std::atomic<uint64> ms_valuesUpdateBytesShared;
+
         uint16 m_objectType;
 
         uint8 m_objectTypeId;
@@ -618,6 +663,7 @@ class MANGOS_DLL_SPEC Object
         uint16 m_valuesCount;
 
         bool m_objectUpdated;
+        MapWorkQueueSlot m_clientUpdateQueueSlot;
         bool _deleted;          // Object in remove list
         uint32 _delayedActions;
 
@@ -676,6 +722,15 @@ m_obj->m_updateTracker.Reset();
         void Relocate(float x, float y, float z, float orientation);
         void Relocate(float x, float y, float z);
 
+        // Packed copy of the position in the cell container holding the object, for the grid searchers
+        void AddToGridPositions(GridPositions& positions);
+        void RemoveFromGridPositions() { GridPositions::Remove(m_gridPosition); }
+        void UpdateGridPosition()
+        {
+            if (m_gridPosition.owner)
+                GridPositions::Update(m_gridPosition, m_position.x, m_position.y, m_position.z, GetObjectBoundingRadius());
+        }
+
         void SetOrientation(float orientation);
 
         float GetPositionX( ) const { return m_position.x; }
@@ -941,6 +996,7 @@ m_obj->m_updateTracker.Reset();
         uint32 m_InstanceId;                                // in map copy with instance id
 
         Position m_position;
+        GridPositionSlot m_gridPosition;
 
         ViewPoint m_viewPoint;
 
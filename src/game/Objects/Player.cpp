@@ -578,6 +578,9 @@ Player::Player(WorldSession *session) : Unit(),
     i_AI = NULL;
     _playerOptions = 0x0;
     m_DbSaveDisabled = false;
+    ResetSaveSections();
+    for (uint32 i = 0; i < MAX_SAVE_SECTIONS; ++i)
+        m_saveSectionWrites[i] = 0;
 
     m_lastFromClientCastedSpellID = 0;
 
@@ -1366,6 +1369,7 @@ void Player::Update(uint32 update_diff, uint32 p_time)
             m_position.y = y;
             m_position.z = z;
             m_position.o = o;
+            UpdateGridPosition();
             /*
             if (Unit* c = SummonCreature(1, x, y, z, o, TEMPSUMMON_TIMED_DESPAWN, 5000))
             {
@@ -1416,6 +1420,7 @@ void Player::RelocateToLastClientPosition()
         m_position.y = y;
         m_position.z = z;
         m_position.o = o;
+        UpdateGridPosition();
     }
 }
 
@@ -2620,6 +2625,7 @@ void Player::SetGMVisible(bool on, bool notify)
     }
     // Sauvegarde directement pour que le site n'affiche plus le MJ parmis les joueurs co.
     CharacterDatabase.PExecute("UPDATE characters SET extra_flags = %u WHERE guid = %u", m_ExtraFlags, GetGUIDLow());
+    InvalidateSaveSection(SAVE_SECTION_CHARACTER);
 }
 
 void Player::SetGodMode(bool on, bool notify)
@@ -3720,25 +3726,42 @@ void Player::_SaveSpellCooldowns()
     static SqlStatementID deleteSpellCooldown ;
     static SqlStatementID insertSpellCooldown ;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
     time_t curTime = time(NULL);
     time_t infTime = curTime + infinityCooldownDelayCheck;
 
-    // remove outdated and save active
+    // remove outdated, cooldowns ending are absolute times: the saved rows only change when a cooldown starts or expires
+    uint64 hash = FNV1A_64_SEED;
     for (SpellCooldowns::iterator itr = m_spellCooldowns.begin(); itr != m_spellCooldowns.end();)
     {
         if (itr->second.end <= curTime)
             m_spellCooldowns.erase(itr++);
-        else if (itr->second.end <= infTime)                // not save locked cooldowns, it will be reset or set at reload
+        else
+        {
+            if (itr->second.end <= infTime)
+            {
+                hash = HashFNV1aValue(itr->first, hash);
+                hash = HashFNV1aValue(itr->second.itemid, hash);
+                hash = HashFNV1aValue(uint64(itr->second.end), hash);
+                hash = HashFNV1aValue(uint64(itr->second.categoryEnd), hash);
+            }
+            ++itr;
+        }
+    }
+
+    if (!IsSaveSectionChanged(SAVE_SECTION_COOLDOWNS, hash))
+        return;
+
+    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
+    stmt.PExecute(GetGUIDLow());
+
+    // save active
+    for (SpellCooldowns::const_iterator itr = m_spellCooldowns.begin(); itr != m_spellCooldowns.end(); ++itr)
+    {
+        if (itr->second.end <= infTime)                     // not save locked cooldowns, it will be reset or set at reload
         {
             stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid, spell, item, time, cattime) VALUES( ?, ?, ?, ?, ?)");
             stmt.PExecute(GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end), uint64(itr->second.categoryEnd));
-            ++itr;
         }
-        else
-            ++itr;
     }
 }
 
@@ -15990,129 +16013,189 @@ void Player::SaveToDB(bool online, bool force)
 
     m_honorMgr.Update();
 
-    static SqlStatementID insChar;
+    // Logout saves are always complete: they also recover from a failed previous save.
+    // The hashes are recorded when the statements are queued, not once written: a
+    // periodic full save also rewrites what a lost async write left outdated.
+    if (!sWorld.getConfig(CONFIG_BOOL_INCREMENTAL_PLAYER_SAVE) || m_session->isLogingOut() ||
+        ++m_incrementalSaves >= sWorld.getConfig(CONFIG_UINT32_PLAYER_SAVE_FULL_INTERVAL))
+        ResetSaveSections();
 
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "REPLACE INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
-                              "map, position_x, position_y, position_z, orientation, "
-                              "taximask, online, cinematic, "
-                              "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_multiplier, resettalents_time, "
-                              "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-                              "death_expire_time, taxi_path, "
-                              "honorRankPoints, honorHighestRank, honorStanding, honorLastWeekHK, honorLastWeekCP, honorStoredHK, honorStoredDK, "
-                              "watchedFaction, drunk, health, power1, power2, power3, "
-                              "power4, power5, exploredZones, equipmentCache, ammoId, actionBars, "
-                              "area, world_phase_mask) "
-                              "VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?,"
-                              "?, ?, ?, ?, ?, "
-                              "?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, "
-                              "?, ?) ");
-
-    uberInsert.addUInt32(GetGUIDLow());
-    uberInsert.addUInt32(GetSession()->GetAccountId());
-    uberInsert.addString(m_name);
-    uberInsert.addUInt8(getRace());
-    uberInsert.addUInt8(getClass());
-    uberInsert.addUInt8(getGender());
-    uberInsert.addUInt32(getLevel());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_XP));
-    uberInsert.addUInt32(GetMoney());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
+    _SaveCharacter(online);
 
-    // Nostalrius: Fix toggled PvP flag after relog.
-    uint32 playerFlags = GetUInt32Value(PLAYER_FLAGS) & ~(PLAYER_FLAGS_PVP_DESIRED);
-    if (IsPvP())
-        playerFlags |= PLAYER_FLAGS_PVP_DESIRED;
-    uberInsert.addUInt32(playerFlags);
+    _SaveBGData();
+    _SaveInventory();
+    _SaveQuestStatus();
+    _SaveSpells();
+    _SaveSpellCooldowns();
+    _SaveAuras();
+    _SaveSkills();
+    m_reputationMgr.SaveToDB();
+    m_honorMgr.Save();
 
-    if (!IsBeingTeleported())
-    {
-        uberInsert.addUInt32(GetMapId());
-        uberInsert.addFloat(finiteAlways(GetPositionX()));
-        uberInsert.addFloat(finiteAlways(GetPositionY()));
-        uberInsert.addFloat(finiteAlways(GetPositionZ()));
-        uberInsert.addFloat(MapManager::NormalizeOrientation(finiteAlways(GetOrientation())));
-    }
-    else
+    // Systeme de phasing
+    sObjectMgr.SetPlayerWorldMask(GetGUIDLow(), GetWorldMask());
+    GetSession()->SaveTutorialsData();                      // changed only while character in game
+
+    CharacterDatabase.CommitTransaction();
+
+    // check if stats should only be saved on logout
+    // save stats can be out of transaction
+    if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
+        _SaveStats();
+
+    // save pet (hunter pet level and experience and all type pets health/mana).
+    if (Pet* pet = GetPet())
+        pet->SavePetToDB(PET_SAVE_AS_CURRENT);
+    if (PlayerCacheData* data = sObjectMgr.GetPlayerDataByGUID(GetGUIDLow()))
     {
-        uberInsert.addUInt32(GetTeleportDest().mapid);
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_x));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_y));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_z));
-        uberInsert.addFloat(MapManager::NormalizeOrientation(finiteAlways(GetTeleportDest().orientation)));
+        data->uiLevel = getLevel();
+        data->uiZoneId = GetCachedZoneId();
     }
+}
 
-    std::ostringstream ss;
-    ss << m_taxi;                                   // string with TaxiMaskSize numbers
-    uberInsert.addString(ss);
+bool Player::IsSaveSectionChanged(SaveSection section, uint64 hash)
+{
+    if (m_saveSectionHash[section] == hash)
+        return false;
+    m_saveSectionHash[section] = hash;
+    ++m_saveSectionWrites[section];
+    return true;
+}
 
-    if (!IsInWorld())
-        online = false;
-    uberInsert.addUInt32(online);
+void Player::ResetSaveSections()
+{
+    for (uint32 i = 0; i < MAX_SAVE_SECTIONS; ++i)
+        m_saveSectionHash[i] = 0;
+    m_incrementalSaves = 0;
+}
 
-    uberInsert.addUInt32(m_cinematic);
+// Order independent: the iteration order of the map may change between two saves
+uint64 Player::GetForgottenSkillsHash(std::unordered_map<uint16, uint16> const& skills)
+{
+    uint64 hash = FNV1A_64_SEED;
+    for (const auto itr : skills)
+        hash += HashFNV1aValue(itr.second, HashFNV1aValue(itr.first));
+    return hash;
+}
 
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
+// characters row is split in two parts: position and volatile data, written at every save,
+// and the rest, written only when its content changed. The first save is a full REPLACE.
+void Player::_SaveCharacter(bool online)
+{
+    static SqlStatementID insChar;
+    static SqlStatementID updCharState;
+    static SqlStatementID updCharPosition;
 
-    uberInsert.addFloat(finiteAlways(m_rest_bonus));
-    uberInsert.addUInt64(uint64(time(NULL)));
-    uberInsert.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
-    //save, far from tavern/city
-    //save, but in tavern/city
-    uberInsert.addUInt32(m_resetTalentsMultiplier);
-    uberInsert.addUInt64(uint64(m_resetTalentsTime));
+    if (!IsInWorld())
+        online = false;
 
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->x));
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->y));
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->z));
-    uberInsert.addFloat(MapManager::NormalizeOrientation(finiteAlways(m_movementInfo.GetTransportPos()->o)));
-    if (m_transport)
-        uberInsert.addUInt32(m_transport->GetGUIDLow());
-    else
-        uberInsert.addUInt32(0);
+    if (!m_saveSectionHash[SAVE_SECTION_CHARACTER])
+    {
+        SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "REPLACE INTO characters (guid, "
+                                  "account, name, race, class, gender, level, xp, money, playerBytes, playerBytes2, playerFlags, "
+                                  "taximask, cinematic, resettalents_multiplier, resettalents_time, extra_flags, stable_slots, at_login, "
+                                  "death_expire_time, taxi_path, "
+                                  "honorRankPoints, honorHighestRank, honorStanding, honorLastWeekHK, honorLastWeekCP, honorStoredHK, honorStoredDK, "
+                                  "watchedFaction, drunk, exploredZones, equipmentCache, ammoId, actionBars, world_phase_mask, "
+                                  "map, position_x, position_y, position_z, orientation, online, "
+                                  "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, "
+                                  "trans_x, trans_y, trans_z, trans_o, transguid, zone, area, "
+                                  "health, power1, power2, power3, power4, power5) "
+                                  "VALUES (?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?)");
+
+        uberInsert.addUInt32(GetGUIDLow());
+        _BindCharacterState(uberInsert);
+        IsSaveSectionChanged(SAVE_SECTION_CHARACTER, uberInsert.GetParamsHash(1));
+        _BindCharacterPosition(uberInsert, online);
+        uberInsert.Execute();
+        return;
+    }
+
+    SqlStatement stmt = CharacterDatabase.CreateStatement(updCharState, "UPDATE characters SET "
+                        "account = ?, name = ?, race = ?, class = ?, gender = ?, level = ?, xp = ?, money = ?, playerBytes = ?, playerBytes2 = ?, playerFlags = ?, "
+                        "taximask = ?, cinematic = ?, resettalents_multiplier = ?, resettalents_time = ?, extra_flags = ?, stable_slots = ?, at_login = ?, "
+                        "death_expire_time = ?, taxi_path = ?, "
+                        "honorRankPoints = ?, honorHighestRank = ?, honorStanding = ?, honorLastWeekHK = ?, honorLastWeekCP = ?, honorStoredHK = ?, honorStoredDK = ?, "
+                        "watchedFaction = ?, drunk = ?, exploredZones = ?, equipmentCache = ?, ammoId = ?, actionBars = ?, world_phase_mask = ? "
+                        "WHERE guid = ?");
+    _BindCharacterState(stmt);
+    if (IsSaveSectionChanged(SAVE_SECTION_CHARACTER, stmt.GetParamsHash()))
+    {
+        stmt.addUInt32(GetGUIDLow());
+        stmt.Execute();
+    }
 
-    uberInsert.addUInt32(m_ExtraFlags);
+    stmt = CharacterDatabase.CreateStatement(updCharPosition, "UPDATE characters SET "
+           "map = ?, position_x = ?, position_y = ?, position_z = ?, orientation = ?, online = ?, "
+           "totaltime = ?, leveltime = ?, rest_bonus = ?, logout_time = ?, is_logout_resting = ?, "
+           "trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, transguid = ?, zone = ?, area = ?, "
+           "health = ?, power1 = ?, power2 = ?, power3 = ?, power4 = ?, power5 = ? "
+           "WHERE guid = ?");
+    _BindCharacterPosition(stmt, online);
+    stmt.addUInt32(GetGUIDLow());
+    stmt.Execute();
+}
 
-    uberInsert.addUInt32(uint32(m_stableSlots));                    // to prevent save uint8 as char
+void Player::_BindCharacterState(SqlStatement& stmt)
+{
+    stmt.addUInt32(GetSession()->GetAccountId());
+    stmt.addString(m_name);
+    stmt.addUInt8(getRace());
+    stmt.addUInt8(getClass());
+    stmt.addUInt8(getGender());
+    stmt.addUInt32(getLevel());
+    stmt.addUInt32(GetUInt32Value(PLAYER_XP));
+    stmt.addUInt32(GetMoney());
+    stmt.addUInt32(GetUInt32Value(PLAYER_BYTES));
+    stmt.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
 
-    uberInsert.addUInt32(uint32(m_atLoginFlags));
+    // Nostalrius: Fix toggled PvP flag after relog.
+    uint32 playerFlags = GetUInt32Value(PLAYER_FLAGS) & ~(PLAYER_FLAGS_PVP_DESIRED);
+    if (IsPvP())
+        playerFlags |= PLAYER_FLAGS_PVP_DESIRED;
+    stmt.addUInt32(playerFlags);
 
-    uberInsert.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
+    std::ostringstream ss;
+    ss << m_taxi;                                   // string with TaxiMaskSize numbers
+    stmt.addString(ss);
 
-    uberInsert.addUInt64(uint64(m_deathExpireTime));
+    stmt.addUInt32(m_cinematic);
+    stmt.addUInt32(m_resetTalentsMultiplier);
+    stmt.addUInt64(uint64(m_resetTalentsTime));
+    stmt.addUInt32(m_ExtraFlags);
+    stmt.addUInt32(uint32(m_stableSlots));                    // to prevent save uint8 as char
+    stmt.addUInt32(uint32(m_atLoginFlags));
+    stmt.addUInt64(uint64(m_deathExpireTime));
 
     ss << m_taxi.SaveTaxiDestinationsToString();       //string
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
     // Honor stored data
-    uberInsert.addFloat(finiteAlways(m_honorMgr.GetRankPoints()));
-    uberInsert.addUInt32(uint32(m_honorMgr.GetHighestRank().rank));
-    uberInsert.addUInt32(m_honorMgr.GetStanding());
-    uberInsert.addUInt32(m_honorMgr.GetLastWeekHK());
-    uberInsert.addFloat(finiteAlways(m_honorMgr.GetLastWeekCP()));
-    uberInsert.addUInt32(m_honorMgr.GetStoredHK());
-    uberInsert.addUInt32(m_honorMgr.GetStoredDK());
+    stmt.addFloat(finiteAlways(m_honorMgr.GetRankPoints()));
+    stmt.addUInt32(uint32(m_honorMgr.GetHighestRank().rank));
+    stmt.addUInt32(m_honorMgr.GetStanding());
+    stmt.addUInt32(m_honorMgr.GetLastWeekHK());
+    stmt.addFloat(finiteAlways(m_honorMgr.GetLastWeekCP()));
+    stmt.addUInt32(m_honorMgr.GetStoredHK());
+    stmt.addUInt32(m_honorMgr.GetStoredDK());
 
     // FIXME: at this moment send to DB as unsigned, including unit32(-1)
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
+    stmt.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
 
-    uberInsert.addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE));
-
-    uberInsert.addUInt32(GetHealth());
-
-    for (uint32 i = 0; i < MAX_POWERS; ++i)
-        uberInsert.addUInt32(GetPower(Powers(i)));
+    stmt.addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE));
 
     for (uint32 i = 0; i < PLAYER_EXPLORED_ZONES_SIZE; ++i)         //string
         ss << GetUInt32Value(PLAYER_EXPLORED_ZONES_1 + i) << " ";
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
     for (uint32 i = 0; i < EQUIPMENT_SLOT_END; ++i)         //string: item id, ench (perm/temp)
     {
@@ -16122,45 +16205,59 @@ void Player::SaveToDB(bool online, bool force)
         uint32 ench2 = GetUInt32Value(PLAYER_VISIBLE_ITEM_1_0 + i * MAX_VISIBLE_ITEM_OFFSET + 1 + TEMP_ENCHANTMENT_SLOT);
         ss << uint32(MAKE_PAIR32(ench1, ench2)) << " ";
     }
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
+    stmt.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
+    stmt.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
+    stmt.addUInt32(GetWorldMask());
+}
 
-    uberInsert.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
-    // Nostalrius
-    uberInsert.addUInt32(GetAreaId());
-    uberInsert.addUInt32(GetWorldMask());
-    uberInsert.Execute();
+void Player::_BindCharacterPosition(SqlStatement& stmt, bool online)
+{
+    if (!IsBeingTeleported())
+    {
+        stmt.addUInt32(GetMapId());
+        stmt.addFloat(finiteAlways(GetPositionX()));
+        stmt.addFloat(finiteAlways(GetPositionY()));
+        stmt.addFloat(finiteAlways(GetPositionZ()));
+        stmt.addFloat(MapManager::NormalizeOrientation(finiteAlways(GetOrientation())));
+    }
+    else
+    {
+        stmt.addUInt32(GetTeleportDest().mapid);
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_x));
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_y));
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_z));
+        stmt.addFloat(MapManager::NormalizeOrientation(finiteAlways(GetTeleportDest().orientation)));
+    }
 
-    _SaveBGData();
-    _SaveInventory();
-    _SaveQuestStatus();
-    _SaveSpells();
-    _SaveSpellCooldowns();
-    _SaveAuras();
-    _SaveSkills();
-    m_reputationMgr.SaveToDB();
-    m_honorMgr.Save();
+    stmt.addUInt32(online);
 
-    // Systeme de phasing
-    sObjectMgr.SetPlayerWorldMask(GetGUIDLow(), GetWorldMask());
-    GetSession()->SaveTutorialsData();                      // changed only while character in game
+    stmt.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
+    stmt.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
 
-    CharacterDatabase.CommitTransaction();
+    stmt.addFloat(finiteAlways(m_rest_bonus));
+    stmt.addUInt64(uint64(time(NULL)));
+    //save, far from tavern/city
+    //save, but in tavern/city
+    stmt.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
 
-    // check if stats should only be saved on logout
-    // save stats can be out of transaction
-    if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
-        _SaveStats();
+    stmt.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->x));
+    stmt.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->y));
+    stmt.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->z));
+    stmt.addFloat(MapManager::NormalizeOrientation(finiteAlways(m_movementInfo.GetTransportPos()->o)));
+    if (m_transport)
+        stmt.addUInt32(m_transport->GetGUIDLow());
+    else
+        stmt.addUInt32(0);
 
-    // save pet (hunter pet level and experience and all type pets health/mana).
-    if (Pet* pet = GetPet())
-        pet->SavePetToDB(PET_SAVE_AS_CURRENT);
-    if (PlayerCacheData* data = sObjectMgr.GetPlayerDataByGUID(GetGUIDLow()))
-    {
-        data->uiLevel = getLevel();
-        data->uiZoneId = GetCachedZoneId();
-    }
+    stmt.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
+    // Nostalrius
+    stmt.addUInt32(GetAreaId());
+
+    stmt.addUInt32(GetHealth());
+    for (uint32 i = 0; i < MAX_POWERS; ++i)
+        stmt.addUInt32(GetPower(Powers(i)));
 }
 
 // fast save function for item/money cheating preventing - save only inventory and money state
@@ -16189,6 +16286,7 @@ void Player::SaveGoldToDB()
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(updateGold, "UPDATE characters SET money = ? WHERE guid = ?");
     stmt.PExecute(GetMoney(), GetGUIDLow());
+    InvalidateSaveSection(SAVE_SECTION_CHARACTER);
 }
 
 void Player::_SaveAuras()
@@ -16196,42 +16294,61 @@ void Player::_SaveAuras()
     static SqlStatementID deleteAuras ;
     static SqlStatementID insertAuras ;
 
+    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
+
+    std::vector<AuraSaveStruct> auras;
+    auras.reserve(auraHolders.size());
+    uint64 hash = FNV1A_64_SEED;
+    AuraSaveStruct s;
+    for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
+    {
+        if (!SaveAura(itr->second, s))
+            continue;
+
+        hash = HashFNV1aValue(s.caster_guid.GetRawValue(), hash);
+        hash = HashFNV1aValue(s.item_lowguid, hash);
+        hash = HashFNV1aValue(s.spellid, hash);
+        hash = HashFNV1aValue(s.stackcount, hash);
+        hash = HashFNV1aValue(s.remaincharges, hash);
+        hash = HashFNV1a(s.damage, sizeof(s.damage), hash);
+        hash = HashFNV1a(s.periodicTime, sizeof(s.periodicTime), hash);
+        hash = HashFNV1aValue(s.maxduration, hash);
+        hash = HashFNV1aValue(s.remaintime, hash);
+        hash = HashFNV1aValue(s.effIndexMask, hash);
+        auras.push_back(s);
+    }
+
+    if (!IsSaveSectionChanged(SAVE_SECTION_AURAS, hash))
+        return;
+
     SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
     stmt.PExecute(GetGUIDLow());
 
-    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
-
-    if (auraHolders.empty())
+    if (auras.empty())
         return;
 
     stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
             "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
             "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
 
-    AuraSaveStruct s;
-    for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
+    for (std::vector<AuraSaveStruct>::const_iterator itr = auras.begin(); itr != auras.end(); ++itr)
     {
-        SpellAuraHolder *holder = itr->second;
-
-        if (!SaveAura(holder, s))
-            continue;
-
         stmt.addUInt32(GetGUIDLow());
-        stmt.addUInt64(s.caster_guid.GetRawValue());
-        stmt.addUInt32(s.item_lowguid);
-        stmt.addUInt32(s.spellid);
-        stmt.addUInt32(s.stackcount);
-        stmt.addUInt8(s.remaincharges);
+        stmt.addUInt64(itr->caster_guid.GetRawValue());
+        stmt.addUInt32(itr->item_lowguid);
+        stmt.addUInt32(itr->spellid);
+        stmt.addUInt32(itr->stackcount);
+        stmt.addUInt8(itr->remaincharges);
 
         for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-            stmt.addInt32(s.damage[i]);
+            stmt.addInt32(itr->damage[i]);
 
         for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-            stmt.addUInt32(s.periodicTime[i]);
+            stmt.addUInt32(itr->periodicTime[i]);
 
-        stmt.addInt32(s.maxduration);
-        stmt.addInt32(s.remaintime);
-        stmt.addUInt32(s.effIndexMask);
+        stmt.addInt32(itr->maxduration);
+        stmt.addInt32(itr->remaintime);
+        stmt.addUInt32(itr->effIndexMask);
         stmt.Execute();
     }
 }
@@ -16519,6 +16636,9 @@ void Player::_SaveSkills()
     // Forgotten weapon skills.
     static SqlStatementID forSkills;
 
+    if (!IsSaveSectionChanged(SAVE_SECTION_FORGOTTEN_SKILLS, GetForgottenSkillsHash(m_mForgottenSkills)))
+        return;
+
     for (const auto itr : m_mForgottenSkills)
     {
         if (itr.second > 1)
@@ -16569,10 +16689,7 @@ void Player::_SaveStats()
     static SqlStatementID delStats ;
     static SqlStatementID insertStats ;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delStats, "DELETE FROM character_stats WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    stmt = CharacterDatabase.CreateStatement(insertStats, "INSERT INTO character_stats (guid, maxhealth, maxpower1, maxpower2, maxpower3, maxpower4, maxpower5, "
+    SqlStatement stmt = CharacterDatabase.CreateStatement(insertStats, "INSERT INTO character_stats (guid, maxhealth, maxpower1, maxpower2, maxpower3, maxpower4, maxpower5, "
             "strength, agility, stamina, intellect, spirit, armor, resHoly, resFire, resNature, resFrost, resShadow, resArcane, "
             "blockPct, dodgePct, parryPct, critPct, rangedCritPct, attackPower, rangedAttackPower) "
             "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
@@ -16594,6 +16711,12 @@ void Player::_SaveStats()
     stmt.addUInt32(GetUInt32Value(UNIT_FIELD_ATTACK_POWER));
     stmt.addUInt32(GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER));
 
+    if (!IsSaveSectionChanged(SAVE_SECTION_STATS, stmt.GetParamsHash()))
+        return;
+
+    SqlStatement stmtDel = CharacterDatabase.CreateStatement(delStats, "DELETE FROM character_stats WHERE guid = ?");
+    stmtDel.PExecute(GetGUIDLow());
+
     stmt.Execute();
 }
 
@@ -20274,7 +20397,10 @@ void Player::RemoveAtLoginFlag(AtLoginFlags f, bool in_db_also /*= false*/)
     m_atLoginFlags &= ~f;
 
     if (in_db_also)
+    {
         CharacterDatabase.PExecute("UPDATE characters set at_login = at_login & ~ %u WHERE guid ='%u'", uint32(f), GetGUIDLow());
+        InvalidateSaveSection(SAVE_SECTION_CHARACTER);
+    }
 }
 
 void Player::SendClearCooldown(uint32 spell_id, Unit* target) const
@@ -21036,15 +21162,16 @@ void Player::InterruptSpellsWithCastItem(Item* item)
             }
 
     // Interrupt eventually delayed spells
-    auto i_Events = m_Events.GetEvents().begin();
-    for (; i_Events != m_Events.GetEvents().end(); ++i_Events)
-        if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_Events->second))
-            if (event && event->GetSpell()->m_CastItem == item)
+    m_Events.VisitEvents([item](BasicEvent* e)
+    {
+        if (SpellEvent* event = dynamic_cast<SpellEvent*>(e))
+            if (event->GetSpell()->m_CastItem == item)
             {
                 event->GetSpell()->ClearCastItem();
                 if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                     event->GetSpell()->cancel();
             }
+    });
 }
 
 std::string Player::GetShortDescription() const
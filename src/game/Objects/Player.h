@@ -1333,11 +1333,38 @@ class MANGOS_DLL_SPEC Player final: public Unit
         void _SaveSpells();
         void _SaveBGData();
         void _SaveStats();
+        void _SaveCharacter(bool online);
+        void _BindCharacterState(SqlStatement& stmt);
+        void _BindCharacterPosition(SqlStatement& stmt, bool online);
+
+    public:
+        // Sections rewritten as a whole at each save. They are skipped when the
+        // hash of their values did not change since the last save of this object.
+        enum SaveSection
+        {
+            SAVE_SECTION_CHARACTER,                         // characters row, except position and volatile columns
+            SAVE_SECTION_AURAS,
+            SAVE_SECTION_COOLDOWNS,
+            SAVE_SECTION_STATS,
+            SAVE_SECTION_FORGOTTEN_SKILLS,
+            MAX_SAVE_SECTIONS
+        };
+    private:
+        uint64 m_saveSectionHash[MAX_SAVE_SECTIONS];        // 0: not saved yet, full write
+        uint32 m_saveSectionWrites[MAX_SAVE_SECTIONS];      // times each section was written
+        uint32 m_incrementalSaves;                          // since the last full save
 
         void _SetCreateBits(UpdateMask* updateMask, Player* target) const;
         void _SetUpdateBits(UpdateMask* updateMask, Player* target) const;
         uint32 m_nextSave;
     public:
+        bool IsSaveSectionChanged(SaveSection section, uint64 hash);
+        void ResetSaveSections();
+        // Columns of the section written outside of SaveToDB: the next save writes the section again
+        void InvalidateSaveSection(SaveSection section) { m_saveSectionHash[section] = 0; }
+        uint32 GetSaveSectionWrites(SaveSection section) const { return m_saveSectionWrites[section]; }
+        static uint64 GetForgottenSkillsHash(std::unordered_map<uint16, uint16> const& skills);
+
         void SaveToDB(bool online = true, bool force = false);
         void SaveInventoryAndGoldToDB();                    // fast save function for item/money cheating preventing
         void SaveGoldToDB();
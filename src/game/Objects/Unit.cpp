@@ -280,6 +280,7 @@ void Unit::Update(uint32 update_diff, uint32 p_time)
         _UpdateSpells(m_spellUpdateTimeBuffer);
 
         CleanupDeletedAuras();
+        CompactModAuras();
 
         // update abilities available only for fraction of time
         UpdateReactives(m_spellUpdateTimeBuffer);
@@ -358,8 +359,11 @@ void Unit::Update(uint32 update_diff, uint32 p_time)
     GetMotionMaster()->UpdateMotion(p_time);
     if (GetMotionMaster()->NeedsAsyncUpdate() && IsInWorld())
     {
-        if (sWorld.getConfig(CONFIG_UINT32_CONTINENTS_MOTIONUPDATE_THREADS) && GetMap()->IsContinent())
+        if (GetMap()->BatchesMovementUpdates())
+        {
+            GetMotionMaster()->QueueAsyncUpdate(p_time);
             GetMap()->AddUnitToMovementUpdate(this);
+        }
         else
             GetMotionMaster()->UpdateMotionAsync(p_time);
     }
@@ -4224,6 +4228,14 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder *holder)
     }
     // add aura, register in lists and arrays
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    if (uint32 procFlags = GetSpellAuraHolderProcFlags(holder->GetSpellProto()))
+    {
+        // same position as in m_spellAuraHolders: after the holders of the same spell
+        ProcSpellAuraHolderList::iterator itr = m_procSpellAuraHolders.begin();
+        while (itr != m_procSpellAuraHolders.end() && itr->spellId <= holder->GetId())
+            ++itr;
+        m_procSpellAuraHolders.insert(itr, ProcSpellAuraHolder(holder->GetId(), procFlags, holder));
+    }
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura *aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -4867,6 +4879,14 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder *holder, AuraRemoveMode mode)
             break;
         }
     }
+    for (ProcSpellAuraHolderList::iterator itr = m_procSpellAuraHolders.begin(); itr != m_procSpellAuraHolders.end(); ++itr)
+    {
+        if (itr->holder == holder)
+        {
+            m_procSpellAuraHolders.erase(itr);
+            break;
+        }
+    }
     if (!foundInMap)
         sLog.outInfo("[Crash/Auras] Removing aura holder *not* in holders map ! Aura %u on %s", holder->GetId(), GetName());
     holder->SetRemoveMode(mode);
@@ -4924,7 +4944,7 @@ void Unit::RemoveAura(Aura *Aur, AuraRemoveMode mode)
 {
     // remove from list before mods removing (prevent cyclic calls, mods added before including to aura list - use reverse order)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
-        m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        RemoveFromModAuras(Aur->GetModifier()->m_auraname, Aur);
 
     // Set remove mode
     Aur->SetRemoveMode(mode);
@@ -8024,7 +8044,7 @@ void Unit::UpdateVisibilityAndView()
 
             if (!owner || !isVisibleForOrDetect(owner, this, false))
             {
-                alist.erase(it);
+                RemoveFromModAuras(*type, aura);
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -9319,11 +9339,10 @@ void Unit::ApplyMaxPowerMod(Powers power, uint32 val, bool apply)
 
 void Unit::ApplyAuraProcTriggerDamage(Aura* aura, bool apply)
 {
-    AuraList& tAuraProcTriggerDamage = m_modAuras[SPELL_AURA_PROC_TRIGGER_DAMAGE];
     if (apply)
-        tAuraProcTriggerDamage.push_back(aura);
+        m_modAuras[SPELL_AURA_PROC_TRIGGER_DAMAGE].push_back(aura);
     else
-        tAuraProcTriggerDamage.remove(aura);
+        RemoveFromModAuras(SPELL_AURA_PROC_TRIGGER_DAMAGE, aura);
 }
 
 uint32 Unit::GetCreatePowers(Powers power) const
@@ -9844,22 +9863,28 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
     }
     DEBUG_UNIT(this, DEBUG_PROCS, "PROC: Flags 0x%.5x Ex 0x%.3x Spell %5u %s", procFlag, procExtra, procSpell ? procSpell->Id : 0, isVictim ? "[victim]" : "");
 
-    // Fill triggeredList list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    // Fill triggeredList list, only holders that respond to one of the flags can proc
+    for (size_t index = 0; index < m_procSpellAuraHolders.size(); ++index)
     {
+        ProcSpellAuraHolder const& candidate = m_procSpellAuraHolders[index];
+        if (!(candidate.procFlags & procFlag))
+            continue;
+
         // Can not proc on self.
-        if (procSpell && procSpell->Id == itr->first)
+        if (procSpell && procSpell->Id == candidate.spellId)
             continue;
 
+        SpellAuraHolder* holder = candidate.holder;
+
         // skip deleted auras (possible at recursive triggered call
-        if (itr->second->IsDeleted())
+        if (holder->IsDeleted())
             continue;
 
         // Aura that applies a modifier with charges. Gere? otherwise.
         bool hasmodifier = false;
         for (int i = 0; i < 3; ++i)
-            if (itr->second->GetAuraByEffectIndex(SpellEffectIndex(i)))
-                if (SpellModifier* auraMod = itr->second->GetAuraByEffectIndex(SpellEffectIndex(i))->GetSpellModifier())
+            if (holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
+                if (SpellModifier* auraMod = holder->GetAuraByEffectIndex(SpellEffectIndex(i))->GetSpellModifier())
                     if (auraMod->charges > 0 || (spell && spell->HasModifierApplied(auraMod)))
                     {
                         hasmodifier = true;
@@ -9869,11 +9894,11 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
             continue;
 
         SpellProcEventEntry const* spellProcEvent = nullptr;
-        if (!IsTriggeredAtSpellProcEvent(pTarget, itr->second, procSpell, procFlag, procExtra, attType, isVictim, spellProcEvent))
+        if (!IsTriggeredAtSpellProcEvent(pTarget, holder, procSpell, procFlag, procExtra, attType, isVictim, spellProcEvent))
             continue;
 
-        itr->second->SetInUse(true);                        // prevent holder deletion
-        triggeredList.push_back(ProcTriggeredData(spellProcEvent, itr->second, pTarget, procFlag));
+        holder->SetInUse(true);                             // prevent holder deletion
+        triggeredList.push_back(ProcTriggeredData(spellProcEvent, holder, pTarget, procFlag));
     }
 }
 
@@ -10932,6 +10957,21 @@ void Unit::CleanupDeletedAuras()
     m_deletedAuras.clear();
 }
 
+void Unit::RemoveFromModAuras(uint32 auraName, Aura* aura)
+{
+    AuraList& auras = m_modAuras[auraName];
+    // Only the slot is cleared, loops over the auras of this type may be running
+    if (auras.remove(aura) && auras.removedCount() == 1)
+        m_fragmentedModAuras.push_back(auraName);
+}
+
+void Unit::CompactModAuras()
+{
+    for (std::vector<uint32>::const_iterator itr = m_fragmentedModAuras.begin(); itr != m_fragmentedModAuras.end(); ++itr)
+        m_modAuras[*itr].compact();
+    m_fragmentedModAuras.clear();
+}
+
 bool Unit::CheckAndIncreaseCastCounter()
 {
     uint32 maxCasts = sWorld.getConfig(CONFIG_UINT32_MAX_SPELL_CASTS_IN_CHAIN);
@@ -11057,12 +11097,13 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed, bool interruptPositiveSpe
         if (!killDelayed)
             continue;
         // 2/ Interruption des sorts qui ne sont plus reference, mais dont il reste un event (ceux en parcours par exemple)
-        auto i_Events = (*iter)->m_Events.GetEvents().begin();
-        for (; i_Events != (*iter)->m_Events.GetEvents().end(); ++i_Events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_Events->second))
-                if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
+        (*iter)->m_Events.VisitEvents([this](BasicEvent* e)
+        {
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(e))
+                if (event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
+        });
     }
 }
 
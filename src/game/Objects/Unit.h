@@ -26,6 +26,7 @@
 #include "Object.h"
 #include "Opcodes.h"
 #include "SpellAuraDefines.h"
+#include "FlatAuraList.h"
 #include "UpdateFields.h"
 #include "SharedDefines.h"
 #include "ThreatManager.h"
@@ -1000,7 +1001,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         typedef std::pair<SpellAuraHolderMap::iterator, SpellAuraHolderMap::iterator> SpellAuraHolderBounds;
         typedef std::pair<SpellAuraHolderMap::const_iterator, SpellAuraHolderMap::const_iterator> SpellAuraHolderConstBounds;
         typedef std::list<SpellAuraHolder *> SpellAuraHolderList;
-        typedef std::list<Aura *> AuraList;
+        typedef FlatAuraList AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32> ComboPointHolderSet;
         typedef std::map<SpellEntry const*, ObjectGuid> SingleCastSpellTargetMap;
@@ -1788,6 +1789,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
 
         SpellAuraHolderMap      & GetSpellAuraHolderMap()       { return m_spellAuraHolders; }
         SpellAuraHolderMap const& GetSpellAuraHolderMap() const { return m_spellAuraHolders; }
+        uint32 GetProcSpellAuraHolderCount() const { return m_procSpellAuraHolders.size(); }
         AuraList const& GetAurasByType(AuraType type) const { return m_modAuras[type]; }
         void ApplyAuraProcTriggerDamage(Aura* aura, bool apply);
 
@@ -1862,6 +1864,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         uint32 SpellCriticalHealingBonus(SpellEntry const *spellProto, uint32 damage, Unit *pVictim);
 
         bool IsTriggeredAtSpellProcEvent(Unit *pVictim, SpellAuraHolder* holder, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, SpellProcEventEntry const*& spellProcEvent );
+        static uint32 GetSpellAuraHolderProcFlags(SpellEntry const* spellProto);
         // Aura proc handlers
         SpellAuraProcResult HandleDummyAuraProc(Unit *pVictim, uint32 damage, Aura* triggeredByAura, SpellEntry const *procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
         SpellAuraProcResult HandleHasteAuraProc(Unit *pVictim, uint32 damage, Aura* triggeredByAura, SpellEntry const *procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
@@ -2042,6 +2045,11 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         void OnRelocated();
         void ProcessRelocationVisibilityUpdates();
         bool m_needUpdateVisibility;
+        // Positions in Map::i_unitsRelocated and Map::unitsMvtUpdate
+        MapWorkQueueSlot& GetRelocationQueueSlot() { return m_relocationQueueSlot; }
+        MapWorkQueueSlot& GetMovementQueueSlot() { return m_movementQueueSlot; }
+        MapWorkQueueSlot m_relocationQueueSlot;
+        MapWorkQueueSlot m_movementQueueSlot;
 
         uint32 m_lastCastedSpellID;
         virtual void SetLastCastedSpell(uint32 spell_id, bool byclient);
@@ -2116,6 +2124,18 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
+
+        // Holders of m_spellAuraHolders that can proc, in the same order, with the proc flags they respond to
+        struct ProcSpellAuraHolder
+        {
+            ProcSpellAuraHolder(uint32 _spellId, uint32 _procFlags, SpellAuraHolder* _holder)
+                : spellId(_spellId), procFlags(_procFlags), holder(_holder) {}
+            uint32 spellId;
+            uint32 procFlags;
+            SpellAuraHolder* holder;
+        };
+        typedef std::vector<ProcSpellAuraHolder> ProcSpellAuraHolderList;
+        ProcSpellAuraHolderList m_procSpellAuraHolders;
         AuraList m_deletedAuras;                                       // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
 
@@ -2131,6 +2151,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         float m_modelCollisionHeight;
 
         AuraList m_modAuras[TOTAL_AURAS];
+        std::vector<uint32> m_fragmentedModAuras;                      // m_modAuras with removed auras, compacted at next update
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
         WeaponDamageInfo m_weaponDamage[MAX_ATTACK][MAX_ITEM_PROTO_DAMAGES];
         uint8 m_weaponDamageCount[MAX_ATTACK];
@@ -2176,6 +2197,8 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
 
     private:
         void CleanupDeletedAuras();
+        void RemoveFromModAuras(uint32 auraName, Aura* aura);
+        void CompactModAuras();
         void UpdateSplineMovement(uint32 t_diff);
 
         Unit* _GetTotem(TotemSlot slot) const;              // for templated function without include need
@@ -66,29 +66,73 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
     ++it->blockCount;
 }
 
-void PacketCompressor::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+namespace
 {
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+    // zlib deflate state is ~256KB. Each thread keeps its own stream and resets it
+    // between packets instead of allocating and freeing it for every packet.
+    class DeflateStream
+    {
+        public:
+            DeflateStream() : m_level(-1)
+            {
+                memset(&m_stream, 0, sizeof(m_stream));
+            }
+            ~DeflateStream()
+            {
+                if (m_level >= 0)
+                    deflateEnd(&m_stream);
+            }
+
+            z_stream* Acquire(int level)
+            {
+                if (m_level == level)
+                {
+                    int z_res = deflateReset(&m_stream);
+                    if (z_res == Z_OK)
+                        return &m_stream;
+                    sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+                }
+
+                // First use on this thread, compression level changed, or broken stream
+                if (m_level >= 0)
+                    deflateEnd(&m_stream);
+                m_level = -1;
+                memset(&m_stream, 0, sizeof(m_stream));
+
+                int z_res = deflateInit(&m_stream, level);
+                if (z_res != Z_OK)
+                {
+                    sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                    return nullptr;
+                }
+                m_level = level;
+                return &m_stream;
+            }
+
+        private:
+            z_stream m_stream;
+            int m_level;
+    };
+
+    thread_local DeflateStream t_deflateStream;
+}
 
+void PacketCompressor::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+{
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = t_deflateStream.Acquire(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
@@ -96,14 +140,14 @@ void PacketCompressor::Compress(void* dst, uint32 *dst_size, void* src, int src_
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
@@ -111,15 +155,7 @@ void PacketCompressor::Compress(void* dst, uint32 *dst_size, void* src, int src_
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
+    *dst_size = c_stream->total_out;
 }
 
 bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
@@ -129,74 +165,84 @@ bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
     return BuildPacket(packet, &(m_datas.front()), hasTransport);
 }
 
-bool UpdateData::BuildPacket(WorldPacket *packet, UpdatePacket const* updPacket, bool hasTransport)
+bool UpdateData::BuildPacket(WorldPacket *packet, UpdatePacket const* updPacket, bool hasTransport, bool compress)
 {
     MANGOS_ASSERT(packet->empty());                         // shouldn't happen
 
-    ByteBuffer buf(4 + 1 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + (updPacket ? updPacket->data.wpos() : 0));
+    packet->Initialize(SMSG_UPDATE_OBJECT, 4 + 1 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + (updPacket ? updPacket->data.wpos() : 0));
 
     uint32 blockCount = updPacket ? updPacket->blockCount : 0;
-    buf << (uint32)(!m_outOfRangeGUIDs.empty() ? blockCount + 1 : blockCount);
-    buf << (uint8)(hasTransport ? 1 : 0);
+    *packet << (uint32)(!m_outOfRangeGUIDs.empty() ? blockCount + 1 : blockCount);
+    *packet << (uint8)(hasTransport ? 1 : 0);
 
     if (!m_outOfRangeGUIDs.empty())
     {
-        buf << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
-        buf << (uint32) m_outOfRangeGUIDs.size();
+        *packet << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
+        *packet << (uint32) m_outOfRangeGUIDs.size();
 
 #if SUPPORTED_CLIENT_BUILD > CLIENT_BUILD_1_8_4
         for (ObjectGuidSet::const_iterator i = m_outOfRangeGUIDs.begin(); i != m_outOfRangeGUIDs.end(); ++i)
-            buf << i->WriteAsPacked();
+            *packet << i->WriteAsPacked();
 #else
         for (ObjectGuidSet::const_iterator i = m_outOfRangeGUIDs.begin(); i != m_outOfRangeGUIDs.end(); ++i)
-            buf << *i;
+            *packet << *i;
 #endif
     }
 
     if (updPacket)
-        buf.append(updPacket->data);
+        packet->append(updPacket->data);
 
-    size_t pSize = buf.wpos();                              // use real used data size
+    return !compress || CompressPacket(*packet);
+}
 
-    if (pSize > 100)                                       // compress large packets
-    {
-        if (pSize >= 900000)
-            sLog.outInfo("[CRASH-CLIENT] Too large packet: %u", pSize);
+bool UpdateData::CompressPacket(WorldPacket& packet)
+{
+    MANGOS_ASSERT(packet.GetOpcode() == SMSG_UPDATE_OBJECT);
 
-        uint32 destsize = compressBound(pSize);
-        packet->resize(destsize + sizeof(uint32));
+    size_t pSize = packet.wpos();                           // use real used data size
+    if (pSize <= 100)                                       // send small packets without compression
+        return true;
 
-        packet->put<uint32>(0, pSize);
-        PacketCompressor::Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
-        if (destsize == 0)
-            return false;
+    if (pSize >= 900000)
+        sLog.outInfo("[CRASH-CLIENT] Too large packet: %u", pSize);
 
-        packet->resize(destsize + sizeof(uint32));
-        packet->SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
-    }
-    else                                                    // send small packets without compression
-    {
-        packet->append(buf);
-        packet->SetOpcode(SMSG_UPDATE_OBJECT);
-    }
+    uint32 destsize = compressBound(pSize);
+    WorldPacket compressed(SMSG_COMPRESSED_UPDATE_OBJECT, 0);
+    compressed.resize(destsize + sizeof(uint32));
+
+    compressed.put<uint32>(0, pSize);
+    PacketCompressor::Compress(const_cast<uint8*>(compressed.contents()) + sizeof(uint32), &destsize, (void*)packet.contents(), pSize);
+    if (destsize == 0)
+        return false;
 
+    compressed.resize(destsize + sizeof(uint32));
+    packet = std::move(compressed);
     return true;
 }
 
 void UpdateData::Send(WorldSession* session, bool hasTransport)
 {
+    // Large packets are compressed by the network thread of the session if possible
+    bool deferCompression = sWorld.getConfig(CONFIG_BOOL_COMPRESS_UPDATES_IN_NETWORK_THREADS) && session->CanSendDeferredUpdatePackets();
+
     WorldPacket data;
     if (!m_datas.size() && !m_outOfRangeGUIDs.empty())
     {
-        BuildPacket(&data, NULL, hasTransport);
-        session->SendPacket(&data);
+        BuildPacket(&data, NULL, hasTransport, !deferCompression);
+        if (deferCompression)
+            session->SendDeferredUpdatePacket(data);
+        else
+            session->SendPacket(&data);
         m_outOfRangeGUIDs.clear();
         return;
     }
     for (std::list<UpdatePacket>::iterator it = m_datas.begin(); it != m_datas.end(); ++it)
     {
-        BuildPacket(&data, &(*it), hasTransport);
-        session->SendPacket(&data);
+        BuildPacket(&data, &(*it), hasTransport, !deferCompression);
+        if (deferCompression)
+            session->SendDeferredUpdatePacket(data);
+        else
+            session->SendPacket(&data);
         data.clear();
         m_outOfRangeGUIDs.clear();
     }
@@ -79,7 +79,9 @@ class UpdateData
         void AddUpdateBlock(const ByteBuffer &block);
         void Send(WorldSession* session, bool hasTransport = false);
         bool BuildPacket(WorldPacket *packet, bool hasTransport = false);
-        bool BuildPacket(WorldPacket *packet, UpdatePacket const* updPacket, bool hasTransport = false);
+        bool BuildPacket(WorldPacket *packet, UpdatePacket const* updPacket, bool hasTransport = false, bool compress = true);
+        // Turns a SMSG_UPDATE_OBJECT into SMSG_COMPRESSED_UPDATE_OBJECT if it is large enough
+        static bool CompressPacket(WorldPacket& packet);
         bool HasData() { return m_datas.size() || !m_outOfRangeGUIDs.empty(); }
         void Clear();
 
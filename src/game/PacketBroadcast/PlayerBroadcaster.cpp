@@ -48,10 +48,10 @@ void PlayerBroadcaster::ClearListeners()
     m_listeners.clear();
 }
 
-void PlayerBroadcaster::SendPacket(const WorldPacket& packet)
+void PlayerBroadcaster::SendPacket(const SharedPacket& packet)
 {
     if (m_socket)
-        m_socket->SendPacket(packet);
+        m_socket->SendSharedPacket(packet);
 }
 
 void PlayerBroadcaster::ProcessQueue(uint32& num_packets)
@@ -68,16 +68,19 @@ void PlayerBroadcaster::ProcessQueue(uint32& num_packets)
 
     for (auto& data : queue)
     {
+        // Body shared by the sockets of all the listeners
+        SharedPacket packet = std::make_shared<WorldPacket const>(std::move(data.packet));
+
         // Send to self?
         if (data.sendToSelf && data.except != GetGUID())
-            SendPacket(data.packet);
+            SendPacket(packet);
 
         for (auto it = m_listeners.begin(); it != m_listeners.end(); ++it)
         {
             if (it->first == data.except)
                 continue;
 
-            it->second->SendPacket(data.packet);
+            it->second->SendPacket(packet);
         }
     }
 }
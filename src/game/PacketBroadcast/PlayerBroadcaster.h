@@ -34,7 +34,7 @@ class PlayerBroadcaster final
     std::mutex m_queue_lock;
 
     void ProcessQueue(uint32& num_packets);
-    void SendPacket(const WorldPacket& packet);
+    void SendPacket(const SharedPacket& packet);
 
     static inline bool CanSkipPacket(uint32 opcode)
     {
@@ -31,6 +31,7 @@
 #include "AddonHandler.h"
 
 #include "Opcodes.h"
+#include "UpdateData.h"
 #include "MangosSocketImpl.h"
 
 template class MangosSocket<WorldSession, WorldSocket, AuthCrypt>;
@@ -417,3 +418,9 @@ int WorldSocket::SendStartupPacket()
 
     return SendPacket(packet);
 }
+
+void WorldSocket::PrepareQueuedPacket(WorldPacket& pct)
+{
+    if (pct.GetOpcode() == SMSG_UPDATE_OBJECT)
+        UpdateData::CompressPacket(pct);
+}
@@ -48,6 +48,9 @@ class WorldSocket: public MangosSocket<WorldSession, WorldSocket, AuthCrypt>
 
         int ProcessIncoming (WorldPacket* new_pct);
 
+        /// Compresses update packets queued with WorldSession::SendDeferredUpdatePacket().
+        void PrepareQueuedPacket (WorldPacket& pct);
+
         /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
         int HandleAuthSession (WorldPacket& recvPacket);
 
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_FLATAURALIST_H
+#define MANGOS_FLATAURALIST_H
+
+#include "Platform/Define.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+class Aura;
+
+/*
+ * Auras of a unit, in the order they were added (Unit::GetAurasByType).
+ * Kept in a vector instead of a std::list: adding an aura does not allocate
+ * once the vector has grown, and the loops over the auras of a type read
+ * contiguous memory.
+ * Iterators behave like the list ones: removing an aura only clears its slot,
+ * so iterators on the other auras stay valid while auras are added or removed.
+ * The cleared slots are skipped, and dropped by compact() when nothing
+ * iterates over the list anymore.
+ */
+class FlatAuraList
+{
+    public:
+        class const_iterator
+        {
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef Aura* value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Aura* const* pointer;
+                typedef Aura* const& reference;
+
+                const_iterator() : m_list(NULL), m_index(0) {}
+
+                reference operator*() const { return m_list->m_auras[m_index]; }
+                pointer operator->() const { return &m_list->m_auras[m_index]; }
+
+                const_iterator& operator++()
+                {
+                    ++m_index;
+                    while (m_index < m_list->m_auras.size() && !m_list->m_auras[m_index])
+                        ++m_index;
+                    return *this;
+                }
+                const_iterator& operator--()
+                {
+                    do
+                        --m_index;
+                    while (!m_list->m_auras[m_index]);
+                    return *this;
+                }
+                const_iterator operator++(int) { const_iterator itr = *this; ++*this; return itr; }
+                const_iterator operator--(int) { const_iterator itr = *this; --*this; return itr; }
+
+                bool operator==(const_iterator const& other) const { return m_index == other.m_index; }
+                bool operator!=(const_iterator const& other) const { return m_index != other.m_index; }
+
+            private:
+                friend class FlatAuraList;
+                const_iterator(FlatAuraList const* list, uint32 index) : m_list(list), m_index(index) {}
+
+                FlatAuraList const* m_list;
+                uint32 m_index;
+        };
+        typedef const_iterator iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef const_reverse_iterator reverse_iterator;
+        typedef Aura* value_type;
+
+        FlatAuraList() : m_removed(0) {}
+
+        const_iterator begin() const
+        {
+            const_iterator itr(this, 0);
+            if (!m_auras.empty() && !m_auras[0])
+                ++itr;
+            return itr;
+        }
+        const_iterator end() const { return const_iterator(this, m_auras.size()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const { return rend(); }
+
+        bool empty() const { return m_auras.size() == m_removed; }
+        size_t size() const { return m_auras.size() - m_removed; }
+        size_t capacity() const { return m_auras.capacity(); }
+        Aura* front() const { return *begin(); }
+        Aura* back() const { return *--end(); }
+
+        void push_back(Aura* aura)
+        {
+            m_auras.push_back(aura);
+        }
+
+        // Returns false when the aura is not in the list
+        bool remove(Aura* aura)
+        {
+            std::vector<Aura*>::iterator itr = std::find(m_auras.begin(), m_auras.end(), aura);
+            if (itr == m_auras.end())
+                return false;
+            *itr = NULL;
+            ++m_removed;
+            return true;
+        }
+        void erase(const_iterator itr)
+        {
+            m_auras[itr.m_index] = NULL;
+            ++m_removed;
+        }
+        void clear()
+        {
+            m_auras.clear();
+            m_removed = 0;
+        }
+
+        // Count of cleared slots waiting for compact()
+        uint32 removedCount() const { return m_removed; }
+
+        // Invalidates the iterators
+        void compact()
+        {
+            if (!m_removed)
+                return;
+            m_auras.erase(std::remove(m_auras.begin(), m_auras.end(), static_cast<Aura*>(NULL)), m_auras.end());
+            m_removed = 0;
+        }
+
+    private:
+        std::vector<Aura*> m_auras;
+        uint32 m_removed;
+};
+
+#endif
@@ -102,6 +102,8 @@ enum ProcFlags
                                   PROC_FLAG_SUCCESSFUL_RANGED_SPELL_HIT | \
                                   PROC_FLAG_TAKEN_RANGED_SPELL_HIT)
 
+#define ANY_TRIGGER_MASK 0xFFFFFFFF
+
 #define NEGATIVE_TRIGGER_MASK (MELEE_BASED_TRIGGER_MASK                | \
                                PROC_FLAG_SUCCESSFUL_NONE_SPELL_HIT     | \
                                PROC_FLAG_TAKEN_NONE_SPELL_HIT          | \
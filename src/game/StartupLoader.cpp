@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "StartupLoader.h"
+#include "Database/DatabaseEnv.h"
+#include "ProgressBar.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+#include "Log.h"
+
+void StartupLoader::Add(char const* name, LoadFunction function, std::initializer_list<char const*> dependencies)
+{
+    uint32 index = uint32(m_loaders.size());
+    m_loaders.push_back(Loader());
+    Loader& loader = m_loaders.back();
+    loader.name = name;
+    loader.function = function;
+
+    for (char const* dependency : dependencies)
+    {
+        auto itr = std::find_if(m_loaders.begin(), m_loaders.begin() + index,
+            [dependency](Loader const& other) { return other.name == dependency; });
+        // Unknown, or declared after us: the serial order would be wrong
+        MANGOS_ASSERT(itr != m_loaders.begin() + index);
+        itr->dependents.push_back(index);
+        ++loader.pendingDependencies;
+    }
+}
+
+void StartupLoader::RunLoader(Loader& loader)
+{
+    sLog.outString("Loading %s...", loader.name.c_str());
+    uint32 startTime = WorldTimer::getMSTime();
+    loader.function();
+    loader.elapsed = WorldTimer::getMSTimeDiffToNow(startTime);
+    sLog.outString(">> %s loaded in %u ms", loader.name.c_str(), loader.elapsed);
+}
+
+void StartupLoader::Run(uint32 numThreads)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    if (numThreads)
+        RunParallel(numThreads);
+    else
+        for (Loader& loader : m_loaders)
+            RunLoader(loader);
+
+    uint32 total = 0;
+    for (Loader const& loader : m_loaders)
+        total += loader.elapsed;
+
+    sLog.outString();
+    sLog.outString(">>> %s: %u loaders in %u ms (%u ms of loading, %u threads)", m_name.c_str(),
+        uint32(m_loaders.size()), WorldTimer::getMSTimeDiffToNow(startTime), total, numThreads);
+    sLog.outString();
+}
+
+void StartupLoader::RunParallel(uint32 numThreads)
+{
+    // Progress bars of concurrent loaders would be mixed on the console
+    bool showProgress = BarGoLink::GetOutputState();
+    BarGoLink::SetOutputState(false);
+
+    {
+        ThreadPool pool(numThreads, false,
+            []() { WorldDatabase.ThreadStart(); },
+            []() { WorldDatabase.ThreadEnd(); });
+        ThreadPool::TaskGroup group(&pool);
+
+        std::unique_lock<std::mutex> lock(m_finishedLock);
+        auto launch = [this, &group](uint32 index)
+        {
+            group.Run([this, index]()
+            {
+                RunLoader(m_loaders[index]);
+                std::lock_guard<std::mutex> guard(m_finishedLock);
+                m_finished.push_back(index);
+                m_finishedCond.notify_one();
+            });
+        };
+
+        for (uint32 i = 0; i < m_loaders.size(); ++i)
+            if (!m_loaders[i].pendingDependencies)
+                launch(i);
+
+        for (size_t done = 0; done < m_loaders.size();)
+        {
+            m_finishedCond.wait(lock, [this]() { return !m_finished.empty(); });
+            for (uint32 index : m_finished)
+            {
+                ++done;
+                for (uint32 dependent : m_loaders[index].dependents)
+                    if (--m_loaders[dependent].pendingDependencies == 0)
+                        launch(dependent);
+            }
+            m_finished.clear();
+        }
+        lock.unlock();
+        group.Wait();
+    }
+
+    BarGoLink::SetOutputState(showProgress);
+}
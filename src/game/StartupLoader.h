@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_STARTUPLOADER_H
+#define MANGOS_STARTUPLOADER_H
+
+#include "Common.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+/**
+ * Dependency graph of database loaders run at startup.
+ *
+ * Each loader declares the loaders it depends on (reads their data, or writes
+ * the same containers). Dependencies must be declared before their dependents,
+ * so the declaration order is always a valid serial order.
+ * - Without threads, loaders run one after another in declaration order.
+ * - With threads, a loader starts as soon as all its dependencies are done.
+ *   Independent loaders must not share any state: the final state is then the
+ *   same as with a serial load.
+ */
+class StartupLoader
+{
+    public:
+        typedef std::function<void()> LoadFunction;
+
+        explicit StartupLoader(char const* name) : m_name(name) {}
+
+        void Add(char const* name, LoadFunction function, std::initializer_list<char const*> dependencies = {});
+        void Run(uint32 numThreads);
+
+    private:
+        struct Loader
+        {
+            Loader() : pendingDependencies(0), elapsed(0) {}
+            std::string name;
+            LoadFunction function;
+            std::vector<uint32> dependents;
+            uint32 pendingDependencies;
+            uint32 elapsed;
+        };
+
+        void RunLoader(Loader& loader);
+        void RunParallel(uint32 numThreads);
+
+        std::string m_name;
+        std::vector<Loader> m_loaders;
+
+        std::mutex m_finishedLock;
+        std::condition_variable m_finishedCond;
+        std::vector<uint32> m_finished;
+};
+
+#endif
@@ -68,6 +68,8 @@ HostileReference::HostileReference(Unit* pUnit, ThreatManager *pThreatManager, f
     iUnitGuid = pUnit->GetObjectGuid();
     iOnline = true;
     iAccessible = true;
+    iContainer = nullptr;
+    iThreatChanged = false;
 }
 
 //============================================================
@@ -206,10 +208,56 @@ void ThreatContainer::clearReferences()
 {
     for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
     {
+        (*i)->iContainer = nullptr;
         (*i)->unlink();
         delete(*i);
     }
     iThreatList.clear();
+    iThreatOrder.clear();
+    iThreatIndex.clear();
+    iChangedRefs.clear();
+}
+
+//============================================================
+// New references are ranked with the next update
+
+void ThreatContainer::addReference(HostileReference* pHostileReference)
+{
+    iThreatIndex[pHostileReference->getUnitGuid()] = pHostileReference;
+    pHostileReference->iContainer = this;
+    pHostileReference->iListItr = iThreatList.insert(iThreatList.end(), pHostileReference);
+    pHostileReference->iThreatChanged = true;
+    iChangedRefs.push_back(pHostileReference);
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* pRef)
+{
+    if (pRef->iContainer != this)
+        return;
+
+    if (pRef->iThreatChanged)
+        iChangedRefs.erase(std::find(iChangedRefs.begin(), iChangedRefs.end(), pRef));
+    else
+        iThreatOrder.erase(pRef->iOrderItr);
+
+    iThreatList.erase(pRef->iListItr);
+    iThreatIndex.erase(pRef->getUnitGuid());
+    pRef->iContainer = nullptr;
+    pRef->iThreatChanged = false;
+}
+
+//============================================================
+
+void ThreatContainer::threatChanged(HostileReference* pRef)
+{
+    if (pRef->iContainer != this || pRef->iThreatChanged)
+        return;
+
+    iThreatOrder.erase(pRef->iOrderItr);
+    pRef->iThreatChanged = true;
+    iChangedRefs.push_back(pRef);
 }
 
 //============================================================
@@ -219,18 +267,8 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
     if (!pVictim)
         return nullptr;
 
-    HostileReference* result = nullptr;
-    ObjectGuid guid = pVictim->GetObjectGuid();
-    for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-    {
-        if ((*i)->getUnitGuid() == guid)
-        {
-            result = (*i);
-            break;
-        }
-    }
-
-    return result;
+    ThreatListIndex::const_iterator itr = iThreatIndex.find(pVictim->GetObjectGuid());
+    return itr != iThreatIndex.end() ? itr->second : nullptr;
 }
 
 //============================================================
@@ -265,20 +303,21 @@ void ThreatContainer::modifyThreatPercent(Unit *pVictim, int32 pPercent)
 
 //============================================================
 
-bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileReference* rhs)
-{
-    // std::list::sort ordering predicate must be: (Pred(x,y)&&Pred(y,x))==false
-    return lhs->getThreat() > rhs->getThreat();             // reverse sorting
-}
-
-//============================================================
-// Check if the list is dirty and sort if necessary
+// Rank the changed references again: each one is moved in the list
+// just before the reference that follows it in the threat order
 
 void ThreatContainer::update()
 {
-    if (iDirty && iThreatList.size() > 1)
-        iThreatList.sort(HostileReferenceSortPredicate);
-    iDirty = false;
+    for (std::vector<HostileReference*>::const_iterator i = iChangedRefs.begin(); i != iChangedRefs.end(); ++i)
+    {
+        HostileReference* ref = *i;
+        ref->iOrderItr = iThreatOrder.insert(ThreatOrderMap::value_type(ref->getThreat(), ref));
+        ref->iThreatChanged = false;
+
+        ThreatOrderMap::const_iterator next = std::next(ref->iOrderItr);
+        iThreatList.splice(next != iThreatOrder.end() ? next->second->iListItr : iThreatList.end(), iThreatList, ref->iListItr);
+    }
+    iChangedRefs.clear();
 }
 
 //============================================================
@@ -517,35 +556,28 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch (threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostileReference && threatRefStatusChangeEvent->getFValue() < 0.0f) ||
-                    (getCurrentVictim() != hostileReference && threatRefStatusChangeEvent->getFValue() > 0.0f))
-                setDirty(true);                             // the order in the threat list might have changed
+            if (hostileReference->isOnline())
+                iThreatContainer.threatChanged(hostileReference);
+            else
+                iThreatOfflineContainer.threatChanged(hostileReference);
             break;
         case UEV_THREAT_REF_ONLINE_STATUS:
             if (!hostileReference->isOnline())
             {
                 if (hostileReference == getCurrentVictim())
-                {
                     setCurrentVictim(nullptr);
-                    setDirty(true);
-                }
                 iThreatContainer.remove(hostileReference);
                 iThreatOfflineContainer.addReference(hostileReference);
             }
             else
             {
-                if (getCurrentVictim() && hostileReference->getThreat() > (1.1f * getCurrentVictim()->getThreat()))
-                    setDirty(true);
-                iThreatContainer.addReference(hostileReference);
                 iThreatOfflineContainer.remove(hostileReference);
+                iThreatContainer.addReference(hostileReference);
             }
             break;
         case UEV_THREAT_REF_REMOVE_FROM_LIST:
             if (hostileReference == getCurrentVictim())
-            {
                 setCurrentVictim(nullptr);
-                setDirty(true);
-            }
             if (hostileReference->isOnline())
                 iThreatContainer.remove(hostileReference);
             else
@@ -28,14 +28,22 @@
 #include "UnitEvents.h"
 #include "ObjectGuid.h"
 #include <list>
+#include <vector>
+#include <functional>
 
 //==============================================================
 
 class Unit;
 class Creature;
 class ThreatManager;
+class ThreatContainer;
+class HostileReference;
 class SpellEntry;
 
+typedef std::list<HostileReference*> ThreatList;
+// Threat of the references at the last ThreatContainer::update(), highest first
+typedef std::multimap<float, HostileReference*, std::greater<float> > ThreatOrderMap;
+
 //==============================================================
 // Class to calculate the real threat based
 
@@ -122,6 +130,8 @@ class MANGOS_DLL_SPEC HostileReference : public Reference<Unit, ThreatManager>
         // Tell our refFrom (source) object, that the link is cut (Target destroyed)
         void sourceObjectDestroyLink() override;
     private:
+        friend class ThreatContainer;
+
         // Inform the source, that the status of that reference was changed
         void fireStatusChanged(ThreatRefStatusChangeEvent& pThreatRefStatusChangeEvent);
 
@@ -130,27 +140,39 @@ class MANGOS_DLL_SPEC HostileReference : public Reference<Unit, ThreatManager>
         ObjectGuid iUnitGuid;
         bool iOnline;
         bool iAccessible;
+
+        // Rank in the container that holds the reference
+        ThreatContainer* iContainer;
+        ThreatList::iterator iListItr;
+        ThreatOrderMap::iterator iOrderItr;                 // not valid while iThreatChanged
+        bool iThreatChanged;
 };
 
 //==============================================================
-class ThreatManager;
-
-typedef std::list<HostileReference*> ThreatList;
 
+// The list is kept ordered by threat (highest first) with an index of the threats at the last
+// update. A reference whose threat changed leaves the index and keeps its place in the list until
+// update() moves it to its new rank, so iterators on the list stay valid while threat changes.
 class MANGOS_DLL_SPEC ThreatContainer
 {
+    typedef std::unordered_map<ObjectGuid, HostileReference*> ThreatListIndex;
+
     ThreatList iThreatList;
-    bool iDirty;
+    ThreatOrderMap iThreatOrder;
+    ThreatListIndex iThreatIndex;
+    std::vector<HostileReference*> iChangedRefs;
 protected:
     friend class ThreatManager;
 
-    void remove(HostileReference* pRef) { iThreatList.remove(pRef); }
-    void addReference(HostileReference* pHostileReference) { iThreatList.push_back(pHostileReference); }
+    void remove(HostileReference* pRef);
+    void addReference(HostileReference* pHostileReference);
     void clearReferences();
-    // Sort the list if necessary
+    // The threat of the reference changed, its rank will be updated with the next update()
+    void threatChanged(HostileReference* pRef);
+    // Move the changed references to their rank
     void update();
 public:
-    ThreatContainer() { iDirty = false; }
+    ThreatContainer() {}
     ~ThreatContainer() { clearReferences(); }
 
     HostileReference* addThreat(Unit* pVictim, float pThreat);
@@ -159,9 +181,7 @@ public:
 
     HostileReference* selectNextVictim(Creature* pAttacker, HostileReference* pCurrentVictim);
 
-    void setDirty(bool pDirty) { iDirty = pDirty; }
-
-    bool isDirty() const { return iDirty; }
+    bool isDirty() const { return !iChangedRefs.empty(); }
 
     bool empty() const { return iThreatList.empty(); }
 
@@ -211,8 +231,6 @@ public:
 
     void setCurrentVictim(HostileReference* pHostileReference);
 
-    void setDirty(bool pDirty) { iThreatContainer.setDirty(pDirty); }
-
     // Don't must be used for explicit modify threat values in iterator return pointers
     ThreatList const& getThreatList() const { return iThreatContainer.getThreatList(); }
 private:
@@ -236,6 +236,45 @@ inline bool SpellCanTrigger(const SpellEntry* spellProto, const SpellEntry* proc
     return (procSpell && procSpell->SpellFamilyName == spellProto->SpellFamilyName && procSpell->SpellFamilyFlags & spellProto->EffectItemType[eff_idx]);
 }
 
+// Proc flags for which IsTriggeredAtSpellProcEvent may accept a holder of the spell. The spells
+// it handles before checking the flags get all of them: keep both functions in sync.
+// Note: auras already applied keep their flags on a reload of spell_proc_event.
+uint32 Unit::GetSpellAuraHolderProcFlags(SpellEntry const* spellProto)
+{
+#if SUPPORTED_CLIENT_BUILD > CLIENT_BUILD_1_8_4
+    // Eye for an Eye
+#if SUPPORTED_CLIENT_BUILD > CLIENT_BUILD_1_9_4
+    if (spellProto->SpellIconID == 1820)
+#else
+    if (spellProto->SpellIconID == 1799)
+#endif
+        return ANY_TRIGGER_MASK;
+#endif
+    // Improved Lay on Hands, Inspiration
+    if (spellProto->SpellIconID == 79 && (spellProto->SpellFamilyName == SPELLFAMILY_PALADIN || spellProto->SpellFamilyName == SPELLFAMILY_PRIEST))
+        return ANY_TRIGGER_MASK;
+
+    switch (spellProto->Id)
+    {
+        case 25906:                                         // Wrath of Cenarius
+        case 24658:                                         // Zandalarian Hero Charm
+        case 16864:                                         // Omen of Clarity
+        case 17768:                                         // Wolfshead Helm
+        case 24392:                                         // Frosty Zap
+#if SUPPORTED_CLIENT_BUILD <= CLIENT_BUILD_1_9_4
+        case 12292:                                         // Sweeping Strikes
+        case 18765:
+#endif
+        case 6346:                                          // Fear Ward
+            return ANY_TRIGGER_MASK;
+    }
+
+    SpellProcEventEntry const* spellProcEvent = sSpellMgr.GetSpellProcEvent(spellProto->Id);
+    if (spellProcEvent && spellProcEvent->procFlags)
+        return spellProcEvent->procFlags;
+    return spellProto->procFlags;
+}
+
 bool Unit::IsTriggeredAtSpellProcEvent(Unit *pVictim, SpellAuraHolder* holder, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, SpellProcEventEntry const*& spellProcEvent)
 {
     SpellEntry const* spellProto = holder->GetSpellProto();
@@ -47,6 +47,7 @@
 #include "ItemEnchantmentMgr.h"
 #include "MapManager.h"
 #include "ScriptMgr.h"
+#include "StartupLoader.h"
 #include "CreatureAIRegistry.h"
 #include "Policies/SingletonImp.h"
 #include "BattleGroundMgr.h"
@@ -81,7 +82,9 @@
 #include "Anticheat/Anticheat.h"
 #include "AuraRemovalMgr.h"
 #include "InstanceStatistics.h"
+#include "LogsDatabaseWriter.h"
 #include "GuardMgr.h"
+#include "TickProfiler.h"
 
 #include <chrono>
 
@@ -521,9 +524,13 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
     setConfig(CONFIG_BOOL_CLEANUP_TERRAIN, "CleanupTerrain", true);
+    setConfig(CONFIG_BOOL_WORLD_DB_BINARY_RESULTS, "WorldDatabase.BinaryResultSets", false);
+    setConfig(CONFIG_BOOL_WORLD_DB_BINARY_RESULTS_COMPARE, "WorldDatabase.BinaryResultSets.Compare", false);
     setConfigPos(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
     setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, "PlayerSave.Stats.SaveOnlyOnLogout", true);
+    setConfig(CONFIG_BOOL_INCREMENTAL_PLAYER_SAVE, "PlayerSave.Incremental", true);
+    setConfigMin(CONFIG_UINT32_PLAYER_SAVE_FULL_INTERVAL, "PlayerSave.Incremental.FullSaveInterval", 4, 1);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_GRIDCLEAN, "GridCleanUpDelay", 5 * MINUTE * IN_MILLISECONDS, MIN_GRID_DELAY);
     if (reload)
@@ -854,6 +861,8 @@ void World::LoadConfigSettings(bool reload)
     VMAP::VMapFactory::preventSpellsFromBeingTestedForLoS(ignoreSpellIds.c_str());
     sLog.outString("WORLD: VMap support included. LineOfSight:%i, getHeight:%i, indoorCheck:%i", enableLOS, enableHeight, getConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK) ? 1 : 0);
     sLog.outString("WORLD: VMap data directory is: %svmaps", m_dataPath.c_str());
+    setConfigMinMax(CONFIG_UINT32_LOS_CACHE_TIME, "vmap.losCacheTime", 250, 0, 5000);
+
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
     sLog.outString("WORLD: mmap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
     setConfig(CONFIG_BOOL_IS_MAPSERVER, "IsMapServer", false);
@@ -861,9 +870,13 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_EMPTY_MAPS_UPDATE_TIME, "MapUpdate.Empty.UpdateTime", 0);
     setConfigMinMax(CONFIG_UINT32_MAP_OBJECTSUPDATE_THREADS, "MapUpdate.ObjectsUpdate.MaxThreads", 4, 1, 20);
     setConfigMinMax(CONFIG_UINT32_MAP_OBJECTSUPDATE_TIMEOUT, "MapUpdate.ObjectsUpdate.Timeout", 100, 10, 2000);
+    setConfig(CONFIG_BOOL_SHARE_VALUES_UPDATE_BLOCKS, "MapUpdate.ObjectsUpdate.ShareValuesBlocks", true);
     setConfigMinMax(CONFIG_UINT32_MAP_VISIBILITYUPDATE_THREADS, "MapUpdate.VisibilityUpdate.MaxThreads", 4, 1, 20);
     setConfigMinMax(CONFIG_UINT32_MAP_VISIBILITYUPDATE_TIMEOUT, "MapUpdate.VisibilityUpdate.Timeout", 100, 10, 2000);
     setConfigMinMax(CONFIG_UINT32_MAPUPDATE_INSTANCED_UPDATE_THREADS, "MapUpdate.Instanced.UpdateThreads", 2, 0, 20);
+    setConfigMinMax(CONFIG_UINT32_MAPUPDATE_POOL_THREADS, "MapUpdate.ThreadPool.Threads", 0, 0, 64);
+    setConfigMinMax(CONFIG_UINT32_STARTUP_LOADER_THREADS, "StartupLoader.Threads", 0, 0, 16);
+    setConfig(CONFIG_BOOL_MAPUPDATE_POOL_PIN_THREADS, "MapUpdate.ThreadPool.PinThreads", false);
     setConfigMinMax(CONFIG_UINT32_MTCELLS_THREADS, "MapUpdate.Continents.MTCells.Threads", 0, 0, 20);
     setConfigMinMax(CONFIG_UINT32_MTCELLS_SAFEDISTANCE, "MapUpdate.Continents.MTCells.SafeDistance", 1066, 0, 34112);
     setConfigMinMax(CONFIG_UINT32_MAPUPDATE_UPDATE_PACKETS_DIFF, "MapUpdate.UpdatePacketsDiff", 100, 1, 10000);
@@ -878,8 +891,12 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_MAPUPDATE_MIN_VISIBILITY_DISTANCE, "MapUpdate.MinVisibilityDistance", 0);
     setConfig(CONFIG_BOOL_CONTINENTS_INSTANCIATE, "Continents.Instanciate", false);
     setConfig(CONFIG_UINT32_CONTINENTS_MOTIONUPDATE_THREADS, "Continents.MotionUpdate.Threads", 0);
+    setConfig(CONFIG_BOOL_MOTIONUPDATE_BATCH, "MotionUpdate.Batch", true);
     setConfig(CONFIG_BOOL_TERRAIN_PRELOAD_CONTINENTS, "Terrain.Preload.Continents", 1);
     setConfig(CONFIG_BOOL_TERRAIN_PRELOAD_INSTANCES, "Terrain.Preload.Instances", 1);
+    setConfig(CONFIG_BOOL_TERRAIN_MAPPED_TILES, "Terrain.MappedTiles", true);
+    setConfigMinMax(CONFIG_UINT32_GRID_PRELOAD_THREADS, "Terrain.GridPreload.Threads", 2, 0, 16);
+    setConfigMinMax(CONFIG_UINT32_GRID_PRELOAD_DISTANCE, "Terrain.GridPreload.Distance", 200, 0, 1000);
 
     setConfig(CONFIG_BOOL_ENABLE_MOVEMENT_INTERP, "Movement.Interpolation", true);
     setConfigMinMax(CONFIG_UINT32_MAX_POINTS_PER_MVT_PACKET, "Movement.MaxPointsPerPacket", 80, 5, 10000);
@@ -911,6 +928,10 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_PERFLOG_SLOW_MAP_PACKETS, "PerformanceLog.SlowMapPackets", 60);
     setConfig(CONFIG_UINT32_PERFLOG_SLOW_SESSIONS_UPDATE, "PerformanceLog.SlowSessionsUpdate", 0);
     setConfig(CONFIG_UINT32_PERFLOG_SLOW_PACKET_BCAST, "PerformanceLog.SlowPacketBroadcast", 0);
+    setConfig(CONFIG_UINT32_PERFLOG_TICK_STATS_INTERVAL, "PerformanceLog.TickStatsInterval", 60);
+    setConfig(CONFIG_BOOL_TICK_PROFILER, "PerformanceLog.TickProfiler", true);
+    sTickProfiler.SetEnabled(getConfig(CONFIG_BOOL_TICK_PROFILER));
+    m_timers[WUPDATE_TICK_STATS].SetInterval(getConfig(CONFIG_UINT32_PERFLOG_TICK_STATS_INTERVAL) * IN_MILLISECONDS);
     setConfig(CONFIG_UINT32_LOG_MONEY_TRADES_TRESHOLD, "LogMoneyTreshold", 10000);
 
     setConfig(CONFIG_FLOAT_DYN_RESPAWN_CHECK_RANGE, "DynamicRespawn.Range", -1.0f);
@@ -962,6 +983,7 @@ void World::LoadConfigSettings(bool reload)
 
     setConfigMinMax(CONFIG_UINT32_ASYNC_TASKS_THREADS_COUNT,       "AsyncTasks.Threads", 1, 1, 20);
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET,               "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_BOOL_COMPRESS_UPDATES_IN_NETWORK_THREADS,     "Network.CompressUpdatesInNetworkThreads", false);
     setConfig(CONFIG_UINT32_PACKET_BCAST_THREADS,                  "Network.PacketBroadcast.Threads", 0);
     setConfig(CONFIG_UINT32_PACKET_BCAST_FREQUENCY,                "Network.PacketBroadcast.Frequency", 50);
     setConfig(CONFIG_UINT32_PBCAST_DIFF_LOWER_VISIBILITY_DISTANCE, "Network.PacketBroadcast.ReduceVisDistance.DiffAbove", 0);
@@ -1095,6 +1117,7 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Instance Statistics...");
     sLog.outString();
     sInstanceStatistics.LoadFromDB();
+    sLogsDatabaseWriter.Initialize();
 
     ///- Chargements des variables (necessaire pour le OutdoorJcJ)
     sLog.outString("Loading saved variables ...");
@@ -1366,73 +1389,50 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading spell pet auras...");
     sSpellMgr.LoadSpellPetAuras();
 
-    sLog.outString("Loading Player Create Info & Level Stats...");
-    sLog.outString();
-    sObjectMgr.LoadPlayerInfo();
-    sLog.outString(">>> Player Create Info & Level Stats loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Exploration BaseXP Data...");
-    sObjectMgr.LoadExplorationBaseXP();
-
-    sLog.outString("Loading Pet Name Parts...");
-    sObjectMgr.LoadPetNames();
-
+    // Independent loaders: run concurrently when StartupLoader.Threads is set.
+    // Dependencies must list every loader whose data is read, see StartupLoader.h
+    StartupLoader loader("Player data, loot, gossip, vendors, trainers and waypoints");
+    loader.Add("Player Create Info & Level Stats", []() { sObjectMgr.LoadPlayerInfo(); });
+    loader.Add("Exploration BaseXP Data", []() { sObjectMgr.LoadExplorationBaseXP(); });
+    loader.Add("Pet Name Parts", []() { sObjectMgr.LoadPetNames(); });
     if (!isMapServer)
     {
-        CharacterDatabaseCleaner::CleanDatabase();
-
-        sLog.outString("Loading character cache data...");
-        sObjectMgr.LoadPlayerCacheData();
-
-        sLog.outString("Loading the max pet number...");
-        sObjectMgr.LoadPetNumber();
+        loader.Add("character cache data", []()
+        {
+            CharacterDatabaseCleaner::CleanDatabase();
+            sObjectMgr.LoadPlayerCacheData();
+            sObjectMgr.LoadPetNumber();
+        });
     }
-
-    sLog.outString("Loading pet level stats...");
-    sObjectMgr.LoadPetLevelInfo();
-
+    loader.Add("pet level stats", []() { sObjectMgr.LoadPetLevelInfo(); });
     if (!isMapServer)
-    {
-        sLog.outString("Loading Player Corpses...");
-        sObjectMgr.LoadCorpses();
-    }
-
-    sLog.outString("Loading Loot Tables...");
-    sLog.outString();
-    LoadLootTables();
-    sLog.outString(">>> Loot Tables loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    sLog.outString("Loading Npc Text Id...");
-    sObjectMgr.LoadNpcGossips();                            // must be after load Creature and LoadNPCText
-
-    sLog.outString("Loading Gossip scripts...");
-    sScriptMgr.LoadGossipScripts();                         // must be before gossip menu options
-
-    sLog.outString("Loading Gossip menus...");
-    sObjectMgr.LoadGossipMenu();
-
-    sLog.outString("Loading Gossip menu options...");
-    sObjectMgr.LoadGossipMenuItems();
-
-    sLog.outString("Loading Vendors...");
-    sObjectMgr.LoadVendorTemplates();                       // must be after load ItemTemplate
-    sObjectMgr.LoadVendors();                               // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
-
-    sLog.outString("Loading Trainers...");
-    sObjectMgr.LoadTrainerTemplates();                      // must be after load CreatureTemplate
-    sObjectMgr.LoadTrainers();                              // must be after load CreatureTemplate, TrainerTemplate
-
-    sLog.outString("Loading Waypoint scripts...");          // before loading from creature_movement
-    sScriptMgr.LoadCreatureMovementScripts();
-
-    sLog.outString("Loading Waypoints...");
-    sLog.outString();
-    sWaypointMgr.Load();
+        loader.Add("Player Corpses", []() { sObjectMgr.LoadCorpses(); }, { "character cache data" });
+
+    // Each loot store only reads templates and conditions, references check all of them
+    loader.Add("Creature Loot Tables", []() { LoadLootTemplates_Creature(); });
+    loader.Add("Fishing Loot Tables", []() { LoadLootTemplates_Fishing(); });
+    loader.Add("Gameobject Loot Tables", []() { LoadLootTemplates_Gameobject(); });
+    loader.Add("Item Loot Tables", []() { LoadLootTemplates_Item(); });
+    loader.Add("Mail Loot Tables", []() { LoadLootTemplates_Mail(); });
+    loader.Add("Pickpocketing Loot Tables", []() { LoadLootTemplates_Pickpocketing(); });
+    loader.Add("Skinning Loot Tables", []() { LoadLootTemplates_Skinning(); });
+    loader.Add("Disenchant Loot Tables", []() { LoadLootTemplates_Disenchant(); });
+    loader.Add("Reference Loot Tables", []() { LoadLootTemplates_Reference(); },
+        { "Creature Loot Tables", "Fishing Loot Tables", "Gameobject Loot Tables", "Item Loot Tables",
+          "Mail Loot Tables", "Pickpocketing Loot Tables", "Skinning Loot Tables", "Disenchant Loot Tables" });
+
+    loader.Add("Skill Fishing base level requirements", []() { sObjectMgr.LoadFishingBaseSkillLevel(); });
+    loader.Add("Npc Text Id", []() { sObjectMgr.LoadNpcGossips(); });                     // must be after load Creature and LoadNPCText
+    loader.Add("Gossip scripts", []() { sScriptMgr.LoadGossipScripts(); });             // must be before gossip menu options
+    loader.Add("Gossip menus", []() { sObjectMgr.LoadGossipMenu(); });
+    loader.Add("Gossip menu options", []() { sObjectMgr.LoadGossipMenuItems(); }, { "Gossip scripts", "Gossip menus" });
+    loader.Add("Vendor templates", []() { sObjectMgr.LoadVendorTemplates(); });         // must be after load ItemTemplate
+    loader.Add("Vendors", []() { sObjectMgr.LoadVendors(); }, { "Vendor templates" });  // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
+    loader.Add("Trainer templates", []() { sObjectMgr.LoadTrainerTemplates(); });       // must be after load CreatureTemplate
+    loader.Add("Trainers", []() { sObjectMgr.LoadTrainers(); }, { "Trainer templates" });
+    loader.Add("Waypoint scripts", []() { sScriptMgr.LoadCreatureMovementScripts(); }); // before loading from creature_movement
+    loader.Add("Waypoints", []() { sWaypointMgr.Load(); }, { "Waypoint scripts" });
+    loader.Run(getConfig(CONFIG_UINT32_STARTUP_LOADER_THREADS));
 
     ///- Loading localization data
     sLog.outString("Loading Localization strings...");
@@ -1725,6 +1725,9 @@ public:
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    TickProfile* profile = sTickProfiler.GetWorldProfile();
+    TickPhaseTimer worldTimer(profile, TICK_PHASE_WORLD);
+
     ///- Update the different timers
     for (int i = 0; i < WUPDATE_COUNT; ++i)
     {
@@ -1740,6 +1743,9 @@ void World::Update(uint32 diff)
     ///-Update mass mailer tasks if any
     sMassMailMgr.Update();
 
+    ///- Write the buffered logs database events
+    sLogsDatabaseWriter.Update();
+
     /// <ul><li> Handle auctions when the timer has passed
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
@@ -1752,7 +1758,9 @@ void World::Update(uint32 diff)
 
     /// <li> Handle session updates
     uint32 updateSessionsTime = WorldTimer::getMSTime();
+    TickPhaseTimer sessionsTimer(profile, TICK_PHASE_WORLD_SESSIONS);
     UpdateSessions(diff);
+    sessionsTimer.Stop();
     updateSessionsTime = WorldTimer::getMSTimeDiffToNow(updateSessionsTime);
     if (getConfig(CONFIG_UINT32_PERFLOG_SLOW_SESSIONS_UPDATE) && updateSessionsTime > getConfig(CONFIG_UINT32_PERFLOG_SLOW_SESSIONS_UPDATE))
         sLog.out(LOG_PERFORMANCE, "Update sessions: %ums", updateSessionsTime);
@@ -1770,6 +1778,7 @@ void World::Update(uint32 diff)
 
     ///- Update objects (maps, transport, creatures,...)
     uint32 updateMapSystemTime = WorldTimer::getMSTime();
+    TickPhaseTimer mapsTimer(profile, TICK_PHASE_WORLD_MAPS);
     std::vector<ACE_Based::Thread*> asyncTaskThreads;
     int threadsCount = getConfig(CONFIG_UINT32_ASYNC_TASKS_THREADS_COUNT);
     for (int i = 0; i < threadsCount; ++i)
@@ -1801,6 +1810,7 @@ void World::Update(uint32 diff)
         delete asyncTaskThreads[i];
     }
 
+    mapsTimer.Stop();
     updateMapSystemTime = WorldTimer::getMSTimeDiffToNow(updateMapSystemTime);
     if (getConfig(CONFIG_UINT32_PERFLOG_SLOW_MAPSYSTEM_UPDATE) && updateMapSystemTime > getConfig(CONFIG_UINT32_PERFLOG_SLOW_MAPSYSTEM_UPDATE))
         sLog.out(LOG_PERFORMANCE, "Update map system: %ums [%ums for async]", updateMapSystemTime, WorldTimer::getMSTimeDiffToNow(asyncWaitBegin));
@@ -1814,7 +1824,9 @@ void World::Update(uint32 diff)
 
     // execute callbacks from sql queries that were queued recently
     uint32 asyncQueriesTime = WorldTimer::getMSTime();
+    TickPhaseTimer callbacksTimer(profile, TICK_PHASE_WORLD_DB_CALLBACKS);
     UpdateResultQueue();
+    callbacksTimer.Stop();
     asyncQueriesTime = WorldTimer::getMSTimeDiffToNow(asyncQueriesTime);
     if (getConfig(CONFIG_UINT32_PERFLOG_SLOW_ASYNC_QUERIES) && asyncQueriesTime > getConfig(CONFIG_UINT32_PERFLOG_SLOW_ASYNC_QUERIES))
         sLog.out(LOG_PERFORMANCE, "Update async queries: %ums", asyncQueriesTime);
@@ -1865,11 +1877,22 @@ void World::Update(uint32 diff)
     //cleanup unused GridMap objects as well as VMaps
     if (getConfig(CONFIG_BOOL_CLEANUP_TERRAIN))
         sTerrainMgr.Update(diff);
+
+    worldTimer.Stop();
+    profile->EndTick();
+    sTickProfiler.EndNetworkTick();
+
+    if (getConfig(CONFIG_UINT32_PERFLOG_TICK_STATS_INTERVAL) && sTickProfiler.IsEnabled() && m_timers[WUPDATE_TICK_STATS].Passed())
+    {
+        m_timers[WUPDATE_TICK_STATS].Reset();
+        sLog.out(LOG_PERFORMANCE, "%s", sTickProfiler.GetSummary().c_str());
+    }
 }
 
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket *packet, WorldSession *self, uint32 team)
 {
+    BroadcastPacket shared(packet);
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -1878,7 +1901,7 @@ void World::SendGlobalMessage(WorldPacket *packet, WorldSession *self, uint32 te
                 itr->second->GetPlayer()->IsInWorld() &&
                 itr->second != self &&
                 (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
-            itr->second->SendPacket(packet);
+            shared.SendTo(itr->second);
     }
 }
 
@@ -2723,16 +2746,15 @@ void World::LogMoneyTrade(ObjectGuid sender, ObjectGuid receiver, uint32 amount,
 {
     if (!LogsDatabase || !sWorld.getConfig(CONFIG_BOOL_LOGSDB_TRADES))
         return;
-    static SqlStatementID insLogMoney;
-    SqlStatement logStmt = LogsDatabase.CreateStatement(insLogMoney, "INSERT INTO logs_trade SET sender=?, senderType=?, senderEntry=?, receiver=?, amount=?, type=?, data=?");
-    logStmt.addUInt32(sender.GetCounter());
-    logStmt.addUInt32(sender.GetHigh());
-    logStmt.addUInt32(sender.GetEntry());
-    logStmt.addUInt32(receiver.GetCounter());
-    logStmt.addUInt32(amount);
-    logStmt.addString(type);
-    logStmt.addUInt32(dataInt);
-    logStmt.Execute();
+    LogsDatabaseEvent event(LOGS_TABLE_TRADE);
+    event.addString(type);
+    event.addUInt32(sender.GetCounter());
+    event.addUInt32(sender.GetHigh());
+    event.addUInt32(sender.GetEntry());
+    event.addUInt32(receiver.GetCounter());
+    event.addUInt32(amount);
+    event.addUInt32(dataInt);
+    event.Write();
 }
 
 void World::LogCharacter(Player* character, const char* action)
@@ -2740,16 +2762,15 @@ void World::LogCharacter(Player* character, const char* action)
     if (!LogsDatabase || !sWorld.getConfig(CONFIG_BOOL_LOGSDB_CHARACTERS))
         return;
     ASSERT(character);
-    static SqlStatementID insLogChar;
-    SqlStatement logStmt = LogsDatabase.CreateStatement(insLogChar, "INSERT INTO logs_characters SET type=?, guid=?, account=?, name=?, ip=?, clientHash=?");
-    logStmt.addString(action);
-    logStmt.addUInt32(character->GetGUIDLow());
-    logStmt.addUInt32(character->GetSession()->GetAccountId());
-    logStmt.addString(character->GetName());
-    logStmt.addString(character->GetSession()->GetRemoteAddress());
+    LogsDatabaseEvent event(LOGS_TABLE_CHARACTERS);
+    event.addString(action);
+    event.addUInt32(character->GetGUIDLow());
+    event.addUInt32(character->GetSession()->GetAccountId());
+    event.addString(character->GetName());
+    event.addString(character->GetSession()->GetRemoteAddress());
     character->GetSession()->ComputeClientHash();
-    logStmt.addString(character->GetSession()->GetClientHash());
-    logStmt.Execute();
+    event.addString(character->GetSession()->GetClientHash());
+    event.Write();
 }
 
 void World::LogCharacter(WorldSession* sess, uint32 lowGuid, std::string const& charName, const char* action)
@@ -2757,16 +2778,15 @@ void World::LogCharacter(WorldSession* sess, uint32 lowGuid, std::string const&
     if (!LogsDatabase || !sWorld.getConfig(CONFIG_BOOL_LOGSDB_CHARACTERS))
         return;
     ASSERT(sess);
-    static SqlStatementID insLogChar;
-    SqlStatement logStmt = LogsDatabase.CreateStatement(insLogChar, "INSERT INTO logs_characters SET type=?, guid=?, account=?, name=?, ip=?, clientHash=?");
-    logStmt.addString(action);
-    logStmt.addUInt32(lowGuid);
-    logStmt.addUInt32(sess->GetAccountId());
-    logStmt.addString(charName);
-    logStmt.addString(sess->GetRemoteAddress());
+    LogsDatabaseEvent event(LOGS_TABLE_CHARACTERS);
+    event.addString(action);
+    event.addUInt32(lowGuid);
+    event.addUInt32(sess->GetAccountId());
+    event.addString(charName);
+    event.addString(sess->GetRemoteAddress());
     sess->ComputeClientHash();
-    logStmt.addString(sess->GetClientHash());
-    logStmt.Execute();
+    event.addString(sess->GetClientHash());
+    event.Write();
 }
 
 void World::LogChat(WorldSession* sess, const char* type, std::string const& msg, PlayerPointer target, uint32 chanId, const char* chanStr)
@@ -2786,16 +2806,14 @@ void World::LogChat(WorldSession* sess, const char* type, std::string const& msg
 
     if (!LogsDatabase || !sWorld.getConfig(CONFIG_BOOL_LOGSDB_CHAT))
         return;
-    static SqlStatementID insLogChat;
-    SqlStatement logStmt = LogsDatabase.CreateStatement(insLogChat,
-            "INSERT INTO logs_chat SET type=?, guid=?, target=?, channelId=?, channelName=?, message=?");
-    logStmt.addString(type);
-    logStmt.addUInt32(plr->GetObjectGuid().GetCounter());
-    logStmt.addUInt32(target ? target->GetObjectGuid().GetCounter() : 0);
-    logStmt.addUInt32(chanId);
-    logStmt.addString(chanStr ? chanStr : "");
-    logStmt.addString(msg);
-    logStmt.Execute();
+    LogsDatabaseEvent event(LOGS_TABLE_CHAT);
+    event.addString(type);
+    event.addUInt32(plr->GetObjectGuid().GetCounter());
+    event.addUInt32(target ? target->GetObjectGuid().GetCounter() : 0);
+    event.addUInt32(chanId);
+    event.addString(chanStr ? chanStr : "");
+    event.addString(msg);
+    event.Write();
 }
 
 void World::LogTransaction(PlayerTransactionData const& data)
@@ -2803,17 +2821,14 @@ void World::LogTransaction(PlayerTransactionData const& data)
     if (!LogsDatabase || !sWorld.getConfig(CONFIG_BOOL_LOGSDB_TRANSACTIONS))
         return;
 
-    static SqlStatementID insLogTransaction;
-    SqlStatement logStmt = LogsDatabase.CreateStatement(insLogTransaction,
-        "INSERT INTO logs_transactions SET type=?, guid1=?, money1=?, spell1=?, items1=?, "
-        "guid2=?, money2=?, spell2=?, items2=?");
-    logStmt.addString(data.type);
+    LogsDatabaseEvent event(LOGS_TABLE_TRANSACTIONS);
+    event.addString(data.type);
     for (int i = 0; i < 2; ++i)
     {
         TransactionPart const& part = data.parts[i];
-        logStmt.addUInt32(part.lowGuid);
-        logStmt.addUInt32(part.money);
-        logStmt.addUInt32(part.spell);
+        event.addUInt32(part.lowGuid);
+        event.addUInt32(part.money);
+        event.addUInt32(part.spell);
         std::stringstream items;
         for (int i = 0; i < TransactionPart::MAX_TRANSACTION_ITEMS; ++i)
         {
@@ -2824,9 +2839,9 @@ void World::LogTransaction(PlayerTransactionData const& data)
                 items << uint32(part.itemsEntries[i]) << ":" << uint32(part.itemsCount[i]) << ":" << part.itemsGuid[i];
             }
         }
-        logStmt.addString(items.str());
+        event.addString(items.str());
     }
-    logStmt.Execute();
+    event.Write();
 }
 
 bool World::CanSkipQueue(WorldSession const* sess)
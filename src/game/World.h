@@ -85,7 +85,8 @@ enum WorldTimers
     WUPDATE_EVENTS      = 3,
     WUPDATE_SAVE_VAR    = 4,
     WUPDATE_GROUPS      = 5,
-    WUPDATE_COUNT       = 6
+    WUPDATE_TICK_STATS  = 6,
+    WUPDATE_COUNT       = 7
 };
 
 /// Configuration elements
@@ -138,6 +139,8 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MTCELLS_THREADS,
     CONFIG_UINT32_MTCELLS_SAFEDISTANCE,
     CONFIG_UINT32_MAPUPDATE_INSTANCED_UPDATE_THREADS,
+    CONFIG_UINT32_MAPUPDATE_POOL_THREADS,
+    CONFIG_UINT32_STARTUP_LOADER_THREADS,
     CONFIG_UINT32_MAPUPDATE_UPDATE_PACKETS_DIFF,
     CONFIG_UINT32_MAPUPDATE_UPDATE_PLAYERS_DIFF,
     CONFIG_UINT32_MAPUPDATE_UPDATE_CELLS_DIFF,
@@ -151,15 +154,19 @@ enum eConfigUInt32Values
     CONFIG_UINT32_PBCAST_DIFF_LOWER_VISIBILITY_DISTANCE,
     CONFIG_UINT32_MAPUPDATE_MIN_GRID_ACTIVATION_DISTANCE,
     CONFIG_UINT32_CONTINENTS_MOTIONUPDATE_THREADS,
+    CONFIG_UINT32_LOS_CACHE_TIME,
     CONFIG_UINT32_PERFLOG_SLOW_WORLD_UPDATE,
     CONFIG_UINT32_PERFLOG_SLOW_MAP_UPDATE,
     CONFIG_UINT32_PERFLOG_SLOW_MAPSYSTEM_UPDATE,
+    CONFIG_UINT32_GRID_PRELOAD_THREADS,
+    CONFIG_UINT32_GRID_PRELOAD_DISTANCE,
     CONFIG_UINT32_PERFLOG_SLOW_SESSIONS_UPDATE,
     CONFIG_UINT32_PERFLOG_SLOW_UNIQUE_SESSION_UPDATE,
     CONFIG_UINT32_PERFLOG_SLOW_ASYNC_QUERIES,
     CONFIG_UINT32_PERFLOG_SLOW_PACKET,
     CONFIG_UINT32_PERFLOG_SLOW_MAP_PACKETS,
     CONFIG_UINT32_PERFLOG_SLOW_PACKET_BCAST,
+    CONFIG_UINT32_PERFLOG_TICK_STATS_INTERVAL,
     CONFIG_UINT32_ASYNC_QUERIES_TICK_TIMEOUT,
     CONFIG_UINT32_LOGIN_PER_TICK,
     CONFIG_UINT32_ANTICRASH_REARM_TIMER,
@@ -252,6 +259,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_TIMERBAR_FIRE_GMLEVEL,
     CONFIG_UINT32_TIMERBAR_FIRE_MAX,
     CONFIG_UINT32_MIN_LEVEL_STAT_SAVE,
+    CONFIG_UINT32_PLAYER_SAVE_FULL_INTERVAL,
     CONFIG_UINT32_MAINTENANCE_DAY,
     CONFIG_UINT32_CHARDELETE_KEEP_DAYS,
     CONFIG_UINT32_CHARDELETE_METHOD,
@@ -394,6 +402,12 @@ enum eConfigBoolValues
     CONFIG_BOOL_SMARTLOG_SCRIPTINFO,
     CONFIG_BOOL_TERRAIN_PRELOAD_CONTINENTS,
     CONFIG_BOOL_TERRAIN_PRELOAD_INSTANCES,
+    CONFIG_BOOL_TERRAIN_MAPPED_TILES,
+    CONFIG_BOOL_MOTIONUPDATE_BATCH,
+    CONFIG_BOOL_MAPUPDATE_POOL_PIN_THREADS,
+    CONFIG_BOOL_SHARE_VALUES_UPDATE_BLOCKS,
+    CONFIG_BOOL_WORLD_DB_BINARY_RESULTS,
+    CONFIG_BOOL_WORLD_DB_BINARY_RESULTS_COMPARE,
     CONFIG_BOOL_CLEANUP_TERRAIN,
     CONFIG_BOOL_OUTDOORPVP_EP_ENABLE,
     CONFIG_BOOL_OUTDOORPVP_SI_ENABLE,
@@ -439,8 +453,11 @@ enum eConfigBoolValues
     CONFIG_BOOL_BATTLEGROUND_CAST_DESERTER,
     CONFIG_BOOL_BATTLEGROUND_QUEUE_ANNOUNCER_START,
     CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET,
+    CONFIG_BOOL_COMPRESS_UPDATES_IN_NETWORK_THREADS,
     CONFIG_BOOL_PET_LOS,
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
+    CONFIG_BOOL_INCREMENTAL_PLAYER_SAVE,
+    CONFIG_BOOL_TICK_PROFILER,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
     CONFIG_BOOL_PET_UNSUMMON_AT_MOUNT,
@@ -244,6 +244,36 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     }
 }
 
+void WorldSession::SendDeferredUpdatePacket(WorldPacket& packet)
+{
+    MANGOS_ASSERT(CanSendDeferredUpdatePackets());
+
+    if (Player* player = GetPlayer())
+        DEBUG_UNIT(player, DEBUG_PACKETS_SEND, "[%s] Send deferred packet : %u/0x%x (%s)", player->GetName(), packet.GetOpcode(), packet.GetOpcode(), LookupOpcodeName(packet.GetOpcode()));
+
+    if (m_Socket->SendDeferredPacket(packet) == -1)
+        m_Socket->CloseSocket();
+}
+
+void WorldSession::SendSharedPacket(SharedPacket const& packet)
+{
+    MANGOS_ASSERT(CanSendSharedPackets());
+
+    if (packet->size() > 0x8000)
+    {
+        // Packet will be rejected by client
+        sLog.outInfo("[NETWORK] Packet %s size %u is too large. Not sent [Account %u Player %s]", LookupOpcodeName(packet->GetOpcode()), packet->size(), GetAccountId(), GetPlayerName());
+        return;
+    }
+
+    if (Player* player = GetPlayer())
+        DEBUG_UNIT_IF(packet->GetOpcode() != SMSG_MESSAGECHAT, player,
+            DEBUG_PACKETS_SEND, "[%s] Send shared packet : %u/0x%x (%s)", player->GetName(), packet->GetOpcode(), packet->GetOpcode(), LookupOpcodeName(packet->GetOpcode()));
+
+    if (m_Socket->SendSharedPacket(packet) == -1)
+        m_Socket->CloseSocket();
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* newPacket, NodeSession* from_node)
 {
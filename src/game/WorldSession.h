@@ -29,6 +29,7 @@
 #include "Common.h"
 #include "SharedDefines.h"
 #include "ObjectGuid.h"
+#include "WorldPacket.h"
 #include "AuctionHouseMgr.h"
 #include "Item.h"
 #include "GossipDef.h"
@@ -289,6 +290,12 @@ class MANGOS_DLL_SPEC WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const* packet);
+        // Uncompressed SMSG_UPDATE_OBJECT, compressed later by the network thread of the socket
+        bool CanSendDeferredUpdatePackets() const { return m_Socket && !m_masterSession && !_pcktWriting; }
+        void SendDeferredUpdatePacket(WorldPacket& packet);
+        // Body shared by the receivers of a broadcast, queued without copy by the socket
+        bool CanSendSharedPackets() const { return m_Socket && !m_masterSession && !_pcktWriting; }
+        void SendSharedPacket(SharedPacket const& packet);
         void SendNotification(const char *format,...) ATTR_PRINTF(2,3);
         void SendNotification(int32 string_id,...);
         void SendPetNameInvalid(uint32 error, const std::string& name);
@@ -1006,5 +1013,35 @@ class MANGOS_DLL_SPEC WorldSession
         MasterPlayer*   m_masterPlayer;
         /// End of clustering system
 };
+
+/**
+ * One packet sent to many sessions. Its body is shared by the sockets
+ * (see WorldSession::SendSharedPacket) instead of being copied for each of them.
+ */
+class BroadcastPacket
+{
+    public:
+        // Copied once, at the first receiver able to share it (never if smaller than MIN_SHARED_PACKET_SIZE)
+        explicit BroadcastPacket(WorldPacket const* packet) : m_packet(packet) {}
+        // Moved, never copied
+        explicit BroadcastPacket(WorldPacket&& packet) : m_shared(std::make_shared<WorldPacket const>(std::move(packet))), m_packet(m_shared.get()) {}
+
+        void SendTo(WorldSession* session)
+        {
+            // the socket would copy a small shared body to its buffer anyway
+            if (m_packet->size() < MIN_SHARED_PACKET_SIZE || !session->CanSendSharedPackets())
+            {
+                session->SendPacket(m_packet);
+                return;
+            }
+            if (!m_shared)
+                m_shared = std::make_shared<WorldPacket const>(*m_packet);
+            session->SendSharedPacket(m_shared);
+        }
+
+    private:
+        SharedPacket m_shared;
+        WorldPacket const* m_packet;
+};
 #endif
 /// @}
@@ -20,6 +20,7 @@
 #define _IVMAPMANAGER_H
 
 #include<string>
+#include <vector>
 #include <Platform/Define.h>
 
 //===========================================================
@@ -62,6 +63,13 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId, int x, int y) = 0;
             virtual void unloadMap(unsigned int pMapId) = 0;
 
+            /**
+            Load the models spawned on a tile ahead of loadMap(). Can be called from any thread: the tree of the map is not modified.
+            The acquired models are appended to 'models', and stay loaded until releaseMapModels()
+            */
+            virtual void preloadMapModels(const char* pBasePath, unsigned int pMapId, int x, int y, std::vector<std::string>& models) = 0;
+            virtual void releaseMapModels(std::vector<std::string> const& models) = 0;
+
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
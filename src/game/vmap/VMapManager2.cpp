@@ -119,6 +119,45 @@ void VMapManager2::unloadMap(unsigned int pMapId)
 
 //=========================================================
 
+void VMapManager2::preloadMapModels(const char* pBasePath, unsigned int pMapId, int x, int y, std::vector<std::string>& models)
+{
+    if (!isMapLoadingEnabled())
+        return;
+
+    std::string basePath = pBasePath;
+    if (basePath.length() > 0 && (basePath[basePath.length() - 1] != '/' && basePath[basePath.length() - 1] != '\\'))
+        basePath.append("/");
+
+    // non tiled maps have no tile file: their models are loaded with the map
+    FILE* tf = fopen((basePath + StaticMapTree::getTileFileName(pMapId, x, y)).c_str(), "rb");
+    if (!tf)
+        return;
+
+    char chunk[8];
+    uint32 numSpawns = 0;
+    if (readChunk(tf, chunk, VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, tf) == 1)
+    {
+        for (uint32 i = 0; i < numSpawns; ++i)
+        {
+            ModelSpawn spawn;
+            uint32 referencedVal;
+            if (!ModelSpawn::readFromFile(tf, spawn) || fread(&referencedVal, sizeof(uint32), 1, tf) != 1)
+                break;
+            if (acquireModelInstance(basePath, spawn.name))
+                models.push_back(spawn.name);
+        }
+    }
+    fclose(tf);
+}
+
+void VMapManager2::releaseMapModels(std::vector<std::string> const& models)
+{
+    for (std::vector<std::string>::const_iterator itr = models.begin(); itr != models.end(); ++itr)
+        releaseModelInstance(*itr);
+}
+
+//=========================================================
+
 void VMapManager2::unloadMap(unsigned int  pMapId, int x, int y)
 {
     InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
@@ -273,20 +312,30 @@ WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, cons
     if (model == iLoadedModelFiles.end())
     {
         m_modelsLock.release();
+
+        // read the file before taking the write lock, so the map threads and the
+        // grid preload workers only wait for each other during the insertion
+        WorldModel* worldmodel = new WorldModel();
+        if (!worldmodel->readFile(basepath + filename + ".vmo"))
+        {
+            delete worldmodel;
+            worldmodel = NULL;
+        }
+
         m_modelsLock.acquire_write();
         model = iLoadedModelFiles.find(filename);
         if (model != iLoadedModelFiles.end())
         {
+            // loaded by another thread meanwhile
             model->second.incRefCount();
             m_modelsLock.release();
+            delete worldmodel;
             return model->second.getModel();
         }
 
-        WorldModel* worldmodel = new WorldModel();
-        if (!worldmodel->readFile(basepath + filename + ".vmo"))
+        if (!worldmodel)
         {
             ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
-            delete worldmodel;
             m_modelsLock.release();
             return NULL;
         }
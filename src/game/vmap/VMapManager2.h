@@ -89,6 +89,9 @@ namespace VMAP
             void unloadMap(unsigned int pMapId, int x, int y) override;
             void unloadMap(unsigned int pMapId) override;
 
+            void preloadMapModels(const char* pBasePath, unsigned int pMapId, int x, int y, std::vector<std::string>& models) override;
+            void releaseMapModels(std::vector<std::string> const& models) override;
+
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) override;
             ModelInstance* FindCollisionModel(unsigned int mapId, float x0, float y0, float z0, float x1, float y1, float z1);
             /**
@@ -48,6 +48,7 @@
 #include "Util.h"
 #include "MaNGOSsoap.h"
 #include "MassMailMgr.h"
+#include "LogsDatabaseWriter.h"
 #include "DBCStores.h"
 #include "migrations_list.h"
 
@@ -467,6 +468,8 @@ int Master::Run()
 
     // send all still queued mass mails (before DB connections shutdown)
     sMassMailMgr.Update(true);
+    // and all the buffered logs database events
+    sLogsDatabaseWriter.Update(true);
 
     ///- Wait for DB delay threads to end
     CharacterDatabase.StopServer();
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "Common.h"
+#include "AccountCache.h"
+#include "Util.h"
+#include "Database/DatabaseEnv.h"
+
+extern DatabaseType LoginDatabase;
+
+static char const* const IP_BANS_QUERY =
+    "SELECT ip, bandate, unbandate FROM ip_banned WHERE unbandate = bandate OR unbandate > UNIX_TIMESTAMP()";
+static char const* const ACCOUNT_BANS_QUERY =
+    "SELECT id, bandate, unbandate FROM account_banned WHERE active = 1 AND (unbandate > UNIX_TIMESTAMP() OR unbandate = bandate)";
+static char const* const SECURITY_LEVELS_QUERY =
+    "SELECT id, gmlevel, RealmID FROM account_access";
+
+// Rows are stamped with last_modified when written, but only visible once their transaction commits:
+// the accounts changed this many seconds before the last update are read again
+#define ACCOUNT_CACHE_MODIFIED_MARGIN 60
+
+AccountCache::AccountCache() : m_UpdateInterval(0), m_NextUpdateTime(time(NULL)), m_updateQueuedTime(0), m_lastModified(0), m_pendingUpdates(0)
+{
+}
+
+AccountCache& sAccountCache
+{
+    static AccountCache accountCache;
+    return accountCache;
+}
+
+void AccountCache::Initialize(uint32 updateInterval, uint32 preloadDays)
+{
+    m_UpdateInterval = updateInterval;
+    if (!m_UpdateInterval)
+        return;
+
+    // The first update reads the rows changed from now on
+    if (QueryResult* result = LoginDatabase.Query("SELECT UNIX_TIMESTAMP()"))
+    {
+        m_lastModified = result->Fetch()[0].GetUInt32();
+        delete result;
+    }
+
+    LoadIpBans(LoginDatabase.Query(IP_BANS_QUERY));
+    LoadAccountBans(LoginDatabase.Query(ACCOUNT_BANS_QUERY));
+    LoadSecurityLevels(LoginDatabase.Query(SECURITY_LEVELS_QUERY));
+
+    if (preloadDays)
+        LoadAccounts(LoginDatabase.PQuery("SELECT " ACCOUNT_CACHE_COLUMNS ", UNIX_TIMESTAMP() FROM account a "
+            "WHERE a.last_login >= NOW() - INTERVAL %u DAY", preloadDays));
+
+    m_NextUpdateTime = time(NULL) + m_UpdateInterval;
+
+    sLog.outString("Account cache: %u accounts, %u banned IPs, %u banned accounts loaded",
+        uint32(m_accounts.size()), uint32(m_ipBans.size()), uint32(m_accountBans.size()));
+}
+
+void AccountCache::UpdateIfNeed()
+{
+    // maybe disabled, updated recently or still updating
+    if (!m_UpdateInterval || m_pendingUpdates || m_NextUpdateTime > time(NULL))
+        return;
+
+    m_updateQueuedTime = time(NULL);
+    m_NextUpdateTime = m_updateQueuedTime + m_UpdateInterval;
+
+    // Bans and security levels are small, read them again. Accounts only when changed.
+    if (LoginDatabase.AsyncQueryUnsafe(this, &AccountCache::UpdateCallback, CACHE_IP_BANS, IP_BANS_QUERY))
+        ++m_pendingUpdates;
+    if (LoginDatabase.AsyncQueryUnsafe(this, &AccountCache::UpdateCallback, CACHE_ACCOUNT_BANS, ACCOUNT_BANS_QUERY))
+        ++m_pendingUpdates;
+    if (LoginDatabase.AsyncQueryUnsafe(this, &AccountCache::UpdateCallback, CACHE_SECURITY_LEVELS, SECURITY_LEVELS_QUERY))
+        ++m_pendingUpdates;
+    if (LoginDatabase.AsyncPQueryUnsafe(this, &AccountCache::UpdateCallback, CACHE_ACCOUNTS,
+        "SELECT " ACCOUNT_CACHE_COLUMNS ", UNIX_TIMESTAMP() FROM account a "
+        "WHERE a.last_modified >= FROM_UNIXTIME(%u)", m_lastModified > ACCOUNT_CACHE_MODIFIED_MARGIN ? m_lastModified - ACCOUNT_CACHE_MODIFIED_MARGIN : 0))
+        ++m_pendingUpdates;
+}
+
+void AccountCache::UpdateCallback(QueryResult* result, CacheTable table)
+{
+    --m_pendingUpdates;
+
+    switch (table)
+    {
+        case CACHE_ACCOUNTS:        LoadAccounts(result);       break;
+        case CACHE_IP_BANS:         LoadIpBans(result);         break;
+        case CACHE_ACCOUNT_BANS:    LoadAccountBans(result);    break;
+        case CACHE_SECURITY_LEVELS: LoadSecurityLevels(result); break;
+    }
+}
+
+void AccountCache::ReadAccount(Field* fields, CachedAccount& account)
+{
+    account.id = fields[0].GetUInt32();
+    account.shaPassHash = fields[2].GetCppString();
+    account.v = fields[3].GetCppString();
+    account.s = fields[4].GetCppString();
+    account.lastIP = fields[5].GetCppString();
+    account.security = fields[6].GetCppString();
+    account.lockFlags = fields[7].GetUInt32();
+    account.emailVerified = fields[8].GetBool();
+    account.geolockPin = fields[9].GetUInt32();
+    account.email = fields[10].GetCppString();
+    account.joinDate = fields[11].GetUInt32();
+}
+
+/// Accounts (re)read from the database, deleted accounts are kept until the restart
+void AccountCache::LoadAccounts(QueryResult* result)
+{
+    if (!result)
+        return;
+
+    do
+    {
+        Field* fields = result->Fetch();
+
+        std::string username = fields[1].GetCppString();
+        strToUpper(username);
+        ReadAccount(fields, m_accounts[username]);
+
+        // Time of the query: rows changed later, even in the same second or committed late, are read by the next update
+        m_lastModified = fields[ACCOUNT_CACHE_COLUMN_COUNT].GetUInt32();
+    } while (result->NextRow());
+
+    delete result;
+}
+
+void AccountCache::LoadIpBans(QueryResult* result)
+{
+    m_ipBans.clear();
+    KeepLocalBans(m_ipBans, m_localIpBans);
+    if (!result)
+        return;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        AddBan(m_ipBans, fields[0].GetCppString(), fields[1].GetUInt64(), fields[2].GetUInt64());
+    } while (result->NextRow());
+
+    delete result;
+}
+
+void AccountCache::LoadAccountBans(QueryResult* result)
+{
+    m_accountBans.clear();
+    KeepLocalBans(m_accountBans, m_localAccountBans);
+    if (!result)
+        return;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        AddBan(m_accountBans, fields[0].GetUInt32(), fields[1].GetUInt64(), fields[2].GetUInt64());
+    } while (result->NextRow());
+
+    delete result;
+}
+
+/// The reloaded bans may have been read before the insertion of the bans added by realmd: keep these
+/// until a reload queued long enough after them, or their end
+template<class BanMap>
+void AccountCache::KeepLocalBans(BanMap& bans, BanMap& localBans)
+{
+    time_t now = time(NULL);
+    for (typename BanMap::iterator itr = localBans.begin(); itr != localBans.end();)
+    {
+        CachedBan const& ban = itr->second;
+        if (!ban.IsActive(now) || ban.bandate + ACCOUNT_CACHE_MODIFIED_MARGIN < uint64(m_updateQueuedTime))
+            itr = localBans.erase(itr);
+        else
+        {
+            AddBan(bans, itr->first, ban.bandate, ban.unbandate);
+            ++itr;
+        }
+    }
+}
+
+void AccountCache::LoadSecurityLevels(QueryResult* result)
+{
+    m_securityLevels.clear();
+    if (!result)
+        return;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        m_securityLevels[fields[0].GetUInt32()].push_back(std::make_pair(fields[2].GetInt32(), AccountTypes(fields[1].GetUInt32())));
+    } while (result->NextRow());
+
+    delete result;
+}
+
+CachedAccount* AccountCache::FindAccount(std::string const& username)
+{
+    std::string key = username;
+    strToUpper(key);
+
+    AccountMap::iterator itr = m_accounts.find(key);
+    return itr != m_accounts.end() ? &itr->second : NULL;
+}
+
+void AccountCache::AddAccount(std::string const& username, CachedAccount const& account)
+{
+    if (!IsEnabled())
+        return;
+
+    std::string key = username;
+    strToUpper(key);
+    m_accounts[key] = account;
+}
+
+CachedBan const* AccountCache::FindIpBan(std::string const& ip) const
+{
+    IpBanMap::const_iterator itr = m_ipBans.find(ip);
+    return itr != m_ipBans.end() ? &itr->second : NULL;
+}
+
+CachedBan const* AccountCache::FindAccountBan(uint32 accountId) const
+{
+    AccountBanMap::const_iterator itr = m_accountBans.find(accountId);
+    return itr != m_accountBans.end() ? &itr->second : NULL;
+}
+
+/// Keep the ban that lasts longest, like the permanent one
+void AccountCache::MergeBan(CachedBan& ban, uint64 bandate, uint64 unbandate)
+{
+    if (ban.IsPermanent())
+        return;
+
+    if (bandate == unbandate || unbandate > ban.unbandate)
+    {
+        ban.bandate = bandate;
+        ban.unbandate = unbandate;
+    }
+}
+
+template<class BanMap>
+void AccountCache::AddBan(BanMap& bans, typename BanMap::key_type const& key, uint64 bandate, uint64 unbandate)
+{
+    typename BanMap::iterator itr = bans.find(key);
+    if (itr == bans.end())
+    {
+        CachedBan ban = { bandate, unbandate };
+        bans[key] = ban;
+    }
+    else
+        MergeBan(itr->second, bandate, unbandate);
+}
+
+void AccountCache::AddIpBan(std::string const& ip, uint64 bandate, uint64 unbandate)
+{
+    if (!IsEnabled())
+        return;
+
+    AddBan(m_ipBans, ip, bandate, unbandate);
+    AddBan(m_localIpBans, ip, bandate, unbandate);
+}
+
+void AccountCache::AddAccountBan(uint32 accountId, uint64 bandate, uint64 unbandate)
+{
+    if (!IsEnabled())
+        return;
+
+    AddBan(m_accountBans, accountId, bandate, unbandate);
+    AddBan(m_localAccountBans, accountId, bandate, unbandate);
+}
+
+AccountSecurityLevels const* AccountCache::FindSecurityLevels(uint32 accountId) const
+{
+    SecurityLevelsMap::const_iterator itr = m_securityLevels.find(accountId);
+    return itr != m_securityLevels.end() ? &itr->second : NULL;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _ACCOUNTCACHE_H
+#define _ACCOUNTCACHE_H
+
+#include "Common.h"
+
+class Field;
+class QueryResult;
+
+/// Account row read by a logon challenge
+struct CachedAccount
+{
+    uint32 id;
+    std::string shaPassHash;
+    std::string v;
+    std::string s;
+    std::string lastIP;
+    std::string security;
+    std::string email;
+    uint32 lockFlags;
+    uint32 geolockPin;
+    uint32 joinDate;
+    bool emailVerified;
+};
+
+/// Active ban of an IP or an account
+struct CachedBan
+{
+    uint64 bandate;
+    uint64 unbandate;
+
+    bool IsPermanent() const { return unbandate == bandate; }
+    bool IsActive(time_t now) const { return IsPermanent() || unbandate > uint64(now); }
+};
+
+/// Security levels of an account: RealmID (negative for all the realms) and level
+typedef std::vector<std::pair<int32, AccountTypes> > AccountSecurityLevels;
+
+/// Columns read by AccountCache::ReadAccount, from the account table aliased 'a'
+#define ACCOUNT_CACHE_COLUMNS "a.id,a.username,a.sha_pass_hash,a.v,a.s,a.last_ip,a.security,a.locked,a.email_verif,a.geolock_pin,a.email,UNIX_TIMESTAMP(a.joindate)"
+#define ACCOUNT_CACHE_COLUMN_COUNT 12
+
+/// Copy of the accounts, bans and security levels read by the logons, refreshed from the database every few seconds
+class AccountCache
+{
+    public:
+        static AccountCache& Instance();
+
+        AccountCache();
+        ~AccountCache() {}
+
+        /// Loads the bans, the security levels and the accounts logged in the last preloadDays
+        void Initialize(uint32 updateInterval, uint32 preloadDays);
+        bool IsEnabled() const { return m_UpdateInterval != 0; }
+
+        /// Queues the refresh queries, applied from LoginDatabase.ProcessResultQueue()
+        void UpdateIfNeed();
+
+        /// NULL if the account did not log in since the start, read it from the database then
+        CachedAccount* FindAccount(std::string const& username);
+        void AddAccount(std::string const& username, CachedAccount const& account);
+
+        CachedBan const* FindIpBan(std::string const& ip) const;
+        CachedBan const* FindAccountBan(uint32 accountId) const;
+        /// Bans added by realmd itself, kept over the reloads that may have been read before their insertion
+        void AddIpBan(std::string const& ip, uint64 bandate, uint64 unbandate);
+        void AddAccountBan(uint32 accountId, uint64 bandate, uint64 unbandate);
+
+        AccountSecurityLevels const* FindSecurityLevels(uint32 accountId) const;
+
+        static void ReadAccount(Field* fields, CachedAccount& account);
+    private:
+        enum CacheTable
+        {
+            CACHE_ACCOUNTS,
+            CACHE_IP_BANS,
+            CACHE_ACCOUNT_BANS,
+            CACHE_SECURITY_LEVELS
+        };
+
+        void UpdateCallback(QueryResult* result, CacheTable table);
+        void LoadAccounts(QueryResult* result);
+        void LoadIpBans(QueryResult* result);
+        void LoadAccountBans(QueryResult* result);
+        void LoadSecurityLevels(QueryResult* result);
+
+        static void MergeBan(CachedBan& ban, uint64 bandate, uint64 unbandate);
+        template<class BanMap>
+        static void AddBan(BanMap& bans, typename BanMap::key_type const& key, uint64 bandate, uint64 unbandate);
+        template<class BanMap>
+        void KeepLocalBans(BanMap& bans, BanMap& localBans);
+    private:
+        typedef std::unordered_map<std::string, CachedAccount> AccountMap;
+        typedef std::unordered_map<std::string, CachedBan> IpBanMap;
+        typedef std::unordered_map<uint32, CachedBan> AccountBanMap;
+        typedef std::unordered_map<uint32, AccountSecurityLevels> SecurityLevelsMap;
+
+        AccountMap        m_accounts;                       ///< Accounts by upper case name
+        IpBanMap          m_ipBans;
+        AccountBanMap     m_accountBans;
+        SecurityLevelsMap m_securityLevels;
+        IpBanMap          m_localIpBans;                    ///< Added by AddIpBan, bandate is the time of the addition
+        AccountBanMap     m_localAccountBans;
+
+        uint32   m_UpdateInterval;
+        time_t   m_NextUpdateTime;
+        time_t   m_updateQueuedTime;                        ///< When the pending update queries were queued
+        uint32   m_lastModified;                            ///< Time of the last accounts update, the next one reads the rows changed since (minus a margin)
+        uint32   m_pendingUpdates;
+};
+
+#define sAccountCache AccountCache::Instance()
+
+#endif
+/// @}
@@ -30,6 +30,7 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "RealmList.h"
+#include "AccountCache.h"
 #include "AuthSocket.h"
 #include "AuthCodes.h"
 #include "PatchHandler.h"
@@ -178,9 +179,11 @@ typedef struct AuthHandler
 
 std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B, 0x21, 0x57, 0xFC, 0x37, 0x3F, 0xB3, 0x69, 0xCD, 0xD2, 0xF1 } };
 
+uint32 AuthSocket::s_pendingQueries = 0;
+
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket() : gridSeed(0), promptPin(false), _accountId(0), _lastRealmListRequest(0),
-_geoUnlockPIN(0)
+_geoUnlockPIN(0), _queryPending(false), _closePending(false)
 {
     N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
     g.SetDword(7);
@@ -232,6 +235,10 @@ void AuthSocket::OnRead()
     uint8 _cmd;
     while (1)
     {
+        // the next commands stay buffered until the query result resumes the session
+        if (_queryPending)
+            return;
+
         if(!recv_soft((char *)&_cmd, 1))
             return;
 
@@ -273,6 +280,72 @@ void AuthSocket::OnRead()
     }
 }
 
+/// Queue a query on the LoginDatabase delay thread instead of blocking the reactor
+bool AuthSocket::AsyncQuery(QueryHandler handler, const char* format, ...)
+{
+    char query[MAX_QUERY_LEN];
+
+    va_list ap;
+    va_start(ap, format);
+    int res = vsnprintf(query, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return false;
+    }
+
+    // Result callbacks run in the main thread, from LoginDatabase.ProcessResultQueue()
+    if (!LoginDatabase.AsyncQueryUnsafe(this, &AuthSocket::_HandleQueryResult, handler, query))
+        return false;
+
+    _queryPending = true;
+    ++s_pendingQueries;
+    return true;
+}
+
+/// Resume the session with the result of its query
+void AuthSocket::_HandleQueryResult(QueryResult* result, QueryHandler handler)
+{
+    std::unique_ptr<QueryResult> holder(result);
+
+    _queryPending = false;
+    --s_pendingQueries;
+
+    bool ok = (this->*handler)(result);
+
+    ///- The client left while the query ran: release the socket once the session does not wait anymore
+    if (_closePending)
+    {
+        if (!_queryPending)
+            BufferedSocket::handle_close();
+        return;
+    }
+
+    if (!ok)
+    {
+        DEBUG_LOG("[Auth] Query handler failed, recv length %u", (uint32)recv_len());
+        close_connection();
+        return;
+    }
+
+    ///- Handle the commands received meanwhile
+    OnRead();
+}
+
+/// The reactor does not call back anymore, but a pending query still refers to the socket
+int AuthSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask m)
+{
+    if (_queryPending)
+    {
+        _closePending = true;
+        return 0;
+    }
+
+    return BufferedSocket::handle_close(h, m);
+}
+
 /// Make the SRP6 calculation from hash in dB
 void AuthSocket::_SetVSFields(const std::string& rI)
 {
@@ -301,6 +374,11 @@ void AuthSocket::_SetVSFields(const std::string& rI)
     v_hex = v.AsHexStr();
     s_hex = s.AsHexStr();
     LoginDatabase.PExecute("UPDATE account SET v = '%s', s = '%s' WHERE username = '%s'", v_hex, s_hex, _safelogin.c_str() );
+    if (CachedAccount* account = sAccountCache.FindAccount(_login))
+    {
+        account->v = v_hex;
+        account->s = s_hex;
+    }
     OPENSSL_free((void*)v_hex);
     OPENSSL_free((void*)s_hex);
 }
@@ -390,14 +468,16 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
     memcpy(&_os, ch->os, sizeof(_os));
     memcpy(&_platform, ch->platform, sizeof(_platform));
 
+    _localizationName.resize(4);
+    for(int i = 0; i < 4; ++i)
+        _localizationName[i] = ch->country[4-i-1];
+
     ///- Normalize account name
     //utf8ToUpperOnlyLatin(_login); -- client already send account in expected form
 
@@ -406,191 +486,248 @@ bool AuthSocket::_HandleLogonChallenge()
     _safelogin = _login;
     LoginDatabase.escape_string(_safelogin);
 
-    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
-    pkt << (uint8) 0x00;
-
     ///- Verify that this IP is not in the ip_banned table
+    if (sAccountCache.IsEnabled())
+    {
+        CachedBan const* ban = sAccountCache.FindIpBan(get_remote_address());
+        return LogonChallengeIpChecked(ban && ban->IsActive(time(NULL)));
+    }
+
     // No SQL injection possible (paste the IP address as passed by the socket)
     std::string address = get_remote_address();
     LoginDatabase.escape_string(address);
-    QueryResult *result = LoginDatabase.PQuery("SELECT unbandate FROM ip_banned WHERE "
+    return AsyncQuery(&AuthSocket::_HandleIpBanResult, "SELECT unbandate FROM ip_banned WHERE "
     //    permanent                    still banned
         "(unbandate = bandate OR unbandate > UNIX_TIMESTAMP()) AND ip = '%s'", address.c_str());
-    if (result)
+}
+
+/// Logon Challenge: IP ban read from the database
+bool AuthSocket::_HandleIpBanResult(QueryResult* result)
+{
+    return LogonChallengeIpChecked(result != NULL);
+}
+
+bool AuthSocket::LogonChallengeIpChecked(bool banned)
+{
+    if (banned)
     {
-        pkt << (uint8)WOW_FAIL_DB_BUSY;
         BASIC_LOG("[AuthChallenge] Banned ip '%s' tries to login with account '%s'!", get_remote_address().c_str(), _login.c_str());
-        delete result;
+
+        ByteBuffer pkt;
+        pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+        pkt << (uint8) 0x00;
+        pkt << (uint8) WOW_FAIL_DB_BUSY;
+        send((char const*)pkt.contents(), pkt.size());
+        return true;
     }
-    else
+
+    ///- Accounts which logged in recently are cached, with their bans
+    if (CachedAccount* account = sAccountCache.FindAccount(_login))
+        return LogonChallengeAccountFound(*account, sAccountCache.FindAccountBan(account->id));
+
+    ///- Get the account details from the account table, with its active ban if any
+    // No SQL injection (escaped user name)
+    return AsyncQuery(&AuthSocket::_HandleAccountResult, "SELECT " ACCOUNT_CACHE_COLUMNS ",b.bandate,b.unbandate "
+        "FROM account a LEFT JOIN account_banned b ON b.id = a.id AND b.active = 1 AND (b.unbandate > UNIX_TIMESTAMP() OR b.unbandate = b.bandate) "
+        "WHERE a.username = '%s' LIMIT 1", _safelogin.c_str());
+}
+
+/// Logon Challenge: account read from the database
+bool AuthSocket::_HandleAccountResult(QueryResult* result)
+{
+    if (!result)                                            // no account
     {
-        ///- Get the account details from the account table
-        // No SQL injection (escaped user name)
-        result = LoginDatabase.PQuery("SELECT sha_pass_hash,id,locked,last_ip,v,s,security,email_verif,geolock_pin,email,UNIX_TIMESTAMP(joindate) FROM account WHERE username = '%s'",_safelogin.c_str ());
-        if (result)
-        {
-            Field* fields = result->Fetch();
+        ByteBuffer pkt;
+        pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+        pkt << (uint8) 0x00;
+        pkt<< (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
+        send((char const*)pkt.contents(), pkt.size());
+        return true;
+    }
 
-            // Prevent login if the user's email address has not been verified
-            bool requireVerification = sConfig.GetBoolDefault("ReqEmailVerification", false);
-            int32 requireEmailSince = sConfig.GetIntDefault("ReqEmailSince", 0);
-            bool verified = (*result)[7].GetBool();
-            
-            // Prevent login if the user's join date is bigger than the timestamp in configuration
-            if (requireEmailSince > 0)
-            {
-                uint32 t = (*result)[10].GetUInt32();
-                requireVerification = requireVerification && (t >= requireEmailSince);
-            }
+    Field* fields = result->Fetch();
 
-            if (requireVerification && !verified)
-            {
-                BASIC_LOG("[AuthChallenge] Account '%s' using IP '%s 'email address requires email verification - rejecting login", _login.c_str(), get_remote_address().c_str());
-                pkt << (uint8)WOW_FAIL_UNKNOWN_ACCOUNT;
-                send((char const*)pkt.contents(), pkt.size());
-                return true;
-            }
+    CachedAccount account;
+    AccountCache::ReadAccount(fields, account);
+    sAccountCache.AddAccount(fields[1].GetCppString(), account);
 
-            ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
-            bool locked = false;
-            lockFlags = (LockFlag)(*result)[2].GetUInt32();
-            securityInfo = (*result)[6].GetCppString();
-            _lastIP = fields[3].GetString();
-            _geoUnlockPIN = fields[8].GetUInt32();
-            _email = fields[9].GetCppString();
+    CachedBan ban = { 0, 0 };
+    bool banned = !fields[ACCOUNT_CACHE_COLUMN_COUNT].IsNULL();
+    if (banned)
+    {
+        ban.bandate = fields[ACCOUNT_CACHE_COLUMN_COUNT].GetUInt64();
+        ban.unbandate = fields[ACCOUNT_CACHE_COLUMN_COUNT + 1].GetUInt64();
+    }
 
-            if (lockFlags & IP_LOCK)
-            {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), _lastIP.c_str());
-                DEBUG_LOG("[AuthChallenge] Player address is '%s'", get_remote_address().c_str());
+    return LogonChallengeAccountFound(account, banned ? &ban : NULL);
+}
 
-                if (_lastIP != get_remote_address())
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP differs");
+/// Logon Challenge: answer the client
+bool AuthSocket::LogonChallengeAccountFound(CachedAccount const& account, CachedBan const* ban)
+{
+    ByteBuffer pkt;
+    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+    pkt << (uint8) 0x00;
 
-                    // account is IP locked and the player does not have 2FA enabled
-                    if (((lockFlags & TOTP) != TOTP && (lockFlags & FIXED_PIN) != FIXED_PIN))
-                        pkt << (uint8) WOW_FAIL_SUSPENDED;
+    // Prevent login if the user's email address has not been verified
+    bool requireVerification = sConfig.GetBoolDefault("ReqEmailVerification", false);
+    int32 requireEmailSince = sConfig.GetIntDefault("ReqEmailSince", 0);
+    bool verified = account.emailVerified;
 
-                    locked = true;
-                }
-                else
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP matches");
-                }
-            }
-            else
-            {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
-            }
+    // Prevent login if the user's join date is bigger than the timestamp in configuration
+    if (requireEmailSince > 0)
+    {
+        uint32 t = account.joinDate;
+        requireVerification = requireVerification && (t >= requireEmailSince);
+    }
 
-            if (!locked || (locked && (lockFlags & FIXED_PIN || lockFlags & TOTP)))
-            {
-                uint32 account_id = fields[1].GetUInt32();
-                ///- If the account is banned, reject the logon attempt
-                QueryResult *banresult = LoginDatabase.PQuery("SELECT bandate,unbandate FROM account_banned WHERE "
-                    "id = %u AND active = 1 AND (unbandate > UNIX_TIMESTAMP() OR unbandate = bandate) LIMIT 1", account_id);
-                if (banresult)
-                {
-                    if((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                    {
-                        pkt << (uint8) WOW_FAIL_BANNED;
-                        BASIC_LOG("[AuthChallenge] Banned account '%s' using IP '%s' tries to login!",_login.c_str (), get_remote_address().c_str());
-                    }
-                    else
-                    {
-                        pkt << (uint8) WOW_FAIL_SUSPENDED;
-                        BASIC_LOG("[AuthChallenge] Temporarily banned account '%s' using IP '%s' tries to login!",_login.c_str (), get_remote_address().c_str());
-                    }
-
-                    delete banresult;
-                }
-                else
-                {
-                    ///- Get the password from the account table, upper it, and make the SRP6 calculation
-                    std::string rI = fields[0].GetCppString();
-
-                    ///- Don't calculate (v, s) if there are already some in the database
-                    std::string databaseV = fields[4].GetCppString();
-                    std::string databaseS = fields[5].GetCppString();
-
-                    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
-
-                    // multiply with 2, bytes are stored as hexstring
-                    if(databaseV.size() != s_BYTE_SIZE*2 || databaseS.size() != s_BYTE_SIZE*2)
-                        _SetVSFields(rI);
-                    else
-                    {
-                        s.SetHexStr(databaseS.c_str());
-                        v.SetHexStr(databaseV.c_str());
-                    }
-
-                    b.SetRand(19 * 8);
-                    BigNumber gmod = g.ModExp(b, N);
-                    B = ((v * 3) + gmod) % N;
-
-                    MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
-
-                    ///- Fill the response packet with the result
-                    pkt << uint8(WOW_SUCCESS);
-
-                    // B may be calculated < 32B so we force minimal length to 32B
-                    pkt.append(B.AsByteArray(32));      // 32 bytes
-                    pkt << uint8(1);
-                    pkt.append(g.AsByteArray());
-                    pkt << uint8(32);
-                    pkt.append(N.AsByteArray(32));
-                    pkt.append(s.AsByteArray());        // 32 bytes
-                    pkt.append(VersionChallenge.data(), VersionChallenge.size());
-
-                    // figure out whether we need to display the PIN grid
-                    promptPin = locked; // always prompt if the account is IP locked & 2FA is enabled
-
-                    if (!locked && ((lockFlags & ALWAYS_ENFORCE) == ALWAYS_ENFORCE) || _geoUnlockPIN)
-                    {
-                        promptPin = true; // prompt if the lock hasn't been triggered but ALWAYS_ENFORCE is set
-                    }
-
-                    if (promptPin)
-                    {
-                        BASIC_LOG("[AuthChallenge] Account '%s' using IP '%s' requires PIN authentication", _login.c_str(), get_remote_address().c_str());
-
-                        uint32 gridSeedPkt = gridSeed = static_cast<uint32>(rand32());
-                        EndianConvert(gridSeedPkt);
-                        serverSecuritySalt.SetRand(16 * 8); // 16 bytes random
-
-                        pkt << uint8(1); // securityFlags, only '1' is available in classic (PIN input)
-                        pkt << gridSeedPkt;
-                        pkt.append(serverSecuritySalt.AsByteArray(16).data(), 16);
-                    }
-                    else
-                    {
-                        if (_build > CLIENT_BUILD_1_10_2)
-                            pkt << uint8(0);
-                    }
-
-                    _localizationName.resize(4);
-                    for(int i = 0; i < 4; ++i)
-                        _localizationName[i] = ch->country[4-i-1];
-
-                    LoadAccountSecurityLevels(account_id);
-                    BASIC_LOG("[AuthChallenge] Account '%s' using IP '%s' is using '%c%c%c%c' locale (%u)", _login.c_str (), get_remote_address().c_str(), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(_localizationName));
-
-                    _accountId = account_id;
-
-                    ///- All good, await client's proof
-                    _status = STATUS_LOGON_PROOF;
-                }
-            }
-            delete result;
+    if (requireVerification && !verified)
+    {
+        BASIC_LOG("[AuthChallenge] Account '%s' using IP '%s 'email address requires email verification - rejecting login", _login.c_str(), get_remote_address().c_str());
+        pkt << (uint8)WOW_FAIL_UNKNOWN_ACCOUNT;
+        send((char const*)pkt.contents(), pkt.size());
+        return true;
+    }
+
+    ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
+    bool locked = false;
+    lockFlags = (LockFlag)account.lockFlags;
+    securityInfo = account.security;
+    _lastIP = account.lastIP;
+    _geoUnlockPIN = account.geolockPin;
+    _email = account.email;
+
+    if (lockFlags & IP_LOCK)
+    {
+        DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), _lastIP.c_str());
+        DEBUG_LOG("[AuthChallenge] Player address is '%s'", get_remote_address().c_str());
+
+        if (_lastIP != get_remote_address())
+        {
+            DEBUG_LOG("[AuthChallenge] Account IP differs");
+
+            // account is IP locked and the player does not have 2FA enabled
+            if (((lockFlags & TOTP) != TOTP && (lockFlags & FIXED_PIN) != FIXED_PIN))
+                pkt << (uint8) WOW_FAIL_SUSPENDED;
+
+            locked = true;
         }
-        else                                                // no account
+        else
+        {
+            DEBUG_LOG("[AuthChallenge] Account IP matches");
+        }
+    }
+    else
+    {
+        DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+    }
+
+    if (locked && !(lockFlags & FIXED_PIN || lockFlags & TOTP))
+    {
+        send((char const*)pkt.contents(), pkt.size());
+        return true;
+    }
+
+    uint32 account_id = account.id;
+
+    ///- If the account is banned, reject the logon attempt
+    if (ban && ban->IsActive(time(NULL)))
+    {
+        if(ban->IsPermanent())
         {
-            pkt<< (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
+            pkt << (uint8) WOW_FAIL_BANNED;
+            BASIC_LOG("[AuthChallenge] Banned account '%s' using IP '%s' tries to login!",_login.c_str (), get_remote_address().c_str());
         }
+        else
+        {
+            pkt << (uint8) WOW_FAIL_SUSPENDED;
+            BASIC_LOG("[AuthChallenge] Temporarily banned account '%s' using IP '%s' tries to login!",_login.c_str (), get_remote_address().c_str());
+        }
+
+        send((char const*)pkt.contents(), pkt.size());
+        return true;
+    }
+
+    ///- Get the password from the account table, upper it, and make the SRP6 calculation
+    std::string rI = account.shaPassHash;
+
+    ///- Don't calculate (v, s) if there are already some in the database
+    std::string databaseV = account.v;
+    std::string databaseS = account.s;
+
+    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
+
+    // multiply with 2, bytes are stored as hexstring
+    if(databaseV.size() != s_BYTE_SIZE*2 || databaseS.size() != s_BYTE_SIZE*2)
+        _SetVSFields(rI);
+    else
+    {
+        s.SetHexStr(databaseS.c_str());
+        v.SetHexStr(databaseV.c_str());
+    }
+
+    b.SetRand(19 * 8);
+    BigNumber gmod = g.ModExp(b, N);
+    B = ((v * 3) + gmod) % N;
+
+    MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
+
+    ///- Fill the response packet with the result
+    pkt << uint8(WOW_SUCCESS);
+
+    // B may be calculated < 32B so we force minimal length to 32B
+    pkt.append(B.AsByteArray(32));      // 32 bytes
+    pkt << uint8(1);
+    pkt.append(g.AsByteArray());
+    pkt << uint8(32);
+    pkt.append(N.AsByteArray(32));
+    pkt.append(s.AsByteArray());        // 32 bytes
+    pkt.append(VersionChallenge.data(), VersionChallenge.size());
+
+    // figure out whether we need to display the PIN grid
+    promptPin = locked; // always prompt if the account is IP locked & 2FA is enabled
+
+    if (!locked && ((lockFlags & ALWAYS_ENFORCE) == ALWAYS_ENFORCE) || _geoUnlockPIN)
+    {
+        promptPin = true; // prompt if the lock hasn't been triggered but ALWAYS_ENFORCE is set
+    }
+
+    if (promptPin)
+    {
+        BASIC_LOG("[AuthChallenge] Account '%s' using IP '%s' requires PIN authentication", _login.c_str(), get_remote_address().c_str());
+
+        uint32 gridSeedPkt = gridSeed = static_cast<uint32>(rand32());
+        EndianConvert(gridSeedPkt);
+        serverSecuritySalt.SetRand(16 * 8); // 16 bytes random
+
+        pkt << uint8(1); // securityFlags, only '1' is available in classic (PIN input)
+        pkt << gridSeedPkt;
+        pkt.append(serverSecuritySalt.AsByteArray(16).data(), 16);
+    }
+    else
+    {
+        if (_build > CLIENT_BUILD_1_10_2)
+            pkt << uint8(0);
     }
+
+    BASIC_LOG("[AuthChallenge] Account '%s' using IP '%s' is using '%s' locale (%u)", _login.c_str (), get_remote_address().c_str(), _localizationName.c_str(), GetLocaleByName(_localizationName));
+
+    _accountId = account_id;
+
+    ///- All good, await client's proof
+    _status = STATUS_LOGON_PROOF;
     send((char const*)pkt.contents(), pkt.size());
-    return true;
+
+    if (sAccountCache.IsEnabled())
+    {
+        if (AccountSecurityLevels const* levels = sAccountCache.FindSecurityLevels(account_id))
+            for (AccountSecurityLevels::const_iterator itr = levels->begin(); itr != levels->end(); ++itr)
+                SetSecurityLevel(itr->first, itr->second);
+        return true;
+    }
+
+    // The security levels are loaded meanwhile, the proof is handled once they are known
+    return AsyncQuery(&AuthSocket::_HandleAccountAccessResult, "SELECT gmlevel, RealmID FROM account_access WHERE id = %u", account_id);
 }
 
 /// Logon Proof command handler
@@ -812,6 +949,12 @@ bool AuthSocket::_HandleLogonProof()
             return true;
         }
 
+        ///- Finish SRP6, the result is sent once the session key is stored
+        sha.Initialize();
+        sha.UpdateBigNumbers(&A, &M, &K, NULL);
+        sha.Finalize();
+        _logonProof = sha;
+
         // Geolocking checks must be done after an otherwise successful login to prevent lockout attacks
         if (_geoUnlockPIN) // remove the PIN to unlock the account since login succeeded
         {
@@ -822,73 +965,26 @@ bool AuthSocket::_HandleLogonProof()
             {
                 sLog.outError("Unable to remove geolock PIN for %s - account has not been unlocked", _safelogin.c_str());
             }
+            else if (CachedAccount* account = sAccountCache.FindAccount(_login))
+                account->geolockPin = 0;
         }
-        else if (GeographicalLockCheck())
+        else if (NeedsGeographicalLockCheck())
         {
-            BASIC_LOG("Account '%s' (%u) using IP '%s' has been geolocked", _login.c_str(), _accountId, get_remote_address().c_str()); // todo, add additional logging info
-
-            auto pin = urand(100000, 999999); // check rand32_max
-            auto result = LoginDatabase.PExecute("UPDATE account SET geolock_pin = %u WHERE username = '%s'",
-                pin, _safelogin.c_str());
-
-            if (!result)
-            {
-                sLog.outError("Unable to write geolock PIN for %s - account has not been locked", _safelogin.c_str());
-
-                char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_DB_BUSY };
-                send(data, sizeof(data));
-                return true;
-            }
-
-#ifdef USE_SENDGRID
-            if (sConfig.GetBoolDefault("SendMail", false))
-            {
-                auto mail = std::make_unique<SendgridMail>
-                (
-                    sConfig.GetStringDefault("SendGridKey", ""),
-                    sConfig.GetStringDefault("GeolockGUID", "")
-                );
-
-                mail->recipient(_email);
-                mail->from(sConfig.GetStringDefault("MailFrom", ""));
-                mail->substitution("%username%", _login);
-                mail->substitution("%unlock_pin%", std::to_string(pin));
-                mail->substitution("%originating_ip%", get_remote_address());
-
-                MailerService::get_global_mailer()->send(std::move(mail),
-                    [](SendgridMail::Result res)
-                    {
-                        DEBUG_LOG("Mail result: %d", res);
-                    }
-                );
-            }
-#endif
-
-            char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_PARENTCONTROL };
-            send(data, sizeof(data));
-            return true;
+            // Networks of the current and of the previous address, in a single round trip
+            return AsyncQuery(&AuthSocket::_HandleGeoLockResult,
+                "(SELECT 0, INET_ATON('%s') AS ip, network_start_integer, geoname_id, registered_country_geoname_id "
+                "FROM geoip "
+                "WHERE network_last_integer >= INET_ATON('%s') "
+                "ORDER BY network_last_integer ASC LIMIT 1) "
+                "UNION ALL "
+                "(SELECT 1, INET_ATON('%s') AS ip, network_start_integer, geoname_id, registered_country_geoname_id "
+                "FROM geoip "
+                "WHERE network_last_integer >= INET_ATON('%s') "
+                "ORDER BY network_last_integer ASC LIMIT 1)",
+                get_remote_address().c_str(), get_remote_address().c_str(), _lastIP.c_str(), _lastIP.c_str());
         }
 
-        BASIC_LOG("[AuthChallenge] Account '%s' using IP '%s' successfully authenticated", _login.c_str(), get_remote_address().c_str());
-
-        ///- Update the sessionkey, last_ip, last login time and reset number of failed logins in the account table for this account
-        // No SQL injection (escaped user name) and IP address as received by socket
-        const char* K_hex = K.AsHexStr();
-        const char *os = reinterpret_cast<char *>(&_os);    // no injection as there are only two possible values
-        auto result = LoginDatabase.PQuery("UPDATE account SET sessionkey = '%s', last_ip = '%s', last_login = NOW(), locale = '%u', failed_logins = 0, os = '%s' WHERE username = '%s'",
-            K_hex, get_remote_address().c_str(), GetLocaleByName(_localizationName), os, _safelogin.c_str() );
-        delete result;
-        OPENSSL_free((void*)K_hex);
-
-        ///- Finish SRP6 and send the final result to the client
-        sha.Initialize();
-        sha.UpdateBigNumbers(&A, &M, &K, NULL);
-        sha.Finalize();
-
-        SendProof(sha);
-
-        ///- Set _status to authed!
-        _status = STATUS_AUTHED;
+        return StoreSessionKey();
     }
     else
     {
@@ -911,37 +1007,131 @@ bool AuthSocket::_HandleLogonProof()
             //Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
             LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'",_safelogin.c_str());
 
-            if(QueryResult *loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
-            {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
+            // Queued after the update on the same delay queue
+            return AsyncQuery(&AuthSocket::_HandleFailedLoginsResult, "SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str());
+        }
+    }
+    return true;
+}
 
-                if( failed_logins >= MaxWrongPassCount )
-                {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
-
-                    if(WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned (id, bandate, unbandate, bannedby, banreason, active, realm) "
-                            "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1,1)",
-                            acc_id, WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] Account '%s' using  IP '%s' got banned for '%u' seconds because it failed to authenticate '%u' times",
-                            _login.c_str(), get_remote_address().c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
-                    {
-                        std::string current_ip = get_remote_address();
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
-                            current_ip.c_str(), WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] IP '%s' got banned for '%u' seconds because account '%s' failed to authenticate '%u' times",
-                            current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
-                    }
-                }
-                delete loginfail;
+/// Logon Proof: networks of the addresses fetched
+bool AuthSocket::_HandleGeoLockResult(QueryResult* result)
+{
+    if (!GeographicalLockCheck(result))
+        return StoreSessionKey();
+
+    BASIC_LOG("Account '%s' (%u) using IP '%s' has been geolocked", _login.c_str(), _accountId, get_remote_address().c_str()); // todo, add additional logging info
+
+    auto pin = urand(100000, 999999); // check rand32_max
+    auto updated = LoginDatabase.PExecute("UPDATE account SET geolock_pin = %u WHERE username = '%s'",
+        pin, _safelogin.c_str());
+
+    if (!updated)
+    {
+        sLog.outError("Unable to write geolock PIN for %s - account has not been locked", _safelogin.c_str());
+
+        char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_DB_BUSY };
+        send(data, sizeof(data));
+        return true;
+    }
+
+    if (CachedAccount* account = sAccountCache.FindAccount(_login))
+        account->geolockPin = pin;
+
+#ifdef USE_SENDGRID
+    if (sConfig.GetBoolDefault("SendMail", false))
+    {
+        auto mail = std::make_unique<SendgridMail>
+        (
+            sConfig.GetStringDefault("SendGridKey", ""),
+            sConfig.GetStringDefault("GeolockGUID", "")
+        );
+
+        mail->recipient(_email);
+        mail->from(sConfig.GetStringDefault("MailFrom", ""));
+        mail->substitution("%username%", _login);
+        mail->substitution("%unlock_pin%", std::to_string(pin));
+        mail->substitution("%originating_ip%", get_remote_address());
+
+        MailerService::get_global_mailer()->send(std::move(mail),
+            [](SendgridMail::Result res)
+            {
+                DEBUG_LOG("Mail result: %d", res);
             }
+        );
+    }
+#endif
+
+    char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_PARENTCONTROL };
+    send(data, sizeof(data));
+    return true;
+}
+
+/// Logon Proof: store the session key for the world server, then send the proof
+bool AuthSocket::StoreSessionKey()
+{
+    BASIC_LOG("[AuthChallenge] Account '%s' using IP '%s' successfully authenticated", _login.c_str(), get_remote_address().c_str());
+
+    ///- Update the sessionkey, last_ip, last login time and reset number of failed logins in the account table for this account
+    // No SQL injection (escaped user name) and IP address as received by socket
+    // The client connects to the world server right after the proof, so the key has to be written first
+    const char* K_hex = K.AsHexStr();
+    const char *os = reinterpret_cast<char *>(&_os);    // no injection as there are only two possible values
+    bool queued = AsyncQuery(&AuthSocket::_HandleSessionKeyStored, "UPDATE account SET sessionkey = '%s', last_ip = '%s', last_login = NOW(), locale = '%u', failed_logins = 0, os = '%s' WHERE username = '%s'",
+        K_hex, get_remote_address().c_str(), GetLocaleByName(_localizationName), os, _safelogin.c_str() );
+    OPENSSL_free((void*)K_hex);
+
+    if (CachedAccount* account = sAccountCache.FindAccount(_login))
+        account->lastIP = get_remote_address();
+    return queued;
+}
+
+/// Logon Proof: session key stored
+bool AuthSocket::_HandleSessionKeyStored(QueryResult* /*result*/)
+{
+    SendProof(_logonProof);
+
+    ///- Set _status to authed!
+    _status = STATUS_AUTHED;
+    return true;
+}
+
+/// Logon Proof: failed logins counted, ban the account or IP at the limit
+bool AuthSocket::_HandleFailedLoginsResult(QueryResult* loginfail)
+{
+    if (!loginfail)
+        return true;
+
+    uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
+
+    Field* fields = loginfail->Fetch();
+    uint32 failed_logins = fields[1].GetUInt32();
+
+    if( failed_logins >= MaxWrongPassCount )
+    {
+        uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+        bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+        uint64 now = time(NULL);
+
+        if(WrongPassBanType)
+        {
+            uint32 acc_id = fields[0].GetUInt32();
+            LoginDatabase.PExecute("INSERT INTO account_banned (id, bandate, unbandate, bannedby, banreason, active, realm) "
+                "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1,1)",
+                acc_id, WrongPassBanTime);
+            sAccountCache.AddAccountBan(acc_id, now, now + WrongPassBanTime);
+            BASIC_LOG("[AuthChallenge] Account '%s' using  IP '%s' got banned for '%u' seconds because it failed to authenticate '%u' times",
+                _login.c_str(), get_remote_address().c_str(), WrongPassBanTime, failed_logins);
+        }
+        else
+        {
+            std::string current_ip = get_remote_address();
+            sAccountCache.AddIpBan(current_ip, now, now + WrongPassBanTime);
+            LoginDatabase.escape_string(current_ip);
+            LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
+                current_ip.c_str(), WrongPassBanTime);
+            BASIC_LOG("[AuthChallenge] IP '%s' got banned for '%u' seconds because account '%s' failed to authenticate '%u' times",
+                current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
         }
     }
     return true;
@@ -988,20 +1178,22 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
 
-    QueryResult *result = LoginDatabase.PQuery ("SELECT sessionkey,id FROM account WHERE username = '%s'", _safelogin.c_str ());
+    return AsyncQuery(&AuthSocket::_HandleReconnectAccountResult, "SELECT sessionkey,id FROM account WHERE username = '%s'", _safelogin.c_str());
+}
 
+/// Reconnect Challenge: session key fetched
+bool AuthSocket::_HandleReconnectAccountResult(QueryResult* result)
+{
     // Stop if the account is not found
     if (!result)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
-        close_connection();
         return false;
     }
 
     Field* fields = result->Fetch ();
     K.SetHexStr (fields[0].GetString ());
     _accountId = fields[1].GetUInt32();
-    delete result;
 
     ///- All good, await client's proof
     _status = STATUS_RECON_PROOF;
@@ -1097,12 +1289,29 @@ bool AuthSocket::_HandleRealmList()
         return false;
     }
 
+    ///- Count the characters of the account on all realms at once
+    return AsyncQuery(&AuthSocket::_HandleRealmCharactersResult, "SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", _accountId);
+}
+
+/// %Realm List: characters counted
+bool AuthSocket::_HandleRealmCharactersResult(QueryResult* result)
+{
+    std::map<uint32, uint8> characterCounts;
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            characterCounts[fields[0].GetUInt32()] = fields[1].GetUInt8();
+        } while (result->NextRow());
+    }
+
     ///- Update realm list if need
     sRealmList.UpdateIfNeed();
 
     ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
     ByteBuffer pkt;
-    LoadRealmlist(pkt);
+    LoadRealmlist(pkt, characterCounts);
 
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
@@ -1114,7 +1323,7 @@ bool AuthSocket::_HandleRealmList()
     return true;
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer &pkt)
+void AuthSocket::LoadRealmlist(ByteBuffer &pkt, std::map<uint32, uint8> const& characterCounts)
 {
     switch(_build)
     {
@@ -1131,18 +1340,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer &pkt)
 
             for(RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult *result = LoginDatabase.PQuery( "SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, _accountId);
-                if( result )
-                {
-                    Field *fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                std::map<uint32, uint8>::const_iterator count = characterCounts.find(i->second.m_ID);
+                uint8 AmountOfCharacters = count != characterCounts.end() ? count->second : 0;
 
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
@@ -1192,18 +1391,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer &pkt)
 
             for(RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult *result = LoginDatabase.PQuery( "SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, _accountId);
-                if( result )
-                {
-                    Field *fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                std::map<uint32, uint8>::const_iterator count = characterCounts.find(i->second.m_ID);
+                uint8 AmountOfCharacters = count != characterCounts.end() ? count->second : 0;
 
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
@@ -1425,28 +1614,30 @@ void AuthSocket::InitPatch()
     }
 }
 
-void AuthSocket::LoadAccountSecurityLevels(uint32 accountId)
+/// Logon Challenge: security levels of the account on the realms
+bool AuthSocket::_HandleAccountAccessResult(QueryResult* result)
 {
-    QueryResult* result = LoginDatabase.PQuery("SELECT gmlevel, RealmID FROM account_access WHERE id = %u",
-        accountId);
     if (!result)
-        return;
+        return true;
 
     do
     {
         Field *fields = result->Fetch();
-        AccountTypes security = AccountTypes(fields[0].GetUInt32());
-        int realmId = fields[1].GetInt32();
-        if (realmId < 0)
-            _accountDefaultSecurityLevel = security;
-        else
-            _accountSecurityOnRealm[realmId] = security;
+        SetSecurityLevel(fields[1].GetInt32(), AccountTypes(fields[0].GetUInt32()));
     } while (result->NextRow());
 
-    delete result;
+    return true;
 }
 
-bool AuthSocket::GeographicalLockCheck()
+void AuthSocket::SetSecurityLevel(int32 realmId, AccountTypes security)
+{
+    if (realmId < 0)
+        _accountDefaultSecurityLevel = security;
+    else
+        _accountSecurityOnRealm[realmId] = security;
+}
+
+bool AuthSocket::NeedsGeographicalLockCheck() const
 {
     if (!sConfig.GetBoolDefault("GeoLocking"), false)
     {
@@ -1463,38 +1654,49 @@ bool AuthSocket::GeographicalLockCheck()
         return false;
     }
 
-    auto result = std::unique_ptr<QueryResult>(LoginDatabase.PQuery(
-        "SELECT INET_ATON('%s') AS ip, network_start_integer, geoname_id, registered_country_geoname_id "
-        "FROM geoip "
-        "WHERE network_last_integer >= INET_ATON('%s') "
-        "ORDER BY network_last_integer ASC LIMIT 1",
-        get_remote_address().c_str(), get_remote_address().c_str())
-        );
-
-    auto result_prev = std::unique_ptr<QueryResult>(LoginDatabase.PQuery(
-        "SELECT INET_ATON('%s') AS ip, network_start_integer, geoname_id, registered_country_geoname_id "
-        "FROM geoip "
-        "WHERE network_last_integer >= INET_ATON('%s') "
-        "ORDER BY network_last_integer ASC LIMIT 1",
-        _lastIP.c_str(), _lastIP.c_str())
-        );
+    return true;
+}
 
-    if (!result && !result_prev)
+// 'result' holds the network of the current address (first column 0) and of the previous one (1)
+bool AuthSocket::GeographicalLockCheck(QueryResult* result) const
+{
+    if (!result)
     {
         return false;
     }
 
+    bool current = false;
+    bool previous = false;
+    std::string geoname_id, country_geoname_id, prev_geoname_id, prev_country_geoname_id;
+    uint32_t net_start = 0, net_start_prev = 0, ip = 0, ip_prev = 0;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        if (fields[0].GetUInt32() == 0)
+        {
+            current = true;
+            ip = fields[1].GetUInt32();
+            net_start = fields[2].GetUInt32();
+            geoname_id = fields[3].GetCppString();
+            country_geoname_id = fields[4].GetCppString();
+        }
+        else
+        {
+            previous = true;
+            ip_prev = fields[1].GetUInt32();
+            net_start_prev = fields[2].GetUInt32();
+            prev_geoname_id = fields[3].GetCppString();
+            prev_country_geoname_id = fields[4].GetCppString();
+        }
+    } while (result->NextRow());
+
     // If only one of the queries returns a result, assume location has changed
-    if ((result && !result_prev) || (!result && result_prev))
+    if (!current || !previous)
     {
         return true;
     }
 
-    uint32_t net_start = result->Fetch()[1].GetUInt32();
-    uint32_t net_start_prev = result_prev->Fetch()[1].GetUInt32();
-    uint32_t ip = result->Fetch()[0].GetUInt32();
-    uint32_t ip_prev = result_prev->Fetch()[0].GetUInt32();
-
     /* The optimised query will return the next highest range in the event
      * of the address not being found in the database. Therefore, we need
      * to perform a second check to ensure our address falls within
@@ -1506,11 +1708,6 @@ bool AuthSocket::GeographicalLockCheck()
         return false;
     }
 
-    std::string geoname_id = result->Fetch()[2].GetString();
-    std::string country_geoname_id = result->Fetch()[3].GetString();
-    std::string prev_geoname_id = result_prev->Fetch()[2].GetString();
-    std::string prev_country_geoname_id = result_prev->Fetch()[3].GetString();
-
     if (lockFlags & GEO_CITY)
     {
         return geoname_id != prev_geoname_id;
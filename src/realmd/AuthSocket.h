@@ -33,6 +33,10 @@
 
 #include "BufferedSocket.h"
 
+class QueryResult;
+struct CachedAccount;
+struct CachedBan;
+
 struct PINData
 {
     uint8 salt[16];
@@ -62,7 +66,7 @@ class AuthSocket: public BufferedSocket
         void OnAccept();
         void OnRead();
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer &pkt);
+        void LoadRealmlist(ByteBuffer &pkt, std::map<uint32, uint8> const& characterCounts);
         bool VerifyPinData(uint32 pin, const PINData& clientData);
         uint32 GenerateTotpPin(const std::string& secret, int interval);
 
@@ -71,6 +75,16 @@ class AuthSocket: public BufferedSocket
         bool _HandleReconnectChallenge();
         bool _HandleReconnectProof();
         bool _HandleRealmList();
+
+        // Continuations of the handlers above, called with the result of their async query
+        bool _HandleIpBanResult(QueryResult* result);
+        bool _HandleAccountResult(QueryResult* result);
+        bool _HandleAccountAccessResult(QueryResult* result);
+        bool _HandleGeoLockResult(QueryResult* result);
+        bool _HandleSessionKeyStored(QueryResult* result);
+        bool _HandleFailedLoginsResult(QueryResult* result);
+        bool _HandleReconnectAccountResult(QueryResult* result);
+        bool _HandleRealmCharactersResult(QueryResult* result);
         //data transfer handle for patch
 
         bool _HandleXferResume();
@@ -79,6 +93,11 @@ class AuthSocket: public BufferedSocket
 
         void _SetVSFields(const std::string& rI);
 
+        int handle_close(ACE_HANDLE h = ACE_INVALID_HANDLE, ACE_Reactor_Mask m = ACE_Event_Handler::ALL_EVENTS_MASK) override;
+
+        // Count of sockets waiting for a login query, the main loop polls the results more often meanwhile
+        static uint32 GetPendingQueries() { return s_pendingQueries; }
+
     private:
         enum eStatus
         {
@@ -92,10 +111,21 @@ class AuthSocket: public BufferedSocket
 
         bool VerifyVersion(uint8 const* a, int32 aLength, uint8 const* versionProof, bool isReconnect);
 
+        typedef bool (AuthSocket::*QueryHandler)(QueryResult*);
+
+        // Suspends the reading of commands until 'handler' has been called with the result
+        bool AsyncQuery(QueryHandler handler, const char* format, ...) ATTR_PRINTF(3, 4);
+        void _HandleQueryResult(QueryResult* result, QueryHandler handler);
+
+        bool _queryPending;
+        bool _closePending;
+        static uint32 s_pendingQueries;
+
         BigNumber N, s, g, v;
         BigNumber b, B;
         BigNumber K;
         BigNumber _reconnectProof;
+        Sha1Hash _logonProof;                               // sent once the session key is stored
 
         bool _authed, promptPin;
 
@@ -130,8 +160,12 @@ class AuthSocket: public BufferedSocket
         uint16 _build;
 
         AccountTypes GetSecurityOn(uint32 realmId) const;
-        void LoadAccountSecurityLevels(uint32 accountId);
-        bool GeographicalLockCheck();
+        bool LogonChallengeIpChecked(bool banned);
+        bool LogonChallengeAccountFound(CachedAccount const& account, CachedBan const* ban);
+        void SetSecurityLevel(int32 realmId, AccountTypes security);
+        bool StoreSessionKey();
+        bool NeedsGeographicalLockCheck() const;
+        bool GeographicalLockCheck(QueryResult* result) const;
 
         AccountTypes _accountDefaultSecurityLevel;
         typedef std::map<uint32, AccountTypes> AccountSecurityMap;
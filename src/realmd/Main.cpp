@@ -30,6 +30,7 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "AccountCache.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "Util.h"
@@ -283,6 +284,9 @@ extern int main(int argc, char **argv)
     LoginDatabase.Execute("DELETE FROM ip_banned WHERE unbandate<=UNIX_TIMESTAMP() AND unbandate<>bandate");
     LoginDatabase.CommitTransaction();
 
+    ///- Load the accounts and bans checked at each login
+    sAccountCache.Initialize(sConfig.GetIntDefault("AccountCache.UpdateDelay", 10), sConfig.GetIntDefault("AccountCache.PreloadDays", 7));
+
     ///- Launch the listening network socket
     ACE_Acceptor<AuthSocket, ACE_SOCK_Acceptor> acceptor;
 
@@ -347,9 +351,9 @@ extern int main(int argc, char **argv)
     //server has started up successfully => enable async DB requests
     LoginDatabase.AllowAsyncTransactions();
 
-    // maximum counter for next ping
-    uint32 numLoops = (sConfig.GetIntDefault( "MaxPingTime", 30 ) * (MINUTE * 1000000 / 100000));
-    uint32 loopCounter = 0;
+    // time of the next ping, the loop does not run at a fixed rate
+    time_t const pingInterval = sConfig.GetIntDefault( "MaxPingTime", 30 ) * MINUTE;
+    time_t nextPing = time(NULL) + pingInterval;
 
     #ifndef WIN32
     detachDaemon();
@@ -358,14 +362,20 @@ extern int main(int argc, char **argv)
     while (!stopEvent)
     {
         // dont move this outside the loop, the reactor will modify it
-        ACE_Time_Value interval(0, 100000);
+        // wake up sooner while logins wait for their queries, the delay thread polls every 10ms
+        ACE_Time_Value interval(0, AuthSocket::GetPendingQueries() ? 5000 : 100000);
 
-        if (ACE_Reactor::instance()->run_reactor_event_loop(interval) == -1)
+        if (ACE_Reactor::instance()->handle_events(interval) == -1)
             break;
 
-        if( (++loopCounter) == numLoops )
+        sAccountCache.UpdateIfNeed();
+
+        ///- Resume the logins whose queries completed, in this thread like the socket events
+        LoginDatabase.ProcessResultQueue();
+
+        if (time(NULL) >= nextPing)
         {
-            loopCounter = 0;
+            nextPing = time(NULL) + pingInterval;
             DETAIL_LOG("Ping MySQL to keep connection alive");
             LoginDatabase.Ping();
         }
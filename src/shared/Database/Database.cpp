@@ -23,6 +23,7 @@
 #include "DatabaseEnv.h"
 #include "Config/Config.h"
 #include "Database/SqlOperations.h"
+#include "Timer.h"
 
 #include <ctime>
 #include <iostream>
@@ -154,6 +155,9 @@ bool Database::Initialize(const char * infoString, int nConns /*= 1*/, int nWork
 
     m_pingIntervallms = sConfig.GetIntDefault ("MaxPingTime", 30) * (MINUTE * 1000);
 
+    m_asyncBatchMaxStatements = std::max<int32>(1, sConfig.GetIntDefault("Database.AsyncBatch.MaxStatements", 100));
+    m_asyncBatchMaxDelay = std::max<int32>(0, sConfig.GetIntDefault("Database.AsyncBatch.MaxDelay", 20));
+
     //create DB connections
 
     //setup connection pool size
@@ -377,6 +381,44 @@ QueryResult* Database::PQuery(const char *format,...)
     return Query(szQuery);
 }
 
+void Database::CompareQueryProtocols(const char *sql)
+{
+    uint32 elapsed[2] = { 0, 0 };
+    uint64 rows[2] = { 0, 0 };
+    uint64 integers[2] = { 0, 0 };
+    double floats[2] = { 0.0, 0.0 };
+
+    // Fetch and decode every field the way loaders do, with each protocol
+    for (int binary = 0; binary < 2; ++binary)
+    {
+        uint32 startTime = WorldTimer::getMSTime();
+        std::unique_ptr<QueryResult> result(binary ? QueryBinary(sql) : Query(sql));
+        if (result)
+        {
+            do
+            {
+                Field* fields = result->Fetch();
+                for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+                {
+                    switch (fields[i].GetType())
+                    {
+                        case Field::DB_TYPE_INTEGER: integers[binary] += fields[i].GetUInt32(); break;
+                        case Field::DB_TYPE_FLOAT:   floats[binary] += fields[i].GetFloat(); break;
+                        default:                     fields[i].GetCppString(); break;
+                    }
+                }
+                ++rows[binary];
+            }
+            while (result->NextRow());
+        }
+        elapsed[binary] = WorldTimer::getMSTimeDiffToNow(startTime);
+    }
+
+    bool same = rows[0] == rows[1] && integers[0] == integers[1] && floats[0] == floats[1];
+    sLog.outString(">> Result set protocols: text %u ms, binary %u ms for " UI64FMTD " rows%s",
+        elapsed[0], elapsed[1], rows[0], same ? "" : " (RESULTS DIFFER)");
+}
+
 QueryNamedResult* Database::PQueryNamed(const char *format,...)
 {
     if(!format) return NULL;
@@ -573,6 +615,16 @@ bool Database::HasAsyncQuery()
     return hasQuery;
 }
 
+void Database::GetAsyncStats(SqlAsyncStats& stats)
+{
+    stats.queued = uint32(m_delayQueue->size());
+    for (uint32 i = 0; i < m_numAsyncWorkers && m_serialDelayQueue; ++i)
+        stats.queued += uint32(m_serialDelayQueue[i]->size());
+
+    for (uint32 i = 0; i < m_numAsyncWorkers && m_threadsBodies; ++i)
+        m_threadsBodies[i]->AddStats(stats);
+}
+
 bool Database::CheckRequiredMigrations(const char **migrations)
 {
     std::set<std::string> appliedMigrations;
@@ -55,6 +55,8 @@ class MANGOS_DLL_SPEC SqlConnection
         //public methods for making queries
         virtual QueryResult* Query(const char *sql) = 0;
         virtual QueryNamedResult* QueryNamed(const char *sql) = 0;
+        // same as Query(), through a server-side prepared statement (binary protocol, typed fields)
+        virtual QueryResult* QueryBinary(const char *sql) { return Query(sql); }
 
         //public methods for making requests
         virtual bool Execute(const char *sql) = 0;
@@ -67,6 +69,15 @@ class MANGOS_DLL_SPEC SqlConnection
         virtual bool CommitTransaction() { return true; }
         // can't rollback without transaction support
         virtual bool RollbackTransaction() { return true; }
+        // partial rollback inside a transaction (one SqlTransaction of a batch)
+        virtual bool SetSavepoint() { return true; }
+        virtual bool RollbackToSavepoint() { return true; }
+        // true if a failed statement leaves the rest of the transaction usable,
+        // so that async operations may be grouped in one transaction
+        virtual bool CanBatchOperations() const { return false; }
+        // true once the server rolled back the open transaction (deadlock, connection lost):
+        // the statements executed since BeginTransaction() are lost
+        bool IsTransactionAborted() const { return m_transactionAborted; }
 
         //methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
@@ -88,7 +99,7 @@ class MANGOS_DLL_SPEC SqlConnection
         Database& DB() { return m_db; }
 
     protected:
-        SqlConnection(Database& db) : m_db(db) {}
+        SqlConnection(Database& db) : m_db(db), m_inTransaction(false), m_transactionAborted(false) {}
 
         virtual SqlPreparedStatement * CreateStatement(const std::string& fmt);
         //allocate prepared statement and return statement ID
@@ -107,6 +118,9 @@ class MANGOS_DLL_SPEC SqlConnection
         std::string m_password;
         std::string m_database;
 
+        bool m_inTransaction;
+        bool m_transactionAborted;
+
     private:
         typedef ACE_Recursive_Thread_Mutex LOCK_TYPE;
         LOCK_TYPE m_mutex;
@@ -139,6 +153,17 @@ class MANGOS_DLL_SPEC Database
             return guard->QueryNamed(sql);
         }
 
+        // Numeric columns are sent and stored in binary form: no text parsing in Field getters.
+        // Worth it for large result sets (startup loading), costs an extra round trip otherwise.
+        inline QueryResult* QueryBinary(const char *sql)
+        {
+            SqlConnection::Lock guard(getQueryConnection());
+            return guard->QueryBinary(sql);
+        }
+
+        // Runs 'sql' with both Query() and QueryBinary(), decodes every field and logs the timings
+        void CompareQueryProtocols(const char *sql);
+
         QueryResult* PQuery(const char *format,...) ATTR_PRINTF(2,3);
         QueryNamedResult* PQueryNamed(const char *format,...) ATTR_PRINTF(2,3);
 
@@ -269,6 +294,10 @@ class MANGOS_DLL_SPEC Database
 
         bool HasAsyncQuery();
 
+        void GetAsyncStats(SqlAsyncStats& stats);
+        uint32 GetAsyncBatchMaxStatements() const { return m_asyncBatchMaxStatements; }
+        uint32 GetAsyncBatchMaxDelay() const { return m_asyncBatchMaxDelay; }
+
         void AddToSerialDelayQueue(SqlOperation *op);
 
         // Frees data, cancels scheduled queries, closes connection
@@ -276,7 +305,7 @@ class MANGOS_DLL_SPEC Database
     protected:
         Database() : m_pAsyncConn(NULL), m_pResultQueue(NULL), m_threadsBodies(NULL), m_delayThreads(NULL), m_numAsyncWorkers(0),
             m_serialDelayQueue(NULL), m_delayQueue(new SqlQueue()), m_logSQL(false), m_pingIntervallms(0), m_nQueryConnPoolSize(1),
-            m_bAllowAsyncTransactions(false), m_iStmtIndex(-1)
+            m_bAllowAsyncTransactions(false), m_asyncBatchMaxStatements(1), m_asyncBatchMaxDelay(0), m_iStmtIndex(-1)
         {
             m_nQueryCounter = -1;
         }
@@ -341,6 +370,8 @@ class MANGOS_DLL_SPEC Database
         ACE_Based::Thread** m_delayThreads;                   ///< Pointer to executer thread
 
         bool m_bAllowAsyncTransactions;                      ///< flag which specifies if async transactions are enabled
+        uint32 m_asyncBatchMaxStatements;                    ///< statements per delay thread transaction (1: no batching)
+        uint32 m_asyncBatchMaxDelay;                         ///< ms before a delay thread commits its transaction
 
         //PREPARED STATEMENT REGISTRY
         typedef ACE_Thread_Mutex LOCK_TYPE;
@@ -165,10 +165,18 @@ bool MySQLConnection::HandleMySQLError(uint32 errNo)
         case CR_SERVER_LOST_EXTENDED:
         {
             mysql_close(mMysql);
+            // The open transaction is lost with the connection: the statement must not be retried outside of it
+            if (m_inTransaction)
+            {
+                CheckTransactionError(errNo);
+                Reconnect();
+                return false;
+            }
             return Reconnect();
         }
 
         case ER_LOCK_DEADLOCK:
+            CheckTransactionError(errNo);
             return false;
         // Query related errors - skip query
         case ER_WRONG_VALUE_COUNT:
@@ -191,6 +199,26 @@ bool MySQLConnection::HandleMySQLError(uint32 errNo)
     }
 }
 
+void MySQLConnection::CheckTransactionError(uint32 errNo)
+{
+    if (!m_inTransaction)
+        return;
+
+    switch (errNo)
+    {
+        case CR_SERVER_GONE_ERROR:
+        case CR_SERVER_LOST:
+        case CR_INVALID_CONN_HANDLE:
+        case CR_SERVER_LOST_EXTENDED:
+        case ER_LOCK_DEADLOCK:                              // InnoDB rolls back the whole transaction
+            m_inTransaction = false;
+            m_transactionAborted = true;
+            break;
+        default:
+            break;
+    }
+}
+
 bool MySQLConnection::_Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount)
 {
     if (!mMysql && !Reconnect())
@@ -271,6 +299,74 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char *sql)
     return new QueryNamedResult(queryResult,names);
 }
 
+QueryResult* MySQLConnection::QueryBinary(const char *sql)
+{
+    if (!mMysql && !Reconnect())
+        return NULL;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    MYSQL_STMT* stmt = mysql_stmt_init(mMysql);
+    if (!stmt)
+    {
+        sLog.outError("SQL: mysql_stmt_init() failed ");
+        return NULL;
+    }
+
+    MYSQL_RES* metadata = NULL;
+    my_bool updateMaxLength = 1;
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)) ||
+        !(metadata = mysql_stmt_result_metadata(stmt)) ||
+        mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength) ||
+        mysql_stmt_execute(stmt) ||
+        mysql_stmt_store_result(stmt))
+    {
+        uint32 lErrno = mysql_stmt_errno(stmt);
+
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("[%u] %s", lErrno, mysql_stmt_error(stmt));
+
+        if (metadata)
+            mysql_free_result(metadata);
+        mysql_stmt_close(stmt);
+
+        // Not everything can be prepared, the text protocol still works for those
+        if (lErrno == ER_UNSUPPORTED_PS)
+            return Query(sql);
+
+        if (lErrno && HandleMySQLError(lErrno)) // If error is handled, just try again
+            return QueryBinary(sql);
+
+        return NULL;
+    }
+    else
+    {
+        DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL (binary): %s", WorldTimer::getMSTimeDiff(_s,WorldTimer::getMSTime()), sql);
+    }
+
+    uint64 rowCount = mysql_stmt_num_rows(stmt);
+    uint32 fieldCount = mysql_stmt_field_count(stmt);
+
+    // Every row is copied out of the statement: it can be closed while the connection is still locked
+    QueryResultMysql* queryResult = NULL;
+    if (rowCount)
+    {
+        queryResult = new QueryResultMysql(stmt, mysql_fetch_fields(metadata), rowCount, fieldCount);
+        if (!queryResult->GetRowCount())
+        {
+            delete queryResult;
+            queryResult = NULL;
+        }
+        else
+            queryResult->NextRow();
+    }
+
+    mysql_free_result(metadata);
+    mysql_stmt_free_result(stmt);
+    mysql_stmt_close(stmt);
+    return queryResult;
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
     if (!mMysql)
@@ -314,19 +410,43 @@ bool MySQLConnection::_TransactionCmd(const char *sql)
 
 bool MySQLConnection::BeginTransaction()
 {
-    return _TransactionCmd("START TRANSACTION");
+    m_transactionAborted = false;
+    m_inTransaction = _TransactionCmd("START TRANSACTION");
+    return m_inTransaction;
 }
 
 bool MySQLConnection::CommitTransaction()
 {
-    return _TransactionCmd("COMMIT");
+    if (_TransactionCmd("COMMIT"))
+    {
+        m_inTransaction = false;
+        return true;
+    }
+
+    // Only a deadlock tells that nothing was committed, a lost connection leaves it unknown
+    uint32 lErrno = mysql_errno(mMysql);
+    if (lErrno == ER_LOCK_DEADLOCK)
+        CheckTransactionError(lErrno);
+    m_inTransaction = false;
+    return false;
 }
 
 bool MySQLConnection::RollbackTransaction()
 {
+    m_inTransaction = false;
     return _TransactionCmd("ROLLBACK");
 }
 
+bool MySQLConnection::SetSavepoint()
+{
+    return _TransactionCmd("SAVEPOINT sql_batch");
+}
+
+bool MySQLConnection::RollbackToSavepoint()
+{
+    return _TransactionCmd("ROLLBACK TO SAVEPOINT sql_batch");
+}
+
 unsigned long MySQLConnection::escape_string(char *to, const char *from, unsigned long length)
 {
     if (!mMysql || !to || !from || !length)
@@ -495,6 +615,7 @@ bool MySqlPreparedStatement::execute()
     {
         sLog.outError("SQL: cannot execute '%s'", m_szFmt.c_str());
         sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        static_cast<MySQLConnection&>(m_pConn).CheckTransactionError(mysql_stmt_errno(m_stmt));
         return false;
     }
 
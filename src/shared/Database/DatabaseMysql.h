@@ -78,9 +78,12 @@ class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
         bool OpenConnection(bool reconnect);
         bool Reconnect();
         bool HandleMySQLError(uint32 errNo);
+        // Notes whether the error rolled back the open transaction
+        void CheckTransactionError(uint32 errNo);
 
         QueryResult* Query(const char *sql);
         QueryNamedResult* QueryNamed(const char *sql);
+        QueryResult* QueryBinary(const char *sql);
         bool Execute(const char *sql);
 
         unsigned long escape_string(char *to, const char *from, unsigned long length);
@@ -88,6 +91,9 @@ class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
         bool BeginTransaction();
         bool CommitTransaction();
         bool RollbackTransaction();
+        bool SetSavepoint();
+        bool RollbackToSavepoint();
+        bool CanBatchOperations() const { return true; }
 
     protected:
         SqlPreparedStatement * CreateStatement(const std::string& fmt);
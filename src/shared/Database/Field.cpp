@@ -20,3 +20,24 @@
  */
 
 //#include "DatabaseEnv.h"
+#include "Field.h"
+
+void Field::FormatNative() const
+{
+    switch (mStorage)
+    {
+        case DB_STORAGE_INT64:
+            snprintf(mBuffer, sizeof(mBuffer), SI64FMTD, mNative.i);
+            break;
+        case DB_STORAGE_UINT64:
+            snprintf(mBuffer, sizeof(mBuffer), UI64FMTD, mNative.u);
+            break;
+        case DB_STORAGE_DOUBLE:
+            snprintf(mBuffer, sizeof(mBuffer), "%.9g", mNative.d);
+            break;
+        default:
+            mBuffer[0] = '\0';
+            break;
+    }
+    mFormatted = true;
+}
@@ -37,28 +37,58 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        // How the value is stored: text from the DBMS, or native value from a binary result set
+        enum StorageTypes
+        {
+            DB_STORAGE_TEXT   = 0x00,
+            DB_STORAGE_INT64  = 0x01,
+            DB_STORAGE_UINT64 = 0x02,
+            DB_STORAGE_DOUBLE = 0x03
+        };
+
+        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN), mStorage(DB_STORAGE_TEXT), mFormatted(false) { mNative.u = 0; }
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mStorage(DB_STORAGE_TEXT), mFormatted(false) { mNative.u = 0; }
 
         ~Field() {}
 
         enum DataTypes GetType() const { return mType; }
         bool IsNULL() const { return mValue == NULL; }
 
-        const char *GetString() const { return mValue; }
+        const char *GetString() const
+        {
+            if (mStorage != DB_STORAGE_TEXT && mValue && !mFormatted)
+                FormatNative();
+            return mValue;
+        }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            const char* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
+        float GetFloat() const
+        {
+            if (mStorage == DB_STORAGE_DOUBLE)
+                return mValue ? static_cast<float>(mNative.d) : 0.0f;
+            if (mStorage != DB_STORAGE_TEXT)
+                return mValue ? static_cast<float>(GetNativeInteger<int64>()) : 0.0f;
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
+        bool GetBool() const
+        {
+            if (mStorage != DB_STORAGE_TEXT)
+                return mValue ? GetNativeInteger<int64>() > 0 : false;
+            return mValue ? atoi(mValue) > 0 : false;
+        }
+        int32 GetInt32() const { return GetInteger<int32>(); }
+        uint8 GetUInt8() const { return GetInteger<uint8>(); }
+        uint16 GetUInt16() const { return GetInteger<uint16>(); }
+        int16 GetInt16() const { return GetInteger<int16>(); }
+        uint32 GetUInt32() const { return GetInteger<uint32>(); }
         uint64 GetUInt64() const
         {
+            if (mStorage != DB_STORAGE_TEXT)
+                return mValue ? GetNativeInteger<uint64>() : 0;
+
             uint64 value = 0;
             if(!mValue || sscanf(mValue,UI64FMTD,&value) == -1)
                 return 0;
@@ -69,13 +99,57 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         //no need for memory allocations to store resultset field strings
         //all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; };
+        void SetValue(const char* value) { mValue = value; mStorage = DB_STORAGE_TEXT; };
+
+        // Binary result sets: the value is kept in native form, no text parsing
+        void SetNull() { mValue = NULL; }
+        void SetValue(int64 value) { mNative.i = value; SetNative(DB_STORAGE_INT64); }
+        void SetValue(uint64 value) { mNative.u = value; SetNative(DB_STORAGE_UINT64); }
+        void SetValue(double value) { mNative.d = value; SetNative(DB_STORAGE_DOUBLE); }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        void SetNative(enum StorageTypes storage)
+        {
+            mStorage = storage;
+            mFormatted = false;
+            mValue = mBuffer;                               // non NULL marker, text form built on demand
+        }
+
+        // Same conversions as the text path: through a signed integer, then truncated
+        template<typename T> T GetInteger() const
+        {
+            if (!mValue)
+                return T(0);
+            if (mStorage != DB_STORAGE_TEXT)
+                return GetNativeInteger<T>();
+            return static_cast<T>(atol(mValue));
+        }
+
+        template<typename T> T GetNativeInteger() const
+        {
+            switch (mStorage)
+            {
+                case DB_STORAGE_INT64:  return static_cast<T>(mNative.i);
+                case DB_STORAGE_UINT64: return static_cast<T>(mNative.u);
+                default:                return static_cast<T>(static_cast<int64>(mNative.d));
+            }
+        }
+
+        void FormatNative() const;
+
         const char* mValue;
         enum DataTypes mType;
+        enum StorageTypes mStorage;
+        union
+        {
+            int64 i;
+            uint64 u;
+            double d;
+        } mNative;
+        mutable bool mFormatted;
+        mutable char mBuffer[32];
 };
 #endif
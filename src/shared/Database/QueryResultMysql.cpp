@@ -25,7 +25,7 @@
 #include "Errors.h"
 
 QueryResultMysql::QueryResultMysql(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount) :
-    QueryResult(rowCount, fieldCount), mResult(result)
+    QueryResult(rowCount, fieldCount), mResult(result), mBinaryRow(0)
 {
 
     mCurrentRow = new Field[mFieldCount];
@@ -35,6 +35,120 @@ QueryResultMysql::QueryResultMysql(MYSQL_RES *result, MYSQL_FIELD *fields, uint6
         mCurrentRow[i].SetType(ConvertNativeType(fields[i].type));
 }
 
+QueryResultMysql::QueryResultMysql(MYSQL_STMT *stmt, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount) :
+    QueryResult(rowCount, fieldCount), mResult(NULL), mBinaryRow(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    for (uint32 i = 0; i < mFieldCount; i++)
+        mCurrentRow[i].SetType(ConvertNativeType(fields[i].type));
+
+    if (!FetchBinaryRows(stmt, fields))
+        mRowCount = 0;
+}
+
+bool QueryResultMysql::FetchBinaryRows(MYSQL_STMT *stmt, MYSQL_FIELD *fields)
+{
+    // Fetch buffers: integers and floating point values are converted by the
+    // client library to 64 bits values, everything else is fetched as text.
+    std::vector<MYSQL_BIND> binds(mFieldCount);
+    std::vector<uint64> numbers(mFieldCount);
+    std::vector<std::vector<char> > texts(mFieldCount);
+    std::vector<unsigned long> lengths(mFieldCount);
+    std::vector<my_bool> nulls(mFieldCount);
+
+    memset(&binds[0], 0, sizeof(MYSQL_BIND) * mFieldCount);
+    mBinaryStorage.resize(mFieldCount);
+
+    for (uint32 i = 0; i < mFieldCount; i++)
+    {
+        MYSQL_BIND& bind = binds[i];
+        switch (fields[i].type)
+        {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONGLONG:
+            case MYSQL_TYPE_YEAR:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) ? 1 : 0;
+                bind.buffer = &numbers[i];
+                bind.buffer_length = sizeof(uint64);
+                mBinaryStorage[i] = bind.is_unsigned ? Field::DB_STORAGE_UINT64 : Field::DB_STORAGE_INT64;
+                break;
+            case MYSQL_TYPE_FLOAT:
+            case MYSQL_TYPE_DOUBLE:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &numbers[i];
+                bind.buffer_length = sizeof(double);
+                mBinaryStorage[i] = Field::DB_STORAGE_DOUBLE;
+                break;
+            default:                                        // strings, blobs, dates, decimals
+                // max_length is filled by mysql_stmt_store_result (STMT_ATTR_UPDATE_MAX_LENGTH)
+                texts[i].resize(fields[i].max_length + 1);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &texts[i][0];
+                bind.buffer_length = texts[i].size();
+                mBinaryStorage[i] = Field::DB_STORAGE_TEXT;
+                break;
+        }
+        bind.length = &lengths[i];
+        bind.is_null = &nulls[i];
+    }
+
+    if (mysql_stmt_bind_result(stmt, &binds[0]))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed: %s", mysql_stmt_error(stmt));
+        return false;
+    }
+
+    mBinaryValues.resize(size_t(mRowCount) * mFieldCount);
+    BinaryValue* value = mBinaryValues.empty() ? NULL : &mBinaryValues[0];
+    for (uint64 row = 0; row < mRowCount; ++row)
+    {
+        int res = mysql_stmt_fetch(stmt);
+        if (res == MYSQL_DATA_TRUNCATED)
+            sLog.outError("SQL ERROR: mysql_stmt_fetch() truncated a column");
+        else if (res != 0)
+        {
+            if (res == 1)
+                sLog.outError("SQL ERROR: mysql_stmt_fetch() failed: %s", mysql_stmt_error(stmt));
+            mBinaryValues.resize(size_t(row) * mFieldCount);
+            mRowCount = row;
+            break;
+        }
+
+        for (uint32 i = 0; i < mFieldCount; i++, value++)
+        {
+            value->isNull = nulls[i] != 0;
+            if (value->isNull)
+                continue;
+
+            switch (mBinaryStorage[i])
+            {
+                case Field::DB_STORAGE_DOUBLE:
+                    memcpy(&value->d, &numbers[i], sizeof(double));
+                    break;
+                case Field::DB_STORAGE_TEXT:
+                {
+                    unsigned long length = std::min<unsigned long>(lengths[i], texts[i].size() - 1);
+                    value->textOffset = mBinaryText.size();
+                    mBinaryText.insert(mBinaryText.end(), texts[i].begin(), texts[i].begin() + length);
+                    mBinaryText.push_back('\0');
+                    break;
+                }
+                default:
+                    value->u = numbers[i];
+                    break;
+            }
+        }
+    }
+
+    return true;
+}
+
 QueryResultMysql::~QueryResultMysql()
 {
     EndQuery();
@@ -42,6 +156,34 @@ QueryResultMysql::~QueryResultMysql()
 
 bool QueryResultMysql::NextRow()
 {
+    if (!mBinaryStorage.empty())
+    {
+        if (!mCurrentRow || mBinaryRow >= mRowCount)
+        {
+            EndQuery();
+            return false;
+        }
+
+        BinaryValue const* value = &mBinaryValues[size_t(mBinaryRow++) * mFieldCount];
+        for (uint32 i = 0; i < mFieldCount; i++, value++)
+        {
+            Field& field = mCurrentRow[i];
+            if (value->isNull)
+            {
+                field.SetNull();
+                continue;
+            }
+            switch (mBinaryStorage[i])
+            {
+                case Field::DB_STORAGE_INT64:  field.SetValue(value->i); break;
+                case Field::DB_STORAGE_UINT64: field.SetValue(value->u); break;
+                case Field::DB_STORAGE_DOUBLE: field.SetValue(value->d); break;
+                default:                       field.SetValue(&mBinaryText[value->textOffset]); break;
+            }
+        }
+        return true;
+    }
+
     MYSQL_ROW row;
 
     if (!mResult)
@@ -73,6 +215,9 @@ void QueryResultMysql::EndQuery()
         mysql_free_result(mResult);
         mResult = 0;
     }
+
+    mBinaryValues.clear();
+    mBinaryText.clear();
 }
 
 enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
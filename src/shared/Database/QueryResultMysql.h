@@ -37,16 +37,39 @@ class QueryResultMysql : public QueryResult
 {
     public:
         QueryResultMysql(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount);
+        // Binary protocol: fetches every row of an executed and stored statement.
+        // Must be called with the connection locked, the statement can be closed afterwards.
+        QueryResultMysql(MYSQL_STMT *stmt, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount);
 
         ~QueryResultMysql();
 
         bool NextRow();
 
     private:
+        // One column value of a binary result row
+        struct BinaryValue
+        {
+            union
+            {
+                int64 i;
+                uint64 u;
+                double d;
+                size_t textOffset;
+            };
+            bool isNull;
+        };
+
         enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
+        bool FetchBinaryRows(MYSQL_STMT *stmt, MYSQL_FIELD *fields);
         void EndQuery();
 
         MYSQL_RES *mResult;
+
+        // Binary protocol storage
+        std::vector<enum Field::StorageTypes> mBinaryStorage;
+        std::vector<BinaryValue> mBinaryValues;             // mRowCount * mFieldCount
+        std::vector<char> mBinaryText;                      // null terminated strings
+        uint64 mBinaryRow;
 };
 #endif
 #endif
@@ -22,9 +22,13 @@
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
+#include "Timer.h"
 
 SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, int workerId)
-    : m_dbEngine(db), m_dbConnection(conn), m_running(true), m_workerId(workerId)
+    : m_dbEngine(db), m_dbConnection(conn), m_running(true), m_workerId(workerId),
+      m_batchStatements(0), m_batchStartTime(0), m_batchOpen(false),
+      m_batches(0), m_batchedStatements(0), m_maxBatchStatements(0), m_unbatchedOperations(0),
+      m_replayedBatches(0)
 {
 }
 
@@ -77,15 +81,115 @@ void SqlDelayThread::ProcessRequests()
 {
     SqlOperation* s = NULL;
     while (m_dbEngine->NextDelayedOperation(s))
-    {
-        s->Execute(m_dbConnection);
-        delete s;
-    }
+        ProcessOperation(s);
 
     // Process any serial operations for this worker
     while (m_dbEngine->NextSerialDelayedOperation(m_workerId, s))
+        ProcessOperation(s);
+
+    // Never keep a transaction open while sleeping
+    FlushBatch();
+}
+
+void SqlDelayThread::ProcessOperation(SqlOperation* op)
+{
+    uint32 maxStatements = m_dbEngine->GetAsyncBatchMaxStatements();
+    if (maxStatements <= 1 || !op->CanBatch() || !m_dbConnection->CanBatchOperations())
     {
-        s->Execute(m_dbConnection);
-        delete s;
+        // Queries must see every write queued before them (same serial id)
+        FlushBatch();
+        op->Execute(m_dbConnection);
+        delete op;
+        ++m_unbatchedOperations;
+        return;
     }
+
+    if (!m_batchOpen)
+    {
+        // The connection is only used by this thread: no lock needed across the batch
+        if (!m_dbConnection->BeginTransaction())
+        {
+            op->Execute(m_dbConnection);
+            delete op;
+            ++m_unbatchedOperations;
+            return;
+        }
+        m_batchOpen = true;
+        m_batchStatements = 0;
+        m_batchStartTime = WorldTimer::getMSTime();
+    }
+
+    // A failed plain statement only logs its error, as when executed alone
+    op->ExecuteInBatch(m_dbConnection);
+    m_batchStatements += op->GetStatementCount();
+    m_batchOperations.push_back(op);
+
+    if (m_dbConnection->IsTransactionAborted())
+    {
+        ReplayBatch();
+        return;
+    }
+
+    if (m_batchStatements >= maxStatements || WorldTimer::getMSTimeDiffToNow(m_batchStartTime) >= m_dbEngine->GetAsyncBatchMaxDelay())
+        FlushBatch();
+}
+
+void SqlDelayThread::FlushBatch()
+{
+    if (!m_batchOpen)
+        return;
+
+    m_batchOpen = false;
+    if (!m_dbConnection->CommitTransaction())
+    {
+        if (m_dbConnection->IsTransactionAborted())
+        {
+            ReplayBatch();
+            return;
+        }
+
+        // Connection lost on COMMIT: the server may or may not have committed, executing again could write twice
+        sLog.outError("SqlDelayThread: failed to commit a batch of %u statements (%u operations), they may be lost",
+            m_batchStatements, uint32(m_batchOperations.size()));
+    }
+
+    ++m_batches;
+    m_batchedStatements += m_batchStatements;
+    if (m_batchStatements > m_maxBatchStatements)
+        m_maxBatchStatements = m_batchStatements;
+    ClearBatch();
+}
+
+void SqlDelayThread::ReplayBatch()
+{
+    // The server rolled back every statement of the batch (deadlock, lost connection),
+    // and those executed after it ran outside of any transaction: all are executed again, one by one
+    sLog.outError("SqlDelayThread: batch of %u statements rolled back by the server, executing its %u operations again unbatched",
+        m_batchStatements, uint32(m_batchOperations.size()));
+
+    m_batchOpen = false;
+    m_dbConnection->RollbackTransaction();
+
+    for (SqlOperation* op : m_batchOperations)
+        op->Execute(m_dbConnection);
+    m_unbatchedOperations += m_batchOperations.size();
+    ++m_replayedBatches;
+    ClearBatch();
+}
+
+void SqlDelayThread::ClearBatch()
+{
+    for (SqlOperation* op : m_batchOperations)
+        delete op;
+    m_batchOperations.clear();
+}
+
+void SqlDelayThread::AddStats(SqlAsyncStats& stats) const
+{
+    stats.batches += m_batches;
+    stats.batchedStatements += m_batchedStatements;
+    stats.unbatchedOperations += m_unbatchedOperations;
+    stats.replayedBatches += m_replayedBatches;
+    if (m_maxBatchStatements > stats.maxBatchStatements)
+        stats.maxBatchStatements = m_maxBatchStatements;
 }
@@ -25,12 +25,27 @@
 #include "ace/Thread_Mutex.h"
 #include "LockedQueue.h"
 #include "Threading.h"
+#include <atomic>
+#include <vector>
 
 
 class Database;
 class SqlOperation;
 class SqlConnection;
 
+/// Async statements coalesced into one transaction by the delay threads
+struct SqlAsyncStats
+{
+    SqlAsyncStats() : queued(0), batches(0), batchedStatements(0), maxBatchStatements(0), unbatchedOperations(0), replayedBatches(0) {}
+
+    uint32 queued;                                          ///< Operations waiting in the delay queues
+    uint64 batches;
+    uint64 batchedStatements;
+    uint32 maxBatchStatements;
+    uint64 unbatchedOperations;                             ///< Queries and query holders, executed alone
+    uint64 replayedBatches;                                 ///< Rolled back by the server, executed again unbatched
+};
+
 class SqlDelayThread : public ACE_Based::Runnable
 {
     typedef ACE_Based::LockedQueue<SqlOperation*, ACE_Thread_Mutex> SqlQueue;
@@ -43,8 +58,24 @@ class SqlDelayThread : public ACE_Based::Runnable
 
         int m_workerId;
 
+        // Current batch: writes executed in one open transaction, committed by FlushBatch()
+        uint32 m_batchStatements;
+        uint32 m_batchStartTime;
+        bool m_batchOpen;
+        std::vector<SqlOperation*> m_batchOperations;       ///< Kept until committed, to be executed again if the batch is lost
+
+        std::atomic<uint64> m_batches;
+        std::atomic<uint64> m_batchedStatements;
+        std::atomic<uint32> m_maxBatchStatements;
+        std::atomic<uint64> m_unbatchedOperations;
+        std::atomic<uint64> m_replayedBatches;
+
         //process all enqueued requests
         void ProcessRequests();
+        void ProcessOperation(SqlOperation* op);
+        void FlushBatch();
+        void ReplayBatch();
+        void ClearBatch();
 
     public:
         SqlDelayThread(Database* db, SqlConnection* conn, int workerId);
@@ -53,6 +84,8 @@ class SqlDelayThread : public ACE_Based::Runnable
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql) { m_sqlQueue.add(sql); return true; }
 
+        void AddStats(SqlAsyncStats& stats) const;
+
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
@@ -45,6 +45,19 @@ SqlTransaction::~SqlTransaction()
     }
 }
 
+bool SqlTransaction::ExecuteStatements(SqlConnection *conn)
+{
+    const int nItems = m_queue.size();
+    for (int i = 0; i < nItems; ++i)
+    {
+        SqlOperation * pStmt = m_queue[i];
+
+        if(!pStmt->Execute(conn))
+            return false;
+    }
+    return true;
+}
+
 bool SqlTransaction::Execute(SqlConnection *conn)
 {
     if(m_queue.empty())
@@ -54,21 +67,33 @@ bool SqlTransaction::Execute(SqlConnection *conn)
 
     conn->BeginTransaction();
 
-    const int nItems = m_queue.size();
-    for (int i = 0; i < nItems; ++i)
+    if (!ExecuteStatements(conn))
     {
-        SqlOperation * pStmt = m_queue[i];
-
-        if(!pStmt->Execute(conn))
-        {
-            conn->RollbackTransaction();
-            return false;
-        }
+        conn->RollbackTransaction();
+        return false;
     }
 
     return conn->CommitTransaction();
 }
 
+bool SqlTransaction::ExecuteInBatch(SqlConnection *conn)
+{
+    if(m_queue.empty())
+        return true;
+
+    LOCK_DB_CONN(conn);
+
+    // Only this transaction is undone on failure, not the rest of the batch
+    conn->SetSavepoint();
+
+    if (!ExecuteStatements(conn))
+    {
+        conn->RollbackToSavepoint();
+        return false;
+    }
+    return true;
+}
+
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters * arg ) : m_nIndex(nIndex), m_param(arg)
 {
 }
@@ -124,6 +149,10 @@ class SqlResultCallbackCaller : public ACE_Based::Runnable
 
 void SqlResultQueue::Update(uint32 timeout)
 {
+    // realmd polls the queue after each socket event, skip the callers setup when idle
+    if (empty() && _threadUnsafeWaitingQueries.empty())
+        return;
+
     uint32 begin = WorldTimer::getMSTime();
     /// execute the callbacks waiting in the synchronization queue
     int threadsCount = 6;
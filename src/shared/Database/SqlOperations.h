@@ -44,6 +44,12 @@ class SqlOperation
         uint32 GetSerialId() const { return serialId; }
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection *conn) = 0;
+
+        // Writes without result can share the transaction of a delay thread batch
+        virtual bool CanBatch() const { return false; }
+        virtual uint32 GetStatementCount() const { return 1; }
+        // Execute inside the (already started) batch transaction
+        virtual bool ExecuteInBatch(SqlConnection *conn) { return Execute(conn); }
         virtual ~SqlOperation() {}
 
     protected:
@@ -60,6 +66,7 @@ class SqlPlainRequest : public SqlOperation
         SqlPlainRequest(const char *sql) : m_sql(mangos_strdup(sql)){}
         ~SqlPlainRequest() { char* tofree = const_cast<char*>(m_sql); delete [] tofree; }
         bool Execute(SqlConnection *conn);
+        bool CanBatch() const { return true; }
 };
 
 class SqlTransaction : public SqlOperation
@@ -74,6 +81,12 @@ class SqlTransaction : public SqlOperation
         void DelayExecute(SqlOperation * sql)   {   m_queue.push_back(sql); }
 
         bool Execute(SqlConnection *conn);
+        bool CanBatch() const { return true; }
+        uint32 GetStatementCount() const { return uint32(m_queue.size()); }
+        bool ExecuteInBatch(SqlConnection *conn);
+
+    private:
+        bool ExecuteStatements(SqlConnection *conn);
 };
 
 class SqlPreparedRequest : public SqlOperation
@@ -83,6 +96,7 @@ class SqlPreparedRequest : public SqlOperation
         ~SqlPreparedRequest();
 
         bool Execute(SqlConnection *conn);
+        bool CanBatch() const { return true; }
 
     private:
         const int m_nIndex;
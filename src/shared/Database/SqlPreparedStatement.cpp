@@ -17,6 +17,7 @@
  */
 
 #include "DatabaseEnv.h"
+#include "Util.h"
 
 SqlStmtParameters::SqlStmtParameters( int nParams )
 {
@@ -33,6 +34,22 @@ void SqlStmtParameters::reset( const SqlStatement& stmt )
         m_params.reserve(stmt.arguments());
 }
 
+uint64 SqlStmtParameters::hash( int first ) const
+{
+    uint64 result = FNV1A_64_SEED;
+    for (int i = first; i < boundParams(); ++i)
+    {
+        SqlStmtFieldData const& data = m_params[i];
+        uint8 type = uint8(data.type());
+        result = HashFNV1aValue(type, result);
+        result = HashFNV1a(data.buff(), data.size(), result);
+        // strings: separate "ab" + "c" from "a" + "bc"
+        if (data.type() == FIELD_STRING)
+            result = HashFNV1aValue(uint8(0), result);
+    }
+    return result;
+}
+
 //////////////////////////////////////////////////////////////////////////
 SqlStatement& SqlStatement::operator=( const SqlStatement& index )
 {
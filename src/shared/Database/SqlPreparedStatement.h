@@ -160,6 +160,8 @@ class MANGOS_DLL_SPEC SqlStmtParameters
         void swap(SqlStmtParameters& obj);
         //get bound parameters
         const ParameterContainer& params() const { return m_params; }
+        //hash of the parameters bound from index 'first', to detect unchanged data
+        uint64 hash(int first = 0) const;
 
     private:
         SqlStmtParameters& operator=(const SqlStmtParameters& obj);
@@ -203,6 +205,8 @@ class MANGOS_DLL_SPEC SqlStatement
 
         int ID() const { return m_index.ID(); }
         int arguments() const { return m_index.arguments(); }
+        //hash of the parameters bound so far, starting at index 'first'
+        uint64 GetParamsHash(int first = 0) const { return m_pParams ? m_pParams->hash(first) : 0; }
 
         bool Execute();
         bool DirectExecute();
@@ -41,6 +41,7 @@ if (!(CONDITION)) \
     sLog.outInfo("%s:%i: Error: Assertion in %s failed: %s", \
         __FILE__, __LINE__, __FUNCTION__, STRINGIZE(CONDITION)); \
     sLog.outInfo("%s", st.c_str()); \
+    sLog.Flush(); \
     throw std::runtime_error(STRINGIZE(CONDITION)); \
     assert(STRINGIZE(CONDITION) && 0); \
 }
@@ -21,6 +21,7 @@
 
 #include "Common.h"
 #include "Log.h"
+#include "LogWriter.h"
 #include "Policies/SingletonImp.h"
 #include "Config/Config.h"
 #include "Util.h"
@@ -57,7 +58,8 @@ LogFilterData logFilterData[LOG_FILTER_COUNT] =
 
 Log::Log() :
     logfile(nullptr), gmLogfile(nullptr), dberLogfile(nullptr),
-    wardenLogfile(nullptr), honorLogfile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false)
+    wardenLogfile(nullptr), honorLogfile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false),
+    m_writer(nullptr)
 {
     for (int i = 0; i < LOG_MAX_FILES; ++i)
     {
@@ -246,6 +248,10 @@ void Log::SetLogFileLevel(char* level)
 
 void Log::Initialize()
 {
+    // Files reopened below, write the lines queued for the previous ones
+    StopAsyncWriter();
+    m_filePaths.clear();
+
     /// Common log files data
     m_logsDir = sConfig.GetStringDefault("LogsDir","");
     if (!m_logsDir.empty())
@@ -332,6 +338,57 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    StartAsyncWriter();
+}
+
+void Log::StartAsyncWriter()
+{
+    if (!sConfig.GetBoolDefault("LogAsync", false))
+        return;
+
+    uint64 rotateSize = uint64(sConfig.GetIntDefault("LogRotateSize", 0)) * 1024 * 1024;
+    m_writer = new LogWriter(sConfig.GetIntDefault("LogAsyncQueueSize", 4096), rotateSize);
+    for (std::map<FILE*, std::string>::const_iterator itr = m_filePaths.begin(); itr != m_filePaths.end(); ++itr)
+        m_writer->AddRotatedFile(itr->first, itr->second);
+    m_writer->Start();
+}
+
+void Log::StopAsyncWriter()
+{
+    if (!m_writer)
+        return;
+
+    // Lines logged while the writer stops are written directly
+    LogWriter* writer = m_writer;
+    m_writer = nullptr;
+    delete writer;
+}
+
+void Log::Flush()
+{
+    if (m_writer)
+        m_writer->Flush();
+}
+
+uint8 Log::ConsoleFlags(bool toStderr) const
+{
+    uint8 flags = LOG_ENTRY_CONSOLE;
+    if (toStderr)
+        flags |= LOG_ENTRY_STDERR;
+    if (m_colored)
+        flags |= LOG_ENTRY_COLORED;
+    if (m_includeTime)
+        flags |= LOG_ENTRY_CONSOLE_TIME;
+    return flags;
+}
+
+void Log::QueueLine(uint8 flags, LogType type, FILE* file, char const* filePrefix, char const* format, ...)
+{
+    va_list ap;
+    va_start(ap, format);
+    m_writer->Queue(flags, m_colors[type], file, filePrefix, format, ap);
+    va_end(ap);
 }
 
 FILE* Log::openLogFile(char const* configFileName,char const* configTimeStampFlag, char const* mode)
@@ -349,7 +406,10 @@ FILE* Log::openLogFile(char const* configFileName,char const* configTimeStampFla
             logfn += m_logsTimestamp;
     }
 
-    return fopen((m_logsDir+logfn).c_str(), mode);
+    FILE* file = fopen((m_logsDir+logfn).c_str(), mode);
+    if (file)
+        m_filePaths[file] = m_logsDir + logfn;
+    return file;
 }
 
 FILE* Log::openGmlogPerAccount(uint32 account)
@@ -405,6 +465,12 @@ std::string Log::GetTimestampStr()
 
 void Log::outString()
 {
+    if (m_writer)
+    {
+        QueueLine(ConsoleFlags(false) & ~LOG_ENTRY_COLORED, LogNormal, logfile, nullptr, "%s", "");
+        return;
+    }
+
     if (m_includeTime)
         outTime(stdout);
     printf( "\n" );
@@ -423,6 +489,15 @@ void Log::outString( const char * str, ... )
     if (!str)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, str);
+        m_writer->Queue(ConsoleFlags(false), m_colors[LogNormal], logfile, nullptr, str, ap);
+        va_end(ap);
+        return;
+    }
+
     if (m_colored)
         SetColor(true,m_colors[LogNormal]);
 
@@ -459,6 +534,15 @@ void Log::outInfo( const char * str, ...)
 {
     if (!str)
         return;
+
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, str);
+        m_writer->Queue(LOG_ENTRY_CONSOLE, 0, nostalriusLogFile, nullptr, str, ap);
+        va_end(ap);
+        return;
+    }
     va_list ap;
     va_start(ap, str);
     vutf8printf(stdout, str, &ap);
@@ -485,6 +569,15 @@ void Log::outHonor(const char *str, ...)
     if (!str)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, str);
+        m_writer->Queue(HasLogFilter(LOG_FILTER_HONOR) ? 0 : ConsoleFlags(true), m_colors[LogNormal], honorLogfile, nullptr, str, ap);
+        va_end(ap);
+        return;
+    }
+
     if (!HasLogFilter(LOG_FILTER_HONOR))
     {
         if (m_colored)
@@ -528,6 +621,15 @@ void Log::out(LogFile type, const char* str, ...)
     if (!str)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, str);
+        m_writer->Queue(timestampPrefix[type] ? 0 : LOG_ENTRY_NO_TIMESTAMP, 0, logFiles[type], nullptr, str, ap);
+        va_end(ap);
+        return;
+    }
+
     if (logFiles[type])
     {
         if (timestampPrefix[type])
@@ -550,6 +652,15 @@ void Log::outError( const char * err, ... )
     if (!err)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, err);
+        m_writer->Queue(ConsoleFlags(true), m_colors[LogError], logfile, "ERROR:", err, ap);
+        va_end(ap);
+        return;
+    }
+
     if (m_colored)
         SetColor(false,m_colors[LogError]);
 
@@ -584,6 +695,14 @@ void Log::outError( const char * err, ... )
 
 void Log::outErrorDb()
 {
+    if (m_writer)
+    {
+        QueueLine(ConsoleFlags(true) & ~LOG_ENTRY_COLORED, LogError, logfile, "ERROR:", "%s", "");
+        if (dberLogfile)
+            QueueLine(0, LogError, dberLogfile, nullptr, "%s", "");
+        return;
+    }
+
     if (m_includeTime)
         outTime(stderr);
 
@@ -611,6 +730,22 @@ void Log::outErrorDb( const char * err, ... )
     if (!err)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, err);
+        m_writer->Queue(ConsoleFlags(true), m_colors[LogError], logfile, "ERROR:", err, ap);
+        va_end(ap);
+
+        if (dberLogfile)
+        {
+            va_start(ap, err);
+            m_writer->Queue(0, 0, dberLogfile, nullptr, err, ap);
+            va_end(ap);
+        }
+        return;
+    }
+
     if (m_colored)
         SetColor(false,m_colors[LogError]);
 
@@ -662,6 +797,16 @@ void Log::outBasic( const char * str, ... )
     if (!str)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, str);
+        m_writer->Queue(m_logLevel >= LOG_LVL_BASIC ? ConsoleFlags(false) : 0, m_colors[LogDetails],
+            m_logFileLevel >= LOG_LVL_BASIC ? logfile : nullptr, nullptr, str, ap);
+        va_end(ap);
+        return;
+    }
+
     if (m_logLevel >= LOG_LVL_BASIC)
     {
         if (m_colored)
@@ -700,6 +845,16 @@ void Log::outDetail( const char * str, ... )
     if (!str)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, str);
+        m_writer->Queue(m_logLevel >= LOG_LVL_DETAIL ? ConsoleFlags(false) : 0, m_colors[LogDetails],
+            m_logFileLevel >= LOG_LVL_DETAIL ? logfile : nullptr, nullptr, str, ap);
+        va_end(ap);
+        return;
+    }
+
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
 
@@ -741,6 +896,16 @@ void Log::outDebug( const char * str, ... )
     if (!str)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, str);
+        m_writer->Queue(m_logLevel >= LOG_LVL_DEBUG ? ConsoleFlags(false) : 0, m_colors[LogDebug],
+            m_logFileLevel >= LOG_LVL_DEBUG ? logfile : nullptr, nullptr, str, ap);
+        va_end(ap);
+        return;
+    }
+
     if (m_logLevel >= LOG_LVL_DEBUG)
     {
         if (m_colored)
@@ -782,6 +947,15 @@ void Log::outWarden(const char *wrd, ...)
     if (!wrd)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, wrd);
+        m_writer->Queue(ConsoleFlags(false), m_colors[LogWarden], wardenLogfile, nullptr, wrd, ap);
+        va_end(ap);
+        return;
+    }
+
     if (m_colored)
         SetColor(true, m_colors[LogWarden]);
 
@@ -819,6 +993,33 @@ void Log::outCommand( uint32 account, const char * str, ... )
     if (!str)
         return;
 
+    if (m_writer)
+    {
+        va_list ap;
+        va_start(ap, str);
+        m_writer->Queue(m_logLevel >= LOG_LVL_DETAIL ? ConsoleFlags(false) : 0, m_colors[LogDetails],
+            m_logFileLevel >= LOG_LVL_DETAIL ? logfile : nullptr, nullptr, str, ap);
+        va_end(ap);
+
+        if (!m_gmlog_per_account)
+        {
+            va_start(ap, str);
+            m_writer->Queue(0, 0, gmLogfile, nullptr, str, ap);
+            va_end(ap);
+        }
+        // a file per account is opened for each command, written below
+        else if (FILE* per_file = openGmlogPerAccount(account))
+        {
+            outTimestamp(per_file);
+            va_start(ap, str);
+            vfprintf(per_file, str, ap);
+            fprintf(per_file, "\n" );
+            va_end(ap);
+            fclose(per_file);
+        }
+        return;
+    }
+
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
         if (m_colored)
@@ -883,6 +1084,23 @@ void Log::outWorldPacketDump(ACE_HANDLE socketHandle, uint32 opcode,
     if (!worldLogfile)
         return;
 
+    if (m_writer)
+    {
+        std::string data;
+        char byte[4];
+        for (size_t p = 0; p < packet->size(); ++p)
+        {
+            snprintf(byte, sizeof(byte), "%.2X ", (*packet)[p]);
+            data += byte;
+            if (p % 16 == 15 || p + 1 == packet->size())
+                data += '\n';
+        }
+
+        QueueLine(0, LogNormal, worldLogfile, nullptr, "\n%s:\nSOCKET: %p\nLENGTH: %zu\nOPCODE: %s (0x%.4X)\nDATA:\n%s\n",
+            incoming ? "CLIENT" : "SERVER", socketHandle, packet->size(), opcodeName, opcode, data.c_str());
+        return;
+    }
+
     outTimestamp(worldLogfile);
 
     fprintf(worldLogfile,
@@ -905,6 +1123,9 @@ void Log::outWorldPacketDump(ACE_HANDLE socketHandle, uint32 opcode,
 
 void Log::WaitBeforeContinueIfNeed()
 {
+    // the error is printed before the prompt
+    sLog.Flush();
+
     int mode = sConfig.GetIntDefault("WaitAtStartupError",0);
 
     if (mode < 0)
@@ -27,6 +27,7 @@
 
 class Config;
 class ByteBuffer;
+class LogWriter;
 
 enum LogLevel
 {
@@ -125,6 +126,9 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
 
     ~Log()
     {
+        // lines still queued go to the files closed below
+        StopAsyncWriter();
+
         if( logfile != nullptr )
             fclose(logfile);
         logfile = nullptr;
@@ -191,8 +195,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
         uint32 GetLogLevel() const { return m_logLevel; }
         void SetLogLevel(char * Level);
         void SetLogFileLevel(char * Level);
-        void SetColor(bool stdout_stream, Color color);
-        void ResetColor(bool stdout_stream);
+        static void SetColor(bool stdout_stream, Color color);
+        static void ResetColor(bool stdout_stream);
         void outTime(FILE* where);
         static void outTimestamp(FILE* file);
         static std::string GetTimestampStr();
@@ -203,6 +207,9 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
 
         static void WaitBeforeContinueIfNeed();
 
+        // With LogAsync, returns once the lines logged before are written
+        void Flush();
+
         std::list<uint32> m_smartlogExtraEntries;
         std::list<uint32> m_smartlogExtraGuids;
 
@@ -210,6 +217,12 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
         FILE* openLogFile(char const* configFileName,char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
+        void StartAsyncWriter();
+        void StopAsyncWriter();
+        // LogEntryFlags of a line printed on the console
+        uint8 ConsoleFlags(bool toStderr) const;
+        void QueueLine(uint8 flags, LogType type, FILE* file, char const* filePrefix, char const* format, ...) ATTR_PRINTF(6,7);
+
         FILE* logfile;
         FILE* gmLogfile;
         FILE* dberLogfile;
@@ -240,6 +253,10 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
         // gm log control
         bool m_gmlog_per_account;
         std::string m_gmlog_filename_format;
+
+        // lines written by a background thread (LogAsync)
+        LogWriter* m_writer;
+        std::map<FILE*, std::string> m_filePaths;
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
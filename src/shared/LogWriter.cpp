@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Common.h"
+#include "LogWriter.h"
+#include "Log.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "ace/OS_NS_time.h"
+
+// Writer wake up period when the rings are empty. The logging threads never wake it.
+#define LOG_WRITER_IDLE_DELAY   5
+
+namespace
+{
+    std::atomic<uint32> s_nextWriterId(0);
+
+    uint32 RoundUpToPowerOf2(uint32 size)
+    {
+        uint32 result = 2;
+        while (result < size)
+            result <<= 1;
+        return result;
+    }
+}
+
+thread_local LogWriter::ThreadQueues LogWriter::s_threadQueues;
+thread_local bool LogWriter::s_threadExited = false;
+
+LogWriter::ThreadQueues::~ThreadQueues()
+{
+    for (auto& queue : queues)
+        queue.second->closed.store(true, std::memory_order_release);
+    s_threadExited = true;
+}
+
+LogWriter::LogWriter(uint32 queueSize, uint64 rotateSize) :
+    m_id(++s_nextWriterId), m_queueSize(RoundUpToPowerOf2(queueSize)),
+    m_rotateSize(rotateSize), m_sequence(0), m_writtenLines(0), m_fullQueueWaits(0), m_stop(false), m_formattedTime(0)
+{
+    m_dateString[0] = '\0';
+    m_timeString[0] = '\0';
+}
+
+LogWriter::~LogWriter()
+{
+    Stop();
+}
+
+void LogWriter::AddRotatedFile(FILE* file, std::string const& path)
+{
+    if (file && m_rotateSize)
+        m_rotatedFiles[file].path = path;
+}
+
+void LogWriter::Start()
+{
+    if (m_thread.joinable())
+        return;
+
+    m_stop = false;
+    m_thread = std::thread(&LogWriter::WriterLoop, this);
+}
+
+void LogWriter::Stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_stop = true;
+    m_wakeCond.notify_one();
+    m_thread.join();
+}
+
+LogWriter::ThreadQueue* LogWriter::GetThreadQueue()
+{
+    if (s_threadExited)
+        return nullptr;
+
+    for (auto const& queue : s_threadQueues.queues)
+        if (queue.first == m_id)
+            return queue.second.get();
+
+    // First line of this thread
+    std::shared_ptr<ThreadQueue> queue = std::make_shared<ThreadQueue>(m_queueSize);
+    s_threadQueues.queues.push_back(std::make_pair(m_id, queue));
+
+    std::lock_guard<std::mutex> guard(m_queuesLock);
+    m_queues.push_back(queue);
+    return queue.get();
+}
+
+void LogWriter::Queue(uint8 flags, uint8 color, FILE* file, char const* filePrefix, char const* format, va_list ap)
+{
+    if (!file && !(flags & LOG_ENTRY_CONSOLE))
+        return;
+
+    ThreadQueue* queue = GetThreadQueue();
+    if (!queue || m_stop.load(std::memory_order_relaxed))
+    {
+        Entry entry;
+        entry.file = file;
+        entry.filePrefix = filePrefix;
+        entry.flags = flags;
+        entry.color = color;
+        WriteDirect(entry, format, ap);
+        return;
+    }
+
+    uint32 head = queue->head.load(std::memory_order_relaxed);
+    if (head - queue->tail.load(std::memory_order_acquire) >= m_queueSize)
+    {
+        ++m_fullQueueWaits;
+        m_wakeCond.notify_one();
+        while (head - queue->tail.load(std::memory_order_acquire) >= m_queueSize)
+            std::this_thread::yield();
+    }
+
+    Entry& entry = queue->entries[head & (m_queueSize - 1)];
+    entry.sequence = m_sequence.fetch_add(1, std::memory_order_relaxed);
+    entry.time = time(nullptr);
+    entry.file = file;
+    entry.filePrefix = filePrefix;
+    entry.flags = flags;
+    entry.color = color;
+    FormatText(entry.text, format, ap);
+
+    queue->head.store(head + 1, std::memory_order_release);
+}
+
+void LogWriter::Flush()
+{
+    if (!m_thread.joinable())
+        return;
+
+    uint64 queued = m_sequence;
+    std::unique_lock<std::mutex> guard(m_wakeLock);
+    m_wakeCond.notify_one();
+    while (m_writtenLines < queued && !m_stop)
+        m_writtenCond.wait_for(guard, std::chrono::milliseconds(LOG_WRITER_IDLE_DELAY));
+}
+
+void LogWriter::WriterLoop()
+{
+    while (!m_stop)
+    {
+        if (WriteQueued())
+            continue;
+
+        std::unique_lock<std::mutex> guard(m_wakeLock);
+        m_wakeCond.wait_for(guard, std::chrono::milliseconds(LOG_WRITER_IDLE_DELAY));
+    }
+
+    // Lines queued until the stop
+    while (WriteQueued())
+        ;
+}
+
+uint32 LogWriter::WriteQueued()
+{
+    m_snapshot.clear();
+    {
+        std::lock_guard<std::mutex> guard(m_queuesLock);
+        for (size_t i = 0; i < m_queues.size();)
+        {
+            ThreadQueue* queue = m_queues[i].get();
+            // closed first: the head of a closed ring does not move anymore
+            if (queue->closed.load(std::memory_order_acquire) &&
+                queue->head.load(std::memory_order_acquire) == queue->tail.load(std::memory_order_relaxed))
+            {
+                m_queues[i] = m_queues.back();
+                m_queues.pop_back();
+                continue;
+            }
+            m_snapshot.push_back(m_queues[i]);
+            ++i;
+        }
+    }
+
+    m_heads.clear();
+    m_batch.clear();
+    for (auto const& queue : m_snapshot)
+    {
+        uint32 head = queue->head.load(std::memory_order_acquire);
+        for (uint32 i = queue->tail.load(std::memory_order_relaxed); i != head; ++i)
+            m_batch.push_back(&queue->entries[i & (m_queueSize - 1)]);
+        m_heads.push_back(head);
+    }
+
+    if (m_batch.empty())
+        return 0;
+
+    // Each ring is in order, the lines of several threads are interleaved as they were queued
+    if (m_snapshot.size() > 1)
+        std::sort(m_batch.begin(), m_batch.end(), [](Entry const* lhs, Entry const* rhs) { return lhs->sequence < rhs->sequence; });
+
+    bool console = false;
+    m_touchedFiles.clear();
+    for (Entry const* entry : m_batch)
+    {
+        if (entry->time != m_formattedTime)
+        {
+            FormatTime(entry->time, m_dateString, m_timeString);
+            m_formattedTime = entry->time;
+        }
+
+        FILE* file = entry->file;
+        if (file && !m_rotatedFiles.empty())
+        {
+            std::map<FILE*, RotatedFile>::const_iterator itr = m_rotatedFiles.find(file);
+            if (itr != m_rotatedFiles.end() && itr->second.closed)
+                file = nullptr;
+        }
+
+        WriteEntry(*entry, file, m_dateString, m_timeString);
+
+        if (entry->flags & LOG_ENTRY_CONSOLE)
+            console = true;
+        if (file && std::find(m_touchedFiles.begin(), m_touchedFiles.end(), file) == m_touchedFiles.end())
+            m_touchedFiles.push_back(file);
+    }
+
+    // Once per batch
+    if (console)
+    {
+        fflush(stdout);
+        fflush(stderr);
+    }
+    for (FILE* file : m_touchedFiles)
+    {
+        fflush(file);
+
+        if (!m_rotatedFiles.empty())
+        {
+            std::map<FILE*, RotatedFile>::iterator itr = m_rotatedFiles.find(file);
+            if (itr != m_rotatedFiles.end())
+                Rotate(file, itr->second);
+        }
+    }
+
+    // The slots can be filled again
+    for (size_t i = 0; i < m_snapshot.size(); ++i)
+        m_snapshot[i]->tail.store(m_heads[i], std::memory_order_release);
+
+    uint32 written = m_batch.size();
+    m_writtenLines += written;
+    m_writtenCond.notify_all();
+    return written;
+}
+
+void LogWriter::Rotate(FILE* file, RotatedFile& rotated)
+{
+    long size = ftell(file);
+    if (size < 0 || uint64(size) < m_rotateSize)
+        return;
+
+    time_t now = time(nullptr);
+    tm aTm;
+    ACE_OS::localtime_r(&now, &aTm);
+    char suffix[24];
+    snprintf(suffix, sizeof(suffix), "_%04d-%02d-%02d_%02d-%02d-%02d", aTm.tm_year + 1900, aTm.tm_mon + 1, aTm.tm_mday, aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+
+    // Log_YYYY-MM-DD_HH-MM-SS.Ext for Log.Ext, like LogTimestamp
+    size_t slashPos = rotated.path.find_last_of("/\\");
+    size_t dotPos = rotated.path.find_last_of('.');
+    if (dotPos == std::string::npos || (slashPos != std::string::npos && dotPos < slashPos))
+        dotPos = rotated.path.size();
+
+    // Log_YYYY-MM-DD_HH-MM-SS_2.Ext when rotated again in the same second
+    std::string rotatedPath;
+    for (uint32 count = 1; ; ++count)
+    {
+        rotatedPath = rotated.path;
+        rotatedPath.insert(dotPos, count > 1 ? suffix + std::string("_") + std::to_string(count) : std::string(suffix));
+        FILE* existing = fopen(rotatedPath.c_str(), "r");
+        if (!existing)
+            break;
+        fclose(existing);
+    }
+
+#if PLATFORM == PLATFORM_WINDOWS
+    // An open file cannot be renamed
+    freopen("NUL", "a", file);
+#endif
+    // When the rename fails, keep appending to the same file
+    rename(rotated.path.c_str(), rotatedPath.c_str());
+    if (!freopen(rotated.path.c_str(), "a", file))
+        rotated.closed = true;
+}
+
+void LogWriter::WriteDirect(Entry& entry, char const* format, va_list ap)
+{
+    char dateString[24];
+    char timeString[12];
+    entry.time = time(nullptr);
+    FormatText(entry.text, format, ap);
+    FormatTime(entry.time, dateString, timeString);
+    WriteEntry(entry, entry.file, dateString, timeString);
+
+    if (entry.flags & LOG_ENTRY_CONSOLE)
+        fflush((entry.flags & LOG_ENTRY_STDERR) ? stderr : stdout);
+    if (entry.file)
+        fflush(entry.file);
+}
+
+void LogWriter::FormatText(std::string& text, char const* format, va_list ap)
+{
+    char buffer[1024];
+
+    va_list copy;
+    va_copy(copy, ap);
+    int length = vsnprintf(buffer, sizeof(buffer), format, copy);
+    va_end(copy);
+
+    if (length < 0)
+        text.clear();
+    else if (size_t(length) < sizeof(buffer))
+        text.assign(buffer, length);
+    else
+    {
+        text.resize(length + 1);
+        vsnprintf(&text[0], length + 1, format, ap);
+        text.resize(length);
+    }
+}
+
+void LogWriter::FormatTime(time_t time, char* dateString, char* timeString)
+{
+    tm aTm;
+    ACE_OS::localtime_r(&time, &aTm);
+    // Same formats as Log::outTimestamp and Log::outTime
+    snprintf(dateString, 24, "%-4d-%02d-%02d %02d:%02d:%02d ", aTm.tm_year + 1900, aTm.tm_mon + 1, aTm.tm_mday, aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+    snprintf(timeString, 12, "%02d:%02d:%02d ", aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+}
+
+void LogWriter::WriteEntry(Entry const& entry, FILE* file, char const* dateString, char const* timeString)
+{
+    if (entry.flags & LOG_ENTRY_CONSOLE)
+    {
+        bool toStdout = !(entry.flags & LOG_ENTRY_STDERR);
+        FILE* out = toStdout ? stdout : stderr;
+
+        if (entry.flags & LOG_ENTRY_COLORED)
+            Log::SetColor(toStdout, Color(entry.color));
+
+        if (entry.flags & LOG_ENTRY_CONSOLE_TIME)
+            fputs(timeString, out);
+
+        utf8printf(out, "%s", entry.text.c_str());
+
+        if (entry.flags & LOG_ENTRY_COLORED)
+            Log::ResetColor(toStdout);
+
+        fputc('\n', out);
+    }
+
+    if (file)
+    {
+        if (!(entry.flags & LOG_ENTRY_NO_TIMESTAMP))
+            fputs(dateString, file);
+        if (entry.filePrefix)
+            fputs(entry.filePrefix, file);
+        fwrite(entry.text.data(), 1, entry.text.size(), file);
+        fputc('\n', file);
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOGWRITER_H
+#define MANGOS_LOGWRITER_H
+
+#include "Platform/Define.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum LogEntryFlags
+{
+    LOG_ENTRY_CONSOLE       = 0x01,                         // printed on the console too
+    LOG_ENTRY_STDERR        = 0x02,                         // console output on stderr
+    LOG_ENTRY_COLORED       = 0x04,
+    LOG_ENTRY_CONSOLE_TIME  = 0x08,                         // console line prefixed by hh:mm:ss
+    LOG_ENTRY_NO_TIMESTAMP  = 0x10,                         // file line without the date prefix
+};
+
+/**
+ * Background writer of the log lines.
+ *
+ * Each thread that logs gets its own ring of lines, filled without locking:
+ * the calling thread only formats the message and takes the time, the writer
+ * thread prints the lines of each ring in order, and flushes each file once per
+ * batch instead of once per line.
+ * The lines of different threads are sorted by a sequence number taken before
+ * the line is published: a line published late may miss the batch of a later
+ * line of another thread, so across threads the order is only approximate.
+ * A thread waits for the writer only when its ring is full.
+ */
+class LogWriter
+{
+    public:
+        // 'queueSize' lines per logging thread, files are rotated past 'rotateSize' bytes (0: never)
+        explicit LogWriter(uint32 queueSize, uint64 rotateSize = 0);
+        // Writes the queued lines
+        ~LogWriter();
+
+        // Files that are renamed and reopened past the rotation size. Before Start() only.
+        void AddRotatedFile(FILE* file, std::string const& path);
+
+        void Start();
+        void Stop();
+
+        // Any thread. 'filePrefix' must be a string literal.
+        void Queue(uint8 flags, uint8 color, FILE* file, char const* filePrefix, char const* format, va_list ap);
+        // Returns once the lines queued before the call are written
+        void Flush();
+
+        uint64 GetWrittenLines() const { return m_writtenLines; }
+        uint64 GetFullQueueWaits() const { return m_fullQueueWaits; }
+
+    private:
+        struct Entry
+        {
+            Entry() : sequence(0), time(0), file(nullptr), filePrefix(nullptr), flags(0), color(0) {}
+            uint64 sequence;
+            time_t time;
+            FILE* file;
+            char const* filePrefix;
+            uint8 flags;
+            uint8 color;
+            std::string text;                               // keeps its capacity when the slot is reused
+        };
+
+        // Single producer (the logging thread), single consumer (the writer thread)
+        struct ThreadQueue
+        {
+            explicit ThreadQueue(uint32 size) : entries(size), head(0), tail(0), closed(false) {}
+            std::vector<Entry> entries;                     // power of 2 size
+            std::atomic<uint32> head;                       // next slot filled by the thread
+            std::atomic<uint32> tail;                       // next slot written by the writer
+            std::atomic<bool> closed;                       // thread exited, freed once written
+        };
+
+        struct RotatedFile
+        {
+            RotatedFile() : closed(false) {}
+            std::string path;
+            bool closed;                                    // could not be reopened
+        };
+
+        LogWriter(LogWriter const&);
+        LogWriter& operator=(LogWriter const&);
+
+        // Rings of the calling thread, closed when the thread exits
+        struct ThreadQueues
+        {
+            ~ThreadQueues();
+            std::vector<std::pair<uint32, std::shared_ptr<ThreadQueue>>> queues;
+        };
+
+        ThreadQueue* GetThreadQueue();
+        void WriterLoop();
+        // Returns the count of lines written
+        uint32 WriteQueued();
+        void Rotate(FILE* file, RotatedFile& rotated);
+        // Lines of exiting threads or of a stopped writer
+        void WriteDirect(Entry& entry, char const* format, va_list ap);
+
+        static void FormatText(std::string& text, char const* format, va_list ap);
+        static void FormatTime(time_t time, char* dateString, char* timeString);
+        static void WriteEntry(Entry const& entry, FILE* file, char const* dateString, char const* timeString);
+
+        static thread_local ThreadQueues s_threadQueues;
+        static thread_local bool s_threadExited;
+
+        uint32 const m_id;                                  // identifies the thread queues of this writer
+        uint32 const m_queueSize;
+        uint64 const m_rotateSize;
+
+        std::mutex m_queuesLock;
+        std::vector<std::shared_ptr<ThreadQueue>> m_queues;
+
+        std::atomic<uint64> m_sequence;
+        std::atomic<uint64> m_writtenLines;
+        std::atomic<uint64> m_fullQueueWaits;
+
+        std::thread m_thread;
+        std::atomic<bool> m_stop;
+        std::mutex m_wakeLock;
+        std::condition_variable m_wakeCond;
+        std::condition_variable m_writtenCond;
+
+        // Writer thread only
+        std::vector<std::shared_ptr<ThreadQueue>> m_snapshot;
+        std::vector<uint32> m_heads;
+        std::vector<Entry const*> m_batch;
+        std::vector<FILE*> m_touchedFiles;
+        std::map<FILE*, RotatedFile> m_rotatedFiles;
+        time_t m_formattedTime;
+        char m_dateString[24];                              // "YYYY-MM-DD HH:MM:SS "
+        char m_timeString[12];                              // "HH:MM:SS "
+};
+
+#endif
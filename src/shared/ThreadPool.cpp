@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ThreadPool.h"
+#include "Errors.h"
+#include <chrono>
+
+#if PLATFORM == PLATFORM_WINDOWS
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+namespace
+{
+    // Worker identity of the calling thread, used to route nested submissions
+    // to the local queue of the worker that runs the parent task.
+    thread_local ThreadPool const* t_currentPool = nullptr;
+    thread_local int32 t_currentIndex = -1;
+
+    void PinCurrentThread(uint32 index)
+    {
+        uint32 cores = std::thread::hardware_concurrency();
+        if (!cores)
+            return;
+        uint32 core = index % cores;
+#if PLATFORM == PLATFORM_WINDOWS
+        SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+#elif defined(__linux__)
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(core, &cpuset);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+    }
+}
+
+ThreadPool::TaskGroup::TaskGroup(ThreadPool* pool) : m_pool(pool), m_pending(0)
+{
+}
+
+ThreadPool::TaskGroup::~TaskGroup()
+{
+    Wait();
+}
+
+void ThreadPool::TaskGroup::Run(Task task)
+{
+    if (!m_pool || !m_pool->GetNumThreads())
+    {
+        task();
+        return;
+    }
+    ++m_pending;
+    m_pool->Enqueue(QueuedTask(std::move(task), this));
+}
+
+void ThreadPool::TaskGroup::TaskDone()
+{
+    // Decrement under the lock: the owner may destroy the group as soon as it sees zero
+    std::lock_guard<std::mutex> guard(m_doneLock);
+    if (--m_pending == 0)
+        m_doneCond.notify_all();
+}
+
+void ThreadPool::TaskGroup::Wait()
+{
+    while (m_pending)
+    {
+        // Help with our own tasks first. Never pick foreign tasks here: they may
+        // be long-running loops waiting on something this thread has to do next.
+        if (m_pool && m_pool->RunPendingTask(this))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_doneLock);
+        if (m_pending)
+            m_doneCond.wait_for(lock, std::chrono::milliseconds(1));
+    }
+    // Make sure the last TaskDone() call released the lock before we can be destroyed
+    std::lock_guard<std::mutex> guard(m_doneLock);
+}
+
+ThreadPool::ThreadPool(uint32 numThreads, bool pinThreads, ThreadHook onThreadStart, ThreadHook onThreadEnd) :
+    m_numWorkers(0), m_queuedTasks(0), m_stop(false), m_executedTasks(0), m_stolenTasks(0),
+    m_pinThreads(pinThreads), m_onThreadStart(onThreadStart), m_onThreadEnd(onThreadEnd)
+{
+    m_workers.reserve(MAX_POOL_THREADS);
+    Reserve(numThreads);
+}
+
+ThreadPool::~ThreadPool()
+{
+    Stop();
+}
+
+void ThreadPool::Reserve(uint32 numThreads)
+{
+    std::lock_guard<std::mutex> guard(m_workersLock);
+    if (m_stop)
+        return;
+    if (numThreads > MAX_POOL_THREADS)
+        numThreads = MAX_POOL_THREADS;
+    while (m_workers.size() < numThreads)
+        StartWorker(uint32(m_workers.size()));
+}
+
+void ThreadPool::StartWorker(uint32 index)
+{
+    m_workers.emplace_back(new Worker());
+    Worker* worker = m_workers.back().get();
+    worker->index = index;
+    // Publish the slot before the thread (or anyone else) may look at it
+    m_numWorkers = uint32(m_workers.size());
+    worker->thread = std::thread(&ThreadPool::WorkerLoop, this, worker);
+}
+
+void ThreadPool::Stop()
+{
+    std::lock_guard<std::mutex> guard(m_workersLock);
+    {
+        std::lock_guard<std::mutex> sleepGuard(m_sleepLock);
+        m_stop = true;
+        m_sleepCond.notify_all();
+    }
+    for (auto& worker : m_workers)
+        if (worker->thread.joinable())
+            worker->thread.join();
+}
+
+int32 ThreadPool::GetCurrentWorkerIndex() const
+{
+    return t_currentPool == this ? t_currentIndex : -1;
+}
+
+void ThreadPool::Enqueue(QueuedTask&& task)
+{
+    int32 index = GetCurrentWorkerIndex();
+    if (index >= 0)
+    {
+        Worker* self = m_workers[index].get();
+        std::lock_guard<std::mutex> guard(self->queueLock);
+        self->queue.push_back(std::move(task));
+    }
+    else
+    {
+        std::lock_guard<std::mutex> guard(m_injectLock);
+        m_injectQueue.push_back(std::move(task));
+    }
+
+    ++m_queuedTasks;
+    std::lock_guard<std::mutex> guard(m_sleepLock);
+    m_sleepCond.notify_one();
+}
+
+bool ThreadPool::PopFromQueue(std::deque<QueuedTask>& queue, TaskGroup* group, bool back, QueuedTask& result)
+{
+    if (queue.empty())
+        return false;
+
+    if (!group)
+    {
+        if (back)
+        {
+            result = std::move(queue.back());
+            queue.pop_back();
+        }
+        else
+        {
+            result = std::move(queue.front());
+            queue.pop_front();
+        }
+        return true;
+    }
+
+    // Restricted pop: queues are short (a few tasks per map and per tick), a scan is fine.
+    if (back)
+    {
+        for (auto it = queue.rbegin(); it != queue.rend(); ++it)
+            if (it->group == group)
+            {
+                result = std::move(*it);
+                queue.erase(std::next(it).base());
+                return true;
+            }
+    }
+    else
+    {
+        for (auto it = queue.begin(); it != queue.end(); ++it)
+            if (it->group == group)
+            {
+                result = std::move(*it);
+                queue.erase(it);
+                return true;
+            }
+    }
+    return false;
+}
+
+bool ThreadPool::PopTask(TaskGroup* group, QueuedTask& result)
+{
+    if (!m_queuedTasks)
+        return false;
+
+    uint32 numWorkers = m_numWorkers;
+    int32 selfIndex = GetCurrentWorkerIndex();
+
+    // 1- Own queue, newest first (cache-hot subtasks of the task we just ran)
+    if (selfIndex >= 0)
+    {
+        Worker* self = m_workers[selfIndex].get();
+        std::lock_guard<std::mutex> guard(self->queueLock);
+        if (PopFromQueue(self->queue, group, true, result))
+            return true;
+    }
+
+    // 2- Tasks submitted from outside the pool
+    {
+        std::lock_guard<std::mutex> guard(m_injectLock);
+        if (PopFromQueue(m_injectQueue, group, false, result))
+            return true;
+    }
+
+    // 3- Steal the oldest task of another worker
+    uint32 start = selfIndex >= 0 ? uint32(selfIndex) + 1 : 0;
+    for (uint32 i = 0; i < numWorkers; ++i)
+    {
+        uint32 victim = (start + i) % numWorkers;
+        if (int32(victim) == selfIndex)
+            continue;
+        Worker* other = m_workers[victim].get();
+        std::lock_guard<std::mutex> guard(other->queueLock);
+        if (PopFromQueue(other->queue, group, false, result))
+        {
+            ++m_stolenTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::RunPendingTask(TaskGroup* group)
+{
+    QueuedTask task;
+    if (!PopTask(group, task))
+        return false;
+
+    --m_queuedTasks;
+    task.task();
+    ++m_executedTasks;
+    task.group->TaskDone();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(Worker* self)
+{
+    t_currentPool = this;
+    t_currentIndex = int32(self->index);
+
+    if (m_pinThreads)
+        PinCurrentThread(self->index);
+    if (m_onThreadStart)
+        m_onThreadStart();
+
+    while (!m_stop)
+    {
+        if (RunPendingTask(nullptr))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        if (!m_stop && !m_queuedTasks)
+            m_sleepCond.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    if (m_onThreadEnd)
+        m_onThreadEnd();
+
+    t_currentPool = nullptr;
+    t_currentIndex = -1;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_THREADPOOL_H
+#define MANGOS_THREADPOOL_H
+
+#include "Platform/Define.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Long-lived pool of worker threads with per-worker work-stealing queues.
+ *
+ * Replaces the "spawn N threads, join N threads" pattern used every tick by
+ * the map update code. Work is submitted through a TaskGroup, and
+ * TaskGroup::Wait() acts as the barrier: the waiting thread executes pending
+ * tasks of its own group until the group is drained, so nested fork/join
+ * (continent task -> cells tasks) never deadlocks on a saturated pool.
+ */
+class ThreadPool
+{
+    public:
+        enum { MAX_POOL_THREADS = 128 };
+
+        typedef std::function<void()> Task;
+        typedef std::function<void()> ThreadHook;
+
+        class TaskGroup
+        {
+            friend class ThreadPool;
+
+            public:
+                explicit TaskGroup(ThreadPool* pool);
+                ~TaskGroup();
+
+                // Queue a task. Executed inline when the group has no pool.
+                void Run(Task task);
+                // Barrier: returns once every task queued in this group is done.
+                void Wait();
+
+            private:
+                TaskGroup(TaskGroup const&);
+                TaskGroup& operator=(TaskGroup const&);
+
+                void TaskDone();
+
+                ThreadPool* m_pool;
+                std::atomic<uint32> m_pending;
+                std::mutex m_doneLock;
+                std::condition_variable m_doneCond;
+        };
+
+        ThreadPool(uint32 numThreads, bool pinThreads, ThreadHook onThreadStart = ThreadHook(), ThreadHook onThreadEnd = ThreadHook());
+        ~ThreadPool();
+
+        // Grow the pool up to 'numThreads' workers. Workers are never destroyed before Stop().
+        void Reserve(uint32 numThreads);
+        void Stop();
+
+        uint32 GetNumThreads() const { return m_numWorkers; }
+        uint64 GetExecutedTasks() const { return m_executedTasks; }
+        uint64 GetStolenTasks() const { return m_stolenTasks; }
+
+        // Index of the calling worker in this pool, -1 for foreign threads.
+        int32 GetCurrentWorkerIndex() const;
+
+    private:
+        struct QueuedTask
+        {
+            QueuedTask() : group(nullptr) {}
+            QueuedTask(Task&& t, TaskGroup* g) : task(std::move(t)), group(g) {}
+            Task task;
+            TaskGroup* group;
+        };
+
+        struct Worker
+        {
+            Worker() : index(0) {}
+            std::thread thread;
+            std::mutex queueLock;
+            std::deque<QueuedTask> queue;
+            uint32 index;
+        };
+
+        ThreadPool(ThreadPool const&);
+        ThreadPool& operator=(ThreadPool const&);
+
+        void StartWorker(uint32 index);
+        void WorkerLoop(Worker* self);
+        void Enqueue(QueuedTask&& task);
+        // Pops one task (optionally restricted to 'group') and executes it.
+        bool RunPendingTask(TaskGroup* group);
+        bool PopTask(TaskGroup* group, QueuedTask& result);
+        static bool PopFromQueue(std::deque<QueuedTask>& queue, TaskGroup* group, bool back, QueuedTask& result);
+
+        // Reserved once to MAX_POOL_THREADS and never reallocated: other workers
+        // read it without locking while Reserve() appends
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::atomic<uint32> m_numWorkers;
+        std::mutex m_workersLock;                           // serializes Reserve()/Stop()
+        std::mutex m_injectLock;                            // tasks submitted from foreign threads
+        std::deque<QueuedTask> m_injectQueue;
+
+        std::mutex m_sleepLock;
+        std::condition_variable m_sleepCond;
+        std::atomic<uint32> m_queuedTasks;
+        std::atomic<bool> m_stop;
+
+        std::atomic<uint64> m_executedTasks;
+        std::atomic<uint64> m_stolenTasks;
+
+        bool m_pinThreads;
+        ThreadHook m_onThreadStart;
+        ThreadHook m_onThreadEnd;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "TickProfiler.h"
+#include "Policies/SingletonImp.h"
+#include <algorithm>
+#include <sstream>
+
+INSTANTIATE_SINGLETON_1(TickProfiler);
+
+TickProfile::TickProfile(uint32 mapId, uint32 instanceId) : m_mapId(mapId), m_instanceId(instanceId), m_touched(0)
+{
+    for (uint32 i = 0; i < MAX_TICK_PHASES; ++i)
+        m_current[i] = 0;
+}
+
+void TickProfile::EndTick()
+{
+    // Phases not reached this tick (eg. cells update interval not passed) do not record a 0
+    for (uint32 i = 0; i < MAX_TICK_PHASES; ++i)
+    {
+        if (!(m_touched & (1 << i)))
+            continue;
+        AddSample(TickPhase(i), m_current[i]);
+        m_current[i] = 0;
+    }
+    m_touched = 0;
+}
+
+void TickProfile::AddSample(TickPhase phase, uint32 us)
+{
+    Window& window = m_windows[phase];
+    uint32 index = window.next.fetch_add(1, std::memory_order_relaxed);
+    window.samples[index % WINDOW_SIZE].store(us, std::memory_order_relaxed);
+}
+
+TickPhaseStats TickProfile::GetStats(TickPhase phase) const
+{
+    TickPhaseStats stats;
+    Window const& window = m_windows[phase];
+    uint32 count = std::min<uint32>(window.next.load(std::memory_order_relaxed), WINDOW_SIZE);
+    if (!count)
+        return stats;
+
+    std::vector<uint32> samples(count);
+    for (uint32 i = 0; i < count; ++i)
+        samples[i] = window.samples[i].load(std::memory_order_relaxed);
+
+    auto percentile = [&samples, count](uint32 pct)
+    {
+        std::vector<uint32>::iterator nth = samples.begin() + std::min(count - 1, count * pct / 100);
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    };
+    stats.samples = count;
+    stats.p50 = percentile(50);
+    stats.p95 = percentile(95);
+    stats.p99 = percentile(99);
+    stats.max = *std::max_element(samples.begin(), samples.end());
+    return stats;
+}
+
+TickProfiler::TickProfiler() : m_enabled(true), m_world(0, 0), m_copiedBytes(0), m_sharedBytes(0),
+    m_lastTickCopiedBytes(0), m_lastTickSharedBytes(0), m_summaryCopiedBytes(0), m_summarySharedBytes(0), m_summaryTicks(0)
+{
+}
+
+void TickProfiler::EndNetworkTick()
+{
+    m_lastTickCopiedBytes = m_copiedBytes.exchange(0, std::memory_order_relaxed);
+    m_lastTickSharedBytes = m_sharedBytes.exchange(0, std::memory_order_relaxed);
+    m_summaryCopiedBytes += m_lastTickCopiedBytes;
+    m_summarySharedBytes += m_lastTickSharedBytes;
+    ++m_summaryTicks;
+}
+
+TickProfilePtr TickProfiler::CreateMapProfile(uint32 mapId, uint32 instanceId)
+{
+    TickProfilePtr profile = std::make_shared<TickProfile>(mapId, instanceId);
+    std::lock_guard<std::mutex> guard(m_mapsLock);
+    m_maps.push_back(profile);
+    return profile;
+}
+
+void TickProfiler::ReleaseMapProfile(TickProfilePtr const& profile)
+{
+    std::lock_guard<std::mutex> guard(m_mapsLock);
+    m_maps.erase(std::remove(m_maps.begin(), m_maps.end(), profile), m_maps.end());
+}
+
+void TickProfiler::GetMapProfiles(std::vector<TickProfilePtr>& profiles) const
+{
+    std::lock_guard<std::mutex> guard(m_mapsLock);
+    profiles = m_maps;
+}
+
+void TickProfiler::GetSlowestMaps(std::vector<TickProfilePtr>& profiles, uint32 count) const
+{
+    GetMapProfiles(profiles);
+
+    std::vector<std::pair<uint32, TickProfilePtr>> sorted;
+    sorted.reserve(profiles.size());
+    for (auto const& profile : profiles)
+        sorted.emplace_back(profile->GetStats(TICK_PHASE_MAP).p95, profile);
+    std::sort(sorted.begin(), sorted.end(), [](std::pair<uint32, TickProfilePtr> const& a, std::pair<uint32, TickProfilePtr> const& b)
+    {
+        return a.first > b.first;
+    });
+
+    profiles.clear();
+    for (uint32 i = 0; i < sorted.size() && i < count; ++i)
+        profiles.push_back(sorted[i].second);
+}
+
+char const* TickProfiler::GetPhaseName(TickPhase phase)
+{
+    switch (phase)
+    {
+        case TICK_PHASE_WORLD:              return "world";
+        case TICK_PHASE_WORLD_SESSIONS:     return "sessions";
+        case TICK_PHASE_WORLD_MAPS:         return "maps";
+        case TICK_PHASE_WORLD_DB_CALLBACKS: return "dbCallbacks";
+        case TICK_PHASE_NETWORK_FLUSH:      return "network";
+        case TICK_PHASE_MAP:                return "map";
+        case TICK_PHASE_MAP_SESSIONS:       return "sessions";
+        case TICK_PHASE_MAP_PLAYERS:        return "players";
+        case TICK_PHASE_MAP_CELLS:          return "cells";
+        case TICK_PHASE_MAP_MOVEMENT:       return "movement";
+        case TICK_PHASE_MAP_OBJECT_UPDATES: return "objUpdates";
+        case TICK_PHASE_MAP_VISIBILITY:     return "visibility";
+        case TICK_PHASE_MAP_SCRIPTS:        return "scripts";
+        default:                            return "unknown";
+    }
+}
+
+std::string TickProfiler::GetSummary() const
+{
+    std::ostringstream ss;
+    ss << "Tick p50/p95/p99 (us):";
+    for (uint32 i = TICK_PHASE_WORLD; i <= TICK_PHASE_NETWORK_FLUSH; ++i)
+    {
+        TickPhaseStats stats = m_world.GetStats(TickPhase(i));
+        ss << " " << GetPhaseName(TickPhase(i)) << " " << stats.p50 << "/" << stats.p95 << "/" << stats.p99;
+    }
+
+    std::vector<TickProfilePtr> slowest;
+    GetSlowestMaps(slowest, 1);
+    if (!slowest.empty())
+    {
+        TickPhaseStats stats = slowest[0]->GetStats(TICK_PHASE_MAP);
+        ss << " | slowest map " << slowest[0]->GetMapId() << " inst " << slowest[0]->GetInstanceId()
+           << " " << stats.p50 << "/" << stats.p95 << "/" << stats.p99;
+    }
+
+    if (m_summaryTicks)
+    {
+        ss << " | packet bytes/tick copied " << m_summaryCopiedBytes / m_summaryTicks
+           << " shared " << m_summarySharedBytes / m_summaryTicks;
+        m_summaryCopiedBytes = 0;
+        m_summarySharedBytes = 0;
+        m_summaryTicks = 0;
+    }
+    return ss.str();
+}
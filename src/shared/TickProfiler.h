@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ * Copyright (C) 2009-2011 MaNGOSZero <https://github.com/mangos/zero>
+ * Copyright (C) 2011-2016 Nostalrius <https://nostalrius.org>
+ * Copyright (C) 2016-2017 Elysium Project <https://github.com/elysium-project>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TICKPROFILER_H
+#define MANGOS_TICKPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum TickPhase
+{
+    TICK_PHASE_WORLD,                                       // whole World::Update
+    TICK_PHASE_WORLD_SESSIONS,
+    TICK_PHASE_WORLD_MAPS,
+    TICK_PHASE_WORLD_DB_CALLBACKS,
+    TICK_PHASE_NETWORK_FLUSH,                               // one sample per network thread loop
+    TICK_PHASE_MAP,                                         // whole Map::Update, without continents synchronization
+    TICK_PHASE_MAP_SESSIONS,
+    TICK_PHASE_MAP_PLAYERS,
+    TICK_PHASE_MAP_CELLS,
+    TICK_PHASE_MAP_MOVEMENT,
+    TICK_PHASE_MAP_OBJECT_UPDATES,
+    TICK_PHASE_MAP_VISIBILITY,
+    TICK_PHASE_MAP_SCRIPTS,
+    MAX_TICK_PHASES
+};
+
+struct TickPhaseStats
+{
+    TickPhaseStats() : samples(0), p50(0), p95(0), p99(0), max(0) {}
+    uint32 samples;
+    // microseconds
+    uint32 p50;
+    uint32 p95;
+    uint32 p99;
+    uint32 max;
+};
+
+/**
+ * Timings of the last ticks of one updater (the world, or a map).
+ *
+ * Phases can be timed several times in a tick: durations are summed until
+ * EndTick(), which pushes one sample per phase in a rolling window.
+ * Accumulation is done by the owner thread only, the windows can be read
+ * from any thread.
+ */
+class TickProfile
+{
+    public:
+        enum { WINDOW_SIZE = 256 };
+
+        TickProfile(uint32 mapId, uint32 instanceId);
+
+        uint32 GetMapId() const { return m_mapId; }
+        uint32 GetInstanceId() const { return m_instanceId; }
+
+        void Accumulate(TickPhase phase, uint32 us) { m_current[phase] += us; m_touched |= 1 << phase; }
+        void EndTick();
+        // Direct sample, thread safe. Used by phases updated from several threads.
+        void AddSample(TickPhase phase, uint32 us);
+
+        TickPhaseStats GetStats(TickPhase phase) const;
+
+    private:
+        struct Window
+        {
+            Window() : next(0)
+            {
+                for (uint32 i = 0; i < WINDOW_SIZE; ++i)
+                    samples[i] = 0;
+            }
+            std::atomic<uint32> next;
+            std::atomic<uint32> samples[WINDOW_SIZE];
+        };
+
+        uint32 m_mapId;
+        uint32 m_instanceId;
+        uint32 m_current[MAX_TICK_PHASES];
+        uint32 m_touched;
+        Window m_windows[MAX_TICK_PHASES];
+};
+
+typedef std::shared_ptr<TickProfile> TickProfilePtr;
+
+class TickProfiler
+{
+    public:
+        TickProfiler();
+
+        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        bool IsEnabled() const { return m_enabled; }
+
+        TickProfile* GetWorldProfile() { return &m_world; }
+
+        TickProfilePtr CreateMapProfile(uint32 mapId, uint32 instanceId);
+        void ReleaseMapProfile(TickProfilePtr const& profile);
+        void GetMapProfiles(std::vector<TickProfilePtr>& profiles) const;
+        // Maps sorted by decreasing p95 of the whole map update
+        void GetSlowestMaps(std::vector<TickProfilePtr>& profiles, uint32 count) const;
+
+        // Packet bytes written to the socket buffers, and queued by reference to a shared body
+        void AddCopiedBytes(uint32 bytes) { m_copiedBytes.fetch_add(bytes, std::memory_order_relaxed); }
+        void AddSharedBytes(uint32 bytes) { m_sharedBytes.fetch_add(bytes, std::memory_order_relaxed); }
+        // Called at the end of each world tick
+        void EndNetworkTick();
+        uint64 GetLastTickCopiedBytes() const { return m_lastTickCopiedBytes; }
+        uint64 GetLastTickSharedBytes() const { return m_lastTickSharedBytes; }
+
+        static char const* GetPhaseName(TickPhase phase);
+        // World and slowest map summary, for the periodic performance log
+        std::string GetSummary() const;
+
+    private:
+        std::atomic<bool> m_enabled;
+        TickProfile m_world;
+        mutable std::mutex m_mapsLock;
+        std::vector<TickProfilePtr> m_maps;
+
+        std::atomic<uint64> m_copiedBytes;
+        std::atomic<uint64> m_sharedBytes;
+        uint64 m_lastTickCopiedBytes;
+        uint64 m_lastTickSharedBytes;
+        // since the previous summary
+        mutable uint64 m_summaryCopiedBytes;
+        mutable uint64 m_summarySharedBytes;
+        mutable uint32 m_summaryTicks;
+};
+
+#define sTickProfiler MaNGOS::Singleton<TickProfiler>::Instance()
+
+/**
+ * Scoped timer of a tick phase. Costs two clock reads when the profiler
+ * is enabled, nothing otherwise. Stop() and Start() allow to exclude a
+ * part of the scope.
+ * A 'direct' timer pushes its own sample instead of accumulating into the
+ * current tick: use it for phases timed concurrently by several threads.
+ */
+class TickPhaseTimer
+{
+    public:
+        TickPhaseTimer(TickProfile* profile, TickPhase phase, bool direct = false) : m_profile(profile), m_phase(phase), m_running(false), m_direct(direct) { Start(); }
+        ~TickPhaseTimer() { Stop(); }
+
+        void Start()
+        {
+            if (m_profile && !m_running && sTickProfiler.IsEnabled())
+            {
+                m_running = true;
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        void Stop()
+        {
+            if (!m_running)
+                return;
+            m_running = false;
+            uint32 us = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+            if (m_direct)
+                m_profile->AddSample(m_phase, us);
+            else
+                m_profile->Accumulate(m_phase, us);
+        }
+
+    private:
+        TickPhaseTimer(TickPhaseTimer const&);
+        TickPhaseTimer& operator=(TickPhaseTimer const&);
+
+        TickProfile* m_profile;
+        TickPhase m_phase;
+        bool m_running;
+        bool m_direct;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
@@ -480,7 +480,7 @@ void utf8printf(FILE *out, const char *str, ...)
 {
     va_list ap;
     va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
+    vutf8printf(out, str, &ap);
     va_end(ap);
 }
 
@@ -377,4 +377,24 @@ bool IsIPAddress(char const* ipaddress);
 uint32 CreatePIDFile(const std::string& filename);
 
 void hexEncodeByteArray(uint8* bytes, uint32 arrayLen, std::string& result);
+
+// 64 bits FNV-1a. Not cryptographic: only used to detect changed data (eg. between two saves)
+#define FNV1A_64_SEED UI64LIT(0xcbf29ce484222325)
+
+inline uint64 HashFNV1a(void const* data, size_t size, uint64 hash = FNV1A_64_SEED)
+{
+    uint8 const* bytes = static_cast<uint8 const*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= UI64LIT(0x100000001b3);
+    }
+    return hash;
+}
+
+template<typename T>
+inline uint64 HashFNV1aValue(T const& value, uint64 hash = FNV1A_64_SEED)
+{
+    return HashFNV1a(&value, sizeof(T), hash);
+}
 #endif
@@ -24,6 +24,7 @@
 
 #include "Common.h"
 #include "ByteBuffer.h"
+#include <memory>
 
 // Note: m_opcode and size stored in platfom dependent format
 // ignore endianess until send, and converted at receive
@@ -69,4 +70,11 @@ class WorldPacket : public ByteBuffer
         uint16 m_opcode;
         uint32 m_recvdTime;
 };
+
+// Immutable packet body, queued as is by every socket it is sent to (broadcasts)
+typedef std::shared_ptr<WorldPacket const> SharedPacket;
+
+// Packets smaller than this are copied to the socket buffer even when shared,
+// an iovec costs more than the copy: they are not worth sharing at all.
+#define MIN_SHARED_PACKET_SIZE 64
 #endif